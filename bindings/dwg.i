@@ -31,21 +31,29 @@
 //too large
 //%include "dwg_api.h"
 
+// The C name getters return a malloc'd copy since r2007, else the field
+// itself, which a %newobject would free. So the names are bound to the
+// _interned getters, whose names are always owned by the dwg.
+%rename(dwg_ref_get_table_name) dwg_ref_get_table_name_interned;
+%rename(dwg_ent_get_layer_name) dwg_ent_get_layer_name_interned;
+%rename(dwg_obj_layer_get_name) dwg_obj_layer_get_name_interned;
+%rename(dwg_obj_table_get_name) dwg_obj_table_get_name_interned;
+
 EXPORT Dwg_Object_Ref **
 dwg_object_tablectrl_get_entries(const Dwg_Object *restrict obj,
                                  int *restrict error);
 EXPORT char *
-dwg_ref_get_table_name(const Dwg_Object_Ref *restrict ref,
-                       int *restrict error);
+dwg_ref_get_table_name_interned(const Dwg_Object_Ref *restrict ref,
+                                int *restrict error);
 EXPORT char *
-dwg_ent_get_layer_name(const dwg_obj_ent *restrict ent,
-                       int *restrict error);
+dwg_ent_get_layer_name_interned(const dwg_obj_ent *restrict ent,
+                                int *restrict error);
 EXPORT char *
-dwg_obj_layer_get_name(const dwg_obj_layer *restrict layer,
-                          int *restrict error);
+dwg_obj_layer_get_name_interned(const dwg_obj_layer *restrict layer,
+                                int *restrict error);
 EXPORT char *
-dwg_obj_table_get_name(const Dwg_Object *restrict obj,
-                          int *restrict error);
+dwg_obj_table_get_name_interned(const Dwg_Object *restrict obj,
+                                int *restrict error);
 EXPORT Dwg_Object *
 dwg_ent_to_object(const dwg_obj_ent *restrict obj,
                           int *restrict error);
@@ -0,0 +1,76 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * bench.c: the common code of the examples/ benchmarks, see bench.h
+ */
+
+#include "../src/config.h"
+#include <sys/stat.h>
+#include "dwg.h"
+#include "bench.h"
+
+double
+bench_seconds(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+void
+bench_report(const char *label, clock_t start, double amount,
+             const char *unit)
+{
+  double secs = bench_seconds(start);
+  printf("%s: %.3fs, %.1f %s/s\n", label, secs, amount / secs, unit);
+}
+
+int
+bench_args(int argc, char *argv[], unsigned long *n)
+{
+  if (argc > 2 && !strcmp(argv[1], "-n"))
+    {
+      *n = strtoul(argv[2], NULL, 10);
+      return 3;
+    }
+  return 1;
+}
+
+void
+bench_decode(const char *filename, unsigned opts)
+{
+  struct stat attrib;
+  Dwg_Data dwg;
+  clock_t start;
+  double secs;
+  int i;
+
+  if (stat(filename, &attrib) || !attrib.st_size)
+    {
+      fprintf(stderr, "%s not found\n", filename);
+      return;
+    }
+  start = clock();
+  for (i = 0; i < 10 || bench_seconds(start) < 1.0; i++)
+    {
+      memset(&dwg, 0, sizeof(Dwg_Data));
+      dwg.opts = opts;
+      if (dwg_read_file(filename, &dwg) >= DWG_ERR_CRITICAL)
+        {
+          fprintf(stderr, "%s: read error\n", filename);
+          return;
+        }
+      dwg_free(&dwg);
+    }
+  secs = bench_seconds(start);
+  printf("%s opts 0x%x: %.1f MB/s (%d runs)\n", filename, opts,
+         (double)attrib.st_size * i / secs / BENCH_MB, i);
+}
@@ -0,0 +1,41 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * bench.h: the common timing, option and reporting code of the
+ *          examples/ benchmarks. They only measure the current code,
+ *          to compare two revisions run the benchmark built from each.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MB (1024.0 * 1024.0)
+
+/* CPU seconds since start */
+double bench_seconds(clock_t start);
+/* Prints the seconds since start, and amount per second in unit */
+void bench_report(const char *label, clock_t start, double amount,
+                  const char *unit);
+/* An optional leading -n N sets *n.
+   Returns the index of the first other argument. */
+int bench_args(int argc, char *argv[], unsigned long *n);
+/* Reads and frees filename with opts, at least 10 times and for 1s,
+   and prints the MB/s of the file. */
+void bench_decode(const char *filename, unsigned opts);
+
+#endif
@@ -0,0 +1,123 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * bitbench.c: measure the bit and string readers, and the decode
+ *             throughput of DWG files.
+ *   usage: examples/bitbench [-n MB] [DWGFILE...]
+ */
+
+#include "../src/config.h"
+#include "bench.h"
+#include "dwg.h"
+#include "../src/bits.h"
+
+/* The typical mix of an entity: flags, shorts, longs and doubles */
+#define NUM_FIELDS 8
+
+static void
+write_fields(Bit_Chain *dat, unsigned long num)
+{
+  unsigned long i;
+  for (i = 0; i < num; i++)
+    {
+      bit_write_BB(dat, (unsigned char)(i & 3));
+      bit_write_BS(dat, (BITCODE_BS)(i % 3 ? i & 0xff : i & 0xffff));
+      bit_write_BL(dat, (BITCODE_BL)(i % 5 ? i & 0xff : i));
+      bit_write_BD(dat, i % 4 ? (double)i / 7.0 : (double)(i & 1));
+      bit_write_RC(dat, (unsigned char)i);
+      bit_write_RS(dat, (BITCODE_RS)i);
+      bit_write_RL(dat, (BITCODE_RL)i * 31);
+      bit_write_RD(dat, (double)i * 0.5);
+    }
+}
+
+static double
+read_fields(Bit_Chain *dat, unsigned long num)
+{
+  unsigned long i;
+  double sum = 0.0;
+  for (i = 0; i < num; i++)
+    {
+      sum += bit_read_BB(dat);
+      sum += bit_read_BS(dat);
+      sum += bit_read_BL(dat);
+      sum += bit_read_BD(dat);
+      sum += bit_read_RC(dat);
+      sum += bit_read_RS(dat);
+      sum += bit_read_RL(dat);
+      sum += bit_read_RD(dat);
+    }
+  return sum;
+}
+
+/* Strings and binary chunks, TV or TF */
+#define STRLEN 48
+
+static void
+bench_strings(Bit_Chain *dat, unsigned long num)
+{
+  unsigned char str[STRLEN];
+  unsigned long i;
+  volatile unsigned long sum = 0;
+  clock_t start;
+
+  for (i = 0; i < STRLEN; i++)
+    str[i] = (unsigned char)('A' + i % 26);
+  dat->byte = 0;
+  dat->bit = 1;
+  for (i = 0; i < num; i++)
+    bit_write_TF(dat, (char *)str, STRLEN);
+
+  dat->byte = 0;
+  dat->bit = 1;
+  start = clock();
+  for (i = 0; i < num; i++)
+    {
+      bit_read_fixed(dat, str, STRLEN);
+      sum += str[i % STRLEN];
+    }
+  bench_report("TF", start, (double)dat->byte / BENCH_MB, "MB");
+}
+
+int
+main(int argc, char *argv[])
+{
+  Bit_Chain dat = { NULL, 0, 0, 0, NULL, R_2000, R_2000 };
+  unsigned long num, mb = 64;
+  volatile double sum;
+  clock_t start;
+  int i = bench_args(argc, argv, &mb);
+
+  // about 25 bytes per NUM_FIELDS
+  num = mb * 1024 * 1024 / 25;
+  bit_chain_alloc(&dat);
+  bit_write_B(&dat, 1); // unaligned
+  write_fields(&dat, num);
+  dat.size = dat.byte + 1;
+  printf("%lu fields, %.1f MB\n", num * NUM_FIELDS,
+         (double)dat.size / BENCH_MB);
+
+  dat.byte = 0;
+  dat.bit = 1;
+  start = clock();
+  sum = read_fields(&dat, num);
+  bench_report("fields", start, (double)dat.byte / BENCH_MB, "MB");
+  (void)sum;
+  // the same amount of bytes
+  bench_strings(&dat, dat.size / STRLEN - 1);
+  free(dat.chain);
+
+  for (; i < argc; i++)
+    bench_decode(argv[i], 0);
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * crcbench.c: measure the CRCs, and the decode throughput of DWG files
+ *             with and without DWG_OPTS_NOCRC.
+ *   usage: examples/crcbench [-n MB] [DWGFILE...]
+ */
+
+#include "../src/config.h"
+#include "bench.h"
+#include "dwg.h"
+#include "../src/bits.h"
+
+/* Typical CRC'd chunks: objects of 20-200 bytes, and whole sections */
+#define BENCH(name, func, seed, chunk)                                        \
+  start = clock();                                                            \
+  for (sum = 0, i = 0; i + chunk <= size; i += chunk)                         \
+    sum += func(seed, &buf[i], chunk);                                        \
+  snprintf(label, sizeof(label), "%-14s %5d byte chunks", name, chunk);      \
+  bench_report(label, start, (double)size / BENCH_MB, "MB")
+
+int
+main(int argc, char *argv[])
+{
+  unsigned long mb = 256, size, i;
+  volatile unsigned long sum;
+  unsigned char *buf;
+  const int chunks[] = { 24, 200, 0x7400 };
+  char label[64];
+  unsigned c;
+  clock_t start;
+  int a = bench_args(argc, argv, &mb);
+
+  size = mb * 1024 * 1024;
+  buf = malloc(size);
+  if (!buf)
+    return 1;
+  srand(42);
+  for (i = 0; i < size; i++)
+    buf[i] = (unsigned char)rand();
+
+  for (c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++)
+    {
+      int chunk = chunks[c];
+      BENCH("bit_calc_CRC", bit_calc_CRC, 0xC0C1, chunk);
+      BENCH("bit_calc_CRC32", bit_calc_CRC32, 0, chunk);
+    }
+  free(buf);
+
+  for (; a < argc; a++)
+    {
+      bench_decode(argv[a], 0);
+      bench_decode(argv[a], DWG_OPTS_NOCRC);
+    }
+  return 0;
+}
@@ -0,0 +1,72 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * hashbench.c: measure the object_map hash with handle-like keys.
+ *   usage: examples/hashbench [-n num_keys]
+ */
+
+#include "../src/config.h"
+#include "bench.h"
+#include "../src/hash.h"
+
+int
+main (int argc, char *argv[])
+{
+  unsigned long num = 1000000;
+  uint32_t *keys, *probe;
+  uint32_t i, found = 0;
+  dwg_inthash *hash;
+  clock_t start;
+
+  bench_args(argc, argv, &num);
+  keys = malloc(num * sizeof(uint32_t));
+  probe = malloc(num * sizeof(uint32_t));
+  if (!keys || !probe)
+    return 1;
+  // handles are mostly ascending, with small gaps
+  srand(42);
+  keys[0] = 1;
+  for (i = 1; i < num; i++)
+    keys[i] = keys[i - 1] + 1 + (rand() % 4 == 0 ? rand() % 16 : 0);
+  // half hits, half misses
+  for (i = 0; i < num; i++)
+    probe[i] = i % 2 ? keys[rand() % num] : keys[num - 1] + 1 + rand();
+
+  printf("%lu keys\n", num);
+  start = clock();
+  hash = hash_new(num);
+  for (i = 0; i < num; i++)
+    hash_set(hash, keys[i], i);
+  bench_report("set", start, num / 1e6, "M");
+  start = clock();
+  for (i = 0; i < num; i++)
+    found += hash_get(hash, probe[i]) != HASH_NOT_FOUND;
+  bench_report("get", start, num / 1e6, "M");
+  printf("%u found\n", found);
+  found = 0;
+  start = clock();
+  for (i = 0; i < num; i++)
+    found += hash_get(hash, keys[i]) != HASH_NOT_FOUND;
+  bench_report("get ascending", start, num / 1e6, "M");
+  printf("%u found\n", found);
+  start = clock();
+  for (i = 0; i < num; i += 2)
+    hash_del(hash, keys[i]);
+  bench_report("del", start, (num + 1) / 2 / 1e6, "M");
+  printf("%u left\n", hash->elems);
+
+  hash_free(hash);
+  free(keys);
+  free(probe);
+  return 0;
+}
@@ -0,0 +1,163 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * lzbench.c: measure the R2004 section decompressor with the compressed
+ *            pages of DWG files.
+ *   usage: examples/lzbench [-n MB] DWGFILE...
+ */
+
+#include "../src/config.h"
+#include "bench.h"
+#include "dwg.h"
+#include "../src/common.h"
+#include "../src/decompress.h"
+
+typedef struct
+{
+  uint32_t address; /* of the data, behind the page header */
+  uint32_t comp_size;
+  uint32_t decomp_size;
+} page;
+
+/* Collect the compressed pages of all sections */
+static page *
+find_pages(Dwg_Data *dwg, const BITCODE_RC *chain, size_t size,
+           unsigned *num_pages)
+{
+  page *pages = NULL;
+  unsigned i, j, k, n = 0;
+
+  *num_pages = 0;
+  for (i = 0; i < dwg->header.num_infos; i++)
+    {
+      Dwg_Section_Info *info = &dwg->header.section_info[i];
+      if (info->compressed != 2 || !info->sections)
+        continue;
+      for (j = 0; j < info->num_sections; j++)
+        {
+          uint32_t hdr[8];
+          Dwg_Section *sec = info->sections[j];
+          if (!sec || (size_t)sec->address + 32 > size)
+            continue;
+          memcpy(hdr, &chain[sec->address], 32);
+          for (k = 0; k < 8; k++)
+            hdr[k] ^= 0x4164536b ^ sec->address;
+          // tag, section_type, data_size, section_size, ...
+          if (hdr[0] != 0x4163043b
+              || (size_t)sec->address + 32 + hdr[2] > size)
+            continue;
+          pages = realloc(pages, (n + 1) * sizeof(page));
+          pages[n].address = sec->address + 32;
+          pages[n].comp_size = hdr[2];
+          pages[n].decomp_size = info->max_decomp_size;
+          n++;
+        }
+    }
+  *num_pages = n;
+  return pages;
+}
+
+static void
+bench_file(const char *filename, unsigned long mb)
+{
+  Dwg_Data dwg;
+  BITCODE_RC *chain, *out;
+  page *pages;
+  unsigned i, r, num_pages, runs;
+  unsigned long total = 0;
+  uint32_t max_size = 0;
+  size_t size;
+  clock_t start;
+  int errors = 0;
+  FILE *fp;
+
+  memset(&dwg, 0, sizeof(Dwg_Data));
+  if (dwg_read_file(filename, &dwg) >= DWG_ERR_CRITICAL)
+    {
+      fprintf(stderr, "%s: read error\n", filename);
+      return;
+    }
+  if (dwg.header.version < R_2004 || dwg.header.version == R_2007)
+    {
+      fprintf(stderr, "%s: skipped, no R2004 format\n", filename);
+      dwg_free(&dwg);
+      return;
+    }
+  fp = fopen(filename, "rb");
+  if (!fp)
+    {
+      dwg_free(&dwg);
+      return;
+    }
+  fseek(fp, 0, SEEK_END);
+  size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  chain = malloc(size);
+  if (!chain || fread(chain, 1, size, fp) != size)
+    size = 0;
+  fclose(fp);
+
+  pages = find_pages(&dwg, chain, size, &num_pages);
+  dwg_free(&dwg);
+  for (i = 0; i < num_pages; i++)
+    {
+      total += pages[i].decomp_size;
+      if (pages[i].decomp_size > max_size)
+        max_size = pages[i].decomp_size;
+    }
+  if (!num_pages || !total)
+    {
+      fprintf(stderr, "%s: no compressed pages\n", filename);
+      free(chain);
+      free(pages);
+      return;
+    }
+  // the decompressed size of all runs, in MB
+  runs = (unsigned)(mb * 1024 * 1024 / total) + 1;
+  out = calloc(max_size, 1);
+
+  printf("%s: %u pages\n", filename, num_pages);
+  start = clock();
+  for (r = 0; r < runs; r++)
+    for (i = 0; i < num_pages; i++)
+      {
+        uint32_t consumed;
+        errors += decompress_R2004(out, pages[i].decomp_size,
+                                   &chain[pages[i].address],
+                                   pages[i].comp_size, &consumed) != 0;
+      }
+  bench_report("decompress_R2004", start, (double)total * runs / BENCH_MB,
+               "MB");
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+
+  free(out);
+  free(chain);
+  free(pages);
+}
+
+int
+main(int argc, char *argv[])
+{
+  unsigned long mb = 256;
+  int i = bench_args(argc, argv, &mb);
+
+  if (i >= argc)
+    {
+      fprintf(stderr, "usage: %s [-n MB] DWGFILE...\n", argv[0]);
+      return 1;
+    }
+  for (; i < argc; i++)
+    bench_file(argv[i], mb);
+  return 0;
+}
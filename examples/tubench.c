@@ -0,0 +1,143 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * tubench.c: measure bit_convert_TU and bit_utf8_to_TU with the table
+ *             names, texts and class names of r2007+ DWG files, and check
+ *             that their round trip is lossless.
+ *   usage: examples/tubench [-n runs] DWGFILE...
+ *   e.g.   examples/tubench test/test-data/example_20[01]?.dwg
+ */
+
+#include "../src/config.h"
+#include "bench.h"
+#include "dwg.h"
+#include "../src/common.h"
+#include "../src/bits.h"
+
+static BITCODE_TU *strings = NULL;
+static unsigned long num_strings = 0, num_alloced = 0, num_chars = 0;
+
+static void
+add_string(BITCODE_TU wstr)
+{
+  unsigned long len = 0;
+  if (!wstr)
+    return;
+  if (num_strings == num_alloced)
+    {
+      num_alloced = num_alloced ? 2 * num_alloced : 1024;
+      strings = realloc(strings, num_alloced * sizeof(BITCODE_TU));
+      if (!strings)
+        exit(1);
+    }
+  while (wstr[len])
+    len++;
+  strings[num_strings] = malloc((len + 1) * sizeof(*wstr));
+  memcpy(strings[num_strings], wstr, (len + 1) * sizeof(*wstr));
+  num_strings++;
+  num_chars += len;
+}
+
+static void
+add_strings(const char *filename)
+{
+  Dwg_Data dwg;
+  BITCODE_BL i;
+
+  memset(&dwg, 0, sizeof(Dwg_Data));
+  if (dwg_read_file(filename, &dwg) >= DWG_ERR_CRITICAL
+      || dwg.header.version < R_2007)
+    {
+      fprintf(stderr, "%s: no r2007+ DWG, skipped\n", filename);
+      dwg_free(&dwg);
+      return;
+    }
+  for (i = 0; i < dwg.num_classes; i++)
+    {
+      add_string(dwg.dwg_class[i].dxfname_u);
+      add_string((BITCODE_TU)dwg.dwg_class[i].appname);
+      add_string((BITCODE_TU)dwg.dwg_class[i].cppname);
+    }
+  for (i = 0; i < dwg.num_objects; i++)
+    {
+      Dwg_Object *obj = &dwg.object[i];
+      if (obj->supertype == DWG_SUPERTYPE_OBJECT && dwg_obj_is_table(obj))
+        // the name is the first field of all tables
+        add_string((BITCODE_TU)obj->tio.object->tio.LAYER->name);
+      else if (obj->type == DWG_TYPE_TEXT)
+        add_string((BITCODE_TU)obj->tio.entity->tio.TEXT->text_value);
+      else if (obj->type == DWG_TYPE_MTEXT)
+        add_string((BITCODE_TU)obj->tio.entity->tio.MTEXT->text);
+    }
+  dwg_free(&dwg);
+}
+
+int
+main(int argc, char *argv[])
+{
+  unsigned long runs = 2000, r, i, diffs = 0;
+  char **utf8;
+  clock_t start;
+  double mchars;
+  int a = bench_args(argc, argv, &runs);
+
+  if (a >= argc)
+    {
+      fprintf(stderr, "usage: %s [-n runs] DWGFILE...\n", argv[0]);
+      return 1;
+    }
+  for (; a < argc; a++)
+    add_strings(argv[a]);
+  if (!num_strings)
+    return 1;
+  printf("%lu strings, %lu chars\n", num_strings, num_chars);
+  mchars = (double)num_chars * runs / 1e6;
+
+  start = clock();
+  for (r = 0; r < runs; r++)
+    for (i = 0; i < num_strings; i++)
+      free(bit_convert_TU(strings[i]));
+  bench_report("bit_convert_TU", start, mchars, "Mchars");
+
+  utf8 = malloc(num_strings * sizeof(char *));
+  if (!utf8)
+    return 1;
+  for (i = 0; i < num_strings; i++)
+    utf8[i] = bit_convert_TU(strings[i]);
+
+  start = clock();
+  for (r = 0; r < runs; r++)
+    for (i = 0; i < num_strings; i++)
+      free(bit_utf8_to_TU(utf8[i]));
+  bench_report("bit_utf8_to_TU", start, mchars, "Mchars");
+
+  // the round trip must be lossless
+  for (i = 0; i < num_strings; i++)
+    {
+      BITCODE_TU wstr = bit_utf8_to_TU(utf8[i]);
+      unsigned long j = 0;
+      while (wstr[j] && wstr[j] == strings[i][j])
+        j++;
+      if (wstr[j] != strings[i][j])
+        diffs++;
+      free(wstr);
+      free(utf8[i]);
+    }
+  if (diffs)
+    fprintf(stderr, "%lu different results\n", diffs);
+  free(utf8);
+  for (i = 0; i < num_strings; i++)
+    free(strings[i]);
+  free(strings);
+  return diffs ? 1 : 0;
+}
@@ -5591,26 +5591,106 @@ typedef struct _dwg_struct
 
   long unsigned int measurement;
   unsigned int layout_number;
-  unsigned int opts; /* 0xf: loglevel, ... */
+  unsigned int opts; /* 0xf: loglevel, 0x10: minimal DXF, 0x20: arena, 0x40: lazy,
+                       0x80: no CRC checks, 0x100: decode_filter,
+                       0x200: objects_filter */
+  /** With DWG_OPTS_DECODE_FILTER, the R13+ objects of a type are only
+      decoded if it returns non-zero for their type, see dwg_read_file(). */
+  int (*decode_filter)(const struct _dwg_struct *dwg, const unsigned int type);
+  /** With DWG_OPTS_OBJECTS_FILTER, it is called with the uncompressed data
+      of the R13+ objects, before they are decoded. If it returns 0, no objects are decoded,
+      e.g. when a searched string cannot be found in it. */
+  int (*objects_filter)(const struct _dwg_struct *dwg,
+                        const unsigned char *data,
+                        const long unsigned int size);
+  BITCODE_BL num_alloced_objects; /*!< allocated size of object */
+  BITCODE_BL num_alloced_object_refs; /*!< allocated size of object_ref */
+  struct _dwg_ref_slab *ref_slab; /*!< storage of all object_ref's */
+  struct _dwg_arena *arena; /*!< storage of all objects, with DWG_OPTS_ARENA */
+  Dwg_Object_Ref **object_ref_index; /*!< first object_ref of each object */
+  BITCODE_BL num_object_ref_index; /*!< size of object_ref_index */
+  struct _dwg_lazy *lazy; /*!< deferred entities, with DWG_OPTS_LAZY */
+  struct _dwg_class_dispatch *class_dispatch; /*!< internal: the resolved classes */
+  struct _dwg_strings *strings; /*!< UTF-8 copies of r2007+ strings, see dwg_intern_TU() */
 } Dwg_Data;
 
+/** With this in dwg->opts, dwg_read_file() decodes all objects into a
+    few large memory chunks, which dwg_free() releases at once. The fields
+    of such objects must not be freed or re-alloced individually.
+    Ignored for preR13 drawings. */
+#define DWG_OPTS_ARENA 0x20
+
+/** With this in dwg->opts, dwg_read_file() only records the handle, type,
+    address and size of most entities. Such an entity has an empty tio
+    until it is decoded by dwg_decode_lazy_object(), dwg_decode_lazy_objects(),
+    dwg_object_to_entity() or dwg_ref_get_object(). These modify the
+    drawing, so they must not be called concurrently. The lookups, like
+    dwg_resolve_handle() or dwg_get_entities(), do not decode. Objects and
+    the entities owning others, like INSERT, POLYLINE or BLOCK, are still
+    decoded at once. The input is kept until dwg_free().
+    Ignored for preR13 drawings. */
+#define DWG_OPTS_LAZY 0x40
+
+/** With this in dwg->opts, dwg_read_file() does not calculate the CRCs of
+    the R13+ header, sections, handles pages and objects, for trusted
+    input. No DWG_ERR_WRONGCRC is reported then. */
+#define DWG_OPTS_NOCRC 0x80
+
+/** With this in dwg->opts, dwg_read_file() keeps and calls
+    dwg->decode_filter. Without it the field is not read, so it need not
+    be initialized. */
+#define DWG_OPTS_DECODE_FILTER 0x100
+
+/** With this in dwg->opts, dwg_read_file() keeps and calls
+    dwg->objects_filter. Without it the field is not read. */
+#define DWG_OPTS_OBJECTS_FILTER 0x200
+
 /*--------------------------------------------------
  * Exported Functions
  */
 
+/** Reads and decodes a DWG file. dwg is cleared, only dwg->opts,
+    dwg->decode_filter with DWG_OPTS_DECODE_FILTER and dwg->objects_filter
+    with DWG_OPTS_OBJECTS_FILTER are kept.
+    Objects rejected by dwg->decode_filter are skipped by their size. They
+    keep their type, size and handle, but have the supertype
+    DWG_SUPERTYPE_UNKNOWN and an empty tio. The control objects of the
+    tables are always decoded. The DXF, JSON and GeoJSON writers skip
+    such objects, dwg_write_file() returns DWG_ERR_INVALIDDWG.
+ */
 EXPORT int
 dwg_read_file(const char *restrict filename, Dwg_Data *restrict dwg);
 EXPORT int
+dwg_read_mmap(const char *restrict filename, Dwg_Data *restrict dwg);
+EXPORT int
+dwg_read_fd(int fd, Dwg_Data *restrict dwg);
+EXPORT int
 dxf_read_file(const char *restrict filename, Dwg_Data *restrict dwg);
 
 #ifdef USE_WRITE
 EXPORT int
 dwg_write_file(const char *restrict filename, const Dwg_Data *restrict dwg);
+/** Encodes a DWG to an open file descriptor, which stays open.
+    An empty regular file opened read-write is extended and mapped, and the
+    DWG is encoded in place, without holding it in memory. Otherwise, e.g.
+    for pipes, the DWG is encoded into memory and then written.
+ */
+EXPORT int
+dwg_write_fd(int fd, const Dwg_Data *restrict dwg);
 #endif
 
 EXPORT unsigned char*
 dwg_bmp(const Dwg_Data *restrict, BITCODE_RL *restrict);
 
+/** Returns the UTF-8 copy of the r2007+ string wstr. Each distinct string
+    is converted only once per drawing, and the copy is owned by the dwg:
+    do not free or change it, it is valid until dwg_free().
+    Returns NULL if wstr is NULL or out of memory.
+    Not thread-safe for the same dwg.
+ */
+EXPORT char *
+dwg_intern_TU(Dwg_Data *restrict dwg, const BITCODE_TU restrict wstr);
+
 /** Converts the internal enum RC into 100th mm lineweight, with
  *  -1 BYLAYER, -2 BYBLOCK, -3 BYLWDEFAULT.
  */
@@ -5696,10 +5776,18 @@ get_next_owned_block(const Dwg_Object *restrict hdr,
 
 EXPORT Dwg_Object *
 dwg_resolve_handle(const Dwg_Data* dwg,
-                   const BITCODE_BL absref);
+                   const long unsigned int absref);
 EXPORT int
 dwg_resolve_handleref(Dwg_Object_Ref *restrict ref,
                       const Dwg_Object *restrict obj);
+/** Decodes a deferred entity, see DWG_OPTS_LAZY.
+    Returns 0 if already decoded, or the decoder error codes. */
+EXPORT int
+dwg_decode_lazy_object(Dwg_Object *restrict obj);
+/** Decodes all deferred entities, see DWG_OPTS_LAZY.
+    Returns 0 or the combined decoder error codes. */
+EXPORT int
+dwg_decode_lazy_objects(Dwg_Data *restrict dwg);
 
 EXPORT Dwg_Section_Type
 dwg_section_type(const DWGCHAR *wname);
@@ -4617,27 +4617,47 @@ dwg_obj_block_control_get_paper_space(const dwg_obj_block_control *restrict ctrl
 *                    FUNCTIONS FOR LAYER OBJECT                     *
 ********************************************************************/
 
-// Get Layer Name
+// Get Layer Name, since r2007 a malloc'd copy
 EXPORT char *
 dwg_obj_layer_get_name(const dwg_obj_layer *restrict layer,
                           int *restrict error);
 
+// Get Layer Name, since r2007 owned by the dwg, see dwg_intern_TU()
+EXPORT char *
+dwg_obj_layer_get_name_interned(const dwg_obj_layer *restrict layer,
+                                int *restrict error);
+
 /*******************************************************************
 *                    FUNCTIONS FOR TABLES                          *
 *             All other tables and table entries                   *
 ********************************************************************/
 
 /// Get name of any table entry. Defaults to ByLayer.
+/// Since r2007 a malloc'd copy, which the caller must free.
 /// \sa dwg_ent_get_layer_name which defaults to "0"
 EXPORT char *
 dwg_obj_table_get_name(const dwg_object *restrict obj,
                           int *restrict error);
 
+/// Get name of any table entry. Defaults to ByLayer.
+/// Since r2007 the copy owned by the dwg, see dwg_intern_TU(),
+/// which must not be freed.
+EXPORT char *
+dwg_obj_table_get_name_interned(const dwg_object *restrict obj,
+                                int *restrict error);
+
 // Get name of the referenced table entry. Defaults to ByLayer
+// Since r2007 a malloc'd copy
 EXPORT char *
 dwg_ref_get_table_name(const dwg_object_ref *restrict ref,
                        int *restrict error);
 
+// Get name of the referenced table entry. Defaults to ByLayer
+// Since r2007 owned by the dwg, see dwg_intern_TU()
+EXPORT char *
+dwg_ref_get_table_name_interned(const dwg_object_ref *restrict ref,
+                                int *restrict error);
+
 // Get number of table entries from the table.
 EXPORT BITCODE_BL
 dwg_object_tablectrl_get_num_entries(const dwg_object *restrict obj,
@@ -4764,10 +4784,16 @@ EXPORT BITCODE_B
 dwg_ent_get_xdic_missing_flag(const dwg_obj_ent *restrict ent,
                               int *restrict error); //r2004+
 
+// Since r2007 a malloc'd copy
 EXPORT char *
 dwg_ent_get_layer_name(const dwg_obj_ent *restrict ent,
                        int *restrict error);
 
+// Since r2007 owned by the dwg, see dwg_intern_TU()
+EXPORT char *
+dwg_ent_get_layer_name_interned(const dwg_obj_ent *restrict ent,
+                                int *restrict error);
+
 EXPORT BITCODE_B
 dwg_ent_get_isbylayerlt(const dwg_obj_ent *restrict ent,
                           int *restrict error); //r13-r14 only
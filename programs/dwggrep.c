@@ -24,6 +24,7 @@
 #endif // ! _WIN32
 #include <stdio.h>
 #include <stdlib.h>
+#include <ctype.h>
 #ifdef HAVE_STRCASESTR
 # undef  __DARWIN_C_LEVEL
 # define __DARWIN_C_LEVEL __DARWIN_C_FULL
@@ -33,7 +34,6 @@
 # include <string.h>
 #else
 # include <string.h>
-# include <ctype.h>
 #endif
 #include "getopt.h"
 #ifdef HAVE_PCRE2_H
@@ -41,6 +41,13 @@
 # define PCRE2_CODE_UNIT_WIDTH 0
 # include <pcre2.h>
 #endif
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
+#if defined(HAVE_PTHREAD) && defined(HAVE_PTHREAD_H)
+# include <pthread.h>
+# define USE_THREADS 1
+#endif
 
 #include "dwg.h"
 #include "logging.h"
@@ -70,6 +77,7 @@ int opt_count = 0;
 int opt_text = 0;
 int opt_tables = 0;
 int opt_filename = 1;
+int opt_jobs = 1;
 short numdxf = 0;
 short numtype = 0;
 static short dxf[10];  //ensure zero-fill
@@ -82,11 +90,9 @@ static unsigned int cur_ver = 0;
 # undef USE_MATCH_CONTEXT
 /* pcre2_compile */
 static pcre2_code_8 *ri8;
-static pcre2_match_data_8 *match_data8;
 static pcre2_match_context_8 *match_context8 = NULL;
 # ifdef HAVE_PCRE2_16
 static pcre2_code_16 *ri16;
-static pcre2_match_data_16 *match_data16;
 static pcre2_match_context_16 *match_context16 = NULL;
 # endif
 
@@ -100,6 +106,44 @@ static pcre2_compile_context_16 *compile_context16 = NULL;
 # endif
 #endif
 
+/* The state of a thread searching files */
+typedef struct _grep_worker
+{
+#ifdef HAVE_PCRE2_H
+  pcre2_match_data_8 *match_data8;
+# ifdef HAVE_PCRE2_16
+  pcre2_match_data_16 *match_data16;
+# endif
+#endif
+  char *out; // with -j: the matches of the current file, printed in order
+  size_t len;
+  size_t size;
+} Grep_Worker;
+
+static Grep_Worker main_worker;
+#ifdef USE_THREADS
+static pthread_key_t worker_key;
+// dwg_free is not reentrant
+static pthread_mutex_t free_mutex = PTHREAD_MUTEX_INITIALIZER;
+# define MAX_JOBS 64
+#endif
+
+/* The prefilter: an ASCII literal which every match must contain, as
+   8-bit TV (< r2007) or UCS-2 TU string, or in the obfuscated SAT data
+   of 3DSOLIDs, at all 8 bit offsets of the bitstream. Files without it
+   in their objects are not decoded. */
+typedef struct _grep_needle
+{
+  unsigned char *bytes;
+  unsigned char *mask; // zero bits are not compared: partial bytes, case
+  int len;
+  int anchor;          // the index of a byte without masked bits, or -1
+} Grep_Needle;
+
+#define NEEDLE_SAT 2
+static Grep_Needle needles[3][8]; // [is16 or NEEDLE_SAT][bit offset]
+static int have_needle = 0;
+
 static int usage(void) {
   printf("\nUsage: dwggrep [-cRr] pattern *.dwg\n");
   return 1;
@@ -127,6 +171,9 @@ static int help(void) {
   printf("  -y, --type NAME           Search only NAME entities or objects.\n");
   printf("  -d, --dxf NUM             Search only DXF group NUM fields.\n");
   printf("  -t, --text                Search only in TEXT-like entities.\n");
+#ifdef USE_THREADS
+  printf("  -j, --jobs N              Search N files in parallel, 0 for one per CPU.\n");
+#endif
 #if 0
   printf("  -b, --tables              Search only in table names.\n");
 #endif
@@ -143,13 +190,53 @@ static int help(void) {
   return 0;
 }
 
+static Grep_Worker *current_worker(void)
+{
+#ifdef USE_THREADS
+  if (opt_jobs > 1)
+    return (Grep_Worker *)pthread_getspecific(worker_key);
+#endif
+  return &main_worker;
+}
+
+/* With -j the matches of a file are collected, to print the files in order */
+static void worker_print_match(Grep_Worker *restrict w,
+                               const char *restrict filename,
+                               const char *restrict entity,
+                               const int dxfgroup, const char *restrict text)
+{
+  const int len = snprintf(NULL, 0, "%s %s %d: %s\n", filename, entity,
+                           dxfgroup, text);
+  if (len < 0)
+    return;
+  if (w->len + len + 1 > w->size)
+    {
+      size_t size = w->size ? w->size * 2 : 4096;
+      char *out;
+      while (w->len + len + 1 > size)
+        size *= 2;
+      out = (char *)realloc(w->out, size);
+      if (!out)
+        return;
+      w->out = out;
+      w->size = size;
+    }
+  snprintf(&w->out[w->len], len + 1, "%s %s %d: %s\n", filename, entity,
+           dxfgroup, text);
+  w->len += len;
+}
+
 static void print_match(const int is16, const char *restrict filename,
                         const char *restrict entity,
                         const int dxfgroup, char *restrict text)
 {
   if (is16)
     text = bit_convert_TU((BITCODE_TU)text);
-  printf("%s %s %d: %s\n", opt_filename ? filename : "", entity, dxfgroup, text);
+  if (opt_jobs > 1)
+    worker_print_match(current_worker(), opt_filename ? filename : "",
+                       entity, dxfgroup, text);
+  else
+    printf("%s %s %d: %s\n", opt_filename ? filename : "", entity, dxfgroup, text);
   if (is16)
     free(text);
 }
@@ -161,26 +248,28 @@ do_match (const int is16, const char *restrict filename,
 {
 #ifdef HAVE_PCRE2_H
   int rc;
+  Grep_Worker *w = current_worker();
 # ifdef HAVE_PCRE2_16
   if (is16)
     rc = pcre2_match_16(ri16, (PCRE2_SPTR16)text, PCRE2_ZERO_TERMINATED, 0,
                            PCRE2_JIT_MATCH_OPTIONS,
-                           match_data16,     /* block for storing the result */
+                           w->match_data16,  /* block for storing the result */
                            match_context16); /* disabled */
   else
 # endif
     // already converted to UTF-8 before
     rc = pcre2_match_8(ri8, (PCRE2_SPTR8)text, PCRE2_ZERO_TERMINATED, 0,
                        PCRE2_JIT_MATCH_OPTIONS,
-                       match_data8,     /* block for storing the result */
+                       w->match_data8,  /* block for storing the result */
                        match_context8); /* disabled */
   if (rc >= 0) {
     if (!opt_count)
       print_match(is16, filename, entity, dxfgroup, text);
     return 1;
   } else if (rc < -2) { //not PCRE2_ERROR_NOMATCH nor PCRE2_ERROR_PARTIAL
-    pcre2_get_error_message_8(rc, (PCRE2_UCHAR8 *)buf, 4096);
-    LOG_WARN("pcre2 match error %s with %s", buf, pattern);
+    char msg[256];
+    pcre2_get_error_message_8(rc, (PCRE2_UCHAR8 *)msg, sizeof(msg));
+    LOG_WARN("pcre2 match error %s with %s", msg, pattern);
   }
   return 0;
 
@@ -247,7 +336,7 @@ do_match (const int is16, const char *restrict filename,
     for (int _i=0; _i<numdxf; _i++) { \
       if (dxf[_i] == dxfgroup) { dxfok = 1; break; } \
     } \
-    if (dxfok) { [[['(type,ENTITY,text_field,dxfgroup); } \
+    if (dxfok) { MATCH_TYPE(type,ENTITY,text_field,dxfgroup); } \
   } \
   else { \
     MATCH_TYPE(type,ENTITY,text_field,dxfgroup); \
@@ -280,7 +369,7 @@ do_match (const int is16, const char *restrict filename,
   if (text) { \
     if (obj->parent->header.version >= R_2007) \
       text = bit_convert_TU((BITCODE_TU)text); \
-    found += do_match(obj->parent->header.version >= R_2007, filename, #ENTITY, dxfgroup, text); \
+    found += do_match(0, filename, #ENTITY, dxfgroup, text); /* UTF-8 now */ \
     if (obj->parent->header.version >= R_2007) \
       free(text); \
   }
@@ -1006,13 +1095,386 @@ int match_BLOCK_HEADER(const char *restrict filename, Dwg_Object_Ref *restrict r
   return found;
 }
 
+/* The longest run of ASCII characters which every match of the pattern
+   must contain, into lit. 0 if unsure, e.g. with alternatives. */
+static int
+required_literal(const char *restrict pat, char *restrict lit)
+{
+  char *cur = (char *)malloc(strlen(pat) + 1);
+  const char *p;
+  int len = 0, best = 0, depth = 0;
+
+  if (!cur)
+    return 0;
+#ifdef HAVE_PCRE2_H
+  // alternatives, inline options and comments, quoting
+  if ((options & PCRE2_EXTENDED) || strchr(pat, '|') || strstr(pat, "(?")
+      || strstr(pat, "\\Q"))
+    {
+      free(cur);
+      return 0;
+    }
+#endif
+  for (p = pat; *p; p++)
+    {
+      unsigned char c = (unsigned char)*p;
+#ifdef HAVE_PCRE2_H
+      if (c == '*' || c == '?' || c == '{')
+        {
+          if (len) // the previous character is optional
+            len--;
+          if (c == '{' && !(p = strchr(p, '}')))
+            break;
+          c = 0;
+        }
+      else if (c == '+' || c == '.' || c == '^' || c == '$')
+        c = 0;
+      else if (c == '(' || c == ')')
+        {
+          depth += c == '(' ? 1 : -1;
+          c = 0;
+        }
+      else if (c == '[')
+        {
+          p++;
+          if (*p == '^')
+            p++;
+          if (*p == ']')
+            p++;
+          while (*p && *p != ']')
+            {
+              if (*p == '\\' && p[1])
+                p++;
+              else if (*p == '[' && p[1] == ':' && strstr(p, ":]"))
+                p = strstr(p, ":]") + 1;
+              p++;
+            }
+          if (!*p)
+            break;
+          c = 0;
+        }
+      else if (c == '\\')
+        {
+          // \d, \x41, \p{L}, backrefs, ...: stop here
+          if (!ispunct((unsigned char)p[1]))
+            break;
+          c = (unsigned char)*++p;
+        }
+#endif
+      if (c && c < 0x80 && !depth)
+        cur[len++] = (char)c;
+      else
+        {
+          if (len > best)
+            {
+              memcpy(lit, cur, len);
+              best = len;
+            }
+          len = 0;
+        }
+    }
+  if (len > best)
+    {
+      memcpy(lit, cur, len);
+      best = len;
+    }
+  free(cur);
+  return best;
+}
+
+/* Prepares the needles for the literal: as bytes, UCS-2 or SAT, and as
+   written with each bit offset. With -i the case bit 0x20 of letters
+   is not compared, and SAT letters not at all. */
+static int
+needles_init(const char *restrict lit, const int len, const int caseless)
+{
+  int enc, s, k;
+
+  for (enc = 0; enc <= NEEDLE_SAT; enc++)
+    {
+      const int is16 = enc == 1;
+      const int n = is16 ? 2 * len : len;
+      unsigned char *p = (unsigned char *)malloc(n);
+      unsigned char *m = (unsigned char *)malloc(n);
+      if (!p || !m)
+        return 1;
+      for (k = 0; k < len; k++)
+        {
+          unsigned char c = (unsigned char)lit[k];
+          unsigned char cm = caseless && isalpha(c) ? 0xdf : 0xff;
+          if (enc == NEEDLE_SAT)
+            {
+              // see the 3DSOLID acis_data decoding in dwg.spec
+              if (c > 32)
+                c = 159 - c;
+              if (cm != 0xff)
+                cm = 0;
+            }
+          if (is16)
+            {
+              p[2 * k] = c;
+              m[2 * k] = cm;
+              p[2 * k + 1] = 0;
+              m[2 * k + 1] = 0xff;
+            }
+          else
+            {
+              p[k] = c;
+              m[k] = cm;
+            }
+        }
+      for (s = 0; s < 8; s++)
+        {
+          Grep_Needle *nd = &needles[enc][s];
+          // with a bit offset, the first and last bytes are partial
+          nd->len = s ? n + 1 : n;
+          nd->bytes = (unsigned char *)malloc(nd->len);
+          nd->mask = (unsigned char *)malloc(nd->len);
+          nd->anchor = -1;
+          if (!nd->bytes || !nd->mask)
+            return 1;
+          for (k = 0; k < nd->len; k++)
+            {
+              unsigned int b = 0, bm = 0;
+              if (k < n)
+                {
+                  b = p[k] >> s;
+                  bm = m[k] >> s;
+                }
+              if (s && k > 0)
+                {
+                  b |= (p[k - 1] << (8 - s)) & 0xff;
+                  bm |= (m[k - 1] << (8 - s)) & 0xff;
+                }
+              nd->mask[k] = (unsigned char)bm;
+              nd->bytes[k] = (unsigned char)(b & bm);
+              // memchr for a complete byte, preferably not 0
+              if (bm == 0xff
+                  && (nd->anchor < 0 || (!nd->bytes[nd->anchor] && b)))
+                nd->anchor = k;
+            }
+        }
+      free(p);
+      free(m);
+    }
+  return 0;
+}
+
+static int
+needle_search(const Grep_Needle *restrict nd,
+              const unsigned char *restrict data,
+              const long unsigned int size)
+{
+  long unsigned int i;
+  int k;
+
+  if (size < (long unsigned int)nd->len)
+    return 0;
+  if (nd->anchor >= 0)
+    {
+      const unsigned char *p = &data[nd->anchor];
+      const unsigned char *end = &data[size - nd->len + nd->anchor + 1];
+      while (p < end
+             && (p = (const unsigned char *)memchr(p, nd->bytes[nd->anchor],
+                                                   end - p)))
+        {
+          const unsigned char *start = p - nd->anchor;
+          for (k = 0; k < nd->len; k++)
+            if ((start[k] & nd->mask[k]) != nd->bytes[k])
+              break;
+          if (k == nd->len)
+            return 1;
+          p++;
+        }
+      return 0;
+    }
+  for (i = 0; i + nd->len <= size; i++)
+    {
+      for (k = 0; k < nd->len; k++)
+        if ((data[i + k] & nd->mask[k]) != nd->bytes[k])
+          break;
+      if (k == nd->len)
+        return 1;
+    }
+  return 0;
+}
+
+/* dwg->objects_filter: only decode the objects if they contain the
+   literal. The strings are TU since r2007. */
+static int
+objects_filter(const Dwg_Data *restrict dwg, const unsigned char *restrict data,
+               const long unsigned int size)
+{
+  const int is16 = dwg->header.version >= R_2007;
+  int s;
+
+  for (s = 0; s < 8; s++)
+    if (needle_search(&needles[is16][s], data, size))
+      return 1;
+  for (s = 0; s < 8; s++)
+    if (needle_search(&needles[NEEDLE_SAT][s], data, size))
+      return 1;
+  return 0;
+}
+
+/* Searches one file. Returns the number of matches. */
+static int
+grep_file(const char *restrict filename)
+{
+  Dwg_Data dwg;
+  int error, count = 0;
+  long k;
+
+  memset(&dwg, 0, sizeof(Dwg_Data));
+  // freed at once
+  dwg.opts = DWG_OPTS_ARENA;
+  if (have_needle)
+    {
+      dwg.opts |= DWG_OPTS_OBJECTS_FILTER;
+      dwg.objects_filter = objects_filter;
+    }
+  error = dwg_read_file(filename, &dwg);
+  if (error > DWG_ERR_CRITICAL)
+    {
+      fprintf(stderr, "Error: Could not read DWG file %s, error: 0x%x\n",
+              filename, error);
+      return 0;
+    }
+
+  // no objects: without the literal
+  if (dwg.num_objects)
+    {
+      count += match_BLOCK_HEADER(filename, dwg_model_space_ref(&dwg));
+      for (k=0; k < dwg.block_control.num_entries; k++)
+        {
+          count += match_BLOCK_HEADER(filename, dwg.block_control.block_headers[k]);
+        }
+      count += match_BLOCK_HEADER(filename, dwg_paper_space_ref(&dwg));
+    }
+
+#ifdef USE_THREADS
+  if (opt_jobs > 1)
+    pthread_mutex_lock(&free_mutex);
+#endif
+  dwg_free(&dwg);
+#ifdef USE_THREADS
+  if (opt_jobs > 1)
+    pthread_mutex_unlock(&free_mutex);
+#endif
+  return count;
+}
+
+#ifdef USE_THREADS
+/* The result of a file, until all files before it are printed */
+typedef struct _grep_result
+{
+  char *out;
+  size_t len;
+  int count;
+  int done;
+} Grep_Result;
+
+typedef struct _grep_pool
+{
+  pthread_mutex_t mutex;
+  char **files;
+  int num_files;
+  int next;    // the next file to search
+  int printed; // the next file to print
+  int count;
+  Grep_Result *results;
+} Grep_Pool;
+
+/* Searches the next files, until all are taken. The results are
+   printed as soon as all previous files are printed. */
+static void *
+grep_worker(void *arg)
+{
+  Grep_Pool *pool = (Grep_Pool *)arg;
+  Grep_Worker worker;
+
+  memset(&worker, 0, sizeof(Grep_Worker));
+#ifdef HAVE_PCRE2_H
+  worker.match_data8 = pcre2_match_data_create_from_pattern_8(ri8, NULL);
+# ifdef HAVE_PCRE2_16
+  worker.match_data16 = pcre2_match_data_create_from_pattern_16(ri16, NULL);
+# endif
+#endif
+  pthread_setspecific(worker_key, &worker);
+  for (;;)
+    {
+      int j, count;
+      pthread_mutex_lock(&pool->mutex);
+      j = pool->next++;
+      pthread_mutex_unlock(&pool->mutex);
+      if (j >= pool->num_files)
+        break;
+
+      worker.out = NULL;
+      worker.len = worker.size = 0;
+      count = grep_file(pool->files[j]);
+
+      pthread_mutex_lock(&pool->mutex);
+      pool->results[j].out = worker.out;
+      pool->results[j].len = worker.len;
+      pool->results[j].count = count;
+      pool->results[j].done = 1;
+      while (pool->printed < pool->num_files
+             && pool->results[pool->printed].done)
+        {
+          Grep_Result *r = &pool->results[pool->printed++];
+          if (r->len)
+            fwrite(r->out, 1, r->len, stdout);
+          free(r->out);
+          r->out = NULL;
+          pool->count += r->count;
+        }
+      pthread_mutex_unlock(&pool->mutex);
+    }
+#ifdef HAVE_PCRE2_H
+  pcre2_match_data_free_8(worker.match_data8);
+# ifdef HAVE_PCRE2_16
+  pcre2_match_data_free_16(worker.match_data16);
+# endif
+#endif
+  return NULL;
+}
+
+/* Searches the files with opt_jobs threads, the calling one included.
+   Returns the number of matches. */
+static int
+grep_files_parallel(char **files, const int num_files)
+{
+  Grep_Pool pool;
+  pthread_t thread[MAX_JOBS];
+  int t, num_started = 0;
+
+  memset(&pool, 0, sizeof(Grep_Pool));
+  pool.files = files;
+  pool.num_files = num_files;
+  pool.results = (Grep_Result *)calloc(num_files, sizeof(Grep_Result));
+  if (!pool.results)
+    return 0;
+  pthread_mutex_init(&pool.mutex, NULL);
+  for (t = 1; t < opt_jobs; t++)
+    {
+      if (!pthread_create(&thread[num_started], NULL, grep_worker, &pool))
+        num_started++;
+    }
+  grep_worker(&pool);
+  for (t = 0; t < num_started; t++)
+    pthread_join(thread[t], NULL);
+  pthread_mutex_destroy(&pool.mutex);
+  free(pool.results);
+  return pool.count;
+}
+#endif
+
 int
 main (int argc, char *argv[])
 {
-  int error = 0;
   int i = 1, j;
-  char* filename;
-  Dwg_Data dwg;
+  char *lit;
   int plen;
   int errcode;
 #ifdef HAVE_PCRE2_H
@@ -1038,6 +1500,7 @@ main (int argc, char *argv[])
         {"dxf",       1, 0, 'd'},
         {"text",      0, 0, 't'},
         {"tables",    0, 0, 'b'},
+        {"jobs",      1, 0, 'j'},
         {"help",      0, 0, 0},
         {"version",   0, 0, 0},
         {NULL,        0, NULL, 0}
@@ -1051,10 +1514,10 @@ main (int argc, char *argv[])
 
   while
 #ifdef HAVE_GETOPT_LONG
-    ((c = getopt_long(argc, argv, "ixchrRy:d:tb",
+    ((c = getopt_long(argc, argv, "ixchrRy:d:tbj:",
                       long_options, &option_index)) != -1)
 #else
-    ((c = getopt(argc, argv, "ixchrRy:d:tbvu")) != -1)
+    ((c = getopt(argc, argv, "ixchrRy:d:tbj:vu")) != -1)
 #endif
     {
       if (c == -1) break;
@@ -1094,6 +1557,9 @@ main (int argc, char *argv[])
       case 'b':
         opt_tables = 1;
         break;
+      case 'j':
+        opt_jobs = (int)strtol(optarg, NULL, 10);
+        break;
       case 'y':
         if (numtype >= 10) return usage(); //too many
         type[numtype++] = optarg; // a string
@@ -1137,7 +1603,7 @@ main (int argc, char *argv[])
     LOG_ERROR("pcre2_compile_8 error %d: %s with %s", errcode, buf, pattern);
     return 1;
   }
-  match_data8 = pcre2_match_data_create_from_pattern_8(ri8, NULL);
+  main_worker.match_data8 = pcre2_match_data_create_from_pattern_8(ri8, NULL);
   if (have_jit)
     pcre2_jit_compile_8(ri8, PCRE2_JIT_COMPILE_OPTIONS);
 
@@ -1160,37 +1626,49 @@ main (int argc, char *argv[])
     LOG_ERROR("pcre2_compile_16 error %d: %s with %s", errcode, buf, pattern);
     return 1;
   }
-  match_data16 = pcre2_match_data_create_from_pattern_16(ri16, NULL);
+  main_worker.match_data16 = pcre2_match_data_create_from_pattern_16(ri16, NULL);
   if (have_jit)
     pcre2_jit_compile_16(ri16, PCRE2_JIT_COMPILE_OPTIONS);
 # endif
 #endif
 
-  //for all filenames...
-  for (j=i+1; j<argc; j++)
+  // the prefilter, not for single characters
+  lit = (char *)malloc(plen + 1);
+  if (lit)
     {
-      long k;
-
-      filename = argv[j];
-      memset(&dwg, 0, sizeof(Dwg_Data));
-      dwg.opts = 0;
-      error = dwg_read_file(filename, &dwg);
-      if (error > DWG_ERR_CRITICAL)
-        {
-          fprintf(stderr, "Error: Could not read DWG file %s, error: 0x%x\n",
-                  filename, error);
-          continue;
-        }
-
-      count += match_BLOCK_HEADER(filename, dwg_model_space_ref(&dwg));
-      for (k=0; k < dwg.block_control.num_entries; k++)
-        {
-          count += match_BLOCK_HEADER(filename, dwg.block_control.block_headers[k]);
-        }
-      count += match_BLOCK_HEADER(filename, dwg_paper_space_ref(&dwg));
+      int len = required_literal(pattern, lit);
+      if (len > 1 && !needles_init(lit, len, options & PCRE2_CASELESS))
+        have_needle = 1;
+      free(lit);
+    }
 
-      if (j < argc)
-        dwg_free(&dwg); //skip the last free
+#ifdef USE_THREADS
+# ifdef _SC_NPROCESSORS_ONLN
+  if (opt_jobs <= 0)
+    opt_jobs = (int)sysconf(_SC_NPROCESSORS_ONLN);
+# endif
+  if (opt_jobs > MAX_JOBS)
+    opt_jobs = MAX_JOBS;
+  if (opt_jobs > argc - i - 1)
+    opt_jobs = argc - i - 1;
+  if (opt_jobs > 1 && pthread_key_create(&worker_key, NULL))
+    opt_jobs = 1;
+  if (opt_jobs > 1)
+    {
+# ifdef HAVE_SETENV
+      // the files are searched in parallel, not their objects, even with
+      // a LIBREDWG_THREADS set by the user
+      setenv("LIBREDWG_THREADS", "1", 1);
+# endif
+      count = grep_files_parallel(&argv[i + 1], argc - i - 1);
+    }
+  else
+#endif
+    {
+      opt_jobs = 1;
+      //for all filenames...
+      for (j=i+1; j<argc; j++)
+        count += grep_file(argv[j]);
     }
   if (opt_count)
     printf("%d\n", count);
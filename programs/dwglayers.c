@@ -61,6 +61,13 @@ static int help(void) {
   return 0;
 }
 
+static int
+layers_only(const Dwg_Data *dwg, const unsigned int type)
+{
+  (void)dwg;
+  return type == DWG_TYPE_LAYER;
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -125,6 +132,8 @@ main (int argc, char *argv[])
 
   filename_in = argv[i];
   memset(&dwg, 0, sizeof(Dwg_Data));
+  dwg.opts = DWG_OPTS_DECODE_FILTER;
+  dwg.decode_filter = layers_only;
   error = dwg_read_file(filename_in, &dwg);
   if (error >= DWG_ERR_CRITICAL)
     fprintf(stderr, "READ ERROR %s: 0x%x\n", filename_in, error);
@@ -144,11 +153,8 @@ main (int argc, char *argv[])
                layer->on ?     "+" : "-",
                layer->locked ? "l" : " ");
       // since r2007 unicode, converted to utf-8
-      if (dwg.header.version >= R_2007) {
-        char *utf8 = bit_convert_TU((BITCODE_TU)layer->name);
-        printf("%s\n", utf8);
-        free(utf8);
-      }
+      if (dwg.header.version >= R_2007)
+        printf("%s\n", dwg_intern_TU(&dwg, (BITCODE_TU)layer->name));
       else
         printf("%s\n", layer->name);
     }
@@ -0,0 +1,259 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * arena.c: bump allocator for the decoded objects of a drawing.
+ *          Chunks double in size, large blocks get a chunk of their own.
+ *          Every block is preceded by its size, for arena_realloc.
+ */
+
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#if defined(HAVE_PTHREAD) && defined(HAVE_PTHREAD_H)
+# include <pthread.h>
+# define USE_THREADS 1
+#endif
+
+/* the first and the largest chunk size */
+#define ARENA_CHUNK (64 * 1024)
+#define MAX_ARENA_CHUNK (4 * 1024 * 1024)
+
+/* the block header, also giving the alignment */
+typedef union _arena_header
+{
+  size_t size;
+  double d;
+  void *p;
+  long long l;
+} Arena_Header;
+
+#define ARENA_ALIGN(size) \
+  (((size) + sizeof(Arena_Header) - 1) & ~(sizeof(Arena_Header) - 1))
+
+typedef struct _arena_chunk
+{
+  struct _arena_chunk *next;
+  size_t used;
+  size_t size;
+  Arena_Header data[];
+} Arena_Chunk;
+
+struct _dwg_arena
+{
+  Arena_Chunk *chunk; // the current one first
+  size_t next_size;
+};
+
+#ifdef USE_THREADS
+static pthread_key_t arena_key;
+static pthread_once_t arena_once = PTHREAD_ONCE_INIT;
+static int arena_key_ok;
+
+static void
+arena_key_init(void)
+{
+  arena_key_ok = !pthread_key_create(&arena_key, NULL);
+}
+
+static inline Dwg_Arena *
+arena_current(void)
+{
+  return arena_key_ok ? (Dwg_Arena *)pthread_getspecific(arena_key) : NULL;
+}
+#else
+static Dwg_Arena *current_arena;
+# define arena_current() current_arena
+#endif
+
+Dwg_Arena *
+arena_new(void)
+{
+  Dwg_Arena *arena;
+#ifdef USE_THREADS
+  pthread_once(&arena_once, arena_key_init);
+  if (!arena_key_ok)
+    return NULL;
+#endif
+  arena = (Dwg_Arena *)calloc(1, sizeof(Dwg_Arena));
+  if (arena)
+    arena->next_size = ARENA_CHUNK;
+  return arena;
+}
+
+void
+arena_free(Dwg_Arena *arena)
+{
+  if (!arena)
+    return;
+  while (arena->chunk)
+    {
+      Arena_Chunk *next = arena->chunk->next;
+      free(arena->chunk);
+      arena->chunk = next;
+    }
+  free(arena);
+}
+
+void
+arena_join(Dwg_Arena *restrict arena, Dwg_Arena *restrict from)
+{
+  if (!from)
+    return;
+  if (from->chunk)
+    {
+      Arena_Chunk *tail = from->chunk;
+      while (tail->next)
+        tail = tail->next;
+      // keep the current chunk of arena in front
+      if (arena->chunk)
+        {
+          tail->next = arena->chunk->next;
+          arena->chunk->next = from->chunk;
+        }
+      else
+        arena->chunk = from->chunk;
+    }
+  free(from);
+}
+
+Dwg_Arena *
+arena_use(Dwg_Arena *arena)
+{
+  Dwg_Arena *prev = arena_current();
+#ifdef USE_THREADS
+  if (arena_key_ok)
+    pthread_setspecific(arena_key, arena);
+#else
+  current_arena = arena;
+#endif
+  return prev;
+}
+
+static Arena_Chunk *
+arena_new_chunk(size_t size)
+{
+  Arena_Chunk *chunk = (Arena_Chunk *)malloc(sizeof(Arena_Chunk) + size);
+  if (!chunk)
+    return NULL;
+  chunk->next = NULL;
+  chunk->used = 0;
+  chunk->size = size;
+  return chunk;
+}
+
+static void *
+arena_alloc(Dwg_Arena *arena, size_t size)
+{
+  Arena_Chunk *chunk = arena->chunk;
+  Arena_Header *block;
+  size_t need;
+
+  if (size > SIZE_MAX / 2)
+    return NULL;
+  need = sizeof(Arena_Header) + ARENA_ALIGN(size);
+  if (!chunk || chunk->size - chunk->used < need)
+    {
+      if (need > arena->next_size / 4)
+        {
+          // a chunk of its own, behind the current one
+          chunk = arena_new_chunk(need);
+          if (!chunk)
+            return NULL;
+          if (arena->chunk)
+            {
+              chunk->next = arena->chunk->next;
+              arena->chunk->next = chunk;
+            }
+          else
+            arena->chunk = chunk;
+        }
+      else
+        {
+          chunk = arena_new_chunk(arena->next_size);
+          if (!chunk)
+            return NULL;
+          chunk->next = arena->chunk;
+          arena->chunk = chunk;
+          if (arena->next_size < MAX_ARENA_CHUNK)
+            arena->next_size *= 2;
+        }
+    }
+  block = (Arena_Header *)((char *)chunk->data + chunk->used);
+  block->size = size;
+  chunk->used += need;
+  return block + 1;
+}
+
+void *
+arena_malloc(size_t size)
+{
+  Dwg_Arena *arena = arena_current();
+  return arena ? arena_alloc(arena, size) : malloc(size);
+}
+
+void *
+arena_calloc(size_t nmemb, size_t size)
+{
+  Dwg_Arena *arena = arena_current();
+  void *ptr;
+  if (!arena)
+    return calloc(nmemb, size);
+  if (size && nmemb > SIZE_MAX / size)
+    return NULL;
+  ptr = arena_alloc(arena, nmemb * size);
+  if (ptr)
+    memset(ptr, 0, nmemb * size);
+  return ptr;
+}
+
+void *
+arena_realloc(void *ptr, size_t size)
+{
+  Dwg_Arena *arena = arena_current();
+  Arena_Header *block;
+  Arena_Chunk *chunk;
+  void *copy;
+
+  if (!arena)
+    return realloc(ptr, size);
+  if (!ptr)
+    return arena_alloc(arena, size);
+  block = (Arena_Header *)ptr - 1;
+  if (size <= block->size) // keep the reserved size
+    return ptr;
+  // grow the last block in place
+  chunk = arena->chunk;
+  if (chunk
+      && (char *)ptr + ARENA_ALIGN(block->size)
+         == (char *)chunk->data + chunk->used
+      && size <= SIZE_MAX / 2
+      && ARENA_ALIGN(size) - ARENA_ALIGN(block->size)
+         <= chunk->size - chunk->used)
+    {
+      chunk->used += ARENA_ALIGN(size) - ARENA_ALIGN(block->size);
+      block->size = size;
+      return ptr;
+    }
+  copy = arena_alloc(arena, size);
+  if (copy)
+    memcpy(copy, ptr, block->size);
+  return copy;
+}
+
+void
+arena_release(void *ptr)
+{
+  if (!arena_current())
+    free(ptr);
+}
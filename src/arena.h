@@ -0,0 +1,47 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+#ifndef ARENA_H
+#define ARENA_H
+
+/*
+ * arena.h: bump allocator for the decoded objects of a drawing,
+ *          see DWG_OPTS_ARENA.
+ *          Allocations are never freed one by one, only all chunks at once.
+ *
+ * The decoder allocates via arena_malloc, arena_calloc and arena_realloc,
+ * which use the current arena of the thread, or fall back to the libc
+ * functions if there is none.
+ * Memory from these may only be freed with arena_release.
+ */
+#ifndef _WIN32
+#include "config.h"
+#else
+#include "config_win32.h"
+#endif
+#include <stddef.h>
+
+typedef struct _dwg_arena Dwg_Arena;
+
+Dwg_Arena *arena_new(void);
+void arena_free(Dwg_Arena *arena);
+/* Moves all chunks of from into arena, and frees from */
+void arena_join(Dwg_Arena *restrict arena, Dwg_Arena *restrict from);
+/* Sets the current arena of this thread, returns the previous one */
+Dwg_Arena *arena_use(Dwg_Arena *arena);
+
+void *arena_malloc(size_t size);
+void *arena_calloc(size_t nmemb, size_t size);
+void *arena_realloc(void *ptr, size_t size);
+void arena_release(void *ptr);
+
+#endif
@@ -34,11 +34,191 @@
 # include <wchar.h>
 #endif
 // else we roll our own, Latin-1 only.
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+# include <sys/mman.h>
+# include <sys/stat.h>
+# define USE_MMAP 1
+#endif
+/* SSE2 is the x86 baseline. AVX2 is not: its variants are compiled for it
+   with AVX2_TARGET and only called if CPU_HAS_AVX2(). */
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || defined(__i386__))
+# include <immintrin.h>
+# define HAVE_AVX2_TARGET 1
+# define AVX2_TARGET __attribute__((target("avx2")))
+# ifdef __AVX2__
+#  define CPU_HAS_AVX2() 1
+# else
+#  define CPU_HAS_AVX2() __builtin_cpu_supports("avx2")
+# endif
+#elif defined(__SSE2__)
+# include <emmintrin.h>
+#endif
 
 #define DWG_LOGLEVEL DWG_LOGLEVEL_NONE
 #include "logging.h"
+#include "arena.h"
 #include "bits.h"
 
+/*------------------------------------------------------------------------------
+ * Private functions
+ */
+
+/* The fast path of the readers: with at least 8 bytes left, the next 57-64
+   bits are loaded at once into a word, MSB first, and the bounds are only
+   checked here. Otherwise the byte-wise path with all its checks is taken.
+ */
+#define BIT_CAN_PEEK(dat) ((dat)->size >= 8 && (dat)->byte <= (dat)->size - 8)
+
+static inline uint64_t
+bit_load_be64(const unsigned char *p)
+{
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__BYTE_ORDER__)
+  uint64_t word;
+  memcpy(&word, p, 8);
+# if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  word = __builtin_bswap64(word);
+# endif
+  return word;
+#else
+  return ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48)
+       | ((uint64_t)p[2] << 40) | ((uint64_t)p[3] << 32)
+       | ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16)
+       | ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+#endif
+}
+
+/* The next bits at the current position, at least 57 valid. */
+static inline uint64_t
+bit_peek64(const Bit_Chain *dat)
+{
+  return bit_load_be64(&dat->chain[dat->byte]) << dat->bit;
+}
+
+/* Advance by the bits taken from bit_peek64() */
+static inline void
+bit_skip(Bit_Chain *dat, unsigned int bits)
+{
+  bits += dat->bit;
+  dat->byte += bits >> 3;
+  dat->bit = bits & 7;
+}
+
+/* The raw bytes of a RS or RL in the peeked word are little-endian */
+#define PEEK_RS(word) \
+  (BITCODE_RS)((((word) >> 56) & 0xff) | (((word) >> 40) & 0xff00))
+#define PEEK_RL(word) \
+  (BITCODE_RL)((((word) >> 56) & 0xff) | (((word) >> 40) & 0xff00) \
+               | (((word) >> 24) & 0xff0000) | (((word) >> 8) & 0xff000000))
+
+/* dst[i] = src[i] << shift | src[i+1] >> (8 - shift) for i < n, with
+   shift 1-7. Reads n+1 bytes from src. The vector variants shift 16-bit
+   lanes and mask off the bits crossing into the neighbour byte.
+ */
+#ifdef HAVE_AVX2_TARGET
+/* The first n & ~31 bytes. Returns their number. */
+AVX2_TARGET
+static size_t
+bit_shift_merge_avx2(unsigned char *restrict dst,
+                     const unsigned char *restrict src, size_t n,
+                     unsigned int shift)
+{
+  size_t i = 0;
+  const __m128i lcount = _mm_cvtsi32_si128((int)shift);
+  const __m128i rcount = _mm_cvtsi32_si128((int)(8 - shift));
+  const __m256i hmask = _mm256_set1_epi8((char)(0xff << shift));
+  const __m256i lmask = _mm256_set1_epi8((char)(0xff >> (8 - shift)));
+  for (; i + 32 <= n; i += 32)
+    {
+      const __m256i hi = _mm256_loadu_si256((const __m256i *)&src[i]);
+      const __m256i lo = _mm256_loadu_si256((const __m256i *)&src[i + 1]);
+      _mm256_storeu_si256(
+          (__m256i *)&dst[i],
+          _mm256_or_si256(
+              _mm256_and_si256(_mm256_sll_epi16(hi, lcount), hmask),
+              _mm256_and_si256(_mm256_srl_epi16(lo, rcount), lmask)));
+    }
+  return i;
+}
+#endif
+
+static void
+bit_shift_merge(unsigned char *restrict dst, const unsigned char *restrict src,
+                size_t n, unsigned int shift)
+{
+  size_t i = 0;
+#ifdef HAVE_AVX2_TARGET
+  if (n >= 32 && CPU_HAS_AVX2())
+    i = bit_shift_merge_avx2(dst, src, n, shift);
+#endif
+#if defined(__SSE2__)
+  {
+    const __m128i lcount = _mm_cvtsi32_si128((int)shift);
+    const __m128i rcount = _mm_cvtsi32_si128((int)(8 - shift));
+    const __m128i hmask = _mm_set1_epi8((char)(0xff << shift));
+    const __m128i lmask = _mm_set1_epi8((char)(0xff >> (8 - shift)));
+    for (; i + 16 <= n; i += 16)
+      {
+        const __m128i hi = _mm_loadu_si128((const __m128i *)&src[i]);
+        const __m128i lo = _mm_loadu_si128((const __m128i *)&src[i + 1]);
+        _mm_storeu_si128((__m128i *)&dst[i],
+                         _mm_or_si128(
+                             _mm_and_si128(_mm_sll_epi16(hi, lcount), hmask),
+                             _mm_and_si128(_mm_srl_epi16(lo, rcount), lmask)));
+      }
+  }
+#endif
+  for (; i < n; i++)
+    dst[i] = (unsigned char)((src[i] << shift) | (src[i + 1] >> (8 - shift)));
+}
+
+/* Reads length bytes at once, if available. Returns 0 on success. */
+static int
+bit_read_bytes(Bit_Chain *restrict dat, unsigned char *restrict dest,
+               size_t length)
+{
+  const unsigned char *src;
+  // the last bit_read_RC() stops before the end, see bit_advance_position()
+  if (dat->byte >= dat->size || length >= dat->size - dat->byte)
+    return 1;
+  src = &dat->chain[dat->byte];
+  if (!dat->bit)
+    memcpy(dest, src, length);
+  else if (length)
+    bit_shift_merge(dest, src, length, dat->bit);
+  dat->byte += length;
+  return 0;
+}
+
+/* Writes length bytes at once, as length bit_write_RC() calls would. */
+static void
+bit_write_bytes(Bit_Chain *restrict dat, const unsigned char *restrict src,
+                size_t length)
+{
+  unsigned char *dst;
+  const unsigned int bit = dat->bit;
+
+  if (!length)
+    return;
+  while (dat->byte + length + 1 >= dat->size)
+    bit_chain_alloc(dat);
+  dst = &dat->chain[dat->byte];
+  if (!bit)
+    memcpy(dst, src, length);
+  else
+    {
+      dst[0] = (unsigned char)((dst[0] & (0xff << (8 - bit)))
+                               | (src[0] >> bit));
+      bit_shift_merge(&dst[1], src, length - 1, 8 - bit);
+      dst[length] = (unsigned char)((src[length - 1] << (8 - bit))
+                                    | (dst[length] & (0xff >> bit)));
+    }
+  dat->byte += length;
+}
+
 /*------------------------------------------------------------------------------
  * Public functions
  */
@@ -102,6 +282,12 @@ bit_read_B(Bit_Chain * dat)
   unsigned char result;
   unsigned char byte;
 
+  if (BIT_CAN_PEEK(dat))
+    {
+      result = (unsigned char)(bit_peek64(dat) >> 63);
+      bit_skip(dat, 1);
+      return result;
+    }
   if (dat->byte >= dat->size)
     {
       LOG_ERROR("buffer overflow at %lu", dat->byte)
@@ -138,6 +324,12 @@ bit_read_BB(Bit_Chain * dat)
   unsigned char result;
   unsigned char byte;
 
+  if (BIT_CAN_PEEK(dat))
+    {
+      result = (unsigned char)(bit_peek64(dat) >> 62);
+      bit_skip(dat, 2);
+      return result;
+    }
   if (dat->byte >= dat->size)
     {
       LOG_ERROR("buffer overflow at %lu", dat->byte)
@@ -197,7 +389,25 @@ bit_write_BB(Bit_Chain * dat, unsigned char value)
 BITCODE_3B
 bit_read_3B(Bit_Chain * dat)
 {
-  BITCODE_3B result = bit_read_B(dat);
+  BITCODE_3B result;
+
+  if (BIT_CAN_PEEK(dat))
+    {
+      const unsigned char bits = (unsigned char)(bit_peek64(dat) >> 61);
+      if (!(bits & 4))
+        {
+          bit_skip(dat, 1);
+          return 0;
+        }
+      else if (!(bits & 2))
+        {
+          bit_skip(dat, 2);
+          return 2;
+        }
+      bit_skip(dat, 3);
+      return bits & 1 ? 7 : 6;
+    }
+  result = bit_read_B(dat);
   if (result) {
     BITCODE_3B next = bit_read_B(dat);
     if (next) {
@@ -262,6 +472,12 @@ bit_read_RC(Bit_Chain * dat)
   unsigned char result;
   unsigned char byte;
 
+  if (BIT_CAN_PEEK(dat))
+    {
+      result = (unsigned char)(bit_peek64(dat) >> 56);
+      dat->byte++;
+      return result;
+    }
   if (dat->byte >= dat->size)
     {
       LOG_ERROR("buffer overflow at %lu", dat->byte)
@@ -322,6 +538,12 @@ bit_read_RS(Bit_Chain * dat)
 {
   unsigned char byte1, byte2;
 
+  if (BIT_CAN_PEEK(dat))
+    {
+      const uint64_t word = bit_peek64(dat);
+      dat->byte += 2;
+      return PEEK_RS(word);
+    }
   //least significant byte first:
   byte1 = bit_read_RC(dat);
   byte2 = bit_read_RC(dat);
@@ -365,6 +587,12 @@ bit_read_RL(Bit_Chain * dat)
 {
   BITCODE_RS word1, word2;
 
+  if (BIT_CAN_PEEK(dat))
+    {
+      const uint64_t word = bit_peek64(dat);
+      dat->byte += 4;
+      return PEEK_RL(word);
+    }
   //least significant word first
   word1 = bit_read_RS(dat);
   word2 = bit_read_RS(dat);
@@ -437,6 +665,23 @@ bit_read_RD(Bit_Chain * dat)
   unsigned char byte[8];
   double *result;
 
+  // 64 bits, so one more byte is needed when unaligned
+  if (dat->byte + (dat->bit ? 9 : 8) <= dat->size)
+    {
+      const unsigned char *p = &dat->chain[dat->byte];
+      if (dat->bit)
+        {
+          const uint64_t word = (bit_load_be64(p) << dat->bit)
+                                | (p[8] >> (8 - dat->bit));
+          for (i = 0; i < 8; i++)
+            byte[i] = (unsigned char)(word >> (56 - (i * 8)));
+        }
+      else
+        memcpy(byte, p, 8);
+      dat->byte += 8;
+      result = (double *) byte;
+      return (*result);
+    }
   //TODO: I think it might not work on big-endian platforms:
   for (i = 0; i < 8; i++)
     byte[i] = bit_read_RC(dat);
@@ -465,7 +710,27 @@ bit_write_RD(Bit_Chain * dat, double value)
 BITCODE_BS
 bit_read_BS(Bit_Chain * dat)
 {
-  const unsigned char two_bit_code = bit_read_BB(dat);
+  unsigned char two_bit_code;
+  if (BIT_CAN_PEEK(dat))
+    {
+      const uint64_t word = bit_peek64(dat);
+      switch (word >> 62)
+        {
+        case 0:
+          bit_skip(dat, 18);
+          return PEEK_RS(word << 2);
+        case 1:
+          bit_skip(dat, 10);
+          return (BITCODE_BS)((word >> 54) & 0xFF);
+        case 2:
+          bit_skip(dat, 2);
+          return 0;
+        default:
+          bit_skip(dat, 2);
+          return 256;
+        }
+    }
+  two_bit_code = bit_read_BB(dat);
   if (two_bit_code == 0)
     return bit_read_RS(dat);
   else if (two_bit_code == 1)
@@ -504,7 +769,28 @@ bit_write_BS(Bit_Chain * dat, BITCODE_BS value)
 BITCODE_BL
 bit_read_BL(Bit_Chain * dat)
 {
-  const unsigned char two_bit_code =  bit_read_BB(dat);
+  unsigned char two_bit_code;
+  if (BIT_CAN_PEEK(dat))
+    {
+      const uint64_t word = bit_peek64(dat);
+      two_bit_code = (unsigned char)(word >> 62);
+      if (two_bit_code == 0)
+        {
+          bit_skip(dat, 34);
+          return PEEK_RL(word << 2);
+        }
+      else if (two_bit_code == 1)
+        {
+          bit_skip(dat, 10);
+          return (BITCODE_BL)((word >> 54) & 0xFF);
+        }
+      else if (two_bit_code == 2)
+        {
+          bit_skip(dat, 2);
+          return 0;
+        }
+    }
+  two_bit_code = bit_read_BB(dat);
   if (two_bit_code == 0)
     return bit_read_RL(dat);
   else if (two_bit_code == 1)
@@ -1191,6 +1477,9 @@ bit_write_CRC(Bit_Chain * dat, long unsigned int start_address,
 void
 bit_read_fixed(Bit_Chain *restrict dat, BITCODE_RC *restrict dest, int length)
 {
+  if (length <= 0 || !bit_read_bytes(dat, dest, (size_t)length))
+    return;
+  // too short: byte-wise, with its overflow checks
   for (int i = 0; i < length; i++)
     {
       dest[i] = bit_read_RC(dat);
@@ -1204,7 +1493,7 @@ bit_read_fixed(Bit_Chain *restrict dat, BITCODE_RC *restrict dest, int length)
 BITCODE_TF
 bit_read_TF(Bit_Chain *restrict dat, int length)
 {
-  BITCODE_RC *chain = malloc(length+1);
+  BITCODE_RC *chain = arena_malloc(length+1);
 
   bit_read_fixed(dat, chain, length);
   chain[length] = '\0';
@@ -1217,9 +1506,8 @@ bit_read_TF(Bit_Chain *restrict dat, int length)
 void
 bit_write_TF(Bit_Chain *restrict dat, BITCODE_TF restrict chain, int length)
 {
-  int i;
-  for (i = 0; i < length; i++)
-    bit_write_RC(dat, (BITCODE_RC)chain[i]);
+  if (length > 0)
+    bit_write_bytes(dat, (const unsigned char *)chain, (size_t)length);
 }
 
 /** Read simple text. After usage, the allocated memory must be properly freed.
@@ -1227,23 +1515,14 @@ bit_write_TF(Bit_Chain *restrict dat, BITCODE_TF restrict chain, int length)
 BITCODE_TV
 bit_read_TV(Bit_Chain *restrict dat)
 {
-  unsigned int i;
   unsigned int length;
   unsigned char *chain;
 
   length = bit_read_BS(dat);
   // if (length > AVAIL_BITS()) return DWG_ERR_VALUEOUTOFBOUNDS;
-  chain = (unsigned char *) malloc(length + 1);
-  for (i = 0; i < length; i++)
-    {
-      chain[i] = bit_read_RC(dat);
-#if 0
-      /* we support encode and codepages */
-      if (!isprint (chain[i]))
-        chain[i] = '~';
-#endif
-    }
-  chain[i] = '\0';
+  chain = (unsigned char *) arena_malloc(length + 1);
+  bit_read_fixed(dat, chain, (int)length);
+  chain[length] = '\0';
 
   return (char *)chain;
 }
@@ -1253,13 +1532,11 @@ bit_read_TV(Bit_Chain *restrict dat)
 void
 bit_write_TV(Bit_Chain *restrict dat, char *restrict chain)
 {
-  int i;
   int length;
 
   length = chain ? strlen((const char *)chain)+1 : 0;
   bit_write_BS(dat, length);
-  for (i = 0; i < length; i++)
-    bit_write_RC(dat, (unsigned char)chain[i]);
+  bit_write_TF(dat, chain, length);
 }
 
 /** Read UCS-2 unicode text. no supplementary planes
@@ -1273,11 +1550,14 @@ bit_read_TU(Bit_Chain *restrict dat)
   BITCODE_TU chain;
 
   length = bit_read_BS(dat);
-  chain = (BITCODE_TU) malloc((length + 1) * 2);
-  for (i = 0; i < length; i++)
-    {
-      chain[i] = bit_read_RS(dat); // probably without byte swapping
-    }
+  chain = (BITCODE_TU) arena_malloc((length + 1) * 2);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  if (bit_read_bytes(dat, (unsigned char *)chain, length * 2))
+#endif
+    for (i = 0; i < length; i++)
+      {
+        chain[i] = bit_read_RS(dat); // probably without byte swapping
+      }
   chain[length] = 0;
 
   return chain;
@@ -1288,7 +1568,6 @@ bit_read_TU(Bit_Chain *restrict dat)
 void
 bit_write_TU(Bit_Chain *restrict dat, BITCODE_TU restrict chain)
 {
-  unsigned int i;
   unsigned int length;
 
   if (chain)
@@ -1304,99 +1583,401 @@ bit_write_TU(Bit_Chain *restrict dat, BITCODE_TU restrict chain)
     length = 0;
 
   bit_write_BS(dat, length);
-  for (i=0; i < length; i++)
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  bit_write_bytes(dat, (const unsigned char *)chain, length * 2);
+#else
+  for (unsigned int i = 0; i < length; i++)
     {
       bit_write_RS(dat, chain[i]); // probably without byte swapping
     }
+#endif
   bit_write_RS(dat, 0); //?? unsure about that
 }
 
-/* converts UCS-2 to UTF-8 */
+/* The UCS-2 chars before the final 0 of wstr, and if all of them are
+   ASCII. The aligned vector loads never cross into the next page, but
+   may read past the final 0 within the same 16 bytes.
+ */
+#ifdef HAVE_AVX2_TARGET
+/* For an even wstr, with 32-byte aligned loads */
+AVX2_TARGET __attribute__((no_sanitize_address))
+static size_t
+bit_wcs2len_ascii_avx2(const uint16_t *restrict wstr, int *restrict ascii)
+{
+  size_t n = 0;
+  uint16_t high = 0;
+  __m256i acc = _mm256_setzero_si256();
+  const __m256i zero = _mm256_setzero_si256();
+  for (; ((uintptr_t)&wstr[n] & 31); n++)
+    {
+      if (!wstr[n])
+        {
+          *ascii = !(high & 0xff80);
+          return n;
+        }
+      high |= wstr[n];
+    }
+  for (;; n += 16)
+    {
+      const __m256i v = _mm256_load_si256((const __m256i *)&wstr[n]);
+      const int m = _mm256_movemask_epi8(_mm256_cmpeq_epi16(v, zero));
+      if (m)
+        {
+          // the rest before the 0
+          const size_t end = n + (__builtin_ctz((unsigned)m) >> 1);
+          for (; n < end; n++)
+            high |= wstr[n];
+          break;
+        }
+      acc = _mm256_or_si256(acc, v);
+    }
+  if (!_mm256_testz_si256(acc, _mm256_set1_epi16((short)0xff80)))
+    high |= 0xff80;
+  *ascii = !(high & 0xff80);
+  return n;
+}
+#endif
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+__attribute__((no_sanitize_address))
+#endif
+static size_t
+bit_wcs2len_ascii(const uint16_t *restrict wstr, int *restrict ascii)
+{
+  size_t n = 0;
+  uint16_t high = 0;
+#ifdef HAVE_AVX2_TARGET
+  if (!((uintptr_t)wstr & 1) && CPU_HAS_AVX2())
+    return bit_wcs2len_ascii_avx2(wstr, ascii);
+#endif
+#if defined(__SSE2__)
+  if (!((uintptr_t)wstr & 1))
+    {
+      __m128i acc = _mm_setzero_si128();
+      const __m128i zero = _mm_setzero_si128();
+      for (; ((uintptr_t)&wstr[n] & 15); n++)
+        {
+          if (!wstr[n])
+            {
+              *ascii = !(high & 0xff80);
+              return n;
+            }
+          high |= wstr[n];
+        }
+      for (;; n += 8)
+        {
+          const __m128i v = _mm_load_si128((const __m128i *)&wstr[n]);
+          const int m = _mm_movemask_epi8(_mm_cmpeq_epi16(v, zero));
+          if (m)
+            {
+              // the rest before the 0
+              const size_t end = n + (__builtin_ctz((unsigned)m) >> 1);
+              for (; n < end; n++)
+                high |= wstr[n];
+              break;
+            }
+          acc = _mm_or_si128(acc, v);
+        }
+      if (_mm_movemask_epi8(_mm_cmpeq_epi16(
+              _mm_and_si128(acc, _mm_set1_epi16((short)0xff80)), zero))
+          != 0xffff)
+        high |= 0xff80;
+      *ascii = !(high & 0xff80);
+      return n;
+    }
+#endif
+  for (; wstr[n]; n++)
+    high |= wstr[n];
+  *ascii = !(high & 0xff80);
+  return n;
+}
+
+/* dst[i] = src[i] for n ASCII chars */
+#ifdef HAVE_AVX2_TARGET
+/* The first n & ~31 chars. Returns their number. */
+AVX2_TARGET
+static size_t
+bit_TU_to_ascii_avx2(char *restrict dst, const uint16_t *restrict src,
+                     size_t n)
+{
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32)
+    {
+      const __m256i a = _mm256_loadu_si256((const __m256i *)&src[i]);
+      const __m256i b = _mm256_loadu_si256((const __m256i *)&src[i + 16]);
+      // packus works per 128-bit lane
+      _mm256_storeu_si256((__m256i *)&dst[i],
+                          _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b),
+                                                   0xd8));
+    }
+  return i;
+}
+
+/* The ASCII chars of src in runs of 16, up to n. Returns their number. */
+AVX2_TARGET
+static size_t
+bit_TU_ascii_run_avx2(char *restrict dst, const uint16_t *restrict src,
+                      size_t n)
+{
+  size_t i = 0;
+  const __m256i high = _mm256_set1_epi16((short)0xff80);
+  for (; i + 16 <= n; i += 16)
+    {
+      const __m256i v = _mm256_loadu_si256((const __m256i *)&src[i]);
+      if (!_mm256_testz_si256(v, high))
+        break;
+      _mm_storeu_si128((__m128i *)&dst[i],
+                       _mm256_castsi256_si128(_mm256_permute4x64_epi64(
+                           _mm256_packus_epi16(v, v), 0xd8)));
+    }
+  return i;
+}
+#endif
+
+static void
+bit_TU_to_ascii(char *restrict dst, const uint16_t *restrict src, size_t n)
+{
+  size_t i = 0;
+#ifdef HAVE_AVX2_TARGET
+  if (n >= 32 && CPU_HAS_AVX2())
+    i = bit_TU_to_ascii_avx2(dst, src, n);
+#endif
+#if defined(__SSE2__)
+  for (; i + 16 <= n; i += 16)
+    {
+      const __m128i a = _mm_loadu_si128((const __m128i *)&src[i]);
+      const __m128i b = _mm_loadu_si128((const __m128i *)&src[i + 8]);
+      _mm_storeu_si128((__m128i *)&dst[i], _mm_packus_epi16(a, b));
+    }
+#endif
+  for (; i < n; i++)
+    dst[i] = (char)src[i];
+}
+
+#define IS_HIGH_SURROGATE(c) ((c) >= 0xd800 && (c) < 0xdc00)
+#define IS_LOW_SURROGATE(c)  ((c) >= 0xdc00 && (c) < 0xe000)
+
+/* converts UCS-2 or UTF-16 to UTF-8.
+   Surrogate pairs are combined, unpaired surrogates become U+FFFD. */
 char*
 bit_convert_TU(BITCODE_TU restrict wstr)
 {
-  BITCODE_TU tmp = wstr;
+  const uint16_t *ws = (const uint16_t *)wstr;
+  size_t n, len, i, j;
+  int ascii;
   char *str;
-  int i, len = 0;
-  uint16_t c = 0;
-  while ((c = *tmp++)) {
-    len++;
-    if (c >= 256)
-      len++;
-    if (c >= 0x800)
-      len++;
-  }
-  str = malloc(len+1);
-  i = 0;
-  while ((c = *wstr++)) {
-    if (c < 256) {
-      str[i++] = c & 0xff;
-    }
-    else if (c < 0x800) {
-      /*if (i+3 > len) {
-        str = realloc(str, i+3);
-        len = i+2;
-      }*/
-      str[i+1] = (c & 0x3f) | 0x80;
-      str[i]   = (c >> 6) | 0xc0;
-      i += 2;
-    }
-    else { /* windows ucs-2 has no D800-DC00 surrogate pairs. go straight up */
-      /*if (i+3 > len) {
-        str = realloc(str, i+4);
-        len = i+3;
-      }*/
-      str[i+2] = (c & 0x3f) | 0x80;
-      c >>= 6;
-      str[i+1] = (c & 0x3f) | 0x80;
-      c >>= 6;
-      str[i] = c | 0xe0;
-      i += 3;
+#ifdef HAVE_AVX2_TARGET
+  const int avx2 = CPU_HAS_AVX2();
+#endif
+
+  if (!wstr)
+    return NULL;
+  n = bit_wcs2len_ascii(ws, &ascii);
+  if (ascii)
+    {
+      str = malloc(n + 1);
+      if (!str)
+        return NULL;
+      bit_TU_to_ascii(str, ws, n);
+      str[n] = '\0';
+      return str;
     }
-  }
-  str[i] = '\0';
+
+  len = 0;
+  for (i = 0; i < n; i++)
+    {
+      const uint16_t c = ws[i];
+      if (c < 0x80)
+        len++;
+      else if (c < 0x800)
+        len += 2;
+      else if (IS_HIGH_SURROGATE(c) && IS_LOW_SURROGATE(ws[i + 1]))
+        {
+          len += 4;
+          i++;
+        }
+      else
+        len += 3;
+    }
+  str = malloc(len + 1);
+  if (!str)
+    return NULL;
+
+  for (i = j = 0; i < n;)
+    {
+      uint32_t c = ws[i];
+#ifdef HAVE_AVX2_TARGET
+      // ASCII runs 16 chars at once
+      if (avx2 && c < 0x80 && i + 16 <= n)
+        {
+          const size_t k = bit_TU_ascii_run_avx2(&str[j], &ws[i], n - i);
+          if (k)
+            {
+              i += k;
+              j += k;
+              continue;
+            }
+        }
+#endif
+#if defined(__SSE2__)
+      // ASCII runs 8 chars at once
+      if (c < 0x80 && i + 8 <= n)
+        {
+          const __m128i v = _mm_loadu_si128((const __m128i *)&ws[i]);
+          if (_mm_movemask_epi8(_mm_cmpeq_epi16(
+                  _mm_and_si128(v, _mm_set1_epi16((short)0xff80)),
+                  _mm_setzero_si128()))
+              == 0xffff)
+            {
+              _mm_storel_epi64((__m128i *)&str[j], _mm_packus_epi16(v, v));
+              i += 8;
+              j += 8;
+              continue;
+            }
+        }
+#endif
+      i++;
+      if (c < 0x80)
+        str[j++] = (char)c;
+      else if (c < 0x800)
+        {
+          str[j++] = (char)(0xc0 | (c >> 6));
+          str[j++] = (char)(0x80 | (c & 0x3f));
+        }
+      else
+        {
+          if (IS_HIGH_SURROGATE(c) && IS_LOW_SURROGATE(ws[i]))
+            {
+              c = 0x10000 + ((c - 0xd800) << 10) + (ws[i++] - 0xdc00);
+              str[j++] = (char)(0xf0 | (c >> 18));
+              str[j++] = (char)(0x80 | ((c >> 12) & 0x3f));
+            }
+          else
+            {
+              if (IS_HIGH_SURROGATE(c) || IS_LOW_SURROGATE(c))
+                c = 0xfffd;
+              str[j++] = (char)(0xe0 | (c >> 12));
+            }
+          str[j++] = (char)(0x80 | ((c >> 6) & 0x3f));
+          str[j++] = (char)(0x80 | (c & 0x3f));
+        }
+    }
+  str[j] = '\0';
   return str;
 }
 
-/** converts UTF-8 to UCS-2. Returns a copy */
+#ifdef HAVE_AVX2_TARGET
+/* Widens the ASCII chars of src in runs of 32, up to n.
+   Returns their number. */
+AVX2_TARGET
+static size_t
+bit_ascii_run_to_TU_avx2(uint16_t *restrict dst,
+                         const unsigned char *restrict src, size_t n)
+{
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32)
+    {
+      const __m256i v = _mm256_loadu_si256((const __m256i *)&src[i]);
+      if (_mm256_movemask_epi8(v))
+        break;
+      _mm256_storeu_si256((__m256i *)&dst[i],
+                          _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+      _mm256_storeu_si256(
+          (__m256i *)&dst[i + 16],
+          _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+    }
+  return i;
+}
+#endif
+
+/** converts UTF-8 to UCS-2, with surrogate pairs above U+FFFF.
+    Invalid or truncated sequences become U+FFFD. Returns a copy */
 BITCODE_TU
 bit_utf8_to_TU(char* restrict str)
 {
-  BITCODE_TU wstr;
-  int i = 0;
-  int len = strlen(str);
-  unsigned char c;
-
-  wstr = malloc(2*(len+1));
-  while ((c = *str++)) {
-    if (c < 128) {
-      wstr[i++] = c;
-    }
-    else if ((c & 0xe0) == 0xc0) {
-      /* ignore invalid utf8 for now */
-      wstr[i++] = ((c & 0x1f) << 6) | (str[1] & 0x3f);
-      str++;
-    }
-    else if ((c & 0xf0) == 0xe0) {
-      /* ignore invalid utf8 for now */
-      /*
-      if (str[1] < 0x80 || str[1] > 0xBF ||
-          str[2] < 0x80 || str[2] > 0xBF) {
-        LOG_ERROR("utf-8: BAD_CONTINUATION_BYTE %s", str);
-      }
-      if (c == 0xe0 && str[1] < 0xa0) {
-        LOG_ERROR("utf-8: NON_SHORTEST %s", str);
-      } */
-      wstr[i++] = ((c & 0x0f) << 12) |
-                  ((str[1] & 0x3f) << 6) |
-                  (str[2] & 0x3f);
-      str++;
-      str++;
-    }
-    /* everything above 0xf0 exceeds ucs-2, 4-6 byte seqs */
-  }
-  wstr[i] = '\0';
-  return wstr;
+  const unsigned char *s = (const unsigned char *)str;
+  uint16_t *wstr;
+  size_t len, i = 0, j = 0;
+#ifdef HAVE_AVX2_TARGET
+  const int avx2 = CPU_HAS_AVX2();
+#endif
+
+  if (!str)
+    return NULL;
+  len = strlen(str);
+  // never more UCS-2 chars than bytes
+  wstr = malloc(2 * (len + 1));
+  if (!wstr)
+    return NULL;
+  while (i < len)
+    {
+      uint32_t c = s[i];
+      if (c < 0x80)
+        {
+          // ASCII runs, widened 32 or 16 chars at once
+#ifdef HAVE_AVX2_TARGET
+          if (avx2 && i + 32 <= len)
+            {
+              const size_t k = bit_ascii_run_to_TU_avx2(&wstr[j], &s[i],
+                                                        len - i);
+              i += k;
+              j += k;
+            }
+#endif
+#if defined(__SSE2__)
+          for (; i + 16 <= len; i += 16, j += 16)
+            {
+              const __m128i v = _mm_loadu_si128((const __m128i *)&s[i]);
+              if (_mm_movemask_epi8(v))
+                break;
+              _mm_storeu_si128((__m128i *)&wstr[j],
+                               _mm_unpacklo_epi8(v, _mm_setzero_si128()));
+              _mm_storeu_si128((__m128i *)&wstr[j + 8],
+                               _mm_unpackhi_epi8(v, _mm_setzero_si128()));
+            }
+#endif
+          for (; i < len && s[i] < 0x80; i++)
+            wstr[j++] = s[i];
+          continue;
+        }
+#define CONT(k) ((s[i + (k)] & 0xc0) == 0x80)
+      if ((c & 0xe0) == 0xc0 && c >= 0xc2 && CONT(1))
+        {
+          wstr[j++] = (uint16_t)(((c & 0x1f) << 6) | (s[i + 1] & 0x3f));
+          i += 2;
+        }
+      else if ((c & 0xf0) == 0xe0 && CONT(1) && CONT(2))
+        {
+          c = ((c & 0x0f) << 12) | ((s[i + 1] & 0x3f) << 6)
+              | (s[i + 2] & 0x3f);
+          // no overlongs and no encoded surrogates
+          wstr[j++] = (c < 0x800 || (c >= 0xd800 && c < 0xe000))
+                          ? 0xfffd : (uint16_t)c;
+          i += 3;
+        }
+      else if ((c & 0xf8) == 0xf0 && CONT(1) && CONT(2) && CONT(3))
+        {
+          c = ((c & 0x07) << 18) | ((s[i + 1] & 0x3f) << 12)
+              | ((s[i + 2] & 0x3f) << 6) | (s[i + 3] & 0x3f);
+          if (c >= 0x10000 && c < 0x110000)
+            {
+              c -= 0x10000;
+              wstr[j++] = (uint16_t)(0xd800 | (c >> 10));
+              wstr[j++] = (uint16_t)(0xdc00 | (c & 0x3ff));
+            }
+          else
+            wstr[j++] = 0xfffd;
+          i += 4;
+        }
+      else
+        {
+          wstr[j++] = 0xfffd;
+          i++;
+        }
+#undef CONT
+    }
+  wstr[j] = 0;
+  return (BITCODE_TU)wstr;
 }
 
 /* compare an ASCII/utf-8 string to a r2007+ name */
@@ -1559,25 +2140,73 @@ bit_write_EMC(Bit_Chain *restrict dat, Dwg_Color *restrict color)
 int
 bit_search_sentinel(Bit_Chain * dat, unsigned char sentinel[16])
 {
-  long unsigned int i, j;
+  const unsigned char *p, *end;
 
-  for (i = 0; i < dat->size; i++)
+  if (!dat->chain || dat->size < 16)
+    return 0;
+  // only the first byte is scanned for, with memchr
+  p = dat->chain;
+  end = dat->chain + dat->size - 15; // behind the last possible start
+  while (p < end && (p = (const unsigned char *)memchr(p, sentinel[0],
+                                                       end - p)))
     {
-      for (j = 0; j < 16; j++)
-        {
-          if (dat->chain[i + j] != sentinel[j])
-            break;
-        }
-      if (j == 16)
+      if (!memcmp(p + 1, &sentinel[1], 15))
         {
-          dat->byte = i + j;
+          dat->byte = (p - dat->chain) + 16;
           dat->bit = 0;
           return -1;
         }
+      p++;
     }
   return 0;
 }
 
+/* The window of the chain scanned for all sentinels at once */
+#define SENTINEL_WINDOW 4096
+
+/** Search for num sentinels in one pass over the chain.
+    Sets found[i] to the position immediately after the first match of
+    sentinels[i], or 0 if not found. Returns the number of found sentinels.
+    dat is not changed.
+ */
+int
+bit_search_sentinels(const Bit_Chain *dat, unsigned char *const sentinels[],
+                     int num, unsigned long *found)
+{
+  const unsigned char *start, *end, *wend, *p;
+  int i, left = num;
+
+  for (i = 0; i < num; i++)
+    found[i] = 0;
+  if (!dat->chain || dat->size < 16)
+    return 0;
+  end = dat->chain + dat->size - 15; // behind the last possible start
+  // memchr all missing sentinels in a cached window, then the next one
+  for (start = dat->chain; start < end && left; start = wend)
+    {
+      wend = (unsigned long)(end - start) > SENTINEL_WINDOW
+          ? start + SENTINEL_WINDOW : end;
+      for (i = 0; i < num; i++)
+        {
+          if (found[i])
+            continue;
+          p = start;
+          while (p < wend && (p = (const unsigned char *)memchr(
+                                  p, sentinels[i][0], wend - p)))
+            {
+              if (!memcmp(p + 1, &sentinels[i][1], 15))
+                {
+                  found[i] = (p - dat->chain) + 16;
+                  left--;
+                  break;
+                }
+              p++;
+            }
+        }
+    }
+  return num - left;
+}
+
 void
 bit_write_sentinel(Bit_Chain * dat, unsigned char sentinel[16])
 {
@@ -1587,26 +2216,129 @@ bit_write_sentinel(Bit_Chain * dat, unsigned char sentinel[16])
     bit_write_RC(dat, sentinel[i]);
 }
 
+#define CHAIN_BLOCK 40960
+
+#ifdef USE_MMAP
+/* Extends the file of dat->fh to size bytes, and maps it as the chain.
+   If that fails, the chain is moved into memory and dat->fh is cleared.
+   Returns 0 if the chain has size bytes.
+ */
+static int
+chain_map(Bit_Chain *dat, const size_t size)
+{
+  const int fd = fileno(dat->fh);
+  struct stat attrib;
+  size_t mapped = 0;
+  void *map = MAP_FAILED;
+
+  // the file size is the size of the mapping, also after dat->size changed
+  if (dat->chain && !fstat(fd, &attrib))
+    mapped = attrib.st_size;
+  if (!ftruncate(fd, size))
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (map != MAP_FAILED)
+    {
+      if (dat->chain)
+        munmap(dat->chain, mapped);
+      dat->chain = (unsigned char *)map;
+      dat->size = size;
+      return 0;
+    }
+  dat->fh = NULL;
+  if (!dat->chain)
+    return 1;
+  map = calloc(1, size);
+  if (map)
+    memcpy(map, dat->chain, mapped);
+  munmap(dat->chain, mapped);
+  dat->chain = (unsigned char *)map;
+  dat->size = map ? size : 0;
+  return map ? 0 : 1;
+}
+#endif
+
 /*
- * Allocates memory space for bit_chain
- * adds 10 4kB pages.
+ * Allocates an empty chain of at least size bytes, to avoid growing it
+ * when the size of the output is known in advance.
+ * With dat->fh set to a read-write regular file, the encoder's output
+ * file, the file is extended and mapped as the chain instead, so the
+ * output goes to the page cache and is not held in memory.
+ * dat->fh is cleared if the file cannot be mapped.
+ */
+void
+bit_chain_init(Bit_Chain *dat, const size_t size)
+{
+  const size_t alloc_size = size > CHAIN_BLOCK ? size : CHAIN_BLOCK;
+
+  dat->chain = NULL;
+  dat->size = 0;
+  dat->byte = 0;
+  dat->bit = 0;
+#ifdef USE_MMAP
+  if (dat->fh && !chain_map(dat, alloc_size))
+    return;
+#endif
+  dat->fh = NULL;
+  dat->chain = (unsigned char *)calloc(1, alloc_size);
+  if (dat->chain)
+    dat->size = alloc_size;
+}
+
+/*
+ * Allocates memory space for bit_chain.
+ * Starts with 10 4kB pages, and then doubles the size, so that writing
+ * a large file needs only a few reallocs. The new space is zeroed.
  */
-#define CHAIN_BLOCK 40960
 void
 bit_chain_alloc(Bit_Chain * dat)
 {
+  size_t old_size, size;
+
   if (dat->size == 0)
     {
-      dat->chain = (unsigned char *)calloc(1, CHAIN_BLOCK);
-      dat->size = CHAIN_BLOCK;
-      dat->byte = 0;
-      dat->bit = 0;
+      bit_chain_init(dat, CHAIN_BLOCK);
+      return;
     }
-  else
+  old_size = dat->size;
+  size = old_size < CHAIN_BLOCK ? old_size + CHAIN_BLOCK : old_size * 2;
+#ifdef USE_MMAP
+  if (dat->fh && !chain_map(dat, size))
+    return;
+#endif
+  dat->chain = (unsigned char *)realloc(dat->chain, size);
+  if (!dat->chain)
+    {
+      LOG_ERROR("Out of memory")
+      dat->size = 0;
+      return;
+    }
+  memset(&dat->chain[old_size], 0, size - old_size);
+  dat->size = size;
+}
+
+/*
+ * Frees the chain of the encoder. A mapped file is unmapped and truncated
+ * to dat->size. Returns 0 or DWG_ERR_IOERROR.
+ */
+int
+bit_chain_free(Bit_Chain *dat)
+{
+  int error = 0;
+#ifdef USE_MMAP
+  if (dat->fh && dat->chain)
     {
-      dat->chain = (unsigned char *)realloc(dat->chain, dat->size + CHAIN_BLOCK);
-      dat->size += CHAIN_BLOCK;
+      const int fd = fileno(dat->fh);
+      struct stat attrib;
+      if (fstat(fd, &attrib) || munmap(dat->chain, attrib.st_size)
+          || ftruncate(fd, dat->size))
+        error = DWG_ERR_IOERROR;
     }
+  else
+#endif
+    free(dat->chain);
+  dat->chain = NULL;
+  dat->size = 0;
+  return error;
 }
 
 void
@@ -1698,47 +2430,667 @@ bit_explore_chain(Bit_Chain * dat, long unsigned int size)
   puts("---------------------------------------------------------");
 }
 
+/* CRC tables for slicing-by-8: [0] is the classic byte table, [j] the
+   effect of a byte followed by j more bytes. Note that bit_calc_CRC32
+   keeps only the 2nd byte of the shifted crc, so [j] is derived with
+   ((crc >> 8) & 0xFF) ^ [0][crc & 0xFF] for both.
+ */
+static const uint16_t crc16_table[8][256] = {
+  {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+  },
+  {
+    0x0000, 0x9001, 0x6001, 0xF000, 0xC002, 0x5003, 0xA003, 0x3002,
+    0xC007, 0x5006, 0xA006, 0x3007, 0x0005, 0x9004, 0x6004, 0xF005,
+    0xC00D, 0x500C, 0xA00C, 0x300D, 0x000F, 0x900E, 0x600E, 0xF00F,
+    0x000A, 0x900B, 0x600B, 0xF00A, 0xC008, 0x5009, 0xA009, 0x3008,
+    0xC019, 0x5018, 0xA018, 0x3019, 0x001B, 0x901A, 0x601A, 0xF01B,
+    0x001E, 0x901F, 0x601F, 0xF01E, 0xC01C, 0x501D, 0xA01D, 0x301C,
+    0x0014, 0x9015, 0x6015, 0xF014, 0xC016, 0x5017, 0xA017, 0x3016,
+    0xC013, 0x5012, 0xA012, 0x3013, 0x0011, 0x9010, 0x6010, 0xF011,
+    0xC031, 0x5030, 0xA030, 0x3031, 0x0033, 0x9032, 0x6032, 0xF033,
+    0x0036, 0x9037, 0x6037, 0xF036, 0xC034, 0x5035, 0xA035, 0x3034,
+    0x003C, 0x903D, 0x603D, 0xF03C, 0xC03E, 0x503F, 0xA03F, 0x303E,
+    0xC03B, 0x503A, 0xA03A, 0x303B, 0x0039, 0x9038, 0x6038, 0xF039,
+    0x0028, 0x9029, 0x6029, 0xF028, 0xC02A, 0x502B, 0xA02B, 0x302A,
+    0xC02F, 0x502E, 0xA02E, 0x302F, 0x002D, 0x902C, 0x602C, 0xF02D,
+    0xC025, 0x5024, 0xA024, 0x3025, 0x0027, 0x9026, 0x6026, 0xF027,
+    0x0022, 0x9023, 0x6023, 0xF022, 0xC020, 0x5021, 0xA021, 0x3020,
+    0xC061, 0x5060, 0xA060, 0x3061, 0x0063, 0x9062, 0x6062, 0xF063,
+    0x0066, 0x9067, 0x6067, 0xF066, 0xC064, 0x5065, 0xA065, 0x3064,
+    0x006C, 0x906D, 0x606D, 0xF06C, 0xC06E, 0x506F, 0xA06F, 0x306E,
+    0xC06B, 0x506A, 0xA06A, 0x306B, 0x0069, 0x9068, 0x6068, 0xF069,
+    0x0078, 0x9079, 0x6079, 0xF078, 0xC07A, 0x507B, 0xA07B, 0x307A,
+    0xC07F, 0x507E, 0xA07E, 0x307F, 0x007D, 0x907C, 0x607C, 0xF07D,
+    0xC075, 0x5074, 0xA074, 0x3075, 0x0077, 0x9076, 0x6076, 0xF077,
+    0x0072, 0x9073, 0x6073, 0xF072, 0xC070, 0x5071, 0xA071, 0x3070,
+    0x0050, 0x9051, 0x6051, 0xF050, 0xC052, 0x5053, 0xA053, 0x3052,
+    0xC057, 0x5056, 0xA056, 0x3057, 0x0055, 0x9054, 0x6054, 0xF055,
+    0xC05D, 0x505C, 0xA05C, 0x305D, 0x005F, 0x905E, 0x605E, 0xF05F,
+    0x005A, 0x905B, 0x605B, 0xF05A, 0xC058, 0x5059, 0xA059, 0x3058,
+    0xC049, 0x5048, 0xA048, 0x3049, 0x004B, 0x904A, 0x604A, 0xF04B,
+    0x004E, 0x904F, 0x604F, 0xF04E, 0xC04C, 0x504D, 0xA04D, 0x304C,
+    0x0044, 0x9045, 0x6045, 0xF044, 0xC046, 0x5047, 0xA047, 0x3046,
+    0xC043, 0x5042, 0xA042, 0x3043, 0x0041, 0x9040, 0x6040, 0xF041
+  },
+  {
+    0x0000, 0xC051, 0xC0A1, 0x00F0, 0xC141, 0x0110, 0x01E0, 0xC1B1,
+    0xC281, 0x02D0, 0x0220, 0xC271, 0x03C0, 0xC391, 0xC361, 0x0330,
+    0xC501, 0x0550, 0x05A0, 0xC5F1, 0x0440, 0xC411, 0xC4E1, 0x04B0,
+    0x0780, 0xC7D1, 0xC721, 0x0770, 0xC6C1, 0x0690, 0x0660, 0xC631,
+    0xCA01, 0x0A50, 0x0AA0, 0xCAF1, 0x0B40, 0xCB11, 0xCBE1, 0x0BB0,
+    0x0880, 0xC8D1, 0xC821, 0x0870, 0xC9C1, 0x0990, 0x0960, 0xC931,
+    0x0F00, 0xCF51, 0xCFA1, 0x0FF0, 0xCE41, 0x0E10, 0x0EE0, 0xCEB1,
+    0xCD81, 0x0DD0, 0x0D20, 0xCD71, 0x0CC0, 0xCC91, 0xCC61, 0x0C30,
+    0xD401, 0x1450, 0x14A0, 0xD4F1, 0x1540, 0xD511, 0xD5E1, 0x15B0,
+    0x1680, 0xD6D1, 0xD621, 0x1670, 0xD7C1, 0x1790, 0x1760, 0xD731,
+    0x1100, 0xD151, 0xD1A1, 0x11F0, 0xD041, 0x1010, 0x10E0, 0xD0B1,
+    0xD381, 0x13D0, 0x1320, 0xD371, 0x12C0, 0xD291, 0xD261, 0x1230,
+    0x1E00, 0xDE51, 0xDEA1, 0x1EF0, 0xDF41, 0x1F10, 0x1FE0, 0xDFB1,
+    0xDC81, 0x1CD0, 0x1C20, 0xDC71, 0x1DC0, 0xDD91, 0xDD61, 0x1D30,
+    0xDB01, 0x1B50, 0x1BA0, 0xDBF1, 0x1A40, 0xDA11, 0xDAE1, 0x1AB0,
+    0x1980, 0xD9D1, 0xD921, 0x1970, 0xD8C1, 0x1890, 0x1860, 0xD831,
+    0xE801, 0x2850, 0x28A0, 0xE8F1, 0x2940, 0xE911, 0xE9E1, 0x29B0,
+    0x2A80, 0xEAD1, 0xEA21, 0x2A70, 0xEBC1, 0x2B90, 0x2B60, 0xEB31,
+    0x2D00, 0xED51, 0xEDA1, 0x2DF0, 0xEC41, 0x2C10, 0x2CE0, 0xECB1,
+    0xEF81, 0x2FD0, 0x2F20, 0xEF71, 0x2EC0, 0xEE91, 0xEE61, 0x2E30,
+    0x2200, 0xE251, 0xE2A1, 0x22F0, 0xE341, 0x2310, 0x23E0, 0xE3B1,
+    0xE081, 0x20D0, 0x2020, 0xE071, 0x21C0, 0xE191, 0xE161, 0x2130,
+    0xE701, 0x2750, 0x27A0, 0xE7F1, 0x2640, 0xE611, 0xE6E1, 0x26B0,
+    0x2580, 0xE5D1, 0xE521, 0x2570, 0xE4C1, 0x2490, 0x2460, 0xE431,
+    0x3C00, 0xFC51, 0xFCA1, 0x3CF0, 0xFD41, 0x3D10, 0x3DE0, 0xFDB1,
+    0xFE81, 0x3ED0, 0x3E20, 0xFE71, 0x3FC0, 0xFF91, 0xFF61, 0x3F30,
+    0xF901, 0x3950, 0x39A0, 0xF9F1, 0x3840, 0xF811, 0xF8E1, 0x38B0,
+    0x3B80, 0xFBD1, 0xFB21, 0x3B70, 0xFAC1, 0x3A90, 0x3A60, 0xFA31,
+    0xF601, 0x3650, 0x36A0, 0xF6F1, 0x3740, 0xF711, 0xF7E1, 0x37B0,
+    0x3480, 0xF4D1, 0xF421, 0x3470, 0xF5C1, 0x3590, 0x3560, 0xF531,
+    0x3300, 0xF351, 0xF3A1, 0x33F0, 0xF241, 0x3210, 0x32E0, 0xF2B1,
+    0xF181, 0x31D0, 0x3120, 0xF171, 0x30C0, 0xF091, 0xF061, 0x3030
+  },
+  {
+    0x0000, 0xFC01, 0xB801, 0x4400, 0x3001, 0xCC00, 0x8800, 0x7401,
+    0x6002, 0x9C03, 0xD803, 0x2402, 0x5003, 0xAC02, 0xE802, 0x1403,
+    0xC004, 0x3C05, 0x7805, 0x8404, 0xF005, 0x0C04, 0x4804, 0xB405,
+    0xA006, 0x5C07, 0x1807, 0xE406, 0x9007, 0x6C06, 0x2806, 0xD407,
+    0xC00B, 0x3C0A, 0x780A, 0x840B, 0xF00A, 0x0C0B, 0x480B, 0xB40A,
+    0xA009, 0x5C08, 0x1808, 0xE409, 0x9008, 0x6C09, 0x2809, 0xD408,
+    0x000F, 0xFC0E, 0xB80E, 0x440F, 0x300E, 0xCC0F, 0x880F, 0x740E,
+    0x600D, 0x9C0C, 0xD80C, 0x240D, 0x500C, 0xAC0D, 0xE80D, 0x140C,
+    0xC015, 0x3C14, 0x7814, 0x8415, 0xF014, 0x0C15, 0x4815, 0xB414,
+    0xA017, 0x5C16, 0x1816, 0xE417, 0x9016, 0x6C17, 0x2817, 0xD416,
+    0x0011, 0xFC10, 0xB810, 0x4411, 0x3010, 0xCC11, 0x8811, 0x7410,
+    0x6013, 0x9C12, 0xD812, 0x2413, 0x5012, 0xAC13, 0xE813, 0x1412,
+    0x001E, 0xFC1F, 0xB81F, 0x441E, 0x301F, 0xCC1E, 0x881E, 0x741F,
+    0x601C, 0x9C1D, 0xD81D, 0x241C, 0x501D, 0xAC1C, 0xE81C, 0x141D,
+    0xC01A, 0x3C1B, 0x781B, 0x841A, 0xF01B, 0x0C1A, 0x481A, 0xB41B,
+    0xA018, 0x5C19, 0x1819, 0xE418, 0x9019, 0x6C18, 0x2818, 0xD419,
+    0xC029, 0x3C28, 0x7828, 0x8429, 0xF028, 0x0C29, 0x4829, 0xB428,
+    0xA02B, 0x5C2A, 0x182A, 0xE42B, 0x902A, 0x6C2B, 0x282B, 0xD42A,
+    0x002D, 0xFC2C, 0xB82C, 0x442D, 0x302C, 0xCC2D, 0x882D, 0x742C,
+    0x602F, 0x9C2E, 0xD82E, 0x242F, 0x502E, 0xAC2F, 0xE82F, 0x142E,
+    0x0022, 0xFC23, 0xB823, 0x4422, 0x3023, 0xCC22, 0x8822, 0x7423,
+    0x6020, 0x9C21, 0xD821, 0x2420, 0x5021, 0xAC20, 0xE820, 0x1421,
+    0xC026, 0x3C27, 0x7827, 0x8426, 0xF027, 0x0C26, 0x4826, 0xB427,
+    0xA024, 0x5C25, 0x1825, 0xE424, 0x9025, 0x6C24, 0x2824, 0xD425,
+    0x003C, 0xFC3D, 0xB83D, 0x443C, 0x303D, 0xCC3C, 0x883C, 0x743D,
+    0x603E, 0x9C3F, 0xD83F, 0x243E, 0x503F, 0xAC3E, 0xE83E, 0x143F,
+    0xC038, 0x3C39, 0x7839, 0x8438, 0xF039, 0x0C38, 0x4838, 0xB439,
+    0xA03A, 0x5C3B, 0x183B, 0xE43A, 0x903B, 0x6C3A, 0x283A, 0xD43B,
+    0xC037, 0x3C36, 0x7836, 0x8437, 0xF036, 0x0C37, 0x4837, 0xB436,
+    0xA035, 0x5C34, 0x1834, 0xE435, 0x9034, 0x6C35, 0x2835, 0xD434,
+    0x0033, 0xFC32, 0xB832, 0x4433, 0x3032, 0xCC33, 0x8833, 0x7432,
+    0x6031, 0x9C30, 0xD830, 0x2431, 0x5030, 0xAC31, 0xE831, 0x1430
+  },
+  {
+    0x0000, 0xC03D, 0xC079, 0x0044, 0xC0F1, 0x00CC, 0x0088, 0xC0B5,
+    0xC1E1, 0x01DC, 0x0198, 0xC1A5, 0x0110, 0xC12D, 0xC169, 0x0154,
+    0xC3C1, 0x03FC, 0x03B8, 0xC385, 0x0330, 0xC30D, 0xC349, 0x0374,
+    0x0220, 0xC21D, 0xC259, 0x0264, 0xC2D1, 0x02EC, 0x02A8, 0xC295,
+    0xC781, 0x07BC, 0x07F8, 0xC7C5, 0x0770, 0xC74D, 0xC709, 0x0734,
+    0x0660, 0xC65D, 0xC619, 0x0624, 0xC691, 0x06AC, 0x06E8, 0xC6D5,
+    0x0440, 0xC47D, 0xC439, 0x0404, 0xC4B1, 0x048C, 0x04C8, 0xC4F5,
+    0xC5A1, 0x059C, 0x05D8, 0xC5E5, 0x0550, 0xC56D, 0xC529, 0x0514,
+    0xCF01, 0x0F3C, 0x0F78, 0xCF45, 0x0FF0, 0xCFCD, 0xCF89, 0x0FB4,
+    0x0EE0, 0xCEDD, 0xCE99, 0x0EA4, 0xCE11, 0x0E2C, 0x0E68, 0xCE55,
+    0x0CC0, 0xCCFD, 0xCCB9, 0x0C84, 0xCC31, 0x0C0C, 0x0C48, 0xCC75,
+    0xCD21, 0x0D1C, 0x0D58, 0xCD65, 0x0DD0, 0xCDED, 0xCDA9, 0x0D94,
+    0x0880, 0xC8BD, 0xC8F9, 0x08C4, 0xC871, 0x084C, 0x0808, 0xC835,
+    0xC961, 0x095C, 0x0918, 0xC925, 0x0990, 0xC9AD, 0xC9E9, 0x09D4,
+    0xCB41, 0x0B7C, 0x0B38, 0xCB05, 0x0BB0, 0xCB8D, 0xCBC9, 0x0BF4,
+    0x0AA0, 0xCA9D, 0xCAD9, 0x0AE4, 0xCA51, 0x0A6C, 0x0A28, 0xCA15,
+    0xDE01, 0x1E3C, 0x1E78, 0xDE45, 0x1EF0, 0xDECD, 0xDE89, 0x1EB4,
+    0x1FE0, 0xDFDD, 0xDF99, 0x1FA4, 0xDF11, 0x1F2C, 0x1F68, 0xDF55,
+    0x1DC0, 0xDDFD, 0xDDB9, 0x1D84, 0xDD31, 0x1D0C, 0x1D48, 0xDD75,
+    0xDC21, 0x1C1C, 0x1C58, 0xDC65, 0x1CD0, 0xDCED, 0xDCA9, 0x1C94,
+    0x1980, 0xD9BD, 0xD9F9, 0x19C4, 0xD971, 0x194C, 0x1908, 0xD935,
+    0xD861, 0x185C, 0x1818, 0xD825, 0x1890, 0xD8AD, 0xD8E9, 0x18D4,
+    0xDA41, 0x1A7C, 0x1A38, 0xDA05, 0x1AB0, 0xDA8D, 0xDAC9, 0x1AF4,
+    0x1BA0, 0xDB9D, 0xDBD9, 0x1BE4, 0xDB51, 0x1B6C, 0x1B28, 0xDB15,
+    0x1100, 0xD13D, 0xD179, 0x1144, 0xD1F1, 0x11CC, 0x1188, 0xD1B5,
+    0xD0E1, 0x10DC, 0x1098, 0xD0A5, 0x1010, 0xD02D, 0xD069, 0x1054,
+    0xD2C1, 0x12FC, 0x12B8, 0xD285, 0x1230, 0xD20D, 0xD249, 0x1274,
+    0x1320, 0xD31D, 0xD359, 0x1364, 0xD3D1, 0x13EC, 0x13A8, 0xD395,
+    0xD681, 0x16BC, 0x16F8, 0xD6C5, 0x1670, 0xD64D, 0xD609, 0x1634,
+    0x1760, 0xD75D, 0xD719, 0x1724, 0xD791, 0x17AC, 0x17E8, 0xD7D5,
+    0x1540, 0xD57D, 0xD539, 0x1504, 0xD5B1, 0x158C, 0x15C8, 0xD5F5,
+    0xD4A1, 0x149C, 0x14D8, 0xD4E5, 0x1450, 0xD46D, 0xD429, 0x1414
+  },
+  {
+    0x0000, 0xD101, 0xE201, 0x3300, 0x8401, 0x5500, 0x6600, 0xB701,
+    0x4801, 0x9900, 0xAA00, 0x7B01, 0xCC00, 0x1D01, 0x2E01, 0xFF00,
+    0x9002, 0x4103, 0x7203, 0xA302, 0x1403, 0xC502, 0xF602, 0x2703,
+    0xD803, 0x0902, 0x3A02, 0xEB03, 0x5C02, 0x8D03, 0xBE03, 0x6F02,
+    0x6007, 0xB106, 0x8206, 0x5307, 0xE406, 0x3507, 0x0607, 0xD706,
+    0x2806, 0xF907, 0xCA07, 0x1B06, 0xAC07, 0x7D06, 0x4E06, 0x9F07,
+    0xF005, 0x2104, 0x1204, 0xC305, 0x7404, 0xA505, 0x9605, 0x4704,
+    0xB804, 0x6905, 0x5A05, 0x8B04, 0x3C05, 0xED04, 0xDE04, 0x0F05,
+    0xC00E, 0x110F, 0x220F, 0xF30E, 0x440F, 0x950E, 0xA60E, 0x770F,
+    0x880F, 0x590E, 0x6A0E, 0xBB0F, 0x0C0E, 0xDD0F, 0xEE0F, 0x3F0E,
+    0x500C, 0x810D, 0xB20D, 0x630C, 0xD40D, 0x050C, 0x360C, 0xE70D,
+    0x180D, 0xC90C, 0xFA0C, 0x2B0D, 0x9C0C, 0x4D0D, 0x7E0D, 0xAF0C,
+    0xA009, 0x7108, 0x4208, 0x9309, 0x2408, 0xF509, 0xC609, 0x1708,
+    0xE808, 0x3909, 0x0A09, 0xDB08, 0x6C09, 0xBD08, 0x8E08, 0x5F09,
+    0x300B, 0xE10A, 0xD20A, 0x030B, 0xB40A, 0x650B, 0x560B, 0x870A,
+    0x780A, 0xA90B, 0x9A0B, 0x4B0A, 0xFC0B, 0x2D0A, 0x1E0A, 0xCF0B,
+    0xC01F, 0x111E, 0x221E, 0xF31F, 0x441E, 0x951F, 0xA61F, 0x771E,
+    0x881E, 0x591F, 0x6A1F, 0xBB1E, 0x0C1F, 0xDD1E, 0xEE1E, 0x3F1F,
+    0x501D, 0x811C, 0xB21C, 0x631D, 0xD41C, 0x051D, 0x361D, 0xE71C,
+    0x181C, 0xC91D, 0xFA1D, 0x2B1C, 0x9C1D, 0x4D1C, 0x7E1C, 0xAF1D,
+    0xA018, 0x7119, 0x4219, 0x9318, 0x2419, 0xF518, 0xC618, 0x1719,
+    0xE819, 0x3918, 0x0A18, 0xDB19, 0x6C18, 0xBD19, 0x8E19, 0x5F18,
+    0x301A, 0xE11B, 0xD21B, 0x031A, 0xB41B, 0x651A, 0x561A, 0x871B,
+    0x781B, 0xA91A, 0x9A1A, 0x4B1B, 0xFC1A, 0x2D1B, 0x1E1B, 0xCF1A,
+    0x0011, 0xD110, 0xE210, 0x3311, 0x8410, 0x5511, 0x6611, 0xB710,
+    0x4810, 0x9911, 0xAA11, 0x7B10, 0xCC11, 0x1D10, 0x2E10, 0xFF11,
+    0x9013, 0x4112, 0x7212, 0xA313, 0x1412, 0xC513, 0xF613, 0x2712,
+    0xD812, 0x0913, 0x3A13, 0xEB12, 0x5C13, 0x8D12, 0xBE12, 0x6F13,
+    0x6016, 0xB117, 0x8217, 0x5316, 0xE417, 0x3516, 0x0616, 0xD717,
+    0x2817, 0xF916, 0xCA16, 0x1B17, 0xAC16, 0x7D17, 0x4E17, 0x9F16,
+    0xF014, 0x2115, 0x1215, 0xC314, 0x7415, 0xA514, 0x9614, 0x4715,
+    0xB815, 0x6914, 0x5A14, 0x8B15, 0x3C14, 0xED15, 0xDE15, 0x0F14
+  },
+  {
+    0x0000, 0xC010, 0xC023, 0x0033, 0xC045, 0x0055, 0x0066, 0xC076,
+    0xC089, 0x0099, 0x00AA, 0xC0BA, 0x00CC, 0xC0DC, 0xC0EF, 0x00FF,
+    0xC111, 0x0101, 0x0132, 0xC122, 0x0154, 0xC144, 0xC177, 0x0167,
+    0x0198, 0xC188, 0xC1BB, 0x01AB, 0xC1DD, 0x01CD, 0x01FE, 0xC1EE,
+    0xC221, 0x0231, 0x0202, 0xC212, 0x0264, 0xC274, 0xC247, 0x0257,
+    0x02A8, 0xC2B8, 0xC28B, 0x029B, 0xC2ED, 0x02FD, 0x02CE, 0xC2DE,
+    0x0330, 0xC320, 0xC313, 0x0303, 0xC375, 0x0365, 0x0356, 0xC346,
+    0xC3B9, 0x03A9, 0x039A, 0xC38A, 0x03FC, 0xC3EC, 0xC3DF, 0x03CF,
+    0xC441, 0x0451, 0x0462, 0xC472, 0x0404, 0xC414, 0xC427, 0x0437,
+    0x04C8, 0xC4D8, 0xC4EB, 0x04FB, 0xC48D, 0x049D, 0x04AE, 0xC4BE,
+    0x0550, 0xC540, 0xC573, 0x0563, 0xC515, 0x0505, 0x0536, 0xC526,
+    0xC5D9, 0x05C9, 0x05FA, 0xC5EA, 0x059C, 0xC58C, 0xC5BF, 0x05AF,
+    0x0660, 0xC670, 0xC643, 0x0653, 0xC625, 0x0635, 0x0606, 0xC616,
+    0xC6E9, 0x06F9, 0x06CA, 0xC6DA, 0x06AC, 0xC6BC, 0xC68F, 0x069F,
+    0xC771, 0x0761, 0x0752, 0xC742, 0x0734, 0xC724, 0xC717, 0x0707,
+    0x07F8, 0xC7E8, 0xC7DB, 0x07CB, 0xC7BD, 0x07AD, 0x079E, 0xC78E,
+    0xC881, 0x0891, 0x08A2, 0xC8B2, 0x08C4, 0xC8D4, 0xC8E7, 0x08F7,
+    0x0808, 0xC818, 0xC82B, 0x083B, 0xC84D, 0x085D, 0x086E, 0xC87E,
+    0x0990, 0xC980, 0xC9B3, 0x09A3, 0xC9D5, 0x09C5, 0x09F6, 0xC9E6,
+    0xC919, 0x0909, 0x093A, 0xC92A, 0x095C, 0xC94C, 0xC97F, 0x096F,
+    0x0AA0, 0xCAB0, 0xCA83, 0x0A93, 0xCAE5, 0x0AF5, 0x0AC6, 0xCAD6,
+    0xCA29, 0x0A39, 0x0A0A, 0xCA1A, 0x0A6C, 0xCA7C, 0xCA4F, 0x0A5F,
+    0xCBB1, 0x0BA1, 0x0B92, 0xCB82, 0x0BF4, 0xCBE4, 0xCBD7, 0x0BC7,
+    0x0B38, 0xCB28, 0xCB1B, 0x0B0B, 0xCB7D, 0x0B6D, 0x0B5E, 0xCB4E,
+    0x0CC0, 0xCCD0, 0xCCE3, 0x0CF3, 0xCC85, 0x0C95, 0x0CA6, 0xCCB6,
+    0xCC49, 0x0C59, 0x0C6A, 0xCC7A, 0x0C0C, 0xCC1C, 0xCC2F, 0x0C3F,
+    0xCDD1, 0x0DC1, 0x0DF2, 0xCDE2, 0x0D94, 0xCD84, 0xCDB7, 0x0DA7,
+    0x0D58, 0xCD48, 0xCD7B, 0x0D6B, 0xCD1D, 0x0D0D, 0x0D3E, 0xCD2E,
+    0xCEE1, 0x0EF1, 0x0EC2, 0xCED2, 0x0EA4, 0xCEB4, 0xCE87, 0x0E97,
+    0x0E68, 0xCE78, 0xCE4B, 0x0E5B, 0xCE2D, 0x0E3D, 0x0E0E, 0xCE1E,
+    0x0FF0, 0xCFE0, 0xCFD3, 0x0FC3, 0xCFB5, 0x0FA5, 0x0F96, 0xCF86,
+    0xCF79, 0x0F69, 0x0F5A, 0xCF4A, 0x0F3C, 0xCF2C, 0xCF1F, 0x0F0F
+  },
+  {
+    0x0000, 0xCCC1, 0xD981, 0x1540, 0xF301, 0x3FC0, 0x2A80, 0xE641,
+    0xA601, 0x6AC0, 0x7F80, 0xB341, 0x5500, 0x99C1, 0x8C81, 0x4040,
+    0x0C01, 0xC0C0, 0xD580, 0x1941, 0xFF00, 0x33C1, 0x2681, 0xEA40,
+    0xAA00, 0x66C1, 0x7381, 0xBF40, 0x5901, 0x95C0, 0x8080, 0x4C41,
+    0x1802, 0xD4C3, 0xC183, 0x0D42, 0xEB03, 0x27C2, 0x3282, 0xFE43,
+    0xBE03, 0x72C2, 0x6782, 0xAB43, 0x4D02, 0x81C3, 0x9483, 0x5842,
+    0x1403, 0xD8C2, 0xCD82, 0x0143, 0xE702, 0x2BC3, 0x3E83, 0xF242,
+    0xB202, 0x7EC3, 0x6B83, 0xA742, 0x4103, 0x8DC2, 0x9882, 0x5443,
+    0x3004, 0xFCC5, 0xE985, 0x2544, 0xC305, 0x0FC4, 0x1A84, 0xD645,
+    0x9605, 0x5AC4, 0x4F84, 0x8345, 0x6504, 0xA9C5, 0xBC85, 0x7044,
+    0x3C05, 0xF0C4, 0xE584, 0x2945, 0xCF04, 0x03C5, 0x1685, 0xDA44,
+    0x9A04, 0x56C5, 0x4385, 0x8F44, 0x6905, 0xA5C4, 0xB084, 0x7C45,
+    0x2806, 0xE4C7, 0xF187, 0x3D46, 0xDB07, 0x17C6, 0x0286, 0xCE47,
+    0x8E07, 0x42C6, 0x5786, 0x9B47, 0x7D06, 0xB1C7, 0xA487, 0x6846,
+    0x2407, 0xE8C6, 0xFD86, 0x3147, 0xD706, 0x1BC7, 0x0E87, 0xC246,
+    0x8206, 0x4EC7, 0x5B87, 0x9746, 0x7107, 0xBDC6, 0xA886, 0x6447,
+    0x6008, 0xACC9, 0xB989, 0x7548, 0x9309, 0x5FC8, 0x4A88, 0x8649,
+    0xC609, 0x0AC8, 0x1F88, 0xD349, 0x3508, 0xF9C9, 0xEC89, 0x2048,
+    0x6C09, 0xA0C8, 0xB588, 0x7949, 0x9F08, 0x53C9, 0x4689, 0x8A48,
+    0xCA08, 0x06C9, 0x1389, 0xDF48, 0x3909, 0xF5C8, 0xE088, 0x2C49,
+    0x780A, 0xB4CB, 0xA18B, 0x6D4A, 0x8B0B, 0x47CA, 0x528A, 0x9E4B,
+    0xDE0B, 0x12CA, 0x078A, 0xCB4B, 0x2D0A, 0xE1CB, 0xF48B, 0x384A,
+    0x740B, 0xB8CA, 0xAD8A, 0x614B, 0x870A, 0x4BCB, 0x5E8B, 0x924A,
+    0xD20A, 0x1ECB, 0x0B8B, 0xC74A, 0x210B, 0xEDCA, 0xF88A, 0x344B,
+    0x500C, 0x9CCD, 0x898D, 0x454C, 0xA30D, 0x6FCC, 0x7A8C, 0xB64D,
+    0xF60D, 0x3ACC, 0x2F8C, 0xE34D, 0x050C, 0xC9CD, 0xDC8D, 0x104C,
+    0x5C0D, 0x90CC, 0x858C, 0x494D, 0xAF0C, 0x63CD, 0x768D, 0xBA4C,
+    0xFA0C, 0x36CD, 0x238D, 0xEF4C, 0x090D, 0xC5CC, 0xD08C, 0x1C4D,
+    0x480E, 0x84CF, 0x918F, 0x5D4E, 0xBB0F, 0x77CE, 0x628E, 0xAE4F,
+    0xEE0F, 0x22CE, 0x378E, 0xFB4F, 0x1D0E, 0xD1CF, 0xC48F, 0x084E,
+    0x440F, 0x88CE, 0x9D8E, 0x514F, 0xB70E, 0x7BCF, 0x6E8F, 0xA24E,
+    0xE20E, 0x2ECF, 0x3B8F, 0xF74E, 0x110F, 0xDDCE, 0xC88E, 0x044F
+  }
+};
+
+static const uint32_t crc32_table[8][256] = {
+  {
+    0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f,
+    0xe963a535, 0x9e6495a3, 0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
+    0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91, 0x1db71064, 0x6ab020f2,
+    0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
+    0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9,
+    0xfa0f3d63, 0x8d080df5, 0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
+    0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b, 0x35b5a8fa, 0x42b2986c,
+    0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
+    0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423,
+    0xcfba9599, 0xb8bda50f, 0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
+    0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d, 0x76dc4190, 0x01db7106,
+    0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
+    0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d,
+    0x91646c97, 0xe6635c01, 0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
+    0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457, 0x65b0d9c6, 0x12b7e950,
+    0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
+    0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7,
+    0xa4d1c46d, 0xd3d6f4fb, 0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
+    0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9, 0x5005713c, 0x270241aa,
+    0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
+    0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81,
+    0xb7bd5c3b, 0xc0ba6cad, 0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
+    0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683, 0xe3630b12, 0x94643b84,
+    0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
+    0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb,
+    0x196c3671, 0x6e6b06e7, 0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
+    0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5, 0xd6d6a3e8, 0xa1d1937e,
+    0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
+    0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55,
+    0x316e8eef, 0x4669be79, 0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
+    0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f, 0xc5ba3bbe, 0xb2bd0b28,
+    0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
+    0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f,
+    0x72076785, 0x05005713, 0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
+    0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21, 0x86d3d2d4, 0xf1d4e242,
+    0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
+    0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69,
+    0x616bffd3, 0x166ccf45, 0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
+    0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db, 0xaed16a4a, 0xd9d65adc,
+    0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
+    0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693,
+    0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
+    0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
+  },
+  {
+    0x00000000, 0x196c3641, 0x32d86c82, 0x2bb45ac3, 0x646ba804, 0x7d079e45,
+    0x56b3c486, 0x4fdff2c7, 0xc8d75108, 0xd1bb6749, 0xfa0f3d8a, 0xe3630bcb,
+    0xacbcf90c, 0xb5d0cf4d, 0x9e64958e, 0x8708a3cf, 0x4adfa551, 0x53b39310,
+    0x7807c9d3, 0x616bff92, 0x2eb40d55, 0x37d83b14, 0x1c6c61d7, 0x05005796,
+    0x8208f459, 0x9b64c218, 0xb0d098db, 0xa9bcae9a, 0xe6635c5d, 0xff0f6a1c,
+    0xd4bb30df, 0xcdd7069e, 0x95bf4aa2, 0x8cd37ce3, 0xa7672620, 0xbe0b1061,
+    0xf1d4e2a6, 0xe8b8d4e7, 0xc30c8e24, 0xda60b865, 0x5d681baa, 0x44042deb,
+    0x6fb07728, 0x76dc4169, 0x3903b3ae, 0x206f85ef, 0x0bdbdf2c, 0x12b7e96d,
+    0xdf60eff3, 0xc60cd9b2, 0xedb88371, 0xf4d4b530, 0xbb0b47f7, 0xa26771b6,
+    0x89d32b75, 0x90bf1d34, 0x17b7befb, 0x0edb88ba, 0x256fd279, 0x3c03e438,
+    0x73dc16ff, 0x6ab020be, 0x41047a7d, 0x58684c3c, 0xf00f9305, 0xe963a544,
+    0xc2d7ff87, 0xdbbbc9c6, 0x94643b01, 0x8d080d40, 0xa6bc5783, 0xbfd061c2,
+    0x38d8c20d, 0x21b4f44c, 0x0a00ae8f, 0x136c98ce, 0x5cb36a09, 0x45df5c48,
+    0x6e6b068b, 0x770730ca, 0xbad03654, 0xa3bc0015, 0x88085ad6, 0x91646c97,
+    0xdebb9e50, 0xc7d7a811, 0xec63f2d2, 0xf50fc493, 0x7207675c, 0x6b6b511d,
+    0x40df0bde, 0x59b33d9f, 0x166ccf58, 0x0f00f919, 0x24b4a3da, 0x3dd8959b,
+    0x65b0d9a7, 0x7cdcefe6, 0x5768b525, 0x4e048364, 0x01db71a3, 0x18b747e2,
+    0x33031d21, 0x2a6f2b60, 0xad6788af, 0xb40bbeee, 0x9fbfe42d, 0x86d3d26c,
+    0xc90c20ab, 0xd06016ea, 0xfbd44c29, 0xe2b87a68, 0x2f6f7cf6, 0x36034ab7,
+    0x1db71074, 0x04db2635, 0x4b04d4f2, 0x5268e2b3, 0x79dcb870, 0x60b08e31,
+    0xe7b82dfe, 0xfed41bbf, 0xd560417c, 0xcc0c773d, 0x83d385fa, 0x9abfb3bb,
+    0xb10be978, 0xa867df39, 0x3b6e204b, 0x2202160a, 0x09b64cc9, 0x10da7a88,
+    0x5f05884f, 0x4669be0e, 0x6ddde4cd, 0x74b1d28c, 0xf3b97143, 0xead54702,
+    0xc1611dc1, 0xd80d2b80, 0x97d2d947, 0x8ebeef06, 0xa50ab5c5, 0xbc668384,
+    0x71b1851a, 0x68ddb35b, 0x4369e998, 0x5a05dfd9, 0x15da2d1e, 0x0cb61b5f,
+    0x2702419c, 0x3e6e77dd, 0xb966d412, 0xa00ae253, 0x8bbeb890, 0x92d28ed1,
+    0xdd0d7c16, 0xc4614a57, 0xefd51094, 0xf6b926d5, 0xaed16ae9, 0xb7bd5ca8,
+    0x9c09066b, 0x8565302a, 0xcabac2ed, 0xd3d6f4ac, 0xf862ae6f, 0xe10e982e,
+    0x66063be1, 0x7f6a0da0, 0x54de5763, 0x4db26122, 0x026d93e5, 0x1b01a5a4,
+    0x30b5ff67, 0x29d9c926, 0xe40ecfb8, 0xfd62f9f9, 0xd6d6a33a, 0xcfba957b,
+    0x806567bc, 0x990951fd, 0xb2bd0b3e, 0xabd13d7f, 0x2cd99eb0, 0x35b5a8f1,
+    0x1e01f232, 0x076dc473, 0x48b236b4, 0x51de00f5, 0x7a6a5a36, 0x63066c77,
+    0xcb61b34e, 0xd20d850f, 0xf9b9dfcc, 0xe0d5e98d, 0xaf0a1b4a, 0xb6662d0b,
+    0x9dd277c8, 0x84be4189, 0x03b6e246, 0x1adad407, 0x316e8ec4, 0x2802b885,
+    0x67dd4a42, 0x7eb17c03, 0x550526c0, 0x4c691081, 0x81be161f, 0x98d2205e,
+    0xb3667a9d, 0xaa0a4cdc, 0xe5d5be1b, 0xfcb9885a, 0xd70dd299, 0xce61e4d8,
+    0x49694717, 0x50057156, 0x7bb12b95, 0x62dd1dd4, 0x2d02ef13, 0x346ed952,
+    0x1fda8391, 0x06b6b5d0, 0x5edef9ec, 0x47b2cfad, 0x6c06956e, 0x756aa32f,
+    0x3ab551e8, 0x23d967a9, 0x086d3d6a, 0x11010b2b, 0x9609a8e4, 0x8f659ea5,
+    0xa4d1c466, 0xbdbdf227, 0xf26200e0, 0xeb0e36a1, 0xc0ba6c62, 0xd9d65a23,
+    0x14015cbd, 0x0d6d6afc, 0x26d9303f, 0x3fb5067e, 0x706af4b9, 0x6906c2f8,
+    0x42b2983b, 0x5bdeae7a, 0xdcd60db5, 0xc5ba3bf4, 0xee0e6137, 0xf7625776,
+    0xb8bda5b1, 0xa1d193f0, 0x8a65c933, 0x9309ff72
+  },
+  {
+    0x00000000, 0x01db7130, 0x03b6e260, 0x026d9350, 0x076dc4b1, 0x06b6b581,
+    0x04db26d1, 0x050057e1, 0x0edb8863, 0x0f00f953, 0x0d6d6a03, 0x0cb61b33,
+    0x09b64cd2, 0x086d3de2, 0x0a00aeb2, 0x0bdbdf82, 0x1c6c61c7, 0x1db710f7,
+    0x1fda83a7, 0x1e01f297, 0x1b01a576, 0x1adad446, 0x18b74716, 0x196c3626,
+    0x12b7e9a4, 0x136c9894, 0x11010bc4, 0x10da7af4, 0x15da2d15, 0x14015c25,
+    0x166ccf75, 0x17b7be45, 0x38d8c28e, 0x3903b3be, 0x3b6e20ee, 0x3ab551de,
+    0x3fb5063f, 0x3e6e770f, 0x3c03e45f, 0x3dd8956f, 0x36034aed, 0x37d83bdd,
+    0x35b5a88d, 0x346ed9bd, 0x316e8e5c, 0x30b5ff6c, 0x32d86c3c, 0x33031d0c,
+    0x24b4a349, 0x256fd279, 0x27024129, 0x26d93019, 0x23d967f8, 0x220216c8,
+    0x206f8598, 0x21b4f4a8, 0x2a6f2b2a, 0x2bb45a1a, 0x29d9c94a, 0x2802b87a,
+    0x2d02ef9b, 0x2cd99eab, 0x2eb40dfb, 0x2f6f7ccb, 0x706af41c, 0x71b1852c,
+    0x73dc167c, 0x7207674c, 0x770730ad, 0x76dc419d, 0x74b1d2cd, 0x756aa3fd,
+    0x7eb17c7f, 0x7f6a0d4f, 0x7d079e1f, 0x7cdcef2f, 0x79dcb8ce, 0x7807c9fe,
+    0x7a6a5aae, 0x7bb12b9e, 0x6c0695db, 0x6ddde4eb, 0x6fb077bb, 0x6e6b068b,
+    0x6b6b516a, 0x6ab0205a, 0x68ddb30a, 0x6906c23a, 0x62dd1db8, 0x63066c88,
+    0x616bffd8, 0x60b08ee8, 0x65b0d909, 0x646ba839, 0x66063b69, 0x67dd4a59,
+    0x48b23692, 0x496947a2, 0x4b04d4f2, 0x4adfa5c2, 0x4fdff223, 0x4e048313,
+    0x4c691043, 0x4db26173, 0x4669bef1, 0x47b2cfc1, 0x45df5c91, 0x44042da1,
+    0x41047a40, 0x40df0b70, 0x42b29820, 0x4369e910, 0x54de5755, 0x55052665,
+    0x5768b535, 0x56b3c405, 0x53b393e4, 0x5268e2d4, 0x50057184, 0x51de00b4,
+    0x5a05df36, 0x5bdeae06, 0x59b33d56, 0x58684c66, 0x5d681b87, 0x5cb36ab7,
+    0x5edef9e7, 0x5f0588d7, 0xe10e9838, 0xe0d5e908, 0xe2b87a58, 0xe3630b68,
+    0xe6635c89, 0xe7b82db9, 0xe5d5bee9, 0xe40ecfd9, 0xefd5105b, 0xee0e616b,
+    0xec63f23b, 0xedb8830b, 0xe8b8d4ea, 0xe963a5da, 0xeb0e368a, 0xead547ba,
+    0xfd62f9ff, 0xfcb988cf, 0xfed41b9f, 0xff0f6aaf, 0xfa0f3d4e, 0xfbd44c7e,
+    0xf9b9df2e, 0xf862ae1e, 0xf3b9719c, 0xf26200ac, 0xf00f93fc, 0xf1d4e2cc,
+    0xf4d4b52d, 0xf50fc41d, 0xf762574d, 0xf6b9267d, 0xd9d65ab6, 0xd80d2b86,
+    0xda60b8d6, 0xdbbbc9e6, 0xdebb9e07, 0xdf60ef37, 0xdd0d7c67, 0xdcd60d57,
+    0xd70dd2d5, 0xd6d6a3e5, 0xd4bb30b5, 0xd5604185, 0xd0601664, 0xd1bb6754,
+    0xd3d6f404, 0xd20d8534, 0xc5ba3b71, 0xc4614a41, 0xc60cd911, 0xc7d7a821,
+    0xc2d7ffc0, 0xc30c8ef0, 0xc1611da0, 0xc0ba6c90, 0xcb61b312, 0xcabac222,
+    0xc8d75172, 0xc90c2042, 0xcc0c77a3, 0xcdd70693, 0xcfba95c3, 0xce61e4f3,
+    0x91646c24, 0x90bf1d14, 0x92d28e44, 0x9309ff74, 0x9609a895, 0x97d2d9a5,
+    0x95bf4af5, 0x94643bc5, 0x9fbfe447, 0x9e649577, 0x9c090627, 0x9dd27717,
+    0x98d220f6, 0x990951c6, 0x9b64c296, 0x9abfb3a6, 0x8d080de3, 0x8cd37cd3,
+    0x8ebeef83, 0x8f659eb3, 0x8a65c952, 0x8bbeb862, 0x89d32b32, 0x88085a02,
+    0x83d38580, 0x8208f4b0, 0x806567e0, 0x81be16d0, 0x84be4131, 0x85653001,
+    0x8708a351, 0x86d3d261, 0xa9bcaeaa, 0xa867df9a, 0xaa0a4cca, 0xabd13dfa,
+    0xaed16a1b, 0xaf0a1b2b, 0xad67887b, 0xacbcf94b, 0xa76726c9, 0xa6bc57f9,
+    0xa4d1c4a9, 0xa50ab599, 0xa00ae278, 0xa1d19348, 0xa3bc0018, 0xa2677128,
+    0xb5d0cf6d, 0xb40bbe5d, 0xb6662d0d, 0xb7bd5c3d, 0xb2bd0bdc, 0xb3667aec,
+    0xb10be9bc, 0xb0d0988c, 0xbb0b470e, 0xbad0363e, 0xb8bda56e, 0xb966d45e,
+    0xbc6683bf, 0xbdbdf28f, 0xbfd061df, 0xbe0b10ef
+  },
+  {
+    0x00000000, 0x26d930dd, 0x4db261ba, 0x6b6b5167, 0xbc6683de, 0x9abfb303,
+    0xf1d4e264, 0xd70dd2b9, 0xd4bb306a, 0xf26200b7, 0x990951d0, 0xbfd0610d,
+    0x68ddb3b4, 0x4e048369, 0x256fd20e, 0x03b6e2d3, 0x05005772, 0x23d967af,
+    0x48b236c8, 0x6e6b0615, 0xb966d4ac, 0x9fbfe471, 0xf4d4b516, 0xd20d85cb,
+    0xd1bb6718, 0xf76257c5, 0x9c0906a2, 0xbad0367f, 0x6ddde4c6, 0x4b04d41b,
+    0x206f857c, 0x06b6b5a1, 0x0a00aee5, 0x2cd99e38, 0x47b2cf5f, 0x616bff82,
+    0xb6662d3b, 0x90bf1de6, 0xfbd44c81, 0xdd0d7c5c, 0xdebb9e8f, 0xf862ae52,
+    0x9309ff35, 0xb5d0cfe8, 0x62dd1d51, 0x44042d8c, 0x2f6f7ceb, 0x09b64c36,
+    0x0f00f997, 0x29d9c94a, 0x42b2982d, 0x646ba8f0, 0xb3667a49, 0x95bf4a94,
+    0xfed41bf3, 0xd80d2b2e, 0xdbbbc9fd, 0xfd62f920, 0x9609a847, 0xb0d0989a,
+    0x67dd4a23, 0x41047afe, 0x2a6f2b99, 0x0cb61b44, 0x14015cbb, 0x32d86c66,
+    0x59b33d01, 0x7f6a0ddc, 0xa867df65, 0x8ebeefb8, 0xe5d5bedf, 0xc30c8e02,
+    0xc0ba6cd1, 0xe6635c0c, 0x8d080d6b, 0xabd13db6, 0x7cdcef0f, 0x5a05dfd2,
+    0x316e8eb5, 0x17b7be68, 0x11010bc9, 0x37d83b14, 0x5cb36a73, 0x7a6a5aae,
+    0xad678817, 0x8bbeb8ca, 0xe0d5e9ad, 0xc60cd970, 0xc5ba3ba3, 0xe3630b7e,
+    0x88085a19, 0xaed16ac4, 0x79dcb87d, 0x5f0588a0, 0x346ed9c7, 0x12b7e91a,
+    0x1e01f25e, 0x38d8c283, 0x53b393e4, 0x756aa339, 0xa2677180, 0x84be415d,
+    0xefd5103a, 0xc90c20e7, 0xcabac234, 0xec63f2e9, 0x8708a38e, 0xa1d19353,
+    0x76dc41ea, 0x50057137, 0x3b6e2050, 0x1db7108d, 0x1b01a52c, 0x3dd895f1,
+    0x56b3c496, 0x706af44b, 0xa76726f2, 0x81be162f, 0xead54748, 0xcc0c7795,
+    0xcfba9546, 0xe963a59b, 0x8208f4fc, 0xa4d1c421, 0x73dc1698, 0x55052645,
+    0x3e6e7722, 0x18b747ff, 0x2802b806, 0x0edb88db, 0x65b0d9bc, 0x4369e961,
+    0x94643bd8, 0xb2bd0b05, 0xd9d65a62, 0xff0f6abf, 0xfcb9886c, 0xda60b8b1,
+    0xb10be9d6, 0x97d2d90b, 0x40df0bb2, 0x66063b6f, 0x0d6d6a08, 0x2bb45ad5,
+    0x2d02ef74, 0x0bdbdfa9, 0x60b08ece, 0x4669be13, 0x91646caa, 0xb7bd5c77,
+    0xdcd60d10, 0xfa0f3dcd, 0xf9b9df1e, 0xdf60efc3, 0xb40bbea4, 0x92d28e79,
+    0x45df5cc0, 0x63066c1d, 0x086d3d7a, 0x2eb40da7, 0x220216e3, 0x04db263e,
+    0x6fb07759, 0x49694784, 0x9e64953d, 0xb8bda5e0, 0xd3d6f487, 0xf50fc45a,
+    0xf6b92689, 0xd0601654, 0xbb0b4733, 0x9dd277ee, 0x4adfa557, 0x6c06958a,
+    0x076dc4ed, 0x21b4f430, 0x27024191, 0x01db714c, 0x6ab0202b, 0x4c6910f6,
+    0x9b64c24f, 0xbdbdf292, 0xd6d6a3f5, 0xf00f9328, 0xf3b971fb, 0xd5604126,
+    0xbe0b1041, 0x98d2209c, 0x4fdff225, 0x6906c2f8, 0x026d939f, 0x24b4a342,
+    0x3c03e4bd, 0x1adad460, 0x71b18507, 0x5768b5da, 0x80656763, 0xa6bc57be,
+    0xcdd706d9, 0xeb0e3604, 0xe8b8d4d7, 0xce61e40a, 0xa50ab56d, 0x83d385b0,
+    0x54de5709, 0x720767d4, 0x196c36b3, 0x3fb5066e, 0x3903b3cf, 0x1fda8312,
+    0x74b1d275, 0x5268e2a8, 0x85653011, 0xa3bc00cc, 0xc8d751ab, 0xee0e6176,
+    0xedb883a5, 0xcb61b378, 0xa00ae21f, 0x86d3d2c2, 0x51de007b, 0x770730a6,
+    0x1c6c61c1, 0x3ab5511c, 0x36034a58, 0x10da7a85, 0x7bb12be2, 0x5d681b3f,
+    0x8a65c986, 0xacbcf95b, 0xc7d7a83c, 0xe10e98e1, 0xe2b87a32, 0xc4614aef,
+    0xaf0a1b88, 0x89d32b55, 0x5edef9ec, 0x7807c931, 0x136c9856, 0x35b5a88b,
+    0x33031d2a, 0x15da2df7, 0x7eb17c90, 0x58684c4d, 0x8f659ef4, 0xa9bcae29,
+    0xc2d7ff4e, 0xe40ecf93, 0xe7b82d40, 0xc1611d9d, 0xaa0a4cfa, 0x8cd37c27,
+    0x5bdeae9e, 0x7d079e43, 0x166ccf24, 0x30b5fff9
+  },
+  {
+    0x00000000, 0xf862ae59, 0x2bb45af3, 0xd3d6f4aa, 0x616bff50, 0x99095109,
+    0x4adfa5a3, 0xb2bd0bfa, 0xad678876, 0x5505262f, 0x86d3d285, 0x7eb17cdc,
+    0xcc0c7726, 0x346ed97f, 0xe7b82dd5, 0x1fda838c, 0xbe0b1047, 0x4669be1e,
+    0x95bf4ab4, 0x6ddde4ed, 0xdf60ef17, 0x2702414e, 0xf4d4b5e4, 0x0cb61bbd,
+    0x136c9831, 0xeb0e3668, 0x38d8c2c2, 0xc0ba6c9b, 0x72076761, 0x8a65c938,
+    0x59b33d92, 0xa1d193cb, 0xd0601659, 0x2802b800, 0xfbd44caa, 0x03b6e2f3,
+    0xb10be909, 0x49694750, 0x9abfb3fa, 0x62dd1da3, 0x7d079e2f, 0x85653076,
+    0x56b3c4dc, 0xaed16a85, 0x1c6c617f, 0xe40ecf26, 0x37d83b8c, 0xcfba95d5,
+    0x6e6b061e, 0x9609a847, 0x45df5ced, 0xbdbdf2b4, 0x0f00f94e, 0xf7625717,
+    0x24b4a3bd, 0xdcd60de4, 0xc30c8e68, 0x3b6e2031, 0xe8b8d49b, 0x10da7ac2,
+    0xa2677138, 0x5a05df61, 0x89d32bcb, 0x71b18592, 0x5cb36a58, 0xa4d1c401,
+    0x770730ab, 0x8f659ef2, 0x3dd89508, 0xc5ba3b51, 0x166ccffb, 0xee0e61a2,
+    0xf1d4e22e, 0x09b64c77, 0xda60b8dd, 0x22021684, 0x90bf1d7e, 0x68ddb327,
+    0xbb0b478d, 0x4369e9d4, 0xe2b87a1f, 0x1adad446, 0xc90c20ec, 0x316e8eb5,
+    0x83d3854f, 0x7bb12b16, 0xa867dfbc, 0x500571e5, 0x4fdff269, 0xb7bd5c30,
+    0x646ba89a, 0x9c0906c3, 0x2eb40d39, 0xd6d6a360, 0x050057ca, 0xfd62f993,
+    0x8cd37c01, 0x74b1d258, 0xa76726f2, 0x5f0588ab, 0xedb88351, 0x15da2d08,
+    0xc60cd9a2, 0x3e6e77fb, 0x21b4f477, 0xd9d65a2e, 0x0a00ae84, 0xf26200dd,
+    0x40df0b27, 0xb8bda57e, 0x6b6b51d4, 0x9309ff8d, 0x32d86c46, 0xcabac21f,
+    0x196c36b5, 0xe10e98ec, 0x53b39316, 0xabd13d4f, 0x7807c9e5, 0x806567bc,
+    0x9fbfe430, 0x67dd4a69, 0xb40bbec3, 0x4c69109a, 0xfed41b60, 0x06b6b539,
+    0xd5604193, 0x2d02efca, 0xe963a58d, 0x11010bd4, 0xc2d7ff7e, 0x3ab55127,
+    0x88085add, 0x706af484, 0xa3bc002e, 0x5bdeae77, 0x44042dfb, 0xbc6683a2,
+    0x6fb07708, 0x97d2d951, 0x256fd2ab, 0xdd0d7cf2, 0x0edb8858, 0xf6b92601,
+    0x5768b5ca, 0xaf0a1b93, 0x7cdcef39, 0x84be4160, 0x36034a9a, 0xce61e4c3,
+    0x1db71069, 0xe5d5be30, 0xfa0f3dbc, 0x026d93e5, 0xd1bb674f, 0x29d9c916,
+    0x9b64c2ec, 0x63066cb5, 0xb0d0981f, 0x48b23646, 0x3903b3d4, 0xc1611d8d,
+    0x12b7e927, 0xead5477e, 0x58684c84, 0xa00ae2dd, 0x73dc1677, 0x8bbeb82e,
+    0x94643ba2, 0x6c0695fb, 0xbfd06151, 0x47b2cf08, 0xf50fc4f2, 0x0d6d6aab,
+    0xdebb9e01, 0x26d93058, 0x8708a393, 0x7f6a0dca, 0xacbcf960, 0x54de5739,
+    0xe6635cc3, 0x1e01f29a, 0xcdd70630, 0x35b5a869, 0x2a6f2be5, 0xd20d85bc,
+    0x01db7116, 0xf9b9df4f, 0x4b04d4b5, 0xb3667aec, 0x60b08e46, 0x98d2201f,
+    0xb5d0cfd5, 0x4db2618c, 0x9e649526, 0x66063b7f, 0xd4bb3085, 0x2cd99edc,
+    0xff0f6a76, 0x076dc42f, 0x18b747a3, 0xe0d5e9fa, 0x33031d50, 0xcb61b309,
+    0x79dcb8f3, 0x81be16aa, 0x5268e200, 0xaa0a4c59, 0x0bdbdf92, 0xf3b971cb,
+    0x206f8561, 0xd80d2b38, 0x6ab020c2, 0x92d28e9b, 0x41047a31, 0xb966d468,
+    0xa6bc57e4, 0x5edef9bd, 0x8d080d17, 0x756aa34e, 0xc7d7a8b4, 0x3fb506ed,
+    0xec63f247, 0x14015c1e, 0x65b0d98c, 0x9dd277d5, 0x4e04837f, 0xb6662d26,
+    0x04db26dc, 0xfcb98885, 0x2f6f7c2f, 0xd70dd276, 0xc8d751fa, 0x30b5ffa3,
+    0xe3630b09, 0x1b01a550, 0xa9bcaeaa, 0x51de00f3, 0x8208f459, 0x7a6a5a00,
+    0xdbbbc9cb, 0x23d96792, 0xf00f9338, 0x086d3d61, 0xbad0369b, 0x42b298c2,
+    0x91646c68, 0x6906c231, 0x76dc41bd, 0x8ebeefe4, 0x5d681b4e, 0xa50ab517,
+    0x17b7beed, 0xefd510b4, 0x3c03e41e, 0xc4614a47
+  },
+  {
+    0x00000000, 0x12b7e9fe, 0x24b4a3fc, 0x36034a02, 0x6b6b510b, 0x79dcb8f5,
+    0x4fdff2f7, 0x5d681b09, 0xb966d481, 0xabd13d7f, 0x9dd2777d, 0x8f659e83,
+    0xd20d858a, 0xc0ba6c74, 0xf6b92676, 0xe40ecf88, 0xe8b8d423, 0xfa0f3ddd,
+    0xcc0c77df, 0xdebb9e21, 0x83d38528, 0x91646cd6, 0xa76726d4, 0xb5d0cf2a,
+    0x51de00a2, 0x4369e95c, 0x756aa35e, 0x67dd4aa0, 0x3ab551a9, 0x2802b857,
+    0x1e01f255, 0x0cb61bab, 0x12b7e946, 0x000000b8, 0x36034aba, 0x24b4a344,
+    0x79dcb84d, 0x6b6b51b3, 0x5d681bb1, 0x4fdff24f, 0xabd13dc7, 0xb966d439,
+    0x8f659e3b, 0x9dd277c5, 0xc0ba6ccc, 0xd20d8532, 0xe40ecf30, 0xf6b926ce,
+    0xfa0f3d65, 0xe8b8d49b, 0xdebb9e99, 0xcc0c7767, 0x91646c6e, 0x83d38590,
+    0xb5d0cf92, 0xa767266c, 0x4369e9e4, 0x51de001a, 0x67dd4a18, 0x756aa3e6,
+    0x2802b8ef, 0x3ab55111, 0x0cb61b13, 0x1e01f2ed, 0x65b0d9ac, 0x77073052,
+    0x41047a50, 0x53b393ae, 0x0edb88a7, 0x1c6c6159, 0x2a6f2b5b, 0x38d8c2a5,
+    0xdcd60d2d, 0xce61e4d3, 0xf862aed1, 0xead5472f, 0xb7bd5c26, 0xa50ab5d8,
+    0x9309ffda, 0x81be1624, 0x8d080d8f, 0x9fbfe471, 0xa9bcae73, 0xbb0b478d,
+    0xe6635c84, 0xf4d4b57a, 0xc2d7ff78, 0xd0601686, 0x346ed90e, 0x26d930f0,
+    0x10da7af2, 0x026d930c, 0x5f058805, 0x4db261fb, 0x7bb12bf9, 0x6906c207,
+    0x770730ea, 0x65b0d914, 0x53b39316, 0x41047ae8, 0x1c6c61e1, 0x0edb881f,
+    0x38d8c21d, 0x2a6f2be3, 0xce61e46b, 0xdcd60d95, 0xead54797, 0xf862ae69,
+    0xa50ab560, 0xb7bd5c9e, 0x81be169c, 0x9309ff62, 0x9fbfe4c9, 0x8d080d37,
+    0xbb0b4735, 0xa9bcaecb, 0xf4d4b5c2, 0xe6635c3c, 0xd060163e, 0xc2d7ffc0,
+    0x26d93048, 0x346ed9b6, 0x026d93b4, 0x10da7a4a, 0x4db26143, 0x5f0588bd,
+    0x6906c2bf, 0x7bb12b41, 0x9309ff38, 0x81be16c6, 0xb7bd5cc4, 0xa50ab53a,
+    0xf862ae33, 0xead547cd, 0xdcd60dcf, 0xce61e431, 0x2a6f2bb9, 0x38d8c247,
+    0x0edb8845, 0x1c6c61bb, 0x41047ab2, 0x53b3934c, 0x65b0d94e, 0x770730b0,
+    0x7bb12b1b, 0x6906c2e5, 0x5f0588e7, 0x4db26119, 0x10da7a10, 0x026d93ee,
+    0x346ed9ec, 0x26d93012, 0xc2d7ff9a, 0xd0601664, 0xe6635c66, 0xf4d4b598,
+    0xa9bcae91, 0xbb0b476f, 0x8d080d6d, 0x9fbfe493, 0x81be167e, 0x9309ff80,
+    0xa50ab582, 0xb7bd5c7c, 0xead54775, 0xf862ae8b, 0xce61e489, 0xdcd60d77,
+    0x38d8c2ff, 0x2a6f2b01, 0x1c6c6103, 0x0edb88fd, 0x53b393f4, 0x41047a0a,
+    0x77073008, 0x65b0d9f6, 0x6906c25d, 0x7bb12ba3, 0x4db261a1, 0x5f05885f,
+    0x026d9356, 0x10da7aa8, 0x26d930aa, 0x346ed954, 0xd06016dc, 0xc2d7ff22,
+    0xf4d4b520, 0xe6635cde, 0xbb0b47d7, 0xa9bcae29, 0x9fbfe42b, 0x8d080dd5,
+    0xf6b92694, 0xe40ecf6a, 0xd20d8568, 0xc0ba6c96, 0x9dd2779f, 0x8f659e61,
+    0xb966d463, 0xabd13d9d, 0x4fdff215, 0x5d681beb, 0x6b6b51e9, 0x79dcb817,
+    0x24b4a31e, 0x36034ae0, 0x000000e2, 0x12b7e91c, 0x1e01f2b7, 0x0cb61b49,
+    0x3ab5514b, 0x2802b8b5, 0x756aa3bc, 0x67dd4a42, 0x51de0040, 0x4369e9be,
+    0xa7672636, 0xb5d0cfc8, 0x83d385ca, 0x91646c34, 0xcc0c773d, 0xdebb9ec3,
+    0xe8b8d4c1, 0xfa0f3d3f, 0xe40ecfd2, 0xf6b9262c, 0xc0ba6c2e, 0xd20d85d0,
+    0x8f659ed9, 0x9dd27727, 0xabd13d25, 0xb966d4db, 0x5d681b53, 0x4fdff2ad,
+    0x79dcb8af, 0x6b6b5151, 0x36034a58, 0x24b4a3a6, 0x12b7e9a4, 0x0000005a,
+    0x0cb61bf1, 0x1e01f20f, 0x2802b80d, 0x3ab551f3, 0x67dd4afa, 0x756aa304,
+    0x4369e906, 0x51de00f8, 0xb5d0cf70, 0xa767268e, 0x91646c8c, 0x83d38572,
+    0xdebb9e7b, 0xcc0c7785, 0xfa0f3d87, 0xe8b8d479
+  },
+  {
+    0x00000000, 0x5a05dff2, 0xb40bbe94, 0xee0e6166, 0x97d2d9d9, 0xcdd7062b,
+    0x23d9674d, 0x79dcb8bf, 0x9abfb362, 0xc0ba6c90, 0x2eb40df6, 0x74b1d204,
+    0x0d6d6abb, 0x5768b549, 0xb966d42f, 0xe3630bdd, 0xa26771a6, 0xf862ae54,
+    0x166ccf32, 0x4c6910c0, 0x35b5a87f, 0x6fb0778d, 0x81be16eb, 0xdbbbc919,
+    0x38d8c2c4, 0x62dd1d36, 0x8cd37c50, 0xd6d6a3a2, 0xaf0a1b1d, 0xf50fc4ef,
+    0x1b01a589, 0x41047a7b, 0x9fbfe44c, 0xc5ba3bbe, 0x2bb45ad8, 0x71b1852a,
+    0x086d3d95, 0x5268e267, 0xbc668301, 0xe6635cf3, 0x0500572e, 0x5f0588dc,
+    0xb10be9ba, 0xeb0e3648, 0x92d28ef7, 0xc8d75105, 0x26d93063, 0x7cdcef91,
+    0x3dd895ea, 0x67dd4a18, 0x89d32b7e, 0xd3d6f48c, 0xaa0a4c33, 0xf00f93c1,
+    0x1e01f2a7, 0x44042d55, 0xa7672688, 0xfd62f97a, 0x136c981c, 0x496947ee,
+    0x30b5ff51, 0x6ab020a3, 0x84be41c5, 0xdebb9e37, 0xdf60ef1a, 0x856530e8,
+    0x6b6b518e, 0x316e8e7c, 0x48b236c3, 0x12b7e931, 0xfcb98857, 0xa6bc57a5,
+    0x45df5c78, 0x1fda838a, 0xf1d4e2ec, 0xabd13d1e, 0xd20d85a1, 0x88085a53,
+    0x66063b35, 0x3c03e4c7, 0x7d079ebc, 0x2702414e, 0xc90c2028, 0x9309ffda,
+    0xead54765, 0xb0d09897, 0x5edef9f1, 0x04db2603, 0xe7b82dde, 0xbdbdf22c,
+    0x53b3934a, 0x09b64cb8, 0x706af407, 0x2a6f2bf5, 0xc4614a93, 0x9e649561,
+    0x40df0b56, 0x1adad4a4, 0xf4d4b5c2, 0xaed16a30, 0xd70dd28f, 0x8d080d7d,
+    0x63066c1b, 0x3903b3e9, 0xda60b834, 0x806567c6, 0x6e6b06a0, 0x346ed952,
+    0x4db261ed, 0x17b7be1f, 0xf9b9df79, 0xa3bc008b, 0xe2b87af0, 0xb8bda502,
+    0x56b3c464, 0x0cb61b96, 0x756aa329, 0x2f6f7cdb, 0xc1611dbd, 0x9b64c24f,
+    0x7807c992, 0x22021660, 0xcc0c7706, 0x9609a8f4, 0xefd5104b, 0xb5d0cfb9,
+    0x5bdeaedf, 0x01db712d, 0x2802b861, 0x72076793, 0x9c0906f5, 0xc60cd907,
+    0xbfd061b8, 0xe5d5be4a, 0x0bdbdf2c, 0x51de00de, 0xb2bd0b03, 0xe8b8d4f1,
+    0x06b6b597, 0x5cb36a65, 0x256fd2da, 0x7f6a0d28, 0x91646c4e, 0xcb61b3bc,
+    0x8a65c9c7, 0xd0601635, 0x3e6e7753, 0x646ba8a1, 0x1db7101e, 0x47b2cfec,
+    0xa9bcae8a, 0xf3b97178, 0x10da7aa5, 0x4adfa557, 0xa4d1c431, 0xfed41bc3,
+    0x8708a37c, 0xdd0d7c8e, 0x33031de8, 0x6906c21a, 0xb7bd5c2d, 0xedb883df,
+    0x03b6e2b9, 0x59b33d4b, 0x206f85f4, 0x7a6a5a06, 0x94643b60, 0xce61e492,
+    0x2d02ef4f, 0x770730bd, 0x990951db, 0xc30c8e29, 0xbad03696, 0xe0d5e964,
+    0x0edb8802, 0x54de57f0, 0x15da2d8b, 0x4fdff279, 0xa1d1931f, 0xfbd44ced,
+    0x8208f452, 0xd80d2ba0, 0x36034ac6, 0x6c069534, 0x8f659ee9, 0xd560411b,
+    0x3b6e207d, 0x616bff8f, 0x18b74730, 0x42b298c2, 0xacbcf9a4, 0xf6b92656,
+    0xf762577b, 0xad678889, 0x4369e9ef, 0x196c361d, 0x60b08ea2, 0x3ab55150,
+    0xd4bb3036, 0x8ebeefc4, 0x6ddde419, 0x37d83beb, 0xd9d65a8d, 0x83d3857f,
+    0xfa0f3dc0, 0xa00ae232, 0x4e048354, 0x14015ca6, 0x550526dd, 0x0f00f92f,
+    0xe10e9849, 0xbb0b47bb, 0xc2d7ff04, 0x98d220f6, 0x76dc4190, 0x2cd99e62,
+    0xcfba95bf, 0x95bf4a4d, 0x7bb12b2b, 0x21b4f4d9, 0x58684c66, 0x026d9394,
+    0xec63f2f2, 0xb6662d00, 0x68ddb337, 0x32d86cc5, 0xdcd60da3, 0x86d3d251,
+    0xff0f6aee, 0xa50ab51c, 0x4b04d47a, 0x11010b88, 0xf2620055, 0xa867dfa7,
+    0x4669bec1, 0x1c6c6133, 0x65b0d98c, 0x3fb5067e, 0xd1bb6718, 0x8bbeb8ea,
+    0xcabac291, 0x90bf1d63, 0x7eb17c05, 0x24b4a3f7, 0x5d681b48, 0x076dc4ba,
+    0xe963a5dc, 0xb3667a2e, 0x500571f3, 0x0a00ae01, 0xe40ecf67, 0xbe0b1095,
+    0xc7d7a82a, 0x9dd277d8, 0x73dc16be, 0x29d9c94c
+  },
+  {
+    0x00000000, 0x53b393ef, 0xf76257e3, 0xa4d1c40c, 0xff0f6aa9, 0xacbcf946,
+    0x086d3d4a, 0x5bdeaea5, 0xa3bc00c7, 0xf00f9328, 0x54de5724, 0x076dc4cb,
+    0x5cb36a6e, 0x0f00f981, 0xabd13d8d, 0xf862ae62, 0x3fb506ac, 0x6c069543,
+    0xc8d7514f, 0x9b64c2a0, 0xc0ba6c05, 0x9309ffea, 0x37d83be6, 0x646ba809,
+    0x9c09066b, 0xcfba9584, 0x6b6b5188, 0x38d8c267, 0x63066cc2, 0x30b5ff2d,
+    0x94643b21, 0xc7d7a8ce, 0x7f6a0d5f, 0x2cd99eb0, 0x88085abc, 0xdbbbc953,
+    0x806567f6, 0xd3d6f419, 0x77073015, 0x24b4a3fa, 0xdcd60d98, 0x8f659e77,
+    0x2bb45a7b, 0x7807c994, 0x23d96731, 0x706af4de, 0xd4bb30d2, 0x8708a33d,
+    0x40df0bf3, 0x136c981c, 0xb7bd5c10, 0xe40ecfff, 0xbfd0615a, 0xec63f2b5,
+    0x48b236b9, 0x1b01a556, 0xe3630b34, 0xb0d098db, 0x14015cd7, 0x47b2cf38,
+    0x1c6c619d, 0x4fdff272, 0xeb0e367e, 0xb8bda591, 0xfd62f995, 0xaed16a7a,
+    0x0a00ae76, 0x59b33d99, 0x026d933c, 0x51de00d3, 0xf50fc4df, 0xa6bc5730,
+    0x5edef952, 0x0d6d6abd, 0xa9bcaeb1, 0xfa0f3d5e, 0xa1d193fb, 0xf2620014,
+    0x56b3c418, 0x050057f7, 0xc2d7ff39, 0x91646cd6, 0x35b5a8da, 0x66063b35,
+    0x3dd89590, 0x6e6b067f, 0xcabac273, 0x9909519c, 0x616bfffe, 0x32d86c11,
+    0x9609a81d, 0xc5ba3bf2, 0x9e649557, 0xcdd706b8, 0x6906c2b4, 0x3ab5515b,
+    0x8208f4ca, 0xd1bb6725, 0x756aa329, 0x26d930c6, 0x7d079e63, 0x2eb40d8c,
+    0x8a65c980, 0xd9d65a6f, 0x21b4f40d, 0x720767e2, 0xd6d6a3ee, 0x85653001,
+    0xdebb9ea4, 0x8d080d4b, 0x29d9c947, 0x7a6a5aa8, 0xbdbdf266, 0xee0e6189,
+    0x4adfa585, 0x196c366a, 0x42b298cf, 0x11010b20, 0xb5d0cf2c, 0xe6635cc3,
+    0x1e01f2a1, 0x4db2614e, 0xe963a542, 0xbad036ad, 0xe10e9808, 0xb2bd0be7,
+    0x166ccfeb, 0x45df5c04, 0x3ab55176, 0x6906c299, 0xcdd70695, 0x9e64957a,
+    0xc5ba3bdf, 0x9609a830, 0x32d86c3c, 0x616bffd3, 0x990951b1, 0xcabac25e,
+    0x6e6b0652, 0x3dd895bd, 0x66063b18, 0x35b5a8f7, 0x91646cfb, 0xc2d7ff14,
+    0x050057da, 0x56b3c435, 0xf2620039, 0xa1d193d6, 0xfa0f3d73, 0xa9bcae9c,
+    0x0d6d6a90, 0x5edef97f, 0xa6bc571d, 0xf50fc4f2, 0x51de00fe, 0x026d9311,
+    0x59b33db4, 0x0a00ae5b, 0xaed16a57, 0xfd62f9b8, 0x45df5c29, 0x166ccfc6,
+    0xb2bd0bca, 0xe10e9825, 0xbad03680, 0xe963a56f, 0x4db26163, 0x1e01f28c,
+    0xe6635cee, 0xb5d0cf01, 0x11010b0d, 0x42b298e2, 0x196c3647, 0x4adfa5a8,
+    0xee0e61a4, 0xbdbdf24b, 0x7a6a5a85, 0x29d9c96a, 0x8d080d66, 0xdebb9e89,
+    0x8565302c, 0xd6d6a3c3, 0x720767cf, 0x21b4f420, 0xd9d65a42, 0x8a65c9ad,
+    0x2eb40da1, 0x7d079e4e, 0x26d930eb, 0x756aa304, 0xd1bb6708, 0x8208f4e7,
+    0xc7d7a8e3, 0x94643b0c, 0x30b5ff00, 0x63066cef, 0x38d8c24a, 0x6b6b51a5,
+    0xcfba95a9, 0x9c090646, 0x646ba824, 0x37d83bcb, 0x9309ffc7, 0xc0ba6c28,
+    0x9b64c28d, 0xc8d75162, 0x6c06956e, 0x3fb50681, 0xf862ae4f, 0xabd13da0,
+    0x0f00f9ac, 0x5cb36a43, 0x076dc4e6, 0x54de5709, 0xf00f9305, 0xa3bc00ea,
+    0x5bdeae88, 0x086d3d67, 0xacbcf96b, 0xff0f6a84, 0xa4d1c421, 0xf76257ce,
+    0x53b393c2, 0x0000002d, 0xb8bda5bc, 0xeb0e3653, 0x4fdff25f, 0x1c6c61b0,
+    0x47b2cf15, 0x14015cfa, 0xb0d098f6, 0xe3630b19, 0x1b01a57b, 0x48b23694,
+    0xec63f298, 0xbfd06177, 0xe40ecfd2, 0xb7bd5c3d, 0x136c9831, 0x40df0bde,
+    0x8708a310, 0xd4bb30ff, 0x706af4f3, 0x23d9671c, 0x7807c9b9, 0x2bb45a56,
+    0x8f659e5a, 0xdcd60db5, 0x24b4a3d7, 0x77073038, 0xd3d6f434, 0x806567db,
+    0xdbbbc97e, 0x88085a91, 0x2cd99e9d, 0x7f6a0d72
+  }
+};
+
+/* Only the low 16 bits of the crc carry into the next bytes, for
+   both CRC functions. */
+#define CRC_SLICE8(table, dx, addr)                                           \
+  table[7][(addr)[0] ^ (dx & 0xFF)] ^ table[6][(addr)[1] ^ ((dx >> 8) & 0xFF)] \
+      ^ table[5][(addr)[2]] ^ table[4][(addr)[3]] ^ table[3][(addr)[4]]      \
+      ^ table[2][(addr)[5]] ^ table[1][(addr)[6]] ^ table[0][(addr)[7]]
+
 uint16_t
 bit_calc_CRC(const uint16_t seed, unsigned char *addr, long len)
 {
-  register unsigned char al;
-  register uint16_t dx = seed;
-
-  static const uint16_t crctable[256] =
-      { 0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241, 0xC601,
-        0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440, 0xCC01, 0x0CC0,
-        0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40, 0x0A00, 0xCAC1, 0xCB81,
-        0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841, 0xD801, 0x18C0, 0x1980, 0xD941,
-        0x1B00, 0xDBC1, 0xDA81, 0x1A40, 0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01,
-        0x1DC0, 0x1C80, 0xDC41, 0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0,
-        0x1680, 0xD641, 0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081,
-        0x1040, 0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
-        0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441, 0x3C00,
-        0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41, 0xFA01, 0x3AC0,
-        0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840, 0x2800, 0xE8C1, 0xE981,
-        0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41, 0xEE01, 0x2EC0, 0x2F80, 0xEF41,
-        0x2D00, 0xEDC1, 0xEC81, 0x2C40, 0xE401, 0x24C0, 0x2580, 0xE541, 0x2700,
-        0xE7C1, 0xE681, 0x2640, 0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0,
-        0x2080, 0xE041, 0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281,
-        0x6240, 0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
-        0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41, 0xAA01,
-        0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840, 0x7800, 0xB8C1,
-        0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41, 0xBE01, 0x7EC0, 0x7F80,
-        0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40, 0xB401, 0x74C0, 0x7580, 0xB541,
-        0x7700, 0xB7C1, 0xB681, 0x7640, 0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101,
-        0x71C0, 0x7080, 0xB041, 0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0,
-        0x5280, 0x9241, 0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481,
-        0x5440, 0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
-        0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841, 0x8801,
-        0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40, 0x4E00, 0x8EC1,
-        0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41, 0x4400, 0x84C1, 0x8581,
-        0x4540, 0x8701, 0x47C0, 0x4680, 0x8641, 0x8201, 0x42C0, 0x4380, 0x8341,
-        0x4100, 0x81C1, 0x8081, 0x4040 };
+  uint16_t dx = seed;
 
+  for (; len >= 8; len -= 8, addr += 8)
+    dx = CRC_SLICE8(crc16_table, dx, addr);
   for (; len > 0; len--)
     {
-      al = (unsigned char) ((*addr) ^ ((unsigned char) (dx & 0xFF)));
-      dx = ((dx >> 8) & 0xFF) ^ crctable[al];
+      unsigned char al = (unsigned char) ((*addr) ^ ((unsigned char) (dx & 0xFF)));
+      dx = ((dx >> 8) & 0xFF) ^ crc16_table[0][al];
       addr++;
     }
   return dx;
@@ -1747,81 +3099,14 @@ bit_calc_CRC(const uint16_t seed, unsigned char *addr, long len)
 uint32_t
 bit_calc_CRC32(const uint32_t seed, unsigned char *addr, long len)
 {
-  register unsigned char al;
-  register uint32_t dx = ~seed; /* inverted */
-
-  static const uint32_t crctable[256] =
-    {
-      0x00000000, 0x77073096, 0xee0e612c, 0x990951ba,
-      0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
-      0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
-      0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
-      0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de,
-      0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
-      0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec,
-      0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
-      0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
-      0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
-      0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940,
-      0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
-      0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116,
-      0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
-      0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
-      0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
-      0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a,
-      0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
-      0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818,
-      0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
-      0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
-      0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
-      0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c,
-      0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
-      0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2,
-      0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
-      0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
-      0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
-      0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086,
-      0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
-      0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4,
-      0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
-      0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
-      0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
-      0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8,
-      0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
-      0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe,
-      0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
-      0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
-      0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
-      0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252,
-      0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
-      0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60,
-      0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
-      0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
-      0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
-      0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04,
-      0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
-      0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a,
-      0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
-      0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
-      0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
-      0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e,
-      0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
-      0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c,
-      0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
-      0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
-      0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
-      0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0,
-      0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
-      0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6,
-      0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
-      0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
-      0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
-    };
+  uint32_t dx = ~seed; /* inverted */
 
+  for (; len >= 8; len -= 8, addr += 8)
+    dx = CRC_SLICE8(crc32_table, dx, addr);
   for (; len > 0; len--)
     {
-      al = (unsigned char) ((*addr) ^ ((unsigned char) (dx & 0xFF)));
-      dx = ((dx >> 8) & 0xFF) ^ crctable[al];
+      unsigned char al = (unsigned char) ((*addr) ^ ((unsigned char) (dx & 0xFF)));
+      dx = ((dx >> 8) & 0xFF) ^ crc32_table[0][al];
       addr++;
     }
   return ~dx;
@@ -55,7 +55,7 @@ typedef struct _bit_chain
   long unsigned int size;
   long unsigned int byte;
   unsigned char bit;
-  FILE *fh;
+  FILE *fh; // the out_* output, or the encoder's mapped file
   Dwg_Version_Type version;
   Dwg_Version_Type from_version;
 } Bit_Chain;
@@ -297,12 +297,22 @@ bit_write_EMC(Bit_Chain *restrict dat, Dwg_Color *restrict color);
 int
 bit_search_sentinel(Bit_Chain *dat, unsigned char sentinel[16]);
 
+int
+bit_search_sentinels(const Bit_Chain *dat, unsigned char *const sentinels[],
+                     int num, unsigned long *found);
+
 void
 bit_write_sentinel(Bit_Chain *dat, unsigned char sentinel[16]);
 
+void
+bit_chain_init(Bit_Chain *dat, const size_t size);
+
 void
 bit_chain_alloc(Bit_Chain *dat);
 
+int
+bit_chain_free(Bit_Chain *dat);
+
 void
 bit_print(Bit_Chain *dat, long unsigned int size);
 
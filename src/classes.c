@@ -0,0 +1,71 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * classes.c: the resolved classes.inc entries of a drawing.
+ *            Kept in a table beside dwg->dwg_class, indexed like it,
+ *            so that Dwg_Class keeps its public layout.
+ */
+
+#include "classes.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct _dwg_class_dispatch
+{
+  BITCODE_BS num_classes;
+  unsigned short entry[1]; // num_classes entries
+};
+
+/* the first classes.inc entry matching the names of klass */
+static Dwg_Class_Dispatch
+dwg_resolve_class(const Dwg_Class *restrict klass)
+{
+  if (!klass->dxfname)
+    return DWG_CLASS_UNKNOWN;
+
+  #define CLASSES_RESOLVE
+  #include "classes.inc"
+  #undef CLASSES_RESOLVE
+
+  return DWG_CLASS_UNKNOWN;
+}
+
+void
+dwg_resolve_classes(Dwg_Data *restrict dwg)
+{
+  Dwg_Class_Dispatches *table = dwg->class_dispatch;
+  BITCODE_BS i;
+
+  if (!dwg->num_classes || !dwg->dwg_class)
+    return;
+  if (!table || table->num_classes < dwg->num_classes)
+    {
+      table = realloc(table, sizeof(Dwg_Class_Dispatches)
+                      + dwg->num_classes * sizeof(table->entry[0]));
+      if (!table)
+        return; // the lookups then resolve each time
+      dwg->class_dispatch = table;
+    }
+  table->num_classes = dwg->num_classes;
+  for (i = 0; i < dwg->num_classes; i++)
+    table->entry[i] = (unsigned short)dwg_resolve_class(&dwg->dwg_class[i]);
+}
+
+Dwg_Class_Dispatch
+dwg_class_dispatch(const Dwg_Data *restrict dwg, const int i)
+{
+  const Dwg_Class_Dispatches *table = dwg->class_dispatch;
+  if (table && i < (int)table->num_classes)
+    return (Dwg_Class_Dispatch)table->entry[i];
+  return dwg_resolve_class(&dwg->dwg_class[i]);
+}
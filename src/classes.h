@@ -0,0 +1,47 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+#ifndef CLASSES_H
+#define CLASSES_H
+
+/*
+ * classes.h: the entries of the classes.inc dispatcher.
+ *
+ * Each class is resolved once by its dxfname (or cppname) to one of
+ * these entries, and stored in the private dwg->class_dispatch table.
+ * The dispatchers then switch over it, instead of comparing the names
+ * for every object.
+ */
+#include "dwg.h"
+
+typedef enum DWG_CLASS_DISPATCH
+{
+  DWG_CLASS_UNRESOLVED = 0,
+#define CLASSES_ENUM
+#include "classes.inc"
+#undef CLASSES_ENUM
+  DWG_CLASS_UNKNOWN
+} Dwg_Class_Dispatch;
+
+typedef struct _dwg_class_dispatch Dwg_Class_Dispatches;
+
+/* Resolves all classes of the drawing, again after they changed.
+   Call it before decoding objects in parallel. */
+void
+dwg_resolve_classes(Dwg_Data *restrict dwg);
+
+/* Returns the entry of the class dwg->dwg_class[i]. A class not resolved
+   by dwg_resolve_classes() is looked up by its names each time. */
+Dwg_Class_Dispatch
+dwg_class_dispatch(const Dwg_Data *restrict dwg, const int i);
+
+#endif
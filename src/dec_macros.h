@@ -365,7 +365,7 @@
       bit_fprint_bits(stderr, (unsigned char*)tmp, 68); fprintf(stderr,"\n"); \
     } \
     LOG_TRACE_TF(tmp, 24);\
-    free(tmp); \
+    arena_release(tmp); \
     SINCE(R_13) {\
       *dat = here;\
       LOG_TRACE("  B  :"FORMAT_B"\t", bit_read_B(dat));\
@@ -445,7 +445,7 @@
   if (size > 0) \
     { \
       VECTOR_CHKCOUNT(name,type,size) \
-      _obj->name = (BITCODE_##type*) calloc(size, sizeof(BITCODE_##type)); \
+      _obj->name = (BITCODE_##type*) arena_calloc(size, sizeof(BITCODE_##type)); \
       for (vcount=0; vcount<(BITCODE_BL)size; vcount++) \
         {\
           _obj->name[vcount] = bit_read_##type(dat); \
@@ -457,7 +457,7 @@
   if (_obj->size > 0) \
     { \
       _VECTOR_CHKCOUNT(name,_obj->size,dat->version>=R_2007 ? 18 : 2) \
-      _obj->name = calloc(_obj->size, sizeof(char*)); \
+      _obj->name = arena_calloc(_obj->size, sizeof(char*)); \
       for (vcount=0; vcount<(BITCODE_BL)_obj->size; vcount++) \
         {\
           PRE (R_2007) { \
@@ -475,7 +475,7 @@
     { \
       int _dxf = dxf;\
       VECTOR_CHKCOUNT(name,type,size) \
-      _obj->name = (BITCODE_##type*) calloc(size, sizeof(BITCODE_##type)); \
+      _obj->name = (BITCODE_##type*) arena_calloc(size, sizeof(BITCODE_##type)); \
       for (vcount=0; vcount<(BITCODE_BL)size; vcount++) \
         {\
           _obj->name[vcount] = bit_read_##type(dat); \
@@ -490,7 +490,7 @@
   VECTOR_CHKCOUNT(name,2RD,_obj->size) \
   if (_obj->size > 0) \
     { \
-      _obj->name = (BITCODE_2RD *) calloc(_obj->size, sizeof(BITCODE_2RD)); \
+      _obj->name = (BITCODE_2RD *) arena_calloc(_obj->size, sizeof(BITCODE_2RD)); \
       for (vcount=0; vcount< (BITCODE_BL)_obj->size; vcount++)\
         {\
           FIELD_2RD(name[vcount], dxf); \
@@ -501,7 +501,7 @@
   VECTOR_CHKCOUNT(name,2DD,_obj->size) \
   if (_obj->size > 0) \
     { \
-      _obj->name = (BITCODE_2RD *) calloc(_obj->size, sizeof(BITCODE_2RD)); \
+      _obj->name = (BITCODE_2RD *) arena_calloc(_obj->size, sizeof(BITCODE_2RD)); \
       FIELD_2RD(name[0], dxf); \
       for (vcount = 1; vcount < (BITCODE_BL)_obj->size; vcount++)\
         {\
@@ -516,7 +516,7 @@
   VECTOR_CHKCOUNT(name,3BD,_obj->size) \
   if (_obj->size > 0) \
     { \
-      _obj->name = (BITCODE_3DPOINT *) calloc(_obj->size, sizeof(BITCODE_3DPOINT)); \
+      _obj->name = (BITCODE_3DPOINT *) arena_calloc(_obj->size, sizeof(BITCODE_3DPOINT)); \
       for (vcount=0; vcount < (BITCODE_BL)_obj->size; vcount++) \
         {\
           FIELD_3DPOINT(name[vcount], dxf); \
@@ -527,7 +527,7 @@
 #define HANDLE_VECTOR_N(name, size, code, dxf) \
   if (size > 0) \
     { \
-      FIELD_VALUE(name) = (BITCODE_H*) calloc(size, sizeof(BITCODE_H)); \
+      FIELD_VALUE(name) = (BITCODE_H*) arena_calloc(size, sizeof(BITCODE_H)); \
       for (vcount=0; vcount < (BITCODE_BL)size; vcount++) \
         {\
           FIELD_HANDLE_N(name[vcount], vcount, code, dxf);  \
@@ -563,7 +563,7 @@
   if (obj->tio.object->num_reactors > 0) \
     { \
       VECTOR_CHKCOUNT(reactors, HANDLE, obj->tio.object->num_reactors) \
-      obj->tio.object->reactors = calloc(obj->tio.object->num_reactors, sizeof(BITCODE_H)); \
+      obj->tio.object->reactors = arena_calloc(obj->tio.object->num_reactors, sizeof(BITCODE_H)); \
       for (vcount=0; vcount < obj->tio.object->num_reactors; vcount++) \
         {\
           VALUE_HANDLE_N(obj->tio.object->reactors[vcount], reactors, vcount, code, 330); \
@@ -574,7 +574,7 @@
   if (_ent->num_reactors > 0) \
     { \
       VECTOR_CHKCOUNT(reactors, HANDLE, _ent->num_reactors) \
-      _ent->reactors = calloc(_ent->num_reactors, sizeof(BITCODE_H)); \
+      _ent->reactors = arena_calloc(_ent->num_reactors, sizeof(BITCODE_H)); \
       for (vcount=0; vcount < _ent->num_reactors; vcount++) \
         { \
           VALUE_HANDLE_N(_ent->reactors[vcount], reactors, vcount, code, 330); \
@@ -665,20 +665,20 @@
 
 // unchecked with a constant
 #define REPEAT_CN(times, name, type) \
-  if (times > 0) _obj->name = (type *) calloc(times, sizeof(type)); \
+  if (times > 0) _obj->name = (type *) arena_calloc(times, sizeof(type)); \
   for (rcount1=0; rcount1<(BITCODE_BL)times; rcount1++)
 #define REPEAT_N(times, name, type) \
   REPEAT_CHKCOUNT(name,times,type) \
-  if (times > 0) _obj->name = (type *) calloc(times, sizeof(type)); \
+  if (times > 0) _obj->name = (type *) arena_calloc(times, sizeof(type)); \
   for (rcount1=0; rcount1<(BITCODE_BL)times; rcount1++)
 
 #define _REPEAT(times, name, type, idx) \
   REPEAT_CHKCOUNT_LVAL(name,_obj->times,type) \
-  if (_obj->times > 0) _obj->name = (type *) calloc(_obj->times, sizeof(type)); \
+  if (_obj->times > 0) _obj->name = (type *) arena_calloc(_obj->times, sizeof(type)); \
   for (rcount##idx=0; rcount##idx<(BITCODE_BL)_obj->times; rcount##idx++)
 #define _REPEAT_C(times, name, type, idx) \
   REPEAT_CHKCOUNT_LVAL(name,_obj->times,type) \
-  if (_obj->times > 0) _obj->name = (type *) calloc(_obj->times, sizeof(type)); \
+  if (_obj->times > 0) _obj->name = (type *) arena_calloc(_obj->times, sizeof(type)); \
   for (rcount##idx=0; rcount##idx<(BITCODE_BL)_obj->times; rcount##idx++)
 #define _REPEAT_N(times, name, type, idx) \
   if (_obj->name) \
@@ -706,13 +706,17 @@
     Returns 0 or DWG_ERR_OUTOFMEM.
 */
 
+#ifndef DWG_COUNT_ENTITY
+# define DWG_COUNT_ENTITY(dwg) (dwg)->num_entities++
+#endif
+
 #define DWG_ENTITY(token) \
 EXPORT int dwg_add_##token (Dwg_Object *obj) \
 { \
   Dwg_Object_Entity *_ent; \
   Dwg_Entity_##token *_obj; \
   LOG_INFO("Add entity " #token " ")\
-  obj->parent->num_entities++;\
+  DWG_COUNT_ENTITY(obj->parent);\
   obj->supertype = DWG_SUPERTYPE_ENTITY;\
   if (!(int)obj->fixedtype)\
     obj->fixedtype = DWG_TYPE_##token;\
@@ -722,9 +726,9 @@ EXPORT int dwg_add_##token (Dwg_Object *obj) \
     else \
       obj->dxfname = (char*)#token; \
   } \
-  _ent = obj->tio.entity = calloc(1, sizeof(Dwg_Object_Entity));\
+  _ent = obj->tio.entity = arena_calloc(1, sizeof(Dwg_Object_Entity));\
   if (!_ent) return DWG_ERR_OUTOFMEM; \
-  _ent->tio.token = calloc(1, sizeof (Dwg_Entity_##token));\
+  _ent->tio.token = arena_calloc(1, sizeof (Dwg_Entity_##token));\
   if (!_ent->tio.token) return DWG_ERR_OUTOFMEM; \
   _ent->dwg = obj->parent; \
   _ent->objid = obj->index; /* obj ptr itself might move */ \
@@ -797,11 +801,11 @@ EXPORT int dwg_add_##token (Dwg_Object *obj) \
   Dwg_Object_##token *_obj;\
   LOG_INFO("Add object " #token " ")\
   obj->supertype = DWG_SUPERTYPE_OBJECT;\
-  obj->tio.object = calloc (1, sizeof(Dwg_Object_Object)); \
+  obj->tio.object = arena_calloc (1, sizeof(Dwg_Object_Object)); \
   if (!obj->tio.object) return DWG_ERR_OUTOFMEM; \
-  _obj = obj->tio.object->tio.token = calloc (1, sizeof(Dwg_Object_##token)); \
+  _obj = obj->tio.object->tio.token = arena_calloc (1, sizeof(Dwg_Object_##token)); \
   if (!_obj) { \
-    free (obj->tio.object); \
+    arena_release(obj->tio.object); \
     obj->tio.object = NULL; \
     obj->fixedtype = DWG_TYPE_FREED; \
     return DWG_ERR_OUTOFMEM; \
@@ -33,12 +33,19 @@
 #ifdef HAVE_WCHAR_H
 # include <wchar.h>
 #endif
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
 
 #include "common.h"
 #include "bits.h"
 #include "dwg.h"
+#include "classes.h"
 #include "hash.h"
+#include "arena.h"
 #include "decode.h"
+#include "decompress.h"
+#include "threads.h"
 #include "print.h"
 #include "free.h"
 
@@ -54,11 +61,62 @@ static bool env_var_checked_p;
 #endif  /* USE_TRACING */
 #define DWG_LOGLEVEL loglevel
 
+#define REFS_PER_REALLOC 128
+/* the first and the largest object_ref slab */
+#define REFS_PER_SLAB 256
+#define MAX_REFS_PER_SLAB 65536
+
+#ifdef USE_THREADS
+/* A range of objects decoded by one thread, with its own object_ref
+   buffer. The buffers are appended to dwg->object_ref in range order,
+   which gives the same order as the serial decoder. */
+typedef struct _decode_range
+{
+  BITCODE_BL from;
+  BITCODE_BL to;
+  Dwg_Object_Ref **object_ref;
+  BITCODE_BL num_object_refs;
+  BITCODE_BL num_alloced_object_refs;
+  Dwg_Ref_Slab *ref_slab;
+  Dwg_Arena *arena;
+  BITCODE_BL num_entities;
+  int error;
+} Decode_Range;
+
+static pthread_key_t decode_range_key;
+static pthread_once_t decode_range_once = PTHREAD_ONCE_INIT;
+static int decode_range_key_ok;
+
+static void
+decode_range_key_init(void)
+{
+  decode_range_key_ok = !pthread_key_create(&decode_range_key, NULL);
+}
+
+/* The range decoded by the current worker thread, or NULL */
+static inline Decode_Range *
+decode_current_range(void)
+{
+  return decode_range_key_ok
+    ? (Decode_Range *)pthread_getspecific(decode_range_key)
+    : NULL;
+}
+
+static void
+decode_count_entity(Dwg_Data *restrict dwg)
+{
+  Decode_Range *range = decode_current_range();
+  if (range)
+    range->num_entities++;
+  else
+    dwg->num_entities++;
+}
+# define DWG_COUNT_ENTITY(dwg) decode_count_entity(dwg)
+#endif
+
 #include "logging.h"
 #include "dec_macros.h"
 
-#define REFS_PER_REALLOC 128
-
 #define MAX(X,Y) ((X) > (Y) ? (X) : (Y))
 #define MIN(X,Y) ((X) < (Y) ? (X) : (Y))
 
@@ -69,6 +127,9 @@ static bool env_var_checked_p;
 static int
 resolve_objectref_vector(Bit_Chain* dat, Dwg_Data * dwg);
 
+static int
+dwg_reserve_objects(Dwg_Data *restrict dwg, BITCODE_BL num);
+
 static void
 decode_preR13_section_ptr(const char* name, Dwg_Section_Type_r11 id,
                           Bit_Chain* dat, Dwg_Data * dwg);
@@ -86,6 +147,9 @@ decode_preR13(Bit_Chain* dat, Dwg_Data * dwg);
 static int
 decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg);
 static int
+at_sentinel(Bit_Chain* dat, const unsigned long *sentinel_pos,
+            Dwg_Sentinel sentinel);
+static int
 decode_R2004(Bit_Chain* dat, Dwg_Data * dwg);
 static int
 decode_R2007(Bit_Chain* dat, Dwg_Data * dwg);
@@ -126,9 +190,14 @@ dwg_decode(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
   char version[7];
 
   dwg->num_object_refs = 0;
+  dwg->num_alloced_object_refs = 0;
+  dwg->ref_slab = NULL;
+  dwg->arena = NULL;
+  dwg->lazy = NULL;
   //dwg->num_layers = 0; // see now dwg->layer_control->num_entries
   dwg->num_entities = 0;
   dwg->num_objects = 0;
+  dwg->num_alloced_objects = 0;
   dwg->num_classes = 0;
   dwg->picture.size = 0;
   dwg->picture.chain = NULL;
@@ -281,16 +350,14 @@ decode_preR13_section(Dwg_Section_Type_r11 id, Bit_Chain *restrict dat, Dwg_Data
   BITCODE_BL vcount;
   int error = 0;
   long unsigned int num = dwg->num_objects;
-  long unsigned int old_size = num * sizeof(Dwg_Object);
-  long unsigned int size = tbl->number * sizeof(Dwg_Object);
   long unsigned int pos;
 
   LOG_TRACE("\ncontents table %-8s [%2d]: size:%-4u nr:%-3ld (0x%x-0x%lx)\n",
             tbl->name, id, tbl->size, tbl->number, tbl->address,
             (long)(tbl->address + tbl->number * tbl->size))
   dat->byte = tbl->address;
-  if (dwg->num_objects % REFS_PER_REALLOC == 0)
-    dwg->object = realloc(dwg->object, old_size + size + REFS_PER_REALLOC);
+  if (dwg_reserve_objects(dwg, num + tbl->number) > 0)
+    return DWG_ERR_OUTOFMEM;
 
   // TODO: move to a spec dwg_r11.spec, and dwg_decode_r11_NAME
 #define PREP_TABLE(name)\
@@ -742,6 +809,19 @@ decode_preR13(Bit_Chain* dat, Dwg_Data * dwg)
   return 0;
 }
 
+/* Positions dat immediately after a sentinel found by bit_search_sentinels
+   and returns -1, or returns 0, as bit_search_sentinel */
+static int
+at_sentinel(Bit_Chain* dat, const unsigned long *sentinel_pos,
+            Dwg_Sentinel sentinel)
+{
+  if (!sentinel_pos[sentinel])
+    return 0;
+  dat->byte = sentinel_pos[sentinel];
+  dat->bit = 0;
+  return -1;
+}
+
 static int
 decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
 {
@@ -757,6 +837,8 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
   long unsigned int object_end;
   long unsigned int pvz;
   BITCODE_BL j, k;
+  Dwg_Object_Offsets offsets = { 0 };
+  unsigned long sentinel_pos[DWG_SENTINEL_SECOND_HEADER_END + 1];
   int error = 0;
 
   {
@@ -802,10 +884,11 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
     }
 
   // Check CRC
-  crc = bit_calc_CRC(0xC0C1, dat->chain, dat->byte);
+  crc = (dwg->opts & DWG_OPTS_NOCRC)
+    ? 0 : bit_calc_CRC(0xC0C1, dat->chain, dat->byte);
   crc2 = bit_read_RS(dat);
   LOG_TRACE("crc: %04X [RSx]\n", crc2);
-  if (crc != crc2)
+  if (crc != crc2 && !(dwg->opts & DWG_OPTS_NOCRC))
     {
       LOG_ERROR("Header CRC mismatch %04X <=> %04X", crc, crc2);
       //if (dwg->header.version != R_2000)
@@ -819,7 +902,30 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
       error |= DWG_ERR_WRONGCRC;
     }
 
-  if (bit_search_sentinel(dat, dwg_sentinel(DWG_SENTINEL_HEADER_END)))
+  /* Find the sentinels read below in one scan of the file. The header
+     variables and classes are read at their section address. */
+  {
+    static const Dwg_Sentinel used[] = {
+      DWG_SENTINEL_HEADER_END,
+      DWG_SENTINEL_PICTURE_BEGIN,
+      DWG_SENTINEL_PICTURE_END,
+      DWG_SENTINEL_SECOND_HEADER_BEGIN,
+      DWG_SENTINEL_SECOND_HEADER_END
+    };
+    const int num_used = (int)(sizeof(used) / sizeof(used[0]));
+    unsigned char *sentinels[sizeof(used) / sizeof(used[0])];
+    unsigned long found[sizeof(used) / sizeof(used[0])];
+    int s;
+
+    for (s = 0; s < num_used; s++)
+      sentinels[s] = dwg_sentinel(used[s]);
+    bit_search_sentinels(dat, sentinels, num_used, found);
+    memset(sentinel_pos, 0, sizeof(sentinel_pos));
+    for (s = 0; s < num_used; s++)
+      sentinel_pos[used[s]] = found[s];
+  }
+
+  if (at_sentinel(dat, sentinel_pos, DWG_SENTINEL_HEADER_END))
     LOG_TRACE("\n=======> HEADER (end): %8X\n", (unsigned int) dat->byte)
 
   /*-------------------------------------------------------------------------
@@ -849,7 +955,7 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
    * Picture (Pre-R13C3?)
    */
 
-  if (bit_search_sentinel(dat, dwg_sentinel(DWG_SENTINEL_PICTURE_BEGIN)))
+  if (at_sentinel(dat, sentinel_pos, DWG_SENTINEL_PICTURE_BEGIN))
     {
       unsigned long int start_address;
 
@@ -857,7 +963,7 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
       start_address = dat->byte;
       LOG_TRACE("\n=======> PICTURE: %8X\n",
             (unsigned int) start_address - 16)
-      if (bit_search_sentinel(dat, dwg_sentinel(DWG_SENTINEL_PICTURE_END)))
+      if (at_sentinel(dat, sentinel_pos, DWG_SENTINEL_PICTURE_END))
         {
           LOG_TRACE("         PICTURE (end): %8X\n",
                 (unsigned int) dat->byte)
@@ -896,7 +1002,8 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
   LOG_TRACE("HEADER_R13.address 0x%lx\n", pvz);
   LOG_TRACE("HEADER_R13.size %d\n", dwg->header.section[SECTION_HEADER_R13].size);
   // typical sizes: 400-599
-  if (dwg->header.section[SECTION_HEADER_R13].size < 0xfff &&
+  if (!(dwg->opts & DWG_OPTS_NOCRC) &&
+      dwg->header.section[SECTION_HEADER_R13].size < 0xfff &&
       pvz < dat->byte &&
       pvz + dwg->header.section[SECTION_HEADER_R13].size < dat->size)
     {
@@ -904,7 +1011,7 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
       crc2 = bit_calc_CRC(0xC0C1, &(dat->chain[pvz]),
                           dwg->header.section[SECTION_HEADER_R13].size - 34);
     }
-  if (crc != crc2)
+  if (crc != crc2 && !(dwg->opts & DWG_OPTS_NOCRC))
     {
       LOG_WARN("Section[%ld] CRC mismatch %04X <=> %04X",
                dwg->header.section[SECTION_HEADER_R13].number, crc, crc2);
@@ -986,6 +1093,7 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
         }
     }
   while (dat->byte < (lasta - 1));
+  dwg_resolve_classes(dwg);
 
   // Check CRC-on
   dat->byte = dwg->header.section[SECTION_CLASSES_R13].address
@@ -994,14 +1102,16 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
   crc = bit_read_RS(dat);
   LOG_TRACE("crc: %04X [RSx]\n", crc);
   pvz = dwg->header.section[SECTION_CLASSES_R13].address + 16;
-  if (dwg->header.section[SECTION_CLASSES_R13].size < 0xfff &&
+  if (!(dwg->opts & DWG_OPTS_NOCRC) &&
+      dwg->header.section[SECTION_CLASSES_R13].size < 0xfff &&
       pvz < dat->byte &&
       pvz + dwg->header.section[SECTION_CLASSES_R13].size < dat->size)
     {
       crc2 = bit_calc_CRC(0xC0C1, &(dat->chain[pvz]),
                       dwg->header.section[SECTION_CLASSES_R13].size - 34);
     }
-  if (crc != crc2 && dwg->header.version != R_2000)
+  if (crc != crc2 && dwg->header.version != R_2000
+      && !(dwg->opts & DWG_OPTS_NOCRC))
     {
       LOG_ERROR("Section[%ld] CRC mismatch %04X <=> %04X",
                 dwg->header.section[SECTION_CLASSES_R13].number, crc, crc2);
@@ -1033,7 +1143,6 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
       long unsigned int last_offset;
       //long unsigned int last_handle;
       long unsigned int oldpos = 0;
-      int added;
       startpos = dat->byte;
 
       section_size = bit_read_RS_LE(dat);
@@ -1041,6 +1150,7 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
       if (section_size > 2040)
         {
           LOG_ERROR("Object-map section size greater than 2040!")
+          free(offsets.address);
           return DWG_ERR_VALUEOUTOFBOUNDS;
         }
 
@@ -1056,7 +1166,7 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
           offset = bit_read_MC(dat);
           //last_handle += handle;
           last_offset += offset;
-          LOG_TRACE("\nNext object: %lu\t", (unsigned long)dwg->num_objects)
+          LOG_TRACE("\nNext object: %lu\t", (unsigned long)offsets.num)
           LOG_TRACE("Handle: %lX\tOffset: " FORMAT_MC " @%lu\n",
                     handle, offset, last_offset)
 
@@ -1068,9 +1178,7 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
           if (object_begin > last_offset)
             object_begin = last_offset;
 
-          added = dwg_decode_add_object(dwg, dat, dat, last_offset);
-          if (added > 0)
-            error |= added; // else not added (skipped) or -1 for re-allocated
+          error |= dwg_add_object_offset(&offsets, last_offset);
 #if 0
           kobj = dwg->num_objects;
           if (dwg->num_objects > kobj)
@@ -1090,7 +1198,8 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
 
       crc = bit_read_RS_LE(dat);
       LOG_TRACE("crc: %04X\n", crc);
-      crc2 = bit_calc_CRC(0xC0C1, dat->chain + startpos, section_size);
+      crc2 = (dwg->opts & DWG_OPTS_NOCRC)
+        ? crc : bit_calc_CRC(0xC0C1, dat->chain + startpos, section_size);
       if (crc != crc2)
         {
           LOG_ERROR("Section CRC mismatch %04X <=> %04X", crc, crc2);
@@ -1106,6 +1215,10 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
     }
   while (section_size > 2);
 
+  /* Now decode all objects, with the object array reserved once */
+  error |= dwg_decode_add_objects(dwg, dat, dat, &offsets);
+  free(offsets.address);
+
   LOG_INFO("Num objects: %lu\n", (unsigned long)dwg->num_objects)
   LOG_INFO("\n"
            "=======> Object Data 2 (start)  : %8lX\n",
@@ -1153,7 +1266,7 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
    * But partially also since r2004.
    */
 
-  if (bit_search_sentinel(dat, dwg_sentinel(DWG_SENTINEL_SECOND_HEADER_BEGIN)))
+  if (at_sentinel(dat, sentinel_pos, DWG_SENTINEL_SECOND_HEADER_BEGIN))
     {
       int i;
       BITCODE_RC sig, sig2;
@@ -1240,7 +1353,7 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
         }
       }
 
-      if (bit_search_sentinel(dat, dwg_sentinel(DWG_SENTINEL_SECOND_HEADER_END)))
+      if (at_sentinel(dat, sentinel_pos, DWG_SENTINEL_SECOND_HEADER_END))
         LOG_INFO("         Second Header 3 (end)  : %8X\n",
                  (unsigned int) dat->byte)
     }
@@ -1271,6 +1384,36 @@ decode_R13_R2000(Bit_Chain* dat, Dwg_Data * dwg)
   return error;
 }
 
+/* Maps every object to the first object_ref resolving to it,
+   for dwg_find_objectref. Without it, for objects added later, or
+   for objects without a ref then, dwg_find_objectref falls back to
+   scanning all object_refs. */
+static void
+build_object_ref_index(Dwg_Data *restrict dwg)
+{
+  BITCODE_BL i;
+
+  if (dwg->num_object_ref_index != dwg->num_objects)
+    {
+      free(dwg->object_ref_index);
+      dwg->num_object_ref_index = 0;
+      dwg->object_ref_index = (Dwg_Object_Ref **)calloc(dwg->num_objects,
+                                  sizeof(Dwg_Object_Ref *));
+      if (!dwg->object_ref_index)
+        return;
+      dwg->num_object_ref_index = dwg->num_objects;
+    }
+  else if (dwg->object_ref_index)
+    memset(dwg->object_ref_index, 0,
+           dwg->num_objects * sizeof(Dwg_Object_Ref *));
+  for (i = 0; i < dwg->num_object_refs; i++)
+    {
+      Dwg_Object *obj = dwg->object_ref[i]->obj;
+      if (obj && !dwg->object_ref_index[obj->index])
+        dwg->object_ref_index[obj->index] = dwg->object_ref[i];
+    }
+}
+
 static int
 resolve_objectref_vector(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
 {
@@ -1305,6 +1448,11 @@ resolve_objectref_vector(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
             LOG_TRACE("Null object pointer: object_ref[%ld]\n", (long)i)
         }
     }
+  build_object_ref_index(dwg);
+  // the deferred entities can now be decoded, explicitly only, by
+  // dwg_decode_lazy_object() or dwg_decode_lazy_objects()
+  if (dwg->lazy)
+    dwg->lazy->ready = 1;
   return dwg->num_object_refs ? 0 : DWG_ERR_VALUEOUTOFBOUNDS;
 }
 
@@ -1312,9 +1460,9 @@ resolve_objectref_vector(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
  * Silent variant of dwg_resolve_handle
  */
 static Dwg_Object *
-dwg_resolve_handle_silent(const Dwg_Data * dwg, const BITCODE_BL absref)
+dwg_resolve_handle_silent(const Dwg_Data * dwg, const long unsigned int absref)
 {
-  uint32_t i = hash_get(dwg->object_map, (uint32_t)absref);
+  uint32_t i = hash_get(dwg->object_map, (uint64_t)absref);
   if (i == HASH_NOT_FOUND ||
       (BITCODE_BL)i >= dwg->num_objects) //the latter being an invalid handle (read from DWG)
       return NULL;
@@ -1325,6 +1473,11 @@ dwg_resolve_handle_silent(const Dwg_Data * dwg, const BITCODE_BL absref)
 Dwg_Object_Ref*
 dwg_find_objectref(const Dwg_Data *restrict dwg, const Dwg_Object *restrict obj)
 {
+  if (dwg->object_ref_index && obj->index < dwg->num_object_ref_index
+      && &dwg->object[obj->index] == obj
+      && dwg->object_ref_index[obj->index])
+    return dwg->object_ref_index[obj->index];
+  // no ref when the index was built, maybe one was added since
   for (BITCODE_BL i = 0; i < dwg->num_object_refs; i++)
     {
       Dwg_Object_Ref *ref = dwg->object_ref[i];
@@ -1348,190 +1501,36 @@ dwg_resolve_objectrefs_silent(Dwg_Data *restrict dwg)
   for (i = 0; i < dwg->num_object_refs; i++)
     {
       //scan num_objects for the id (absolute_ref)
-      obj = dwg_resolve_handle(dwg, dwg->object_ref[i]->absolute_ref);
+      obj = dwg_resolve_handle_silent(dwg, dwg->object_ref[i]->absolute_ref);
       dwg->object_ref[i]->obj = obj;
     }
+  build_object_ref_index(dwg);
   //TODO: scan dwg->num_objects also to update it's handlerefs
   loglevel = oldloglevel;
 }
 
-/* R2004 Literal Length
- */
-static int
-read_literal_length(Bit_Chain *restrict dat, unsigned char *restrict opcode)
-{
-  int total = 0;
-  BITCODE_RC byte = bit_read_RC(dat);
-
-  *opcode = 0x00;
-
-  if (byte >= 0x01 && byte <= 0x0F)
-    return byte + 3;
-  else if (byte == 0)
-    {
-      total = 0x0F;
-      while ((byte = bit_read_RC(dat)) == 0x00)
-        {
-          total += 0xFF;
-        }
-      return total + byte + 3;
-    }
-  else if (byte & 0xF0)
-    *opcode = byte;
-
-  return 0;
-}
-
-/* R2004 Long Compression Offset
- */
-static int
-read_long_compression_offset(Bit_Chain* dat)
-{
-  int total = 0;
-  BITCODE_RC byte = bit_read_RC(dat);
-  if (byte == 0)
-    {
-      total = 0xFF;
-      while ((byte = bit_read_RC(dat)) == 0x00)
-        total += 0xFF;
-    }
-  return total + byte;
-}
-
-/* R2004 Two Byte Offset
- */
-static int
-read_two_byte_offset(Bit_Chain *restrict dat, int *restrict lit_length)
-{
-  int offset;
-  BITCODE_RC firstByte = bit_read_RC(dat);
-  BITCODE_RC secondByte = bit_read_RC(dat);
-  offset = (firstByte >> 2) | (secondByte << 6);
-  *lit_length = (firstByte & 0x03);
-  return offset;
-}
-
 /* Decompresses a system section of a 2004+ DWG file
  */
 static int
 decompress_R2004_section(Bit_Chain *restrict dat, BITCODE_RC *restrict decomp,
                          uint32_t decomp_data_size, uint32_t comp_data_size)
 {
-  int lit_length, i;
-  uint32_t comp_offset, comp_bytes, bytes_left;
-  unsigned char opcode1 = 0, opcode2;
-  long unsigned int start_byte = dat->byte;
-  BITCODE_RC *src, *dst = decomp;
-
-  bytes_left = decomp_data_size; //to write to
-  if (comp_data_size > dat->size - start_byte) // bytes left to read from
+  uint32_t consumed;
+  int error;
+
+  if (comp_data_size > dat->size - dat->byte) // bytes left to read from
     {
       LOG_WARN("Invalid comp_data_size %lu > %lu bytes left",
-                (unsigned long)bytes_left, dat->size - dat->byte)
+                (unsigned long)comp_data_size, dat->size - dat->byte)
       return DWG_ERR_VALUEOUTOFBOUNDS;
     }
-  // length of the first sequence of uncompressed or literal data.
-  lit_length = read_literal_length(dat, &opcode1);
-  bit_read_fixed(dat, decomp, lit_length);
-  dst += lit_length;
-  bytes_left -= lit_length;
-
-  opcode1 = 0x00;
-  while (dat->byte - start_byte < comp_data_size)
-    {
-      if (opcode1 == 0x00)
-        opcode1 = bit_read_RC(dat);
-
-      if (opcode1 >= 0x40)
-        {
-          comp_bytes = ((opcode1 & 0xF0) >> 4) - 1;
-          opcode2 = bit_read_RC(dat);
-          comp_offset = (opcode2 << 2) | ((opcode1 & 0x0C) >> 2);
-
-          if (opcode1 & 0x03)
-            {
-              lit_length = (opcode1 & 0x03);
-              opcode1  = 0x00;
-            }
-          else
-            lit_length = read_literal_length(dat, &opcode1);
-        }
-      else if (opcode1 >= 0x21 && opcode1 <= 0x3F) // lgtm [cpp/constant-comparison]
-        {
-          comp_bytes  = opcode1 - 0x1E;
-          comp_offset = read_two_byte_offset(dat, &lit_length);
-
-          if (lit_length != 0)
-            opcode1 = 0x00;
-          else
-            lit_length = read_literal_length(dat, &opcode1);
-        }
-      else if (opcode1 == 0x20)
-        {
-          comp_bytes  = read_long_compression_offset(dat) + 0x21;
-          comp_offset = read_two_byte_offset(dat, &lit_length);
-
-          if (lit_length != 0)
-            opcode1 = 0x00;
-          else
-            lit_length = read_literal_length(dat, &opcode1);
-        }
-      else if (opcode1 >= 0x12 && opcode1 <= 0x1F)
-        {
-          comp_bytes  = (opcode1 & 0x0F) + 2;
-          comp_offset = read_two_byte_offset(dat, &lit_length) + 0x3FFF;
-
-          if (lit_length != 0)
-            opcode1 = 0x00;
-          else
-            lit_length = read_literal_length(dat, &opcode1);
-        }
-      else if (opcode1 == 0x10)
-        {
-          comp_bytes  = read_long_compression_offset(dat) + 9;
-          comp_offset = read_two_byte_offset(dat, &lit_length) + 0x3FFF;
-
-          if (lit_length != 0)
-            opcode1 = 0x00;
-          else
-            lit_length = read_literal_length(dat, &opcode1);
-        }
-      else if (opcode1 == 0x11)
-          break;     // Terminates the input stream, everything is ok
-      else
-        {
-          LOG_ERROR("Invalid opcode 0x%x in input stream at pos %lu",
-                    opcode1, dat->byte);
-          return DWG_ERR_INTERNALERROR;  // error in input stream
-        }
-
-      LOG_INSANE("<C %d\n", comp_bytes)
-      // copy "compressed data"
-      src = dst - comp_offset - 1;
-      assert(src >= decomp);
-      if ((uint32_t)comp_bytes > bytes_left) // bytes left to write
-        {
-          LOG_ERROR("Invalid comp_bytes %lu > %lu bytes left",
-                    (unsigned long)comp_bytes, (unsigned long)bytes_left)
-          return DWG_ERR_VALUEOUTOFBOUNDS;
-        }
-      for (i = 0; (uint32_t)i < comp_bytes; ++i)
-        *dst++ = *src++;
-      bytes_left -= comp_bytes;
-
-      // copy "literal data"
-      LOG_INSANE("<L %d\n", lit_length)
-      if ((uint32_t)lit_length > bytes_left) // bytes left to write
-        {
-          LOG_ERROR("Invalid lit_length %lu > %lu bytes left",
-                    (unsigned long)lit_length, (unsigned long)bytes_left)
-          return DWG_ERR_VALUEOUTOFBOUNDS;
-        }
-      for (i = 0; i < lit_length; ++i)
-        *dst++ = bit_read_RC(dat);
-    }
-
-  return 0;  // Success
+  error = decompress_R2004(decomp, decomp_data_size, &dat->chain[dat->byte],
+                           comp_data_size, &consumed);
+  dat->byte += consumed;
+  if (error)
+    LOG_ERROR("Decompression error %d in input stream at pos %lu",
+              error, dat->byte);
+  return error;
 }
 
 /* Read R2004, 2010+ Section Map
@@ -1826,6 +1825,16 @@ typedef union _encrypted_section_header
   } fields;
 } encrypted_section_header;
 
+static int
+decompress_R2004_page(Decompress_Page *page)
+{
+  uint32_t consumed;
+  if (!page->src) // empty section
+    return 0;
+  return decompress_R2004(page->dst, page->dst_size, page->src,
+                          page->src_size, &consumed);
+}
+
 static int
 read_2004_compressed_section(Bit_Chain* dat, Dwg_Data *restrict dwg,
                              Bit_Chain* sec_dat, BITCODE_RL section_type)
@@ -1835,6 +1844,7 @@ read_2004_compressed_section(Bit_Chain* dat, Dwg_Data *restrict dwg,
   Dwg_Section_Info *info = NULL;
   encrypted_section_header es;
   BITCODE_RC *decomp;
+  Decompress_Page *pages;
   BITCODE_BL i, j;
   int error = 0;
 
@@ -1874,8 +1884,20 @@ read_2004_compressed_section(Bit_Chain* dat, Dwg_Data *restrict dwg,
       return DWG_ERR_OUTOFMEM;
     }
 
+  pages = (Decompress_Page *)calloc(info->num_sections,
+                                   sizeof(Decompress_Page));
+  if (!pages)
+    {
+      LOG_ERROR("Out of memory with %u sections", info->num_sections);
+      free(decomp);
+      return DWG_ERR_OUTOFMEM;
+    }
+
+  /* Read the page headers, and decompress the pages in parallel */
   for (i=0; i < info->num_sections; ++i)
     {
+      Decompress_Page *page = &pages[i];
+      page->dst = &decomp[i * info->max_decomp_size];
       if (!info->sections[i])
         {
           LOG_WARN("Skip empty section %u %s", i, info->name);
@@ -1908,16 +1930,33 @@ read_2004_compressed_section(Bit_Chain* dat, Dwg_Data *restrict dwg,
       LOG_HANDLE("Checksum1:        0x%x\n",(unsigned)es.fields.checksum_1)
       LOG_HANDLE("Checksum2:        0x%x\n\n",(unsigned)es.fields.checksum_2)
 
-      error = decompress_R2004_section
-        (dat, &decomp[i * info->max_decomp_size],     //offset
-         max_decomp_size - (i*info->max_decomp_size), //bytes left
-         es.fields.data_size);
+      if (es.fields.data_size > dat->size - dat->byte) // bytes left to read
+        {
+          LOG_WARN("Invalid comp_data_size %lu > %lu bytes left",
+                   (unsigned long)es.fields.data_size, dat->size - dat->byte)
+          page->error = DWG_ERR_VALUEOUTOFBOUNDS;
+          continue;
+        }
+      page->src = &dat->chain[dat->byte];
+      page->src_size = page->comp_size = es.fields.data_size;
+      page->dst_size = info->max_decomp_size;
+    }
+
+  decompress_pages(pages, info->num_sections, decompress_R2004_page);
+  for (i=0; i < info->num_sections; ++i)
+    {
+      error = pages[i].error;
+      if (error && pages[i].src)
+        LOG_ERROR("Decompression error %d in section %s page %u",
+                  error, info->name, i);
       if (error > DWG_ERR_CRITICAL)
         {
+          free(pages);
           free(decomp);
           return error;
         }
     }
+  free(pages);
 
   sec_dat->bit     = 0;
   sec_dat->byte    = 0;
@@ -2046,6 +2085,7 @@ read_2004_section_classes(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
           if (strcmp(dwg->dwg_class[i].dxfname, "LAYOUT") == 0)
             dwg->layout_number = dwg->dwg_class[i].number;
         }
+      dwg_resolve_classes(dwg);
     }
   else
     {
@@ -2110,6 +2150,7 @@ static int
 read_2004_section_handles(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
 {
   Bit_Chain obj_dat = { 0 }, hdl_dat = { 0 };
+  Dwg_Object_Offsets offsets = { 0 };
   BITCODE_RS section_size = 0;
   long unsigned int endpos;
   int error;
@@ -2145,6 +2186,8 @@ read_2004_section_handles(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
       if (section_size > 2040)
         {
           LOG_ERROR("Object-map/handles section size greater than 2040!");
+          free(offsets.address);
+          free(hdl_dat.chain);
           free(obj_dat.chain);
           return DWG_ERR_VALUEOUTOFBOUNDS;
         }
@@ -2153,28 +2196,22 @@ read_2004_section_handles(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
       last_offset = 0;
       while (hdl_dat.byte - startpos < section_size)
         {
-          int added;
           BITCODE_UMC handle;
           BITCODE_MC offset;
 
-          oldpos = dat->byte;
+          oldpos = hdl_dat.byte;
           handle = bit_read_UMC(&hdl_dat);
           offset = bit_read_MC(&hdl_dat);
           //last_handle += handle;
           last_offset += offset;
-          LOG_TRACE("\n< Next object: %lu\t", (unsigned long)dwg->num_objects)
+          LOG_TRACE("\n< Next object: %lu\t", (unsigned long)offsets.num)
           LOG_HANDLE("Handle: %lX\tOffset: " FORMAT_MC " @%lu\n",
                      handle, offset, last_offset)
 
           if (hdl_dat.byte == oldpos)
             break;
 
-          added = dwg_decode_add_object(dwg, &obj_dat, &obj_dat, last_offset);
-          if (added > 0)
-            error |= added;
-          //else re-allocated
-          // we don't stop encoding on single errors, but we sum them all up
-          // as combined bitmask
+          error |= dwg_add_object_offset(&offsets, last_offset);
         }
 
       if (hdl_dat.byte == oldpos)
@@ -2183,10 +2220,11 @@ read_2004_section_handles(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
       if (!bit_check_CRC(&hdl_dat, startpos, 0xC0C1))
         LOG_WARN("Handles section CRC mismatch at offset %lx", startpos);
 #else
-      crc1 = bit_calc_CRC(0xC0C1, &(hdl_dat.chain[startpos]),
-                          hdl_dat.byte - startpos);
+      crc1 = (dwg->opts & DWG_OPTS_NOCRC)
+        ? 0 : bit_calc_CRC(0xC0C1, &(hdl_dat.chain[startpos]),
+                           hdl_dat.byte - startpos);
       crc2 = bit_read_RS_LE(&hdl_dat);
-      if (crc1 == crc2)
+      if (crc1 == crc2 || (dwg->opts & DWG_OPTS_NOCRC))
         {
           LOG_INSANE("Handles section page CRC: %04X from %lx-%lx\n",
                      crc2, startpos, hdl_dat.byte-2);
@@ -2204,9 +2242,16 @@ read_2004_section_handles(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
     }
   while (section_size > 2);
 
+  /* Now decode all objects, maybe in parallel */
+  error |= dwg_decode_add_objects(dwg, &obj_dat, &obj_dat, &offsets);
+
   LOG_TRACE("\nNum objects: %lu\n", (unsigned long)dwg->num_objects);
+  free(offsets.address);
   free(hdl_dat.chain);
-  free(obj_dat.chain);
+  if (dwg->lazy && dwg->lazy->dat.chain == obj_dat.chain)
+    dwg->lazy->release = LAZY_FREE; // kept for the deferred entities
+  else
+    free(obj_dat.chain);
   return error;
 }
 
@@ -2460,8 +2505,7 @@ dwg_decode_eed_data(Bit_Chain *restrict dat, Dwg_Eed_Data *restrict data,
       case 4:
         data->u.eed_4.length = lenc = bit_read_RC(dat);
         /* code:1 + len:1 */
-        for (j=0; j < MIN(lenc,size-2); j++)
-          data->u.eed_4.data[j] = bit_read_RC(dat);
+        bit_read_fixed(dat, (BITCODE_RC*)data->u.eed_4.data, MIN(lenc,size-2));
         LOG_TRACE("raw: %s\n", data->u.eed_4.data);
         break;
       case 10: case 11: case 12: case 13: /*case 14: case 15:*/
@@ -2532,10 +2576,10 @@ dwg_decode_eed(Bit_Chain *restrict dat, Dwg_Object_Object *restrict obj)
         }
 
       if (idx) {
-        obj->eed = (Dwg_Eed*)realloc(obj->eed, (idx+1) * sizeof(Dwg_Eed));
+        obj->eed = (Dwg_Eed*)arena_realloc(obj->eed, (idx+1) * sizeof(Dwg_Eed));
         memset(&obj->eed[idx], 0, sizeof(Dwg_Eed));
       } else {
-        obj->eed = (Dwg_Eed*)calloc(1, sizeof(Dwg_Eed));
+        obj->eed = (Dwg_Eed*)arena_calloc(1, sizeof(Dwg_Eed));
       }
       obj->eed[idx].size = size;
       error |= bit_read_H(dat, &obj->eed[idx].handle);
@@ -2583,7 +2627,7 @@ dwg_decode_eed(Bit_Chain *restrict dat, Dwg_Object_Object *restrict obj)
 
       while (dat->byte < end)
         {
-          obj->eed[idx].data = (Dwg_Eed_Data*)calloc(size + 8, 1);
+          obj->eed[idx].data = (Dwg_Eed_Data*)arena_calloc(size + 8, 1);
           LOG_TRACE("EED[%u] ", idx);
 
           error |= dwg_decode_eed_data(dat, obj->eed[idx].data, end, size);
@@ -2595,7 +2639,7 @@ dwg_decode_eed(Bit_Chain *restrict dat, Dwg_Object_Object *restrict obj)
               size = (long)(end - dat->byte + 1);
               LOG_INSANE("EED[%u] size remaining: %ld\n", idx, (long)size);
 
-              obj->eed = (Dwg_Eed*)realloc(obj->eed, (idx+1) * sizeof(Dwg_Eed));
+              obj->eed = (Dwg_Eed*)arena_realloc(obj->eed, (idx+1) * sizeof(Dwg_Eed));
               obj->eed[idx].handle = obj->eed[idx-1].handle;
               obj->eed[idx].size = 0;
               obj->eed[idx].raw = NULL;
@@ -2896,27 +2940,83 @@ dwg_decode_object(Bit_Chain* dat, Bit_Chain* hdl_dat, Bit_Chain* str_dat,
   return error;
 }
 
+/* A new zeroed object_ref from the slabs of dwg, or of the current
+   decoding thread. */
+static Dwg_Object_Ref *
+dwg_new_object_ref(Dwg_Data *restrict dwg)
+{
+  Dwg_Ref_Slab **slabp = &dwg->ref_slab;
+  Dwg_Ref_Slab *slab;
+  Dwg_Object_Ref *ref;
+
+#ifdef USE_THREADS
+  Decode_Range *range = decode_current_range();
+  if (range)
+    slabp = &range->ref_slab;
+#endif
+  slab = *slabp;
+  if (!slab || slab->used == slab->size)
+    {
+      BITCODE_BL size = slab ? slab->size * 2 : REFS_PER_SLAB;
+      if (size > MAX_REFS_PER_SLAB)
+        size = MAX_REFS_PER_SLAB;
+      slab = (Dwg_Ref_Slab *)malloc(sizeof(Dwg_Ref_Slab)
+                                    + size * sizeof(Dwg_Object_Ref));
+      if (!slab)
+        {
+          LOG_ERROR("Out of memory");
+          return NULL;
+        }
+      slab->next = *slabp;
+      slab->used = 0;
+      slab->size = size;
+      *slabp = slab;
+    }
+  ref = &slab->ref[slab->used++];
+  memset(ref, 0, sizeof(Dwg_Object_Ref));
+  return ref;
+}
+
+/* Append ref to the refs array, growing it geometrically */
 static int
-dwg_decode_add_object_ref(Dwg_Data *restrict dwg, Dwg_Object_Ref *ref)
+append_object_ref(Dwg_Object_Ref ***refsp, BITCODE_BL *nump,
+                  BITCODE_BL *sizep, Dwg_Object_Ref *ref)
 {
-  Dwg_Object_Ref **object_ref_old = dwg->object_ref;
-
-  // Reserve memory space for object references
-  if (!dwg->num_object_refs)
-    dwg->object_ref = calloc(REFS_PER_REALLOC, sizeof(Dwg_Object_Ref*));
-  else if (dwg->num_object_refs % REFS_PER_REALLOC == 0)
-    dwg->object_ref = realloc(dwg->object_ref,
-          (dwg->num_object_refs + REFS_PER_REALLOC) * sizeof(Dwg_Object_Ref*));
-  if (!dwg->object_ref)
+  if (*nump >= *sizep)
     {
-      LOG_ERROR("Out of memory");
-      dwg->object_ref = object_ref_old;
-      return DWG_ERR_OUTOFMEM;
+      BITCODE_BL size = *sizep ? *sizep * 2 : REFS_PER_REALLOC;
+      Dwg_Object_Ref **refs = (Dwg_Object_Ref **)realloc(*refsp,
+                                  size * sizeof(Dwg_Object_Ref*));
+      if (!refs)
+        {
+          LOG_ERROR("Out of memory");
+          return DWG_ERR_OUTOFMEM;
+        }
+      *refsp = refs;
+      *sizep = size;
     }
-  dwg->object_ref[dwg->num_object_refs++] = ref;
+  (*refsp)[(*nump)++] = ref;
   return 0;
 }
 
+static int
+dwg_decode_add_object_ref(Dwg_Data *restrict dwg, Dwg_Object_Ref *ref)
+{
+#ifdef USE_THREADS
+  Decode_Range *range = decode_current_range();
+  if (range)
+    return append_object_ref(&range->object_ref, &range->num_object_refs,
+                             &range->num_alloced_object_refs, ref);
+#endif
+  // a ref added after the index was built, e.g. by dwg_validate_POLYLINE
+  if (ref->obj && dwg->object_ref_index
+      && ref->obj->index < dwg->num_object_ref_index
+      && !dwg->object_ref_index[ref->obj->index])
+    dwg->object_ref_index[ref->obj->index] = ref;
+  return append_object_ref(&dwg->object_ref, &dwg->num_object_refs,
+                           &dwg->num_alloced_object_refs, ref);
+}
+
 /* Store an object reference in a separate dwg->object_ref array
    which is the id for handles, i.e. DXF 5, 330. */
 Dwg_Object_Ref *
@@ -2924,41 +3024,40 @@ dwg_decode_handleref(Bit_Chain *restrict dat, Dwg_Object *restrict obj,
                      Dwg_Data *restrict dwg)
 {
   // Welcome to the house of evil code
-  Dwg_Object_Ref* ref = (Dwg_Object_Ref *) calloc(1, sizeof(Dwg_Object_Ref));
-  if (!ref)
-    {
-      LOG_ERROR("Out of memory");
-      return NULL;
-    }
+  Dwg_Object_Ref* ref;
+  Dwg_Handle handleref = { 0 };
 
-  if (bit_read_H(dat, &ref->handleref))
+  if (bit_read_H(dat, &handleref))
     {
       LOG_WARN("Invalid handleref: (%d.%d.%lX)",
-               ref->handleref.code, ref->handleref.size, ref->handleref.value)
-      free(ref);
+               handleref.code, handleref.size, handleref.value)
       return NULL;
     }
 
   // If the handle size is 0 and not a relative handle, it is probably a null handle.
   // It shouldn't be placed in the object ref vector.
-  if (ref->handleref.size || (obj && ref->handleref.code > 5))
+  if (handleref.size || (obj && handleref.code > 5))
     {
-      if (dwg_decode_add_object_ref(dwg, ref))
-        {
-          free(ref);
-          return NULL;
-        }
+      // in the slabs, freed by dwg_free
+      ref = dwg_new_object_ref(dwg);
+      if (!ref || dwg_decode_add_object_ref(dwg, ref))
+        return NULL;
+      ref->handleref = handleref;
     }
-  else if (!ref->handleref.value)
+  else
     {
-      if (obj)
+      if (!handleref.value && obj)
+        return NULL;
+      // freed with its field
+      ref = (Dwg_Object_Ref *) arena_calloc(1, sizeof(Dwg_Object_Ref));
+      if (!ref)
         {
-          free(ref);
+          LOG_ERROR("Out of memory");
           return NULL;
         }
-      ref->absolute_ref = 0;
-      ref->obj = NULL;
-      return ref;
+      ref->handleref = handleref;
+      if (!handleref.value)
+        return ref;
     }
 
   // We receive a null obj when we are reading
@@ -2973,8 +3072,8 @@ dwg_decode_handleref(Bit_Chain *restrict dat, Dwg_Object *restrict obj,
         }
       if (ref->handleref.code >= 6)
         {
+          // stays in the slabs
           LOG_ERROR("Empty obj argument for handleref code %d", ref->handleref.code);
-          free(ref);
           return NULL;
         }
     }
@@ -3036,43 +3135,41 @@ dwg_decode_handleref_with_code(Bit_Chain *restrict dat,
                                Dwg_Object *restrict obj,
                                Dwg_Data *restrict dwg, unsigned int code)
 {
-  Dwg_Object_Ref* ref = (Dwg_Object_Ref *) calloc(1, sizeof(Dwg_Object_Ref));
-  if (!ref)
-    {
-      LOG_ERROR("Out of memory");
-      return NULL;
-    }
+  Dwg_Object_Ref* ref;
+  Dwg_Handle handleref = { 0 };
 
-  if (bit_read_H(dat, &ref->handleref))
+  if (bit_read_H(dat, &handleref))
     {
       LOG_WARN("Invalid handleref: wanted code %d, got (%d.%d.%lX)",
-               code, ref->handleref.code, ref->handleref.size,
-               ref->handleref.value)
-      free(ref);
+               code, handleref.code, handleref.size, handleref.value)
       return NULL;
     }
 
   // If the handle size is 0 and not a relative handle, it is probably
   // a null handle.
   // It shouldn't be placed in the object ref vector.
-  if (ref->handleref.size || (obj && ref->handleref.code > 5))
+  if (handleref.size || (obj && handleref.code > 5))
     {
-      if (dwg_decode_add_object_ref(dwg, ref))
-        {
-          free(ref);
-          return NULL;
-        }
+      // in the slabs, freed by dwg_free
+      ref = dwg_new_object_ref(dwg);
+      if (!ref || dwg_decode_add_object_ref(dwg, ref))
+        return NULL;
+      ref->handleref = handleref;
     }
-  else if (!ref->handleref.value)
+  else
     {
-          if (obj)
+      if (!handleref.value && obj)
+        return NULL;
+      // freed with its field
+      ref = (Dwg_Object_Ref *) arena_calloc(1, sizeof(Dwg_Object_Ref));
+      if (!ref)
         {
-          free(ref);
+          LOG_ERROR("Out of memory");
           return NULL;
         }
-      ref->absolute_ref = 0;
-      ref->obj = NULL;
-      return ref;
+      ref->handleref = handleref;
+      if (!handleref.value)
+        return ref;
     }
 
   // We receive a null obj when we are reading
@@ -3248,8 +3345,8 @@ dwg_free_xdata_resbuf(Dwg_Resbuf *rbuf)
       Dwg_Resbuf *next = rbuf->next;
       short type = get_base_value_type(rbuf->type);
       if (type == VT_STRING || type == VT_BINARY)
-        free (rbuf->value.str.u.data);
-      free (rbuf);
+        arena_release (rbuf->value.str.u.data);
+      arena_release (rbuf);
       rbuf = next;
     }
 }
@@ -3264,16 +3361,13 @@ dwg_decode_xdata(Bit_Chain *restrict dat, Dwg_Object_XRECORD *restrict obj, int
   BITCODE_BL i, num_xdata = 0;
   BITCODE_RS length;
 
-  static int cnt = 0;
-  cnt++;
-
   end_address = dat->byte + (unsigned long int)size;
   LOG_INSANE("xdata:\n");
   LOG_INSANE_TF(&dat->chain[dat->byte], size);
 
   while (dat->byte < end_address)
     {
-      rbuf = (Dwg_Resbuf *) calloc(1, sizeof(Dwg_Resbuf));
+      rbuf = (Dwg_Resbuf *) arena_calloc(1, sizeof(Dwg_Resbuf));
       if (!rbuf)
         {
           LOG_ERROR("Out of memory");
@@ -3297,14 +3391,14 @@ dwg_decode_xdata(Bit_Chain *restrict dat, Dwg_Object_XRECORD *restrict obj, int
             length = rbuf->value.str.size = bit_read_RS(dat);
             if (length > 0)
               {
-                rbuf->value.str.u.wdata = calloc(length + 1, 2);
+                rbuf->value.str.u.wdata = arena_calloc(length + 1, 2);
                 if (!rbuf->value.str.u.wdata)
                   {
                     LOG_ERROR("Out of memory");
                     if (root)
                       {
                         dwg_free_xdata_resbuf(root);
-                        if (rbuf) free(rbuf);
+                        if (rbuf) arena_release(rbuf);
                       }
                     else
                       dwg_free_xdata_resbuf(rbuf);
@@ -3494,21 +3588,12 @@ decode_preR13_entities(unsigned long start, unsigned long end,
       Dwg_Object_Entity* ent;
       BITCODE_RS crc;
 
-      if (!num)
-        dwg->object = (Dwg_Object *) malloc(REFS_PER_REALLOC * sizeof(Dwg_Object));
-      else if (num % REFS_PER_REALLOC == 0)
-        dwg->object = realloc(dwg->object,
-            (num + REFS_PER_REALLOC) * sizeof(Dwg_Object));
-      if (!dwg->object)
+      if (dwg_add_object(dwg) > 0)
         {
           LOG_ERROR("Out of memory");
           return DWG_ERR_OUTOFMEM;
         }
       obj = &dwg->object[num];
-      memset(obj, 0, sizeof(Dwg_Object));
-      dwg->num_objects++;
-      obj->index = num;
-      obj->parent = dwg;
       obj->address = dat->byte;
 
       DEBUG_HERE;
@@ -3628,8 +3713,35 @@ dwg_decode_variable_type(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_
   return DWG_ERR_UNHANDLEDCLASS;
 }
 
+/** Reserves space for num objects in dwg->object[], so that adding
+    up to num objects does not realloc. The new space is zeroed.
+    Returns -1 if the dwg->object pool was re-alloced, i.e. pointers within
+    are invalidated.
+    Returns 0 or DWG_ERR_OUTOFMEM otherwise.
+ */
+static int
+dwg_reserve_objects(Dwg_Data *restrict dwg, BITCODE_BL num)
+{
+  Dwg_Object *old = dwg->object;
+  if (num <= dwg->num_alloced_objects)
+    return 0;
+  dwg->object = (Dwg_Object *)realloc(old, num * sizeof(Dwg_Object));
+  if (!dwg->object)
+    {
+      LOG_ERROR("Out of memory");
+      dwg->object = old;
+      return DWG_ERR_OUTOFMEM;
+    }
+  memset(&dwg->object[dwg->num_alloced_objects], 0,
+         (num - dwg->num_alloced_objects) * sizeof(Dwg_Object));
+  dwg->num_alloced_objects = num;
+  return old && old != dwg->object ? -1 : 0;
+}
+
 /** Adds a new empty obj to the dwg->object[] array.
     The new object is at &dwg->object[dwg->num_objects-1].
+    The decoder reserves all objects beforehand, otherwise the array
+    grows geometrically.
 
     Returns 0 or some error codes on success.
     Returns -1 if the dwg->object pool was re-alloced, i.e. pointers within
@@ -3641,14 +3753,12 @@ EXPORT int dwg_add_object (Dwg_Data *dwg)
   Dwg_Object *obj;
   BITCODE_BL num = dwg->num_objects;
   int realloced = 0;
-  if (!num)
-    dwg->object = calloc(REFS_PER_REALLOC, sizeof(Dwg_Object));
-  else if (num % REFS_PER_REALLOC == 0) {
-    Dwg_Object *old = dwg->object;
-    dwg->object = realloc(dwg->object, (num + REFS_PER_REALLOC) * sizeof(Dwg_Object));
-    realloced = old != dwg->object;
-  }
-  if (!dwg->object) return DWG_ERR_OUTOFMEM;
+  if (num >= dwg->num_alloced_objects)
+    {
+      realloced = dwg_reserve_objects(dwg, num ? num * 2 : REFS_PER_REALLOC);
+      if (realloced > 0)
+        return realloced;
+    }
 
   obj = &dwg->object[num];
   memset(obj, 0, sizeof(Dwg_Object));
@@ -3658,86 +3768,20 @@ EXPORT int dwg_add_object (Dwg_Data *dwg)
   return realloced ? -1 : 0;
 }
 
-/** Adds an object to the DWG (i.e. dwg->object[dwg->num_objects])
-    Returns 0 or some error codes on success.
-    Returns -1 if the dwg->object pool was re-alloced.
-    Returns some DWG_ERR_* otherwise.
+/** Links a decoded object into the DWG: registers its handle in the
+    object_map and checks the SEQEND and POLYLINE handles against the
+    already decoded objects.
+    Must be called in object order, as dwg_resolve_handle only finds the
+    objects before.
  */
-int
-dwg_decode_add_object(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat,
-                      long unsigned int address)
+static void
+link_decoded_object(Dwg_Data *restrict dwg, Bit_Chain* dat, Dwg_Object *restrict obj)
 {
-  long unsigned int oldpos;
-  long unsigned int object_address, end_address;
-  unsigned char previous_bit;
-  Dwg_Object *obj;
-  BITCODE_BL num = dwg->num_objects;
-  int error = 0;
-  int realloced = 0;
-
-  /* Keep the previous address
-   */
-  oldpos = dat->byte;
-  previous_bit = dat->bit;
-
-  /* Use the indicated address for the object
-   */
-  dat->byte = address;
-  dat->bit = 0;
+  BITCODE_BL num = obj->index;
 
-  //DEBUG_HERE;
-  /*
-   * Reserve memory space for objects. A realloc violates all internal pointers.
-   */
-  realloced = dwg_add_object(dwg);
-  if (realloced > 0)
+  switch (obj->tio.object ? obj->type : 0) // not skipped or deferred
     {
-      dat->byte = oldpos;
-      dat->bit = previous_bit;
-      return realloced; // i.e. DWG_ERR_OUTOFMEM
-    }
-  obj = &dwg->object[num];
-  LOG_INFO("==========================================\n"
-           "Object number: %lu/%lX", (unsigned long)num, (unsigned long)num)
-
-  obj->size = bit_read_MS(dat);
-  LOG_INFO(", Size: %d/0x%x", obj->size, obj->size)
-  obj->address = dat->byte;
-  end_address = obj->address + obj->size; /* (calculate the bitsize) */
-
-  SINCE(R_2010)
-  {
-    obj->handlestream_size = bit_read_UMC(dat);
-    LOG_INFO(", Hdlsize: " FORMAT_UMC, obj->handlestream_size);
-    obj->bitsize = obj->size * 8 - obj->handlestream_size;
-    obj->type = bit_read_BOT(dat);
-  } else {
-    obj->type = bit_read_BS(dat);
-  }
-  LOG_INFO(", Type: %d\n", obj->type)
-  object_address = bit_position(dat);
-
-  /* Check the type of the object
-   */
-  switch (obj->type)
-    {
-    case DWG_TYPE_TEXT:
-      error = dwg_decode_TEXT(dat, obj);
-      break;
-    case DWG_TYPE_ATTRIB:
-      error = dwg_decode_ATTRIB(dat, obj);
-      break;
-    case DWG_TYPE_ATTDEF:
-      error = dwg_decode_ATTDEF(dat, obj);
-      break;
-    case DWG_TYPE_BLOCK:
-      error = dwg_decode_BLOCK(dat, obj);
-      break;
-    case DWG_TYPE_ENDBLK:
-      error = dwg_decode_ENDBLK(dat, obj);
-      break;
     case DWG_TYPE_SEQEND:
-      error = dwg_decode_SEQEND(dat, obj);
       if (dat->version >= R_13 && obj->tio.entity->ownerhandle)
         {
           Dwg_Object *owner = dwg_resolve_handle(dwg,
@@ -3766,6 +3810,144 @@ dwg_decode_add_object(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat
             }
         }
       break;
+    case DWG_TYPE_POLYLINE_2D:
+    case DWG_TYPE_POLYLINE_3D:
+    case DWG_TYPE_POLYLINE_PFACE:
+    case DWG_TYPE_POLYLINE_MESH:
+      if (dat->version >= R_2010)
+        check_POLYLINE_handles(obj);
+      break;
+    default:
+      break;
+    }
+
+  if (obj->handle.value) { // empty only with UNKNOWN
+    LOG_HANDLE("object_map{%lX} = %lu\n", obj->handle.value, (unsigned long)num);
+    hash_set(dwg->object_map, obj->handle.value, (uint32_t)num);
+  }
+}
+
+/* With dwg->decode_filter, if the objects of type are decoded.
+   The control objects are always needed for the tables. */
+static int
+decode_type_wanted(const Dwg_Data *restrict dwg, const unsigned int type)
+{
+  if (!dwg->decode_filter)
+    return 1;
+  switch (type)
+    {
+    case DWG_TYPE_BLOCK_CONTROL:
+    case DWG_TYPE_LAYER_CONTROL:
+    case DWG_TYPE_STYLE_CONTROL:
+    case DWG_TYPE_LTYPE_CONTROL:
+    case DWG_TYPE_VIEW_CONTROL:
+    case DWG_TYPE_UCS_CONTROL:
+    case DWG_TYPE_VPORT_CONTROL:
+    case DWG_TYPE_APPID_CONTROL:
+    case DWG_TYPE_DIMSTYLE_CONTROL:
+    case DWG_TYPE_VPORT_ENTITY_CONTROL:
+      return 1;
+    default:
+      return dwg->decode_filter(dwg, type);
+    }
+}
+
+/* Skips an object rejected by dwg->decode_filter by its size.
+   Only the handle is read, to keep it findable. */
+static int
+decode_skip_object(Bit_Chain *restrict dat, Dwg_Object *restrict obj)
+{
+  int error = 0;
+
+  VERSIONS(R_2000, R_2007)
+  {
+    obj->bitsize = bit_read_RL(dat);
+  }
+  if (bit_read_H(dat, &obj->handle))
+    {
+      obj->handle.value = 0;
+      error = DWG_ERR_INVALIDHANDLE;
+    }
+  LOG_TRACE("skipped type %u, handle %lX\n", obj->type, obj->handle.value)
+  obj->supertype = DWG_SUPERTYPE_UNKNOWN;
+  if (obj->address + obj->size > dat->size)
+    {
+      LOG_ERROR("Invalid object size %u", obj->size)
+      dat->byte = dat->size;
+      dat->bit = 0;
+      return error | DWG_ERR_VALUEOUTOFBOUNDS;
+    }
+  dat->byte = obj->address + obj->size;
+  dat->bit = 0;
+  return error;
+}
+
+/** Decodes the object at address into the already added obj.
+    With linked NULL the object is linked at once, otherwise
+    *linked is set when the caller has to call link_decoded_object() later.
+    Leaves dat at some position after the object.
+ */
+static int
+decode_object_at(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat,
+                 Dwg_Object *restrict obj, long unsigned int address,
+                 unsigned char *linked)
+{
+  long unsigned int object_address, end_address;
+  BITCODE_BL num = obj->index;
+  int error = 0;
+
+  /* Use the indicated address for the object
+   */
+  dat->byte = address;
+  dat->bit = 0;
+
+  LOG_INFO("==========================================\n"
+           "Object number: %lu/%lX", (unsigned long)num, (unsigned long)num)
+
+  obj->size = bit_read_MS(dat);
+  LOG_INFO(", Size: %d/0x%x", obj->size, obj->size)
+  obj->address = dat->byte;
+  end_address = obj->address + obj->size; /* (calculate the bitsize) */
+
+  SINCE(R_2010)
+  {
+    obj->handlestream_size = bit_read_UMC(dat);
+    LOG_INFO(", Hdlsize: " FORMAT_UMC, obj->handlestream_size);
+    obj->bitsize = obj->size * 8 - obj->handlestream_size;
+    obj->type = bit_read_BOT(dat);
+  } else {
+    obj->type = bit_read_BS(dat);
+  }
+  LOG_INFO(", Type: %d\n", obj->type)
+  object_address = bit_position(dat);
+  if (!decode_type_wanted(dwg, obj->type))
+    {
+      error = decode_skip_object(dat, obj);
+      goto link;
+    }
+
+  /* Check the type of the object
+   */
+  switch (obj->type)
+    {
+    case DWG_TYPE_TEXT:
+      error = dwg_decode_TEXT(dat, obj);
+      break;
+    case DWG_TYPE_ATTRIB:
+      error = dwg_decode_ATTRIB(dat, obj);
+      break;
+    case DWG_TYPE_ATTDEF:
+      error = dwg_decode_ATTDEF(dat, obj);
+      break;
+    case DWG_TYPE_BLOCK:
+      error = dwg_decode_BLOCK(dat, obj);
+      break;
+    case DWG_TYPE_ENDBLK:
+      error = dwg_decode_ENDBLK(dat, obj);
+      break;
+    case DWG_TYPE_SEQEND:
+      error = dwg_decode_SEQEND(dat, obj);
+      break;
     case DWG_TYPE_INSERT:
       error = dwg_decode_INSERT(dat, obj);
       break;
@@ -3789,13 +3971,9 @@ dwg_decode_add_object(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat
       break;
     case DWG_TYPE_POLYLINE_2D:
       error = dwg_decode_POLYLINE_2D(dat, obj);
-      if (dat->version >= R_2010)
-        check_POLYLINE_handles(obj);
       break;
     case DWG_TYPE_POLYLINE_3D:
       error = dwg_decode_POLYLINE_3D(dat, obj);
-      if (dat->version >= R_2010)
-        check_POLYLINE_handles(obj);
       break;
     case DWG_TYPE_ARC:
       error = dwg_decode_ARC(dat, obj);
@@ -3835,13 +4013,9 @@ dwg_decode_add_object(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat
       break;
     case DWG_TYPE_POLYLINE_PFACE:
       error = dwg_decode_POLYLINE_PFACE(dat, obj);
-      if (dat->version >= R_2010)
-        check_POLYLINE_handles(obj);
       break;
     case DWG_TYPE_POLYLINE_MESH:
       error = dwg_decode_POLYLINE_MESH(dat, obj);
-      if (dat->version >= R_2010)
-        check_POLYLINE_handles(obj);
       break;
     case DWG_TYPE_SOLID:
       error = dwg_decode_SOLID(dat, obj);
@@ -4055,8 +4229,6 @@ dwg_decode_add_object(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat
               }
             obj->supertype = DWG_SUPERTYPE_UNKNOWN;
             obj->type = 0;
-            dat->byte = oldpos;
-            dat->bit  = previous_bit;
             return error | DWG_ERR_VALUEOUTOFBOUNDS;
           }
           // properly dwg_decode_object/_entity for eed, reactors, xdic
@@ -4107,10 +4279,11 @@ dwg_decode_add_object(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat
         }
     }
 
-  if (obj->handle.value) { // empty only with UNKNOWN
-    LOG_HANDLE("object_map{%lX} = %lu\n", obj->handle.value, (unsigned long)num);
-    hash_set(dwg->object_map, obj->handle.value, (uint32_t)num);
-  }
+ link:
+  if (linked)
+    *linked = 1;
+  else
+    link_decoded_object(dwg, dat, obj);
 
   /* Now 1 padding bits until next byte, and then a RS CRC */
   if (dat->bit) {
@@ -4120,7 +4293,12 @@ dwg_decode_add_object(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat
     bit_advance_position(dat, r);
   }
 #if 1
-  bit_check_CRC(dat, address, 0xC0C1);
+  if (dwg->opts & DWG_OPTS_NOCRC)
+    {
+      bit_read_RS(dat);
+    }
+  else
+    bit_check_CRC(dat, address, 0xC0C1);
 #else
   {
     BITCODE_RS seed, calc;
@@ -4139,6 +4317,39 @@ dwg_decode_add_object(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat
   }
 #endif
 
+  return error;
+}
+
+/** Adds an object to the DWG (i.e. dwg->object[dwg->num_objects])
+    Returns 0 or some error codes on success.
+    Returns -1 if the dwg->object pool was re-alloced.
+    Returns some DWG_ERR_* otherwise.
+ */
+int
+dwg_decode_add_object(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat,
+                      long unsigned int address)
+{
+  long unsigned int oldpos;
+  unsigned char previous_bit;
+  BITCODE_BL num = dwg->num_objects;
+  int error;
+  int realloced;
+
+  /* Keep the previous address
+   */
+  oldpos = dat->byte;
+  previous_bit = dat->bit;
+
+  //DEBUG_HERE;
+  /*
+   * Reserve memory space for objects. A realloc violates all internal pointers.
+   */
+  realloced = dwg_add_object(dwg);
+  if (realloced > 0)
+    return realloced; // i.e. DWG_ERR_OUTOFMEM
+
+  error = decode_object_at(dwg, dat, hdl_dat, &dwg->object[num], address, NULL);
+
   /* Register the previous addresses for return
    */
   dat->byte = oldpos;
@@ -4146,6 +4357,515 @@ dwg_decode_add_object(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat
   return realloced ? -1 : error; //re-alloced or not
 }
 
+/** Appends the address of the next object from the handles section.
+ */
+int
+dwg_add_object_offset(Dwg_Object_Offsets *restrict offsets,
+                      long unsigned int address)
+{
+  if (offsets->num == offsets->size)
+    {
+      BITCODE_BL size = offsets->size ? offsets->size * 2 : REFS_PER_REALLOC;
+      long unsigned int *addr = realloc(offsets->address,
+                                        size * sizeof(long unsigned int));
+      if (!addr)
+        {
+          LOG_ERROR("Out of memory");
+          return DWG_ERR_OUTOFMEM;
+        }
+      offsets->address = addr;
+      offsets->size = size;
+    }
+  offsets->address[offsets->num++] = address;
+  return 0;
+}
+
+#ifdef USE_THREADS
+
+/* Don't start a thread for less objects */
+#define OBJECTS_PER_THREAD 1024
+/* Objects vary in size, so let the threads grab smaller ranges */
+#define RANGES_PER_THREAD 8
+
+typedef struct _decode_pool
+{
+  Dwg_Data *dwg;
+  Bit_Chain *dat;
+  Bit_Chain *hdl_dat;
+  const long unsigned int *address;
+  unsigned char *linked;
+  Decode_Range *range;
+} Decode_Pool;
+
+static void
+decode_range_item(void *arg, unsigned r)
+{
+  Decode_Pool *pool = (Decode_Pool *)arg;
+  Dwg_Data *dwg = pool->dwg;
+  Decode_Range *range = &pool->range[r];
+  /* private stream positions */
+  Bit_Chain dat = *pool->dat;
+  Bit_Chain hdl_dat = *pool->hdl_dat;
+  Bit_Chain *hdl = pool->hdl_dat == pool->dat ? &dat : &hdl_dat;
+  Dwg_Arena *prev_arena = NULL;
+  BITCODE_BL i;
+
+  pthread_setspecific(decode_range_key, range);
+  if (range->arena)
+    prev_arena = arena_use(range->arena);
+  for (i = range->from; i < range->to; i++)
+    range->error |= decode_object_at(dwg, &dat, hdl, &dwg->object[i],
+                                     pool->address[i], &pool->linked[i]);
+  if (range->arena)
+    arena_use(prev_arena);
+  pthread_setspecific(decode_range_key, NULL);
+}
+
+/* Decodes the objects first .. offsets->num-1 with num_threads threads.
+   Each range of objects collects its own object_refs, which are appended
+   in range order afterwards. Linking the objects needs the preceding
+   objects only, and is done serially in object order at the end. So the
+   result is the same as with the serial decoder.
+ */
+static int
+decode_objects_parallel(Dwg_Data *restrict dwg, Bit_Chain* dat,
+                        Bit_Chain* hdl_dat,
+                        const Dwg_Object_Offsets *restrict offsets,
+                        BITCODE_BL first, unsigned num_threads)
+{
+  Decode_Pool pool;
+  unsigned num_ranges = num_threads * RANGES_PER_THREAD, r;
+  BITCODE_BL i, num = offsets->num, num_refs;
+  int error = 0;
+
+  /* All objects are reserved and zeroed already */
+  for (i = first; i < num; i++)
+    {
+      dwg->object[i].index = i;
+      dwg->object[i].parent = dwg;
+    }
+  dwg->num_objects = num;
+
+  memset(&pool, 0, sizeof(pool));
+  pool.dwg = dwg;
+  pool.dat = dat;
+  pool.hdl_dat = hdl_dat;
+  pool.address = offsets->address;
+  pool.linked = (unsigned char *)calloc(num, 1);
+  pool.range = (Decode_Range *)calloc(num_ranges, sizeof(Decode_Range));
+  if (!pool.linked || !pool.range)
+    {
+      LOG_ERROR("Out of memory");
+      free(pool.linked);
+      free(pool.range);
+      dwg->num_objects = first;
+      return DWG_ERR_OUTOFMEM;
+    }
+  for (r = 0; r < num_ranges; r++)
+    {
+      /* every thread allocates from its own arena */
+      if (dwg->arena && !(pool.range[r].arena = arena_new()))
+        {
+          LOG_ERROR("Out of memory");
+          while (r--)
+            arena_free(pool.range[r].arena);
+          free(pool.linked);
+          free(pool.range);
+          dwg->num_objects = first;
+          return DWG_ERR_OUTOFMEM;
+        }
+      pool.range[r].from = first
+        + (BITCODE_BL)((uint64_t)(num - first) * r / num_ranges);
+      pool.range[r].to = first
+        + (BITCODE_BL)((uint64_t)(num - first) * (r + 1) / num_ranges);
+    }
+
+  num_threads = threads_run(num_threads, num_ranges, decode_range_item,
+                            &pool);
+  LOG_INFO("Decoded %lu objects with %u threads\n",
+           (unsigned long)(num - first), num_threads)
+
+  /* Append the object_refs */
+  num_refs = dwg->num_object_refs;
+  for (r = 0; r < num_ranges; r++)
+    num_refs += pool.range[r].num_object_refs;
+  if (num_refs > dwg->num_object_refs)
+    {
+      Dwg_Object_Ref **object_ref = dwg->object_ref;
+      if (num_refs > dwg->num_alloced_object_refs)
+        object_ref = (Dwg_Object_Ref **)realloc(dwg->object_ref,
+                                    num_refs * sizeof(Dwg_Object_Ref*));
+      if (!object_ref)
+        {
+          LOG_ERROR("Out of memory");
+          error |= DWG_ERR_OUTOFMEM;
+        }
+      else
+        {
+          if (num_refs > dwg->num_alloced_object_refs)
+            dwg->num_alloced_object_refs = num_refs;
+          dwg->object_ref = object_ref;
+          for (r = 0; r < num_ranges; r++)
+            {
+              Decode_Range *range = &pool.range[r];
+              if (range->num_object_refs)
+                memcpy(&dwg->object_ref[dwg->num_object_refs],
+                       range->object_ref,
+                       range->num_object_refs * sizeof(Dwg_Object_Ref*));
+              dwg->num_object_refs += range->num_object_refs;
+            }
+        }
+    }
+  for (r = 0; r < num_ranges; r++)
+    {
+      dwg->num_entities += pool.range[r].num_entities;
+      error |= pool.range[r].error;
+      free(pool.range[r].object_ref);
+      /* The refs are owned by dwg from now on */
+      if (pool.range[r].ref_slab)
+        {
+          Dwg_Ref_Slab *tail = pool.range[r].ref_slab;
+          while (tail->next)
+            tail = tail->next;
+          tail->next = dwg->ref_slab;
+          dwg->ref_slab = pool.range[r].ref_slab;
+        }
+      if (pool.range[r].arena)
+        arena_join(dwg->arena, pool.range[r].arena);
+    }
+
+  /* Link in object order, seeing only the preceding objects */
+  for (i = first; i < num; i++)
+    {
+      dwg->num_objects = i + 1;
+      if (pool.linked[i])
+        link_decoded_object(dwg, dat, &dwg->object[i]);
+    }
+  dwg->num_objects = num;
+
+  free(pool.linked);
+  free(pool.range);
+  return error;
+}
+#endif
+
+/* The type of the object at address, without decoding it */
+static BITCODE_BS
+peek_object_type(const Bit_Chain *dat, long unsigned int address)
+{
+  Bit_Chain peek = *dat;
+  if (address >= dat->size)
+    return 0;
+  peek.byte = address;
+  peek.bit = 0;
+  bit_read_MS(&peek);
+  if (peek.version >= R_2010)
+    {
+      bit_read_UMC(&peek);
+      return bit_read_BOT(&peek);
+    }
+  return bit_read_BS(&peek);
+}
+
+/* The entities which are deferred with DWG_OPTS_LAZY. Not the ones
+   owning or linking others, which are checked when linking, and not
+   the classes. */
+static int
+lazy_type_is_deferred(BITCODE_BS type)
+{
+  switch (type)
+    {
+    case DWG_TYPE_TEXT:
+    case DWG_TYPE_ATTDEF:
+    case DWG_TYPE_ARC:
+    case DWG_TYPE_CIRCLE:
+    case DWG_TYPE_LINE:
+    case DWG_TYPE_DIMENSION_ORDINATE:
+    case DWG_TYPE_DIMENSION_LINEAR:
+    case DWG_TYPE_DIMENSION_ALIGNED:
+    case DWG_TYPE_DIMENSION_ANG3PT:
+    case DWG_TYPE_DIMENSION_ANG2LN:
+    case DWG_TYPE_DIMENSION_RADIUS:
+    case DWG_TYPE_DIMENSION_DIAMETER:
+    case DWG_TYPE_POINT:
+    case DWG_TYPE__3DFACE:
+    case DWG_TYPE_SOLID:
+    case DWG_TYPE_TRACE:
+    case DWG_TYPE_SHAPE:
+    case DWG_TYPE_VIEWPORT:
+    case DWG_TYPE_ELLIPSE:
+    case DWG_TYPE_SPLINE:
+    case DWG_TYPE_REGION:
+    case DWG_TYPE__3DSOLID:
+    case DWG_TYPE_BODY:
+    case DWG_TYPE_RAY:
+    case DWG_TYPE_XLINE:
+    case DWG_TYPE_OLEFRAME:
+    case DWG_TYPE_MTEXT:
+    case DWG_TYPE_LEADER:
+    case DWG_TYPE_TOLERANCE:
+    case DWG_TYPE_MLINE:
+    case DWG_TYPE_OLE2FRAME:
+    case DWG_TYPE_LWPOLYLINE:
+    case DWG_TYPE_HATCH:
+      return 1;
+    default:
+      return 0;
+    }
+}
+
+/** Adds a deferred entity, reading only its size, type and handle.
+    Returns 0, or 1 if the handle is invalid and the caller should decode
+    it as usual.
+ */
+static int
+lazy_add_object(Dwg_Data *restrict dwg, Bit_Chain* dat,
+                Dwg_Object *restrict obj, long unsigned int address)
+{
+  dat->byte = address;
+  dat->bit = 0;
+  obj->size = bit_read_MS(dat);
+  obj->address = dat->byte;
+  SINCE(R_2010)
+  {
+    obj->handlestream_size = bit_read_UMC(dat);
+    obj->bitsize = obj->size * 8 - obj->handlestream_size;
+    obj->type = bit_read_BOT(dat);
+  } else {
+    obj->type = bit_read_BS(dat);
+  }
+  VERSIONS(R_2000, R_2007)
+  {
+    obj->bitsize = bit_read_RL(dat);
+  }
+  if (bit_read_H(dat, &obj->handle) || !obj->handle.value)
+    return 1;
+  LOG_HANDLE("deferred %u: %lX\n", obj->type, obj->handle.value)
+  obj->fixedtype = (enum DWG_OBJECT_TYPE)obj->type;
+  obj->supertype = DWG_SUPERTYPE_ENTITY;
+  dwg->num_entities++;
+  link_decoded_object(dwg, dat, obj);
+  return 0;
+}
+
+/** DWG_OPTS_LAZY: adds all objects at the collected addresses, but
+    defers the decoding of most entities to dwg_decode_lazy_object().
+    Keeps dat, which the caller must not release then.
+ */
+static int
+decode_objects_lazy(Dwg_Data *restrict dwg, Bit_Chain* dat, Bit_Chain* hdl_dat,
+                    const Dwg_Object_Offsets *restrict offsets)
+{
+  Dwg_Lazy *lazy;
+  BITCODE_BL i;
+  int error = 0;
+
+  lazy = (Dwg_Lazy *)calloc(1, sizeof(Dwg_Lazy));
+  if (lazy)
+    lazy->address = (long unsigned int *)malloc(
+                       offsets->num * sizeof(long unsigned int));
+  if (!lazy || !lazy->address)
+    {
+      LOG_ERROR("Out of memory");
+      free(lazy);
+      return DWG_ERR_OUTOFMEM;
+    }
+  memcpy(lazy->address, offsets->address,
+         offsets->num * sizeof(long unsigned int));
+  lazy->num_address = offsets->num;
+  lazy->dat = *dat;
+  lazy->release = LAZY_KEEP;
+  dwg->lazy = lazy;
+
+  for (i = 0; i < offsets->num; i++)
+    {
+      long unsigned int address = offsets->address[i];
+      BITCODE_BS type;
+      if (address < dat->size
+          && lazy_type_is_deferred(type = peek_object_type(dat, address))
+          && decode_type_wanted(dwg, type))
+        {
+          long unsigned int oldpos = dat->byte;
+          unsigned char previous_bit = dat->bit;
+          BITCODE_BL num = dwg->num_objects;
+          int retry;
+          if (dwg_add_object(dwg) > 0)
+            return error | DWG_ERR_OUTOFMEM;
+          retry = lazy_add_object(dwg, dat, &dwg->object[num], address);
+          dat->byte = oldpos;
+          dat->bit = previous_bit;
+          if (!retry)
+            continue;
+          memset(&dwg->object[num], 0, sizeof(Dwg_Object));
+          dwg->object[num].index = num;
+          dwg->object[num].parent = dwg;
+          error |= decode_object_at(dwg, dat, hdl_dat, &dwg->object[num],
+                                    address, NULL);
+          dat->byte = oldpos;
+          dat->bit = previous_bit;
+        }
+      else
+        {
+          int added = dwg_decode_add_object(dwg, dat, hdl_dat, address);
+          if (added > 0)
+            error |= added;
+        }
+    }
+  return error;
+}
+
+/** Decodes a deferred entity, see DWG_OPTS_LAZY.
+    Its new object_refs are resolved at once.
+    Returns 0 if already decoded, or the decoder error codes.
+ */
+EXPORT int
+dwg_decode_lazy_object(Dwg_Object *restrict obj)
+{
+  Dwg_Data *dwg;
+  Dwg_Lazy *lazy;
+  Bit_Chain dat;
+  BITCODE_BL i, num_entities, num_refs;
+  Dwg_Arena *prev_arena = NULL;
+  int error;
+
+  if (!obj || obj->tio.entity || obj->supertype != DWG_SUPERTYPE_ENTITY
+      || !obj->parent)
+    return 0;
+  dwg = obj->parent;
+  lazy = dwg->lazy;
+  if (!lazy || !lazy->ready || obj->index >= lazy->num_address)
+    return 0;
+
+  LOG_TRACE("Decode deferred object %u\n", obj->index)
+  dat = lazy->dat;
+  num_entities = dwg->num_entities; // counted already
+  num_refs = dwg->num_object_refs;
+  if (dwg->arena)
+    prev_arena = arena_use(dwg->arena);
+  error = decode_object_at(dwg, &dat, &dat, obj, lazy->address[obj->index],
+                           NULL);
+  if (dwg->arena)
+    arena_use(prev_arena);
+  dwg->num_entities = num_entities;
+
+  for (i = num_refs; i < dwg->num_object_refs; i++)
+    {
+      Dwg_Object_Ref *ref = dwg->object_ref[i];
+      ref->obj = dwg_resolve_handle_silent(dwg, ref->absolute_ref);
+      if (ref->obj && dwg->object_ref_index
+          && ref->obj->index < dwg->num_object_ref_index
+          && !dwg->object_ref_index[ref->obj->index])
+        dwg->object_ref_index[ref->obj->index] = ref;
+    }
+  return error;
+}
+
+/** Decodes all deferred entities, see DWG_OPTS_LAZY.
+    Returns 0 or the combined decoder error codes.
+ */
+EXPORT int
+dwg_decode_lazy_objects(Dwg_Data *restrict dwg)
+{
+  BITCODE_BL i;
+  int error = 0;
+
+  if (!dwg->lazy)
+    return 0;
+  for (i = 0; i < dwg->num_objects; i++)
+    error |= dwg_decode_lazy_object(&dwg->object[i]);
+  return error;
+}
+
+/** Decodes and adds all objects at the collected addresses.
+    The object array is reserved once up front, so it is never
+    re-alloced while decoding.
+    With DWG_OPTS_ARENA all objects are allocated from dwg->arena.
+    With DWG_OPTS_LAZY most entities are only added, see decode_objects_lazy.
+    Large drawings are decoded in parallel, when built with pthreads.
+    Nothing is decoded if dwg->objects_filter rejects the data.
+    Returns 0 or the combined error codes of all objects.
+ */
+int
+dwg_decode_add_objects(Dwg_Data *restrict dwg, Bit_Chain* dat,
+                       Bit_Chain* hdl_dat,
+                       const Dwg_Object_Offsets *restrict offsets)
+{
+  BITCODE_BL i;
+  BITCODE_BL first = offsets->num; // the objects decoded serially
+  int error = 0;
+  Dwg_Arena *prev_arena = NULL;
+#ifdef USE_THREADS
+  unsigned num_threads = 1;
+#endif
+
+  if (dwg->objects_filter && !dwg->num_objects
+      && !dwg->objects_filter(dwg, dat->chain, dat->size))
+    {
+      LOG_TRACE("Objects skipped by the objects_filter\n")
+      return 0;
+    }
+  if (dwg_reserve_objects(dwg, dwg->num_objects + offsets->num) > 0)
+    return DWG_ERR_OUTOFMEM;
+  /* Without an arena the objects are decoded as usual */
+  if ((dwg->opts & DWG_OPTS_ARENA) && !dwg->arena && !dwg->num_objects)
+    dwg->arena = arena_new();
+  if (dwg->arena)
+    prev_arena = arena_use(dwg->arena);
+
+  if ((dwg->opts & DWG_OPTS_LAZY) && !dwg->num_objects && !dwg->lazy)
+    {
+      error = decode_objects_lazy(dwg, dat, hdl_dat, offsets);
+      if (dwg->arena)
+        arena_use(prev_arena);
+      return error;
+    }
+
+#ifdef USE_THREADS
+  /* Not with logging, which would be interleaved */
+  if (DWG_LOGLEVEL < DWG_LOGLEVEL_INFO
+      && !dwg->num_objects
+      && offsets->num >= 2 * OBJECTS_PER_THREAD)
+    {
+      /* An MLEADERSTYLE eed looks at dwg->appid_control, so decode
+         everything up to the APPID_CONTROL object serially. */
+      first = 0;
+      for (i = 0; i < offsets->num; i++)
+        {
+          if (peek_object_type(dat, offsets->address[i])
+              == DWG_TYPE_APPID_CONTROL)
+            first = i + 1;
+        }
+      num_threads = threads_num(offsets->num - first, OBJECTS_PER_THREAD);
+      if (num_threads > 1)
+        {
+          pthread_once(&decode_range_once, decode_range_key_init);
+          if (!decode_range_key_ok)
+            num_threads = 1;
+        }
+      if (num_threads < 2)
+        first = offsets->num;
+    }
+#endif
+
+  for (i = 0; i < first; i++)
+    {
+      int added = dwg_decode_add_object(dwg, dat, hdl_dat, offsets->address[i]);
+      if (added > 0)
+        error |= added;
+      //else re-allocated
+      // we don't stop encoding on single errors, but we sum them all up
+      // as combined bitmask
+    }
+#ifdef USE_THREADS
+  if (first < offsets->num)
+    error |= decode_objects_parallel(dwg, dat, hdl_dat, offsets, first,
+                                     num_threads);
+#endif
+  if (dwg->arena)
+    arena_use(prev_arena);
+  return error;
+}
+
 /** dwg_decode_unknown
    Container to hold a unknown class entity, see classes.inc
    Every DEBUGGING class holds a bits array, a bitsize, and the handle
@@ -4265,7 +4985,9 @@ dwg_validate_POLYLINE(Dwg_Object *obj)
             seqend = dwg_find_objectref(dwg, next); //usually not found, even with set hash
             if (seqend == NULL)
               {
-                seqend = (Dwg_Object_Ref*)calloc(1, sizeof(Dwg_Object_Ref));
+                seqend = dwg_new_object_ref(dwg);
+                if (!seqend)
+                  return DWG_ERR_OUTOFMEM;
                 seqend->obj = next;
                 seqend->handleref = next->handle;
                 seqend->absolute_ref = next->handle.value;
@@ -4281,7 +5003,9 @@ dwg_validate_POLYLINE(Dwg_Object *obj)
               seqend = dwg_find_objectref(dwg, next);
               if (seqend == NULL)
                 {
-                  seqend = (Dwg_Object_Ref*)calloc(1, sizeof(Dwg_Object_Ref));
+                  seqend = dwg_new_object_ref(dwg);
+                  if (!seqend)
+                    return DWG_ERR_OUTOFMEM;
                   seqend->obj = next;
                   seqend->handleref = next->handle;
                   seqend->absolute_ref = next->handle.value;
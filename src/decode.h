@@ -23,6 +23,7 @@
 
 #include "bits.h"
 #include "dwg.h"
+#include "arena.h"
 
 enum RES_BUF_VALUE_TYPE
 {
@@ -49,6 +50,31 @@ dwg_decode_unknown(Bit_Chain *restrict dat, Dwg_Object *restrict obj);
 Dwg_Object_Ref*
 dwg_find_objectref(const Dwg_Data *restrict dwg, const Dwg_Object *restrict obj);
 
+/* The object_refs are allocated in slabs, all freed at once by dwg_free.
+   Each slab is twice the size of the previous one, up to a limit. */
+typedef struct _dwg_ref_slab
+{
+  struct _dwg_ref_slab *next;
+  BITCODE_BL used;
+  BITCODE_BL size;
+  Dwg_Object_Ref ref[];
+} Dwg_Ref_Slab;
+
+/* With DWG_OPTS_LAZY: the objects stream and the start of all objects,
+   for dwg_decode_lazy_object() to decode the deferred entities. */
+typedef struct _dwg_lazy
+{
+  Bit_Chain dat;
+  long unsigned int *address; // by object index
+  BITCODE_BL num_address;
+  int ready;   // all objects are linked, dwg_decode_lazy_object may run
+  int release; // how dwg_free releases dat.chain
+} Dwg_Lazy;
+
+#define LAZY_KEEP   0 // owned by the caller
+#define LAZY_FREE   1
+#define LAZY_MUNMAP 2
+
 /*------------------------------------------------------------------------------
  * Functions reused with decode_r2007
  */
@@ -66,6 +92,23 @@ int
 dwg_decode_add_object(Dwg_Data* dwg, Bit_Chain* dat, Bit_Chain* hdl_dat,
                       long unsigned int address);
 
+/* The object addresses from the handles section (R2004+), collected first
+   and then decoded together, maybe in parallel. */
+typedef struct _dwg_object_offsets
+{
+  long unsigned int *address;
+  BITCODE_BL num;
+  BITCODE_BL size;
+} Dwg_Object_Offsets;
+
+int
+dwg_add_object_offset(Dwg_Object_Offsets *restrict offsets,
+                      long unsigned int address);
+int
+dwg_decode_add_objects(Dwg_Data *restrict dwg, Bit_Chain* dat,
+                       Bit_Chain* hdl_dat,
+                       const Dwg_Object_Offsets *restrict offsets);
+
 /* reused with free */
 void
 dwg_free_xdata_resbuf(Dwg_Resbuf *rbuf);
@@ -25,6 +25,9 @@
 #include "bits.h"
 #include "dec_macros.h"
 #include "decode.h"
+#include "decompress.h"
+#include "hash.h"
+#include "classes.h"
 
 /* The logging level for the read (decode) path.  */
 static unsigned int loglevel;
@@ -83,9 +86,18 @@ typedef struct _r2007_page
   int64_t id;
   int64_t size;
   int64_t offset;
-  struct _r2007_page *next;
 } r2007_page;
 
+/* all pages in file order, indexed by id */
+typedef struct _r2007_page_map
+{
+  r2007_page *pages;
+  uint32_t num_pages;
+  dwg_inthash *index;  // id => pages[] index, the first of each id
+  uint32_t lookups;    // for the trace
+  uint32_t scanned;    // pages compared without the index
+} r2007_page_map;
+
 /* section page */
 typedef struct _r2007_section_page
 {
@@ -112,440 +124,56 @@ typedef struct _r2007_section
   DWGCHAR *name;
   Dwg_Section_Type type;
   r2007_section_page **pages;
-  struct _r2007_section *next;
 } r2007_section;
 
+/* all sections in file order, indexed by type */
+typedef struct _r2007_section_map
+{
+  r2007_section *sections;
+  uint32_t num_sections;
+  r2007_section *by_type[SECTION_UNKNOWN + 1]; // the first of each type
+  uint32_t lookups;    // for the trace
+} r2007_section_map;
+
 /* imported */
-int rs_decode_block(BITCODE_RC *blk, int fix);
+int rs_decode_blocks(BITCODE_RC *dst, const BITCODE_RC *src, int block_count,
+                     int fix);
 
 /* private */
-static r2007_section* get_section(r2007_section *sections_map,
+static r2007_section* get_section(r2007_section_map *sections_map,
                                   Dwg_Section_Type sec_type);
-static r2007_page* get_page(r2007_page *pages_map, int64_t id);
-static void pages_destroy(r2007_page *page);
-static void sections_destroy(r2007_section *section);
-static r2007_section* read_sections_map(Bit_Chain* dat, int64_t size_comp,
-                                        int64_t size_uncomp,
-                                        int64_t correction);
+static r2007_page* get_page(r2007_page_map *pages_map, int64_t id);
+static void pages_destroy(r2007_page_map *pages_map);
+static void sections_destroy(r2007_section_map *sections_map);
+static r2007_section_map* read_sections_map(Bit_Chain* dat, int64_t size_comp,
+                                            int64_t size_uncomp,
+                                            int64_t correction);
 static int read_data_section(Bit_Chain *sec_dat, Bit_Chain *dat,
-                             r2007_section *restrict sections_map,
-                             r2007_page *restrict pages_map,
+                             r2007_section_map *restrict sections_map,
+                             r2007_page_map *restrict pages_map,
                              Dwg_Section_Type sec_type);
 static int read_2007_section_classes(Bit_Chain*restrict dat,
                                      Dwg_Data *restrict dwg,
-                                     r2007_section *restrict sections_map,
-                                     r2007_page *restrict pages_map);
+                                     r2007_section_map *restrict sections_map,
+                                     r2007_page_map *restrict pages_map);
 static int read_2007_section_header(Bit_Chain* dat, Bit_Chain* hdl_dat,
                                     Dwg_Data *restrict dwg,
-                                    r2007_section *restrict sections_map,
-                                    r2007_page *restrict pages_map);
+                                    r2007_section_map *restrict sections_map,
+                                    r2007_page_map *restrict pages_map);
 static int read_2007_section_handles(Bit_Chain* dat, Bit_Chain* hdl_dat,
                                      Dwg_Data *restrict dwg,
-                                     r2007_section *restrict sections_map,
-                                     r2007_page *restrict pages_map);
-static r2007_page* read_pages_map(Bit_Chain* dat, int64_t size_comp,
-                                  int64_t size_uncomp, int64_t correction);
+                                     r2007_section_map *restrict sections_map,
+                                     r2007_page_map *restrict pages_map);
+static r2007_page_map* read_pages_map(Bit_Chain* dat, int64_t size_comp,
+                                      int64_t size_uncomp, int64_t correction);
 static int read_file_header(Bit_Chain *restrict dat,
                             r2007_file_header *restrict file_header);
-static void read_instructions(BITCODE_RC *restrict *restrict src,
-                              BITCODE_RC *restrict opcode,
-                              uint32_t *restrict offset,
-                              uint32_t *restrict length);
-static inline BITCODE_RC* copy_bytes_2(BITCODE_RC *restrict dst, const BITCODE_RC *restrict src);
-static inline BITCODE_RC* copy_bytes_3(BITCODE_RC *restrict dst, const BITCODE_RC *restrict src);
-static void copy_bytes(BITCODE_RC *dst, uint32_t length, uint32_t offset);
-static uint32_t read_literal_length(BITCODE_RC *restrict *restrict src, unsigned char opcode);
-static void copy_compressed_bytes(BITCODE_RC *restrict dst, BITCODE_RC *restrict src, int length);
 static void  bfr_read(void *restrict dst, BITCODE_RC *restrict *restrict src, size_t size);
 static DWGCHAR* bfr_read_string(BITCODE_RC *restrict *restrict src, int64_t size);
 static BITCODE_RC* decode_rs(const BITCODE_RC *src, int block_count, int data_size);
-static int  decompress_r2007(BITCODE_RC *restrict dst, int dst_size,
-                             BITCODE_RC *restrict src, int src_size);
-
-#define copy_1(offset) \
-  *dst++ = *(src + offset);
-
-#define copy_2(offset) \
-  dst = copy_bytes_2(dst, src + offset);
-
-#define copy_3(offset) \
-  dst = copy_bytes_3(dst, src + offset)
-
-// 4 and 8 is not reverse, 16 is
-#define copy_n(n, offset) \
-  memcpy(dst, &src[offset], n); \
-  dst += n
-
-#define copy_4(offset)  copy_n(4, offset)
-#define copy_8(offset)  copy_n(8, offset)
-#define copy_16(offset) \
-  memcpy(dst, &src[offset + 8], 8); \
-  memcpy(&dst[8], &src[offset], 8); \
-  dst += 16
-
-static inline BITCODE_RC*
-copy_bytes_2(BITCODE_RC *restrict dst, const BITCODE_RC *restrict src)
-{
-  dst[0] = src[1];
-  dst[1] = src[0];
-  return dst + 2;
-}
-
-static inline BITCODE_RC*
-copy_bytes_3(BITCODE_RC *restrict dst, const BITCODE_RC *restrict src)
-{
-  dst[0] = src[2];
-  dst[1] = src[1];
-  dst[2] = src[0];
-  return dst + 3;
-}
-
-static void
-copy_bytes(BITCODE_RC *dst, uint32_t length, uint32_t offset)
-{
-  BITCODE_RC *src = dst - offset;
-
-  while (length-- > 0)
-    *dst++ = *src++;
-}
-
-
-/* See spec version 5.0 page 30 */
-static void
-copy_compressed_bytes(BITCODE_RC *restrict dst, BITCODE_RC *restrict src, int length)
-{
-  while (length >= 32)
-    {
-      copy_16(16);
-      copy_16(0);
-
-      src += 32;
-      length -= 32;
-    }
-
-  switch (length)
-  {
-    case 0:
-      break;
-    case 1:
-      copy_1(0);
-      break;
-    case 2:
-      copy_2(0);
-      break;
-    case 3:
-      copy_3(0);
-      break;
-    case 4:
-      copy_4(0);
-      break;
-    case 5:
-      copy_1(4);
-      copy_4(0);
-      break;
-    case 6:
-      copy_1(5);
-      copy_4(1);
-      copy_1(0);
-      break;
-    case 7:
-      copy_2(5);
-      copy_4(1);
-      copy_1(0);
-      break;
-    case 8:
-      copy_8(0);
-      break;
-    case 9:
-      copy_1(8);
-      copy_8(0);
-      break;
-    case 10:
-      copy_1(9);
-      copy_8(1);
-      copy_1(0);
-      break;
-    case 11:
-      copy_2(9);
-      copy_8(1);
-      copy_1(0);
-      break;
-    case 12:
-      copy_4(8);
-      copy_8(0);
-      break;
-    case 13:
-      copy_1(12);
-      copy_4(8);
-      copy_8(0);
-      break;
-    case 14:
-      copy_1(13);
-      copy_4(9);
-      copy_8(1);
-      copy_1(0);
-      break;
-    case 15:
-      copy_2(13);
-      copy_4(9);
-      copy_8(1);
-      copy_1(0);
-      break;
-    case 16:
-      copy_16(0);
-      break;
-    case 17:
-      copy_8(9);
-      copy_1(8);
-      copy_8(0);
-      break;
-    case 18:
-      copy_1(17);
-      copy_16(1);
-      copy_1(0);
-      break;
-    case 19:
-      copy_3(16);
-      copy_16(0);
-      break;
-    case 20:
-      copy_4(16);
-      copy_16(0);
-      break;
-    case 21:
-      copy_1(20);
-      copy_4(16);
-      copy_16(0);
-      break;
-    case 22:
-      copy_2(20);
-      copy_4(16);
-      copy_16(0);
-      break;
-    case 23:
-      copy_3(20);
-      copy_4(16);
-      copy_16(0);
-      break;
-    case 24:
-      copy_8(16);
-      copy_16(0);
-      break;
-    case 25:
-      copy_8(17);
-      copy_1(16);
-      copy_16(0);
-      break;
-    case 26:
-      copy_1(25);
-      copy_8(17);
-      copy_1(16);
-      copy_16(0);
-      break;
-    case 27:
-      copy_2(25);
-      copy_8(17);
-      copy_1(16);
-      copy_16(0);
-      break;
-    case 28:
-      copy_4(24);
-      copy_8(16);
-      copy_16(0);
-      break;
-    case 29:
-      copy_1(28);
-      copy_4(24);
-      copy_8(16);
-      copy_16(0);
-      break;
-    case 30:
-      copy_2(28);
-      copy_4(24);
-      copy_8(16);
-      copy_16(0);
-      break;
-    case 31:
-      copy_1(30);
-      copy_4(26);
-      copy_8(18);
-      copy_16(2);
-      copy_2(0);
-      break;
-    default:
-      LOG_ERROR("Wrong length %d", length);
-  }
-}
-
-/* See spec version 5.1 page 50 */
-static uint32_t
-read_literal_length(BITCODE_RC *restrict *src, unsigned char opcode)
-{
-  uint32_t length = opcode + 8;
-
-  if (length == 0x17)
-    {
-      int n = *(*src)++;
-
-      length += n;
-
-      if (n == 0xff)
-        {
-          do
-            {
-              n = *(*src)++;
-              n |= (*(*src)++ << 8);
-
-              length += n;
-            }
-          while (n == 0xFFFF);
-        }
-    }
-
-  return length;
-}
-
-/* See spec version 5.1 page 53 */
-static void
-read_instructions(BITCODE_RC *restrict *src, unsigned char *restrict opcode,
-                  uint32_t *restrict offset, uint32_t *restrict length)
-{
-  switch (*opcode >> 4)
-    {
-    case 0:
-      *length = (*opcode & 0xf) + 0x13;
-      *offset = *(*src)++;
-      *opcode = *(*src)++;
-      *length = ((*opcode >> 3) & 0x10) + *length;
-      *offset = ((*opcode & 0x78) << 5) + 1 + *offset;
-      break;
-
-    case 1:
-      *length = (*opcode & 0xf) + 3;
-      *offset = *(*src)++;
-      *opcode = *(*src)++;
-      *offset = ((*opcode & 0xf8) << 5) + 1 + *offset;
-      break;
-
-    case 2:
-      *offset = *(*src)++;
-      *offset = ((*(*src)++ << 8) & 0xff00) | *offset;
-      *length = *opcode & 7;
-
-      if ((*opcode & 8) == 0)
-        {
-          *opcode = *(*src)++;
-          *length = (*opcode & 0xf8) + *length;
-        }
-      else
-        {
-          (*offset)++;
-          *length = (*(*src)++ << 3) + *length;
-          *opcode = *(*src)++;
-          *length = (((*opcode & 0xf8) << 8) + *length) + 0x100;
-        }
-      break;
-
-    default:
-      *length = *opcode >> 4;
-      *offset = *opcode & 15;
-      *opcode = *(*src)++;
-      *offset = (((*opcode & 0xf8) << 1) + *offset) + 1;
-      break;
-    }
-}
-
-/* par 4.7 Compression, page 32 (same as format 2004)
-   TODO: replace by decompress_R2004_section(dat, decomp, comp_data_size)
-*/
-static int
-decompress_r2007(BITCODE_RC *restrict dst, int dst_size,
-                 BITCODE_RC *restrict src, int src_size)
-{
-  uint32_t length = 0;
-  uint32_t offset = 0;
-
-  BITCODE_RC *dst_end = dst + dst_size;
-  BITCODE_RC *src_end = src + src_size;
-  unsigned char opcode;
-
-  if (!src)
-    {
-      LOG_ERROR("Empty src argument to %s\n", __FUNCTION__);
-      return DWG_ERR_INTERNALERROR;
-    }
-  opcode = *src++;
-  LOG_INSANE("decompress_r2007(%p %d %p %d)\n", dst, dst_size, src, src_size);
-
-  if ((opcode & 0xf0) == 0x20)
-    {
-      src += 2;
-      length = *src++ & 0x07;
-
-      if (length == 0) {
-        LOG_ERROR("Decompression error: zero length")
-        return DWG_ERR_INTERNALERROR;
-      }
-    }
-
-  while (src < src_end)
-    {
-      if (length == 0)
-        length = read_literal_length(&src, opcode);
-
-      if ((dst + length) > dst_end) {
-        LOG_ERROR("Decompression error: length overflow");
-        return DWG_ERR_INTERNALERROR;
-      }
-
-      //LOG_INSANE("copy_compressed_bytes(%p %p %u)\n", dst, src, length);
-      copy_compressed_bytes(dst, src, length);
-
-      dst += length;
-      src += length;
-
-      length = 0;
-
-      if (src >= src_end)
-        return 0;
-
-      opcode = *src++;
-
-      read_instructions(&src, &opcode, &offset, &length);
-
-      while (1)
-        {
-          if ((dst + length) > dst_end) {
-            LOG_ERROR("Decompression error: length overflow");
-            return DWG_ERR_INTERNALERROR;
-          }
-          //LOG_INSANE("copy_bytes(%p %u %u)\n", dst, length, offset);
-          copy_bytes(dst, length, offset);
-
-          dst += length;
-          length = (opcode & 7);
-
-          if (length != 0 || src >= src_end)
-            break;
-
-          opcode = *src++;
-
-          if ((opcode >> 4) == 0)
-            break;
-
-          if ((opcode >> 4) == 0x0f)
-            opcode &= 0xf;
-
-          read_instructions((unsigned char**)&src, &opcode, &offset, &length);
-        }
-    }
-
-  return 0;
-}
 
-
-// reed-solomon (255, 239) encoding with factor 3
-// TODO: for now disabled, until we get proper data
+// Deinterleaves the reed-solomon (255, 251) blocks of a data page.
+// The 4 parity bytes are not checked.
 static BITCODE_RC*
 decode_rs(const BITCODE_RC *src, int block_count, int data_size)
 {
@@ -568,8 +196,6 @@ decode_rs(const BITCODE_RC *src, int block_count, int data_size)
           *dst++ = *src;
           src += block_count;
         }
-
-      //rs_decode_block((unsigned char*)(dst_base + 239*i), 1);
       src = ++src_base;
     }
 
@@ -617,10 +243,26 @@ read_system_page(Bit_Chain* dat, int64_t size_comp, int64_t size_uncomp,
 
   rsdata = &data[size_uncomp];
   bit_read_fixed(dat, rsdata, page_size);
-  pedata = decode_rs(rsdata, block_count, 239);
+  // reed-solomon (255, 239) encoding, checked and fixed block by block
+  pedata = (BITCODE_RC*)malloc(block_count * 239);
+  if (!pedata)
+    {
+      free(data);
+      LOG_ERROR("Out of memory")
+      return NULL;
+    }
+  error = rs_decode_blocks(pedata, rsdata, (int)block_count, 1);
+  if (error < 0)
+    {
+      LOG_WARN("Unrecoverable Reed-Solomon errors in system page")
+    }
+  else if (error > 0)
+    {
+      LOG_TRACE("Fixed %d Reed-Solomon errors in system page\n", error)
+    }
 
   if (size_comp < size_uncomp)
-    (void)decompress_r2007(data, size_uncomp, pedata, size_comp);
+    (void)decompress_R2007(data, size_uncomp, pedata, size_comp);
   else
     memcpy(data, pedata, size_uncomp);
   free(pedata);
@@ -628,49 +270,59 @@ read_system_page(Bit_Chain* dat, int64_t size_comp, int64_t size_uncomp,
   return data;
 }
 
+/* Decodes the RS blocks of a data page and decompresses it.
+   Runs in parallel for the pages of a section, so it doesn't log. */
 static int
-read_data_page(Bit_Chain *restrict dat, BITCODE_RC *restrict decomp,
-               int64_t page_size, int64_t size_comp, int64_t size_uncomp)
+read_data_page(Decompress_Page *page)
 {
-  int i;
   int error = 0;
 
   int64_t pesize;      // Pre RS encoded size
   int64_t block_count; // Number of RS encoded blocks
 
-  BITCODE_RC *rsdata;        // RS encoded data
   BITCODE_RC *pedata;        // Pre RS encoded data
 
   // Round to a multiple of 8
-  pesize = ((size_comp + 7) & ~7);
+  pesize = ((page->comp_size + 7) & ~7);
   block_count = (pesize + 0xFB - 1) / 0xFB;
 
-  rsdata = (BITCODE_RC*)calloc(1, page_size);
-  if (rsdata == NULL) {
-    LOG_ERROR("Out of memory")
+  pedata = decode_rs(page->src, block_count, 0xFB);
+  if (!pedata)
     return DWG_ERR_OUTOFMEM;
-  }
-  bit_read_fixed(dat, rsdata, page_size);
-  pedata = decode_rs(rsdata, block_count, 0xFB);
 
-  if (size_comp < size_uncomp)
-    error = decompress_r2007(decomp, size_uncomp, pedata, size_comp);
+  // compressed or not by the page size, dst_size only bounds the output
+  if (page->comp_size >= page->uncomp_size)
+    memcpy(page->dst, pedata, page->dst_size);
+  else if (page->dst_size == page->uncomp_size)
+    error = decompress_R2007(page->dst, page->dst_size, pedata,
+                             page->comp_size);
   else
-    memcpy(decomp, pedata, size_uncomp);
+    {
+      // the page overlaps the section end, keep only what fits
+      BITCODE_RC *data = (BITCODE_RC *)malloc(page->uncomp_size);
+      if (!data)
+        error = DWG_ERR_OUTOFMEM;
+      else
+        {
+          error = decompress_R2007(data, page->uncomp_size, pedata,
+                                   page->comp_size);
+          memcpy(page->dst, data, page->dst_size);
+          free(data);
+        }
+    }
 
   free(pedata);
-  free(rsdata);
-
   return error;
 }
 
 static int
 read_data_section(Bit_Chain *sec_dat, Bit_Chain *dat,
-                  r2007_section *restrict sections_map,
-                  r2007_page *restrict pages_map, Dwg_Section_Type sec_type)
+                  r2007_section_map *restrict sections_map,
+                  r2007_page_map *restrict pages_map, Dwg_Section_Type sec_type)
 {
   r2007_section *section;
   r2007_page *page;
+  Decompress_Page *pages;
   int64_t max_decomp_size;
   BITCODE_RC *decomp;
   int error, i;
@@ -687,35 +339,74 @@ read_data_section(Bit_Chain *sec_dat, Bit_Chain *dat,
     LOG_ERROR("Out of memory")
     return DWG_ERR_OUTOFMEM;
   }
+  pages = calloc(section->num_pages ? section->num_pages : 1,
+                 sizeof(Decompress_Page));
+  if (pages == NULL) {
+    free(decomp);
+    LOG_ERROR("Out of memory")
+    return DWG_ERR_OUTOFMEM;
+  }
 
+  /* Find all pages, and decompress them in parallel */
   for (i = 0; i < (int)section->num_pages; i++)
     {
       r2007_section_page *section_page = section->pages[i];
+      int64_t block_count
+          = (((section_page->comp_size + 7) & ~7) + 0xFB - 1) / 0xFB;
       page = get_page(pages_map, section_page->id);
       if (page == NULL)
         {
+          free(pages);
           free(decomp);
           LOG_ERROR("Failed to find page %d", (int)section_page->id)
           return DWG_ERR_PAGENOTFOUND;
         }
       if (section_page->offset > max_decomp_size)
         {
+          free(pages);
           free(decomp);
           LOG_ERROR("Invalid section_page->offset %ld > %ld",
                     (long)section_page->offset, (long)max_decomp_size)
           return DWG_ERR_VALUEOUTOFBOUNDS;
         }
+      if (page->offset < 0 || page->size < block_count * 0xFB
+          || section_page->comp_size < 0 || section_page->uncomp_size < 0
+          || (uint64_t)page->offset + page->size > dat->size)
+        {
+          free(pages);
+          free(decomp);
+          LOG_ERROR("Invalid page %d at %ld, size %ld",
+                    (int)section_page->id, (long)page->offset,
+                    (long)page->size)
+          return DWG_ERR_VALUEOUTOFBOUNDS;
+        }
 
-      dat->byte = page->offset;
-      error = read_data_page(dat, &decomp[section_page->offset], page->size,
-                             section_page->comp_size, section_page->uncomp_size);
+      pages[i].src = &dat->chain[page->offset];
+      pages[i].src_size = (uint32_t)page->size;
+      pages[i].comp_size = (uint32_t)section_page->comp_size;
+      pages[i].uncomp_size = (uint32_t)section_page->uncomp_size;
+      pages[i].dst = &decomp[section_page->offset];
+      // not beyond the section
+      pages[i].dst_size
+          = (uint32_t)(section_page->offset + section_page->uncomp_size
+                           > max_decomp_size
+                       ? max_decomp_size - section_page->offset
+                       : section_page->uncomp_size);
+    }
+
+  decompress_pages(pages, section->num_pages, read_data_page);
+  for (i = 0; i < (int)section->num_pages; i++)
+    {
+      error = pages[i].error;
       if (error)
         {
+          free(pages);
           free(decomp);
-          LOG_ERROR("Failed to read page")
+          LOG_ERROR("Failed to read page %d: error %d", i, error)
           return error;
         }
     }
+  free(pages);
 
   sec_dat->bit     = 0;
   sec_dat->byte    = 0;
@@ -772,13 +463,15 @@ bfr_read_string(BITCODE_RC *restrict *restrict src, int64_t size)
   return str_base;
 }
 
-static r2007_section*
+static r2007_section_map*
 read_sections_map(Bit_Chain* dat, int64_t size_comp,
                   int64_t size_uncomp, int64_t correction)
 {
   BITCODE_RC *data;
-  r2007_section *sections = NULL, *last_section = NULL, *section = NULL;
+  r2007_section_map *sections_map;
+  r2007_section *section = NULL;
   BITCODE_RC *ptr, *ptr_end;
+  uint32_t size = 0;
   int i, j = 0;
 
   data = read_system_page(dat, size_comp, size_uncomp, correction);
@@ -786,6 +479,13 @@ read_sections_map(Bit_Chain* dat, int64_t size_comp,
     LOG_ERROR("Failed to read system page")
     return NULL;
   }
+  sections_map = (r2007_section_map*) calloc(1, sizeof(r2007_section_map));
+  if (!sections_map)
+    {
+      LOG_ERROR("Out of memory");
+      free(data);
+      return NULL;
+    }
 
   ptr = data;
   ptr_end = data + size_uncomp;
@@ -794,13 +494,22 @@ read_sections_map(Bit_Chain* dat, int64_t size_comp,
 
   while (ptr < ptr_end)
     {
-      section = (r2007_section*) malloc(sizeof(r2007_section));
-      if (!section)
+      if (sections_map->num_sections == size)
         {
-          LOG_ERROR("Out of memory");
-          sections_destroy(sections); // the root
-          return NULL;
+          r2007_section *sections;
+          size = size ? size * 2 : 16;
+          sections = (r2007_section*) realloc(sections_map->sections,
+                                              size * sizeof(r2007_section));
+          if (!sections)
+            {
+              LOG_ERROR("Out of memory");
+              free(data);
+              sections_destroy(sections_map);
+              return NULL;
+            }
+          sections_map->sections = sections;
         }
+      section = &sections_map->sections[sections_map->num_sections++];
 
       bfr_read(section, &ptr, 64);
 
@@ -824,19 +533,9 @@ read_sections_map(Bit_Chain* dat, int64_t size_comp,
       assert(section->name_length < dat->size);
       assert(section->num_pages < DBG_MAX_COUNT);
 #endif
-      section->next  = NULL;
       section->pages = NULL;
-          section->name = NULL;
-
-      if (!sections)
-        {
-          sections = last_section = section;
-        }
-      else
-        {
-          last_section->next = section;
-          last_section = section;
-        }
+      section->name = NULL;
+      section->type = SECTION_UNKNOWN;
 
       j++;
       if (ptr >= ptr_end)
@@ -856,15 +555,13 @@ read_sections_map(Bit_Chain* dat, int64_t size_comp,
       if (section->num_pages <= 0)
         continue;
 
-      section->pages = (r2007_section_page**) malloc(
-        (size_t)section->num_pages * sizeof(r2007_section_page*));
+      section->pages = (r2007_section_page**) calloc(
+        (size_t)section->num_pages, sizeof(r2007_section_page*));
       if (!section->pages)
         {
           LOG_ERROR("Out of memory");
-          if (sections)
-            sections_destroy(sections); // the root
-          else
-            sections_destroy(section);
+          free(data);
+          sections_destroy(sections_map);
           return NULL;
         }
 
@@ -875,10 +572,8 @@ read_sections_map(Bit_Chain* dat, int64_t size_comp,
           if (!section->pages[i])
             {
               LOG_ERROR("Out of memory");
-              if (sections)
-                sections_destroy(sections); // the root
-              else
-                sections_destroy(section);
+              free(data);
+              sections_destroy(sections_map);
               return NULL;
             }
 
@@ -903,17 +598,26 @@ read_sections_map(Bit_Chain* dat, int64_t size_comp,
     }
 
   free(data);
+  // the index, the first section of each type as before
+  for (i = (int)sections_map->num_sections - 1; i >= 0; i--)
+    {
+      section = &sections_map->sections[i];
+      if ((unsigned)section->type <= SECTION_UNKNOWN)
+        sections_map->by_type[section->type] = section;
+    }
 
-  return sections;
+  return sections_map;
 }
 
-static r2007_page*
+static r2007_page_map*
 read_pages_map(Bit_Chain* dat, int64_t size_comp,
                int64_t size_uncomp, int64_t correction)
 {
   BITCODE_RC *data, *ptr, *ptr_end;
-  r2007_page *pages = 0, *last_page = 0, *page;
+  r2007_page_map *pages_map;
+  r2007_page *page;
   int64_t offset = 0x480;   //dat->byte;
+  uint32_t i;
   //int64_t index;
 
   data = read_system_page(dat, size_comp, size_uncomp, correction);
@@ -925,19 +629,24 @@ read_pages_map(Bit_Chain* dat, int64_t size_comp,
   ptr = data;
   ptr_end = data + size_uncomp;
 
+  // 16 bytes per page
+  pages_map = (r2007_page_map*) calloc(1, sizeof(r2007_page_map));
+  if (pages_map)
+    pages_map->pages = (r2007_page*) malloc(
+        (size_t)((size_uncomp + 15) / 16) * sizeof(r2007_page));
+  if (!pages_map || !pages_map->pages)
+    {
+      LOG_ERROR("Out of memory")
+      free(data);
+      free(pages_map);
+      return NULL;
+    }
+
   LOG_TRACE("\n=== System Section (Pages Map) ===\n")
 
   while (ptr < ptr_end)
     {
-      page = (r2007_page*) malloc(sizeof(r2007_page));
-      if (page == NULL)
-        {
-          LOG_ERROR("Out of memory")
-          free(data);
-          pages_destroy(pages);
-          return NULL;
-        }
-
+      page = &pages_map->pages[pages_map->num_pages++];
       page->size   = bfr_read_int64(ptr);
       page->id     = bfr_read_int64(ptr);
       page->offset = offset;
@@ -949,79 +658,78 @@ read_pages_map(Bit_Chain* dat, int64_t size_comp,
       LOG_TRACE("size: 0x%05"PRIx64" ", page->size)
       LOG_TRACE("id:      0x%"PRId64" ", page->id)
       LOG_TRACE("offset: 0x6%"PRIx64" \n", page->offset)
-
-      page->next = 0;
-
-      if (pages == 0)
-        pages = last_page = page;
-      else
-        {
-          last_page->next = page;
-          last_page = page;
-        }
     }
 
   free(data);
+  // the index, without the 0 ids
+  if (pages_map->num_pages)
+    pages_map->index = hash_new(pages_map->num_pages);
+  if (pages_map->index)
+    for (i = 0; i < pages_map->num_pages; i++)
+      {
+        uint64_t key = (uint64_t)pages_map->pages[i].id;
+        if (key && hash_get(pages_map->index, key) == HASH_NOT_FOUND)
+          hash_set(pages_map->index, key, i);
+      }
 
-  return pages;
+  return pages_map;
 }
 
 /* Lookup a page in the page map. The page is identified by its id.
  */
 static r2007_page*
-get_page(r2007_page *pages_map, int64_t id)
+get_page(r2007_page_map *pages_map, int64_t id)
 {
-  r2007_page *page = pages_map;
+  uint32_t i;
 
-  while (page != NULL)
+  pages_map->lookups++;
+  if (id && pages_map->index)
     {
-      if (page->id == id)
-        break;
-      page = page->next;
+      i = hash_get(pages_map->index, (uint64_t)id);
+      return i == HASH_NOT_FOUND ? NULL : &pages_map->pages[i];
     }
-
-  return page;
+  for (i = 0; i < pages_map->num_pages; i++)
+    {
+      pages_map->scanned++;
+      if (pages_map->pages[i].id == id)
+        return &pages_map->pages[i];
+    }
+  return NULL;
 }
 
 static void
-pages_destroy(r2007_page *page)
+pages_destroy(r2007_page_map *pages_map)
 {
-  r2007_page *next;
-
-  while (page != 0)
-    {
-      next = page->next;
-      free(page);
-      page = next;
-    }
+  if (!pages_map)
+    return;
+  if (pages_map->index)
+    hash_free(pages_map->index);
+  free(pages_map->pages);
+  free(pages_map);
 }
 
 /* Lookup a section in the section map.
  * The section is identified by its numeric type.
  */
 static r2007_section*
-get_section(r2007_section *sections_map, Dwg_Section_Type sec_type)
+get_section(r2007_section_map *sections_map, Dwg_Section_Type sec_type)
 {
-  r2007_section *section = sections_map;
-  while (section != NULL)
-    {
-      if (section->type == sec_type)
-        break;
-      section = section->next;
-    }
-
-  return section;
+  if (!sections_map || (unsigned)sec_type > SECTION_UNKNOWN)
+    return NULL;
+  sections_map->lookups++;
+  return sections_map->by_type[sec_type];
 }
 
 static void
-sections_destroy(r2007_section *section)
+sections_destroy(r2007_section_map *sections_map)
 {
-  r2007_section *next;
+  uint32_t i;
 
-  while (section != 0)
+  if (!sections_map)
+    return;
+  for (i = 0; i < sections_map->num_sections; i++)
     {
-      next = section->next;
-
+      r2007_section *section = &sections_map->sections[i];
       if (section->pages)
         {
           while (section->num_pages-- > 0)
@@ -1033,10 +741,9 @@ sections_destroy(r2007_section *section)
 
       if (section->name)
         free(section->name);
-
-      free(section);
-      section = next;
     }
+  free(sections_map->sections);
+  free(sections_map);
 }
 
 static int
@@ -1070,7 +777,8 @@ read_file_header(Bit_Chain *restrict dat, r2007_file_header *restrict file_heade
   LOG_TRACE("len2:          %d\n", (int)len2); // 0 when compressed
 
   if (compr_len > 0)
-    error = decompress_r2007((BITCODE_RC*)file_header, 0x110, &pedata[32], compr_len);
+    error = decompress_R2007((BITCODE_RC*)file_header, 0x110, &pedata[32],
+                             (uint32_t)compr_len);
   else
     memcpy(file_header, &pedata[32], sizeof(r2007_file_header));
 
@@ -1215,8 +923,8 @@ section_string_stream(Bit_Chain *restrict dat, BITCODE_RL bitsize,
 // for string stream see p86
 static int
 read_2007_section_classes(Bit_Chain*restrict dat, Dwg_Data *restrict dwg,
-                          r2007_section *restrict sections_map,
-                          r2007_page *restrict pages_map)
+                          r2007_section_map *restrict sections_map,
+                          r2007_page_map *restrict pages_map)
 {
   BITCODE_RL size, i;
   BITCODE_BS max_num;
@@ -1319,6 +1027,7 @@ read_2007_section_classes(Bit_Chain*restrict dat, Dwg_Data *restrict dwg,
           if (strcmp(dwg->dwg_class[i].dxfname, "LAYOUT") == 0)
             dwg->layout_number = dwg->dwg_class[i].number;
         }
+      dwg_resolve_classes(dwg);
     }
   else
     {
@@ -1336,8 +1045,8 @@ read_2007_section_classes(Bit_Chain*restrict dat, Dwg_Data *restrict dwg,
 static int
 read_2007_section_header(Bit_Chain*restrict dat, Bit_Chain*restrict hdl_dat,
                          Dwg_Data *restrict dwg,
-                         r2007_section *restrict sections_map,
-                         r2007_page *restrict pages_map)
+                         r2007_section_map *restrict sections_map,
+                         r2007_page_map *restrict pages_map)
 {
   Bit_Chain sec_dat = { 0 }, str_dat = { 0 };
   int error;
@@ -1391,10 +1100,11 @@ read_2007_section_header(Bit_Chain*restrict dat, Bit_Chain*restrict hdl_dat,
 static int
 read_2007_section_handles(Bit_Chain* dat, Bit_Chain* hdl,
                           Dwg_Data *restrict dwg,
-                          r2007_section *restrict sections_map,
-                          r2007_page *restrict pages_map)
+                          r2007_section_map *restrict sections_map,
+                          r2007_page_map *restrict pages_map)
 {
-  static Bit_Chain obj_dat = { 0 }, hdl_dat = { 0 };
+  Bit_Chain obj_dat = { 0 }, hdl_dat = { 0 };
+  Dwg_Object_Offsets offsets = { 0 };
   BITCODE_RS section_size = 0;
   long unsigned int endpos;
   int error;
@@ -1439,6 +1149,7 @@ read_2007_section_handles(Bit_Chain* dat, Bit_Chain* hdl,
       if (section_size > 2050)
         {
           LOG_ERROR("Object-map/handles section size greater than 2050!");
+          free(offsets.address);
           return DWG_ERR_VALUEOUTOFBOUNDS;
         }
 
@@ -1446,7 +1157,6 @@ read_2007_section_handles(Bit_Chain* dat, Bit_Chain* hdl,
       last_offset = 0;
       while (hdl_dat.byte - startpos < section_size)
         {
-          int added;
           BITCODE_UMC handle;
           BITCODE_MC offset;
 
@@ -1455,16 +1165,14 @@ read_2007_section_handles(Bit_Chain* dat, Bit_Chain* hdl,
           offset = bit_read_MC(&hdl_dat);
           //last_handle += handle;
           last_offset += offset;
-          LOG_TRACE("\nNext object: %lu\t", (unsigned long)dwg->num_objects)
+          LOG_TRACE("\nNext object: %lu\t", (unsigned long)offsets.num)
           LOG_TRACE("Handle: %lX\tOffset: " FORMAT_MC " @%lu\n",
                     handle, offset, last_offset)
 
           if (hdl_dat.byte == oldpos)
             break;
 
-          added = dwg_decode_add_object(dwg, &obj_dat, hdl, last_offset);
-          if (added > 0)
-            error |= added;
+          error |= dwg_add_object_offset(&offsets, last_offset);
         }
 
       if (hdl_dat.byte == oldpos)
@@ -1473,10 +1181,11 @@ read_2007_section_handles(Bit_Chain* dat, Bit_Chain* hdl,
       if (!bit_check_CRC(&hdl_dat, startpos, 0xC0C1))
         LOG_WARN("Handles section CRC mismatch at offset %lx", startpos);
 #else
-      crc1 = bit_calc_CRC(0xC0C1, &(hdl_dat.chain[startpos]),
-                          hdl_dat.byte - startpos);
+      crc1 = (dwg->opts & DWG_OPTS_NOCRC)
+        ? 0 : bit_calc_CRC(0xC0C1, &(hdl_dat.chain[startpos]),
+                           hdl_dat.byte - startpos);
       crc2 = bit_read_RS_LE(&hdl_dat);
-      if (crc1 == crc2)
+      if (crc1 == crc2 || (dwg->opts & DWG_OPTS_NOCRC))
         {
           LOG_INSANE("Handles section page CRC: %04X from %lx-%lx\n",
                      crc2, startpos, hdl_dat.byte-2);
@@ -1494,9 +1203,17 @@ read_2007_section_handles(Bit_Chain* dat, Bit_Chain* hdl,
     }
   while (section_size > 2);
 
+  error |= dwg_decode_add_objects(dwg, &obj_dat, hdl, &offsets);
+
+  free(offsets.address);
   if (hdl_dat.chain)
     free(hdl_dat.chain);
-  if (obj_dat.chain)
+  if (dwg->lazy && dwg->lazy->dat.chain == obj_dat.chain)
+    {
+      dwg->lazy->release = LAZY_FREE; // kept for the deferred entities
+      obj_dat.chain = NULL;
+    }
+  else if (obj_dat.chain)
     free(obj_dat.chain);
   return error;
 }
@@ -1514,8 +1231,9 @@ read_r2007_meta_data(Bit_Chain *dat, Bit_Chain *hdl_dat,
                      Dwg_Data *restrict dwg)
 {
   r2007_file_header file_header;
-  r2007_page *restrict pages_map, *restrict page;
-  r2007_section *restrict sections_map;
+  r2007_page_map *restrict pages_map;
+  r2007_page *restrict page;
+  r2007_section_map *restrict sections_map;
   int error;
 #ifdef USE_TRACING
   char *probe;
@@ -1557,6 +1275,7 @@ read_r2007_meta_data(Bit_Chain *dat, Bit_Chain *hdl_dat,
       LOG_ERROR("%s Invalid comp_data_size %lu > %lu bytes left",
                 __FUNCTION__, (unsigned long)file_header.sections_map_size_comp,
                 dat->size - dat->byte)
+      pages_destroy(pages_map);
       return DWG_ERR_VALUEOUTOFBOUNDS;
     }
   sections_map = read_sections_map(dat, file_header.sections_map_size_comp,
@@ -1568,9 +1287,15 @@ read_r2007_meta_data(Bit_Chain *dat, Bit_Chain *hdl_dat,
   error += read_2007_section_handles(dat, hdl_dat, dwg, sections_map, pages_map);
   //read_2007_blocks(dat, hdl_dat, dwg, sections_map, pages_map);
 
+  LOG_TRACE("\nPages map: %u pages, %u lookups, %u pages scanned\n",
+            (unsigned)pages_map->num_pages, (unsigned)pages_map->lookups,
+            (unsigned)pages_map->scanned)
+  if (sections_map)
+    LOG_TRACE("Sections map: %u sections, %u lookups\n",
+              (unsigned)sections_map->num_sections,
+              (unsigned)sections_map->lookups)
   pages_destroy(pages_map);
-  if (page)
-    sections_destroy(sections_map);
+  sections_destroy(sections_map);
 
   return error;
 }
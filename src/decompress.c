@@ -0,0 +1,726 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * decompress.c: the LZ77 decompressors of the R2004+ sections and of
+ *               the R2007 pages, with a common match copy.
+ * R2004 written by Rodrigo Rodrigues da Silva, R2007 by Till Heuschmann
+ * and Reini Urban.
+ */
+
+#include "decompress.h"
+#include <stdlib.h>
+#include <string.h>
+#include "threads.h"
+
+/* Copies a match of length bytes from dist bytes back. The source may
+   overlap the destination, then the last dist bytes are repeated.
+   With enough slack in dst and no overlap within a chunk, 32, 16 or 8
+   bytes are copied at once, overshooting length by up to 31 bytes.
+ */
+static inline void
+copy_match(BITCODE_RC *dst, const BITCODE_RC *dst_end, size_t dist,
+           size_t length)
+{
+  const BITCODE_RC *src = dst - dist;
+  const size_t slack = (size_t)(dst_end - dst) - length;
+
+#define COPY_CHUNKS(n)                                                        \
+  for (;;)                                                                    \
+    {                                                                         \
+      memcpy(dst, src, n);                                                    \
+      if (length <= n)                                                        \
+        return;                                                               \
+      dst += n;                                                               \
+      src += n;                                                               \
+      length -= n;                                                            \
+    }
+
+  if (!length)
+    return;
+  if (dist >= 32 && slack >= 31)
+    COPY_CHUNKS(32)
+  else if (dist >= 16 && slack >= 15)
+    COPY_CHUNKS(16)
+  else if (dist >= 8 && slack >= 7)
+    COPY_CHUNKS(8)
+#undef COPY_CHUNKS
+  else if (dist >= length)
+    memcpy(dst, src, length);
+  else if (dist == 1) // a run
+    memset(dst, *src, length);
+  else
+    while (length--)
+      *dst++ = *src++;
+}
+
+/*------------------------------------------------------------------------------
+ * R2004, 2010+
+ */
+
+/* R2004 Literal Length, or 0 with the next opcode.
+   Returns -1 at the end of src.
+ */
+static int
+read_literal_length(const BITCODE_RC *restrict *restrict srcp,
+                    const BITCODE_RC *restrict src_end,
+                    unsigned char *restrict opcode)
+{
+  const BITCODE_RC *src = *srcp;
+  int total = 0;
+  BITCODE_RC byte;
+
+  *opcode = 0x00;
+  if (src >= src_end)
+    return -1;
+  byte = *src++;
+  if (byte >= 0x01 && byte <= 0x0F)
+    total = byte + 3;
+  else if (byte == 0)
+    {
+      total = 0x0F;
+      while (src < src_end && (byte = *src++) == 0x00)
+        total += 0xFF;
+      if (!byte)
+        return -1;
+      total += byte + 3;
+    }
+  else
+    *opcode = byte;
+
+  *srcp = src;
+  return total;
+}
+
+/* R2004 Long Compression Offset. Returns -1 at the end of src.
+ */
+static int
+read_long_compression_offset(const BITCODE_RC *restrict *restrict srcp,
+                             const BITCODE_RC *restrict src_end)
+{
+  const BITCODE_RC *src = *srcp;
+  int total = 0;
+  BITCODE_RC byte;
+
+  if (src >= src_end)
+    return -1;
+  byte = *src++;
+  if (byte == 0)
+    {
+      total = 0xFF;
+      while (src < src_end && (byte = *src++) == 0x00)
+        total += 0xFF;
+      if (!byte)
+        return -1;
+    }
+  *srcp = src;
+  return total + byte;
+}
+
+/* R2004 Two Byte Offset. Returns -1 at the end of src.
+ */
+static int
+read_two_byte_offset(const BITCODE_RC *restrict *restrict srcp,
+                     const BITCODE_RC *restrict src_end,
+                     int *restrict lit_length)
+{
+  const BITCODE_RC *src = *srcp;
+  int offset;
+
+  *lit_length = 0;
+  if (src_end - src < 2)
+    return -1;
+  offset = (src[0] >> 2) | (src[1] << 6);
+  *lit_length = (src[0] & 0x03);
+  *srcp = src + 2;
+  return offset;
+}
+
+int
+decompress_R2004(BITCODE_RC *restrict dst, uint32_t dst_size,
+                 const BITCODE_RC *restrict src, uint32_t src_size,
+                 uint32_t *restrict consumed)
+{
+  BITCODE_RC *const dst_start = dst;
+  const BITCODE_RC *const dst_end = dst + dst_size;
+  const BITCODE_RC *const src_start = src;
+  const BITCODE_RC *const src_end = src + src_size;
+  int lit_length, comp_bytes, comp_offset;
+  unsigned char opcode1 = 0, opcode2;
+
+  *consumed = 0;
+  // length of the first sequence of uncompressed or literal data.
+  lit_length = read_literal_length(&src, src_end, &opcode1);
+  if (lit_length < 0 || lit_length > dst_end - dst
+      || lit_length > src_end - src)
+    return DWG_ERR_VALUEOUTOFBOUNDS;
+  memcpy(dst, src, lit_length);
+  dst += lit_length;
+  src += lit_length;
+
+  opcode1 = 0x00;
+  while (src < src_end)
+    {
+      if (opcode1 == 0x00)
+        opcode1 = *src++;
+
+      if (opcode1 >= 0x40)
+        {
+          comp_bytes = ((opcode1 & 0xF0) >> 4) - 1;
+          if (src >= src_end)
+            return DWG_ERR_VALUEOUTOFBOUNDS;
+          opcode2 = *src++;
+          comp_offset = (opcode2 << 2) | ((opcode1 & 0x0C) >> 2);
+
+          if (opcode1 & 0x03)
+            {
+              lit_length = (opcode1 & 0x03);
+              opcode1  = 0x00;
+            }
+          else
+            lit_length = read_literal_length(&src, src_end, &opcode1);
+        }
+      else if (opcode1 >= 0x21) // until 0x3F
+        {
+          comp_bytes  = opcode1 - 0x1E;
+          comp_offset = read_two_byte_offset(&src, src_end, &lit_length);
+
+          if (lit_length != 0)
+            opcode1 = 0x00;
+          else
+            lit_length = read_literal_length(&src, src_end, &opcode1);
+        }
+      else if (opcode1 == 0x20)
+        {
+          comp_bytes  = read_long_compression_offset(&src, src_end);
+          if (comp_bytes < 0)
+            return DWG_ERR_VALUEOUTOFBOUNDS;
+          comp_bytes += 0x21;
+          comp_offset = read_two_byte_offset(&src, src_end, &lit_length);
+
+          if (lit_length != 0)
+            opcode1 = 0x00;
+          else
+            lit_length = read_literal_length(&src, src_end, &opcode1);
+        }
+      else if (opcode1 >= 0x12) // until 0x1F
+        {
+          comp_bytes  = (opcode1 & 0x0F) + 2;
+          comp_offset = read_two_byte_offset(&src, src_end, &lit_length);
+          if (comp_offset >= 0)
+            comp_offset += 0x3FFF;
+
+          if (lit_length != 0)
+            opcode1 = 0x00;
+          else
+            lit_length = read_literal_length(&src, src_end, &opcode1);
+        }
+      else if (opcode1 == 0x10)
+        {
+          comp_bytes  = read_long_compression_offset(&src, src_end);
+          if (comp_bytes < 0)
+            return DWG_ERR_VALUEOUTOFBOUNDS;
+          comp_bytes += 9;
+          comp_offset = read_two_byte_offset(&src, src_end, &lit_length);
+          if (comp_offset >= 0)
+            comp_offset += 0x3FFF;
+
+          if (lit_length != 0)
+            opcode1 = 0x00;
+          else
+            lit_length = read_literal_length(&src, src_end, &opcode1);
+        }
+      else if (opcode1 == 0x11)
+          break;     // Terminates the input stream, everything is ok
+      else
+        {
+          *consumed = (uint32_t)(src - src_start);
+          return DWG_ERR_INTERNALERROR;  // invalid opcode
+        }
+
+      if (comp_offset < 0 || lit_length < 0)
+        return DWG_ERR_VALUEOUTOFBOUNDS;
+      // copy "compressed data"
+      if (comp_offset + 1 > dst - dst_start || comp_bytes > dst_end - dst)
+        return DWG_ERR_VALUEOUTOFBOUNDS;
+      copy_match(dst, dst_end, (size_t)comp_offset + 1, (size_t)comp_bytes);
+      dst += comp_bytes;
+
+      // copy "literal data"
+      if (lit_length > dst_end - dst || lit_length > src_end - src)
+        return DWG_ERR_VALUEOUTOFBOUNDS;
+      memcpy(dst, src, lit_length);
+      dst += lit_length;
+      src += lit_length;
+    }
+
+  *consumed = (uint32_t)(src - src_start);
+  return 0;  // Success
+}
+
+/*------------------------------------------------------------------------------
+ * R2007
+ */
+
+#define copy_1(offset) \
+  *dst++ = *(src + offset);
+
+#define copy_2(offset) \
+  dst = copy_bytes_2(dst, src + offset);
+
+#define copy_3(offset) \
+  dst = copy_bytes_3(dst, src + offset)
+
+// 4 and 8 is not reverse, 16 is
+#define copy_n(n, offset) \
+  memcpy(dst, &src[offset], n); \
+  dst += n
+
+#define copy_4(offset)  copy_n(4, offset)
+#define copy_8(offset)  copy_n(8, offset)
+#define copy_16(offset) \
+  memcpy(dst, &src[offset + 8], 8); \
+  memcpy(&dst[8], &src[offset], 8); \
+  dst += 16
+
+static inline BITCODE_RC*
+copy_bytes_2(BITCODE_RC *restrict dst, const BITCODE_RC *restrict src)
+{
+  dst[0] = src[1];
+  dst[1] = src[0];
+  return dst + 2;
+}
+
+static inline BITCODE_RC*
+copy_bytes_3(BITCODE_RC *restrict dst, const BITCODE_RC *restrict src)
+{
+  dst[0] = src[2];
+  dst[1] = src[1];
+  dst[2] = src[0];
+  return dst + 3;
+}
+
+/* See spec version 5.0 page 30 */
+static void
+copy_compressed_bytes(BITCODE_RC *restrict dst, const BITCODE_RC *restrict src,
+                      int length)
+{
+  while (length >= 32)
+    {
+      copy_16(16);
+      copy_16(0);
+
+      src += 32;
+      length -= 32;
+    }
+
+  switch (length)
+  {
+    case 0:
+      break;
+    case 1:
+      copy_1(0);
+      break;
+    case 2:
+      copy_2(0);
+      break;
+    case 3:
+      copy_3(0);
+      break;
+    case 4:
+      copy_4(0);
+      break;
+    case 5:
+      copy_1(4);
+      copy_4(0);
+      break;
+    case 6:
+      copy_1(5);
+      copy_4(1);
+      copy_1(0);
+      break;
+    case 7:
+      copy_2(5);
+      copy_4(1);
+      copy_1(0);
+      break;
+    case 8:
+      copy_8(0);
+      break;
+    case 9:
+      copy_1(8);
+      copy_8(0);
+      break;
+    case 10:
+      copy_1(9);
+      copy_8(1);
+      copy_1(0);
+      break;
+    case 11:
+      copy_2(9);
+      copy_8(1);
+      copy_1(0);
+      break;
+    case 12:
+      copy_4(8);
+      copy_8(0);
+      break;
+    case 13:
+      copy_1(12);
+      copy_4(8);
+      copy_8(0);
+      break;
+    case 14:
+      copy_1(13);
+      copy_4(9);
+      copy_8(1);
+      copy_1(0);
+      break;
+    case 15:
+      copy_2(13);
+      copy_4(9);
+      copy_8(1);
+      copy_1(0);
+      break;
+    case 16:
+      copy_16(0);
+      break;
+    case 17:
+      copy_8(9);
+      copy_1(8);
+      copy_8(0);
+      break;
+    case 18:
+      copy_1(17);
+      copy_16(1);
+      copy_1(0);
+      break;
+    case 19:
+      copy_3(16);
+      copy_16(0);
+      break;
+    case 20:
+      copy_4(16);
+      copy_16(0);
+      break;
+    case 21:
+      copy_1(20);
+      copy_4(16);
+      copy_16(0);
+      break;
+    case 22:
+      copy_2(20);
+      copy_4(16);
+      copy_16(0);
+      break;
+    case 23:
+      copy_3(20);
+      copy_4(16);
+      copy_16(0);
+      break;
+    case 24:
+      copy_8(16);
+      copy_16(0);
+      break;
+    case 25:
+      copy_8(17);
+      copy_1(16);
+      copy_16(0);
+      break;
+    case 26:
+      copy_1(25);
+      copy_8(17);
+      copy_1(16);
+      copy_16(0);
+      break;
+    case 27:
+      copy_2(25);
+      copy_8(17);
+      copy_1(16);
+      copy_16(0);
+      break;
+    case 28:
+      copy_4(24);
+      copy_8(16);
+      copy_16(0);
+      break;
+    case 29:
+      copy_1(28);
+      copy_4(24);
+      copy_8(16);
+      copy_16(0);
+      break;
+    case 30:
+      copy_2(28);
+      copy_4(24);
+      copy_8(16);
+      copy_16(0);
+      break;
+    case 31:
+      copy_1(30);
+      copy_4(26);
+      copy_8(18);
+      copy_16(2);
+      copy_2(0);
+      break;
+    default:
+      break;
+  }
+}
+
+/* See spec version 5.1 page 50. Returns 1 at the end of src. */
+static int
+read_literal_length_2007(const BITCODE_RC *restrict *restrict srcp,
+                         const BITCODE_RC *restrict src_end,
+                         unsigned char opcode, uint32_t *restrict length)
+{
+  const BITCODE_RC *src = *srcp;
+
+  *length = opcode + 8;
+  if (*length == 0x17)
+    {
+      uint32_t n;
+      if (src >= src_end)
+        return 1;
+      n = *src++;
+      *length += n;
+
+      if (n == 0xff)
+        {
+          do
+            {
+              if (src_end - src < 2)
+                return 1;
+              n = src[0] | (src[1] << 8);
+              src += 2;
+
+              *length += n;
+            }
+          while (n == 0xFFFF);
+        }
+    }
+
+  *srcp = src;
+  return 0;
+}
+
+/* See spec version 5.1 page 53. Returns 1 at the end of src. */
+static int
+read_instructions(const BITCODE_RC *restrict *restrict srcp,
+                  const BITCODE_RC *restrict src_end,
+                  unsigned char *restrict opcode,
+                  uint32_t *restrict offset, uint32_t *restrict length)
+{
+  const BITCODE_RC *src = *srcp;
+  const ptrdiff_t avail = src_end - src;
+
+  switch (*opcode >> 4)
+    {
+    case 0:
+      if (avail < 2)
+        return 1;
+      *length = (*opcode & 0xf) + 0x13;
+      *offset = *src++;
+      *opcode = *src++;
+      *length = ((*opcode >> 3) & 0x10) + *length;
+      *offset = ((*opcode & 0x78) << 5) + 1 + *offset;
+      break;
+
+    case 1:
+      if (avail < 2)
+        return 1;
+      *length = (*opcode & 0xf) + 3;
+      *offset = *src++;
+      *opcode = *src++;
+      *offset = ((*opcode & 0xf8) << 5) + 1 + *offset;
+      break;
+
+    case 2:
+      if (avail < ((*opcode & 8) ? 4 : 3))
+        return 1;
+      *offset = *src++;
+      *offset = ((*src++ << 8) & 0xff00) | *offset;
+      *length = *opcode & 7;
+
+      if ((*opcode & 8) == 0)
+        {
+          *opcode = *src++;
+          *length = (*opcode & 0xf8) + *length;
+        }
+      else
+        {
+          (*offset)++;
+          *length = (*src++ << 3) + *length;
+          *opcode = *src++;
+          *length = (((*opcode & 0xf8) << 8) + *length) + 0x100;
+        }
+      break;
+
+    default:
+      if (avail < 1)
+        return 1;
+      *length = *opcode >> 4;
+      *offset = *opcode & 15;
+      *opcode = *src++;
+      *offset = (((*opcode & 0xf8) << 1) + *offset) + 1;
+      break;
+    }
+
+  *srcp = src;
+  return 0;
+}
+
+/* par 4.7 Compression, page 32 (same as format 2004)
+ */
+int
+decompress_R2007(BITCODE_RC *restrict dst, uint32_t dst_size,
+                 const BITCODE_RC *restrict src, uint32_t src_size)
+{
+  uint32_t length = 0;
+  uint32_t offset = 0;
+
+  BITCODE_RC *const dst_start = dst;
+  const BITCODE_RC *const dst_end = dst + dst_size;
+  const BITCODE_RC *const src_end = src + src_size;
+  unsigned char opcode;
+
+  if (!src || !src_size)
+    return DWG_ERR_INTERNALERROR;
+  opcode = *src++;
+
+  if ((opcode & 0xf0) == 0x20)
+    {
+      if (src_end - src < 3)
+        return DWG_ERR_VALUEOUTOFBOUNDS;
+      src += 2;
+      length = *src++ & 0x07;
+
+      if (length == 0) // zero length
+        return DWG_ERR_INTERNALERROR;
+    }
+
+  while (src < src_end)
+    {
+      if (length == 0
+          && read_literal_length_2007(&src, src_end, opcode, &length))
+        return DWG_ERR_VALUEOUTOFBOUNDS;
+
+      if (length > (uint32_t)(dst_end - dst)) // length overflow
+        return DWG_ERR_INTERNALERROR;
+      if (length > (uint32_t)(src_end - src))
+        return DWG_ERR_VALUEOUTOFBOUNDS;
+
+      copy_compressed_bytes(dst, src, length);
+
+      dst += length;
+      src += length;
+
+      length = 0;
+
+      if (src >= src_end)
+        return 0;
+
+      opcode = *src++;
+
+      if (read_instructions(&src, src_end, &opcode, &offset, &length))
+        return DWG_ERR_VALUEOUTOFBOUNDS;
+
+      while (1)
+        {
+          if (length > (uint32_t)(dst_end - dst)) // length overflow
+            return DWG_ERR_INTERNALERROR;
+          if (offset > (uint32_t)(dst - dst_start))
+            return DWG_ERR_VALUEOUTOFBOUNDS;
+          copy_match(dst, dst_end, offset, length);
+
+          dst += length;
+          length = (opcode & 7);
+
+          if (length != 0 || src >= src_end)
+            break;
+
+          opcode = *src++;
+
+          if ((opcode >> 4) == 0)
+            break;
+
+          if ((opcode >> 4) == 0x0f)
+            opcode &= 0xf;
+
+          if (read_instructions(&src, src_end, &opcode, &offset, &length))
+            return DWG_ERR_VALUEOUTOFBOUNDS;
+        }
+    }
+
+  return 0;
+}
+
+/*------------------------------------------------------------------------------
+ * Pages
+ */
+
+#ifdef USE_THREADS
+
+/* Don't start a thread for less pages */
+#define PAGES_PER_THREAD 4
+
+typedef struct _decompress_pool
+{
+  Decompress_Page *pages;
+  Decompress_Page_Fn fn;
+} Decompress_Pool;
+
+static void
+decompress_page_item(void *arg, unsigned i)
+{
+  Decompress_Pool *pool = (Decompress_Pool *)arg;
+  Decompress_Page *page = &pool->pages[i];
+
+  if (!page->error)
+    page->error = pool->fn(page);
+}
+
+/* Whether the pages write to separate, ascending parts of dst.
+   Otherwise a later page must overwrite an earlier one. */
+static int
+pages_disjoint(const Decompress_Page *pages, unsigned num_pages)
+{
+  unsigned i;
+  for (i = 1; i < num_pages; i++)
+    if (pages[i].dst < pages[i - 1].dst + pages[i - 1].dst_size)
+      return 0;
+  return 1;
+}
+
+#endif /* USE_THREADS */
+
+void
+decompress_pages(Decompress_Page *pages, unsigned num_pages,
+                 Decompress_Page_Fn fn)
+{
+  unsigned i;
+#ifdef USE_THREADS
+  unsigned num_threads = threads_num(num_pages, PAGES_PER_THREAD);
+
+  if (num_threads > 1 && pages_disjoint(pages, num_pages))
+    {
+      Decompress_Pool pool;
+      pool.pages = pages;
+      pool.fn = fn;
+      threads_run(num_threads, num_pages, decompress_page_item, &pool);
+      return;
+    }
+#endif
+  for (i = 0; i < num_pages; i++)
+    if (!pages[i].error)
+      pages[i].error = fn(&pages[i]);
+}
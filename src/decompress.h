@@ -0,0 +1,65 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+#ifndef DECOMPRESS_H
+#define DECOMPRESS_H
+
+/*
+ * decompress.h: the LZ77 decompressors of the R2004+ sections and of
+ *               the R2007 pages.
+ *
+ * Both check all reads against src_size and all writes against dst_size,
+ * and return 0 or DWG_ERR_VALUEOUTOFBOUNDS, DWG_ERR_INTERNALERROR for
+ * invalid data.
+ * The bytes of dst behind the decompressed data, up to dst_size, may be
+ * overwritten.
+ */
+#ifndef _WIN32
+#include "config.h"
+#else
+#include "config_win32.h"
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include "dwg.h"
+
+/* R2004, 2010+. Sets *consumed to the number of read bytes. */
+int decompress_R2004(BITCODE_RC *restrict dst, uint32_t dst_size,
+                     const BITCODE_RC *restrict src, uint32_t src_size,
+                     uint32_t *restrict consumed);
+/* R2007 */
+int decompress_R2007(BITCODE_RC *restrict dst, uint32_t dst_size,
+                     const BITCODE_RC *restrict src, uint32_t src_size);
+
+/* A page of a section, decompressed independently of the others */
+typedef struct _decompress_page
+{
+  const BITCODE_RC *src;
+  uint32_t src_size;
+  uint32_t comp_size; /* R2007: the size before the RS encoding */
+  uint32_t uncomp_size; /* R2007: the page size, dst_size may be less */
+  BITCODE_RC *dst;
+  uint32_t dst_size;
+  int error;
+} Decompress_Page;
+
+typedef int (*Decompress_Page_Fn)(Decompress_Page *page);
+
+/* Calls fn for all pages without an error, in parallel with
+   LIBREDWG_THREADS or the number of online CPUs threads. Pages with
+   overlapping dst are decompressed serially, in order.
+   The errors are left in the pages.
+ */
+void decompress_pages(Decompress_Page *pages, unsigned num_pages,
+                      Decompress_Page_Fn fn);
+
+#endif
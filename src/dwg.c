@@ -27,7 +27,18 @@
 #include <string.h>
 #include <stdbool.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <assert.h>
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+# include <sys/mman.h>
+# define USE_MMAP 1
+#endif
+#ifndef O_BINARY
+# define O_BINARY 0
+#endif
 
 #include "bits.h"
 #include "common.h"
@@ -52,7 +63,47 @@ static bool env_var_checked_p;
  * Public functions
  */
 Dwg_Object *
-dwg_resolve_handle_silent(const Dwg_Data * dwg, const BITCODE_BL absref);
+dwg_resolve_handle_silent(const Dwg_Data * dwg, const long unsigned int absref);
+
+/* Map a regular file read-only into dat->chain, without copying.
+   dat->size must already be set to the file size.
+   Returns 0 on success, or DWG_ERR_IOERROR if the file cannot be mapped,
+   in which case the caller falls back to reading it into memory.
+ */
+static int dat_map_fd (Bit_Chain *restrict dat, int fd)
+{
+#ifdef USE_MMAP
+  void *map;
+
+  if (!dat->size)
+    return DWG_ERR_IOERROR;
+  map = mmap(NULL, dat->size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED)
+    {
+      LOG_TRACE("mmap failed, reading the file instead\n")
+      return DWG_ERR_IOERROR;
+    }
+  dat->chain = (unsigned char *)map;
+  return 0;
+#else
+  (void)dat;
+  (void)fd;
+  return DWG_ERR_IOERROR;
+#endif
+}
+
+/* Release the input chain, either mapped or read into memory. */
+static void dat_release (Bit_Chain *restrict dat, const int mapped)
+{
+#ifdef USE_MMAP
+  if (mapped)
+    munmap(dat->chain, dat->size);
+  else
+#endif
+    free(dat->chain);
+  dat->chain = NULL;
+  dat->size = 0;
+}
 
 static int dat_read_file (Bit_Chain *restrict dat, FILE *restrict fp,
                           const char *restrict filename)
@@ -80,71 +131,265 @@ static int dat_read_file (Bit_Chain *restrict dat, FILE *restrict fp,
   return 0;
 }
 
-static int dat_read_stream (Bit_Chain *restrict dat, FILE *restrict fp)
+/* Initial buffer size for streams of unknown size, which then grows
+   geometrically. Streams larger than STREAM_SPOOL_SIZE are spooled to an
+   unlinked temporary file and mapped, instead of growing on the heap. */
+#define STREAM_CHUNK 65536
+#define STREAM_SPOOL_SIZE (64 * 1024 * 1024)
+
+#ifdef USE_MMAP
+/* Write the already read part and the rest of the stream to a tmpfile
+   and map it. dat->chain (of size cap) is reused as copy buffer.
+   Returns 0 on success, -1 if no tmpfile could be created, so the caller
+   keeps reading into memory, or some DWG_ERR_* otherwise.
+ */
+static int dat_spool_stream (Bit_Chain *restrict dat, FILE *restrict fp,
+                             size_t cap, int *restrict mapped)
 {
-  size_t size = 0;
-
-  do {
-    if (dat->chain)
-      dat->chain = (unsigned char *) realloc(dat->chain, dat->size + 4096);
-    else {
-      dat->chain = (unsigned char *) calloc(1, 4096);
+  size_t size;
+  int error = 0;
+  FILE *tmp = tmpfile();
+
+  if (!tmp)
+    return -1;
+  LOG_TRACE("Spooling stream > %lu to a tmpfile\n", (unsigned long)dat->size)
+  if (fwrite(dat->chain, 1, dat->size, tmp) != dat->size)
+    error = DWG_ERR_IOERROR;
+  while (!error && (size = fread(dat->chain, 1, cap, fp)) > 0)
+    {
+      if (fwrite(dat->chain, 1, size, tmp) != size)
+        error = DWG_ERR_IOERROR;
+      dat->size += size;
+    }
+  free(dat->chain);
+  dat->chain = NULL;
+  if (error || ferror(fp) || fflush(tmp))
+    {
+      LOG_ERROR("Could not spool stream to a tmpfile\n")
+      fclose(fp);
+      fclose(tmp);
       dat->size = 0;
+      return DWG_ERR_IOERROR;
     }
-    if (!dat->chain)
-      {
-        LOG_ERROR("Not enough memory.\n");
-        fclose(fp);
-        return DWG_ERR_OUTOFMEM;
-      }
-    size = fread(&dat->chain[dat->size], sizeof(char), 4096, fp);
-    dat->size += size;
-  } while (size == 4096);
+  if (dat_map_fd(dat, fileno(tmp)))
+    {
+      // read it back then
+      rewind(tmp);
+      error = dat_read_file(dat, tmp, "<tmpfile>");
+      if (error)
+        {
+          fclose(fp);
+          return error;
+        }
+    }
+  else
+    *mapped = 1;
+  fclose(tmp);
+  return 0;
+}
+#endif
+
+/* Read a stream of unknown size into dat->chain.
+   hint is the expected size or 0. Sets mapped if the stream was spooled
+   to a tmpfile and mapped. fp is closed on errors only.
+ */
+static int dat_read_stream (Bit_Chain *restrict dat, FILE *restrict fp,
+                            size_t hint, int *restrict mapped)
+{
+  size_t size;
+  size_t cap = hint ? hint + 1 : STREAM_CHUNK; // +1 to see EOF without growing
 
-  if (dat->size == 0)
+  *mapped = 0;
+  dat->size = 0;
+  dat->chain = (unsigned char *) malloc(cap);
+  if (!dat->chain)
     {
-      LOG_ERROR("Could not read from stream (%lu out of %lu)\n",
-                (long unsigned int)size, dat->size);
+      LOG_ERROR("Not enough memory.\n");
+      fclose(fp);
+      return DWG_ERR_OUTOFMEM;
+    }
+  while ((size = fread(&dat->chain[dat->size], 1, cap - dat->size, fp)) > 0)
+    {
+      unsigned char *chain;
+      dat->size += size;
+      if (dat->size < cap)
+        continue; // short read: EOF or error on the next fread
+#ifdef USE_MMAP
+      if (cap >= STREAM_SPOOL_SIZE)
+        {
+          int error = dat_spool_stream(dat, fp, cap, mapped);
+          if (error >= 0)
+            return error;
+        }
+#endif
+      chain = (unsigned char *) realloc(dat->chain, cap * 2);
+      if (!chain)
+        {
+          LOG_ERROR("Not enough memory.\n");
+          fclose(fp);
+          free(dat->chain);
+          dat->chain = NULL;
+          dat->size = 0;
+          return DWG_ERR_OUTOFMEM;
+        }
+      dat->chain = chain;
+      cap *= 2;
+    }
+
+  if (dat->size == 0 || ferror(fp))
+    {
+      LOG_ERROR("Could not read from stream (%lu bytes)\n", dat->size);
       fclose(fp);
       free(dat->chain);
       dat->chain = NULL;
+      dat->size = 0;
       return DWG_ERR_IOERROR;
     }
 
-  // clear the slack and realloc
-  size = dat->size & 0xfff;
-  if (size)
+  // give back the slack
+  if (dat->size < cap)
     {
-      memset(&dat->chain[dat->size], 0, 0xfff - size);
-      dat->chain = (unsigned char *) realloc(dat->chain, dat->size);
+      unsigned char *chain = (unsigned char *) realloc(dat->chain, dat->size);
+      if (chain)
+        dat->chain = chain;
     }
   return 0;
 }
 
-/** dwg_read_file
+/* Decode the loaded chain and release it afterwards.
+   The decoder copies everything it keeps, so the chain can be a mapping.
+   Only with DWG_OPTS_LAZY it may keep it until dwg_free. */
+static int dat_decode (Bit_Chain *restrict dat, Dwg_Data *restrict dwg,
+                       const int mapped, const char *restrict filename)
+{
+  Bit_Chain orig = *dat;
+  int error = dwg_decode(dat, dwg);
+  if (error >= DWG_ERR_CRITICAL)
+    {
+      LOG_ERROR("Failed to decode file: %s 0x%x\n", filename, error)
+    }
+  // R13-R2000 deferred entities are decoded from the chain itself
+  if (dwg->lazy && dwg->lazy->dat.chain == orig.chain)
+    dwg->lazy->release = mapped ? LAZY_MUNMAP : LAZY_FREE;
+  else
+    dat_release(&orig, mapped);
+  dat->chain = NULL;
+  dat->size = 0;
+  return error;
+}
+
+/** dwg_read_fd
  * returns 0 on success.
  *
+ * Decodes a DWG from an open file descriptor, which stays open.
+ * Regular files are mapped read-only and decoded straight from the page
+ * cache, without a copy. Pipes and files which cannot be mapped are read
+ * into memory as before.
  * everything in dwg is cleared
  * and then either read from dat, or set to a default.
  */
 int
-dwg_read_file(const char *restrict filename, Dwg_Data *restrict dwg)
+dwg_read_fd(int fd, Dwg_Data *restrict dwg)
 {
   FILE *fp;
   struct stat attrib;
-  size_t size;
   Bit_Chain bit_chain = { 0 };
-  int error;
-
-  loglevel = dwg->opts;
+  int error, dupfd, mapped = 0;
+  const unsigned int opts = dwg->opts;
+  int (*decode_filter)(const Dwg_Data *, const unsigned int)
+    = (opts & DWG_OPTS_DECODE_FILTER) ? dwg->decode_filter : NULL;
+  int (*objects_filter)(const Dwg_Data *, const unsigned char *,
+                        const long unsigned int)
+    = (opts & DWG_OPTS_OBJECTS_FILTER) ? dwg->objects_filter : NULL;
+
+  loglevel = opts & 0xf;
   memset(dwg, 0, sizeof(Dwg_Data));
-  dwg->opts = loglevel;
+  dwg->opts = opts;
+  dwg->decode_filter = decode_filter;
+  dwg->objects_filter = objects_filter;
+
+  if (fstat(fd, &attrib))
+    {
+      LOG_ERROR("Could not stat file descriptor %d\n", fd)
+      return DWG_ERR_IOERROR;
+    }
+  if (S_ISREG (attrib.st_mode))
+    {
+      bit_chain.size = attrib.st_size;
+      if (!dat_map_fd(&bit_chain, fd))
+        return dat_decode(&bit_chain, dwg, 1, "<mmap>");
+    }
 
-  if (!strcmp(filename, "-"))
+  /* Not mappable: load the whole file or stream into memory */
+  dupfd = dup(fd);
+  fp = dupfd >= 0 ? fdopen(dupfd, "rb") : NULL;
+  if (!fp)
     {
-      fp = stdin;
+      LOG_ERROR("Could not open file descriptor %d\n", fd)
+      if (dupfd >= 0)
+        close(dupfd);
+      return DWG_ERR_IOERROR;
     }
+  if (S_ISREG (attrib.st_mode))
+    error = dat_read_file(&bit_chain, fp, "<fd>");
   else
+    error = dat_read_stream(&bit_chain, fp,
+                            attrib.st_size > 0 ? (size_t)attrib.st_size : 0,
+                            &mapped);
+  if (error >= DWG_ERR_CRITICAL)
+    return error;
+  fclose(fp);
+
+  return dat_decode(&bit_chain, dwg, mapped, "<fd>");
+}
+
+/** dwg_read_mmap
+ * returns 0 on success.
+ *
+ * Like dwg_read_file, but only for regular files, which are mapped
+ * read-only instead of being read into memory.
+ * Falls back to reading the file if it cannot be mapped.
+ */
+int
+dwg_read_mmap(const char *restrict filename, Dwg_Data *restrict dwg)
+{
+  int fd, error;
+
+  fd = open(filename, O_RDONLY | O_BINARY);
+  if (fd < 0)
+    {
+      loglevel = dwg->opts & 0xf;
+      LOG_ERROR("Could not open file: %s\n", filename)
+      return DWG_ERR_IOERROR;
+    }
+  error = dwg_read_fd(fd, dwg);
+  close(fd);
+  return error;
+}
+
+/** dwg_read_file
+ * returns 0 on success.
+ *
+ * everything in dwg is cleared
+ * and then either read from dat, or set to a default.
+ */
+int
+dwg_read_file(const char *restrict filename, Dwg_Data *restrict dwg)
+{
+  FILE *fp;
+  struct stat attrib;
+  Bit_Chain bit_chain = { 0 };
+  int error, mapped;
+  size_t hint = 0;
+  const unsigned int opts = dwg->opts;
+  int (*decode_filter)(const Dwg_Data *, const unsigned int)
+    = (opts & DWG_OPTS_DECODE_FILTER) ? dwg->decode_filter : NULL;
+  int (*objects_filter)(const Dwg_Data *, const unsigned char *,
+                        const long unsigned int)
+    = (opts & DWG_OPTS_OBJECTS_FILTER) ? dwg->objects_filter : NULL;
+
+  loglevel = opts & 0xf;
+  if (strcmp(filename, "-"))
     {
       if (stat(filename, &attrib))
         {
@@ -160,49 +405,33 @@ dwg_read_file(const char *restrict filename, Dwg_Data *restrict dwg)
           LOG_ERROR("Error: %s\n", filename);
           return DWG_ERR_IOERROR;
         }
-      fp = fopen(filename, "rb");
+      /* mapped, or read into memory if that fails */
+      return dwg_read_mmap(filename, dwg);
     }
-  if (!fp)
+
+  fp = stdin;
+  if (!fstat(fileno(fp), &attrib))
     {
-      LOG_ERROR("Could not open file: %s\n", filename)
-      return DWG_ERR_IOERROR;
+      /* redirected from a file: map it */
+      if (S_ISREG (attrib.st_mode) && ftell(fp) == 0)
+        return dwg_read_fd(fileno(fp), dwg);
+      if (attrib.st_size > 0)
+        hint = attrib.st_size;
     }
+  memset(dwg, 0, sizeof(Dwg_Data));
+  dwg->opts = opts;
+  dwg->decode_filter = decode_filter;
+  dwg->objects_filter = objects_filter;
 
-  /* Load whole file into memory, even if streamed (for now)
+  /* Load whole stream into memory, or spool it if too large
    */
   memset(&bit_chain, 0, sizeof(Bit_Chain));
-  if (fp == stdin)
-    {
-      error = dat_read_stream(&bit_chain, fp);
-      if (error >= DWG_ERR_CRITICAL)
-        return error;
-    }
-  else
-    {
-      bit_chain.size = attrib.st_size;
-      error = dat_read_file(&bit_chain, fp, filename);
-      if (error >= DWG_ERR_CRITICAL)
-        return error;
-    }
-  fclose(fp);
-
-  /* Decode the dwg structure */
-  error = dwg_decode(&bit_chain, dwg);
+  error = dat_read_stream(&bit_chain, fp, hint, &mapped);
   if (error >= DWG_ERR_CRITICAL)
-    {
-      LOG_ERROR("Failed to decode file: %s 0x%x\n", filename, error)
-      free(bit_chain.chain);
-      bit_chain.chain = NULL;
-      bit_chain.size = 0;
-      return error;
-    }
-
-  //TODO: does dwg hold any char* pointers to the bit_chain or are they all copied?
-  free(bit_chain.chain);
-  bit_chain.chain = NULL;
-  bit_chain.size = 0;
+    return error;
+  fclose(fp);
 
-  return error;
+  return dat_decode(&bit_chain, dwg, mapped, filename);
 }
 
 /* if write support is enabled */
@@ -223,6 +452,7 @@ dxf_read_file(const char *restrict filename, Dwg_Data *restrict dwg)
   struct stat attrib;
   size_t size;
   Bit_Chain dat = { 0 };
+  const unsigned int opts = dwg->opts;
 
   if (stat(filename, &attrib))
     {
@@ -247,9 +477,9 @@ dxf_read_file(const char *restrict filename, Dwg_Data *restrict dwg)
 
   /* Load whole file into memory
    */
-  loglevel = dwg->opts;
+  loglevel = opts & 0xf;
   memset(dwg, 0, sizeof(Dwg_Data));
-  dwg->opts = loglevel;
+  dwg->opts = opts;
   memset(&dat, 0, sizeof(Bit_Chain));
   dat.size = attrib.st_size;
   dat.chain = (unsigned char *) calloc(1, dat.size);
@@ -310,63 +540,97 @@ dxf_read_file(const char *restrict filename, Dwg_Data *restrict dwg)
 }
 
 int
-dwg_write_file(const char *restrict filename, const Dwg_Data *restrict dwg)
+dwg_write_fd(int fd, const Dwg_Data *restrict dwg)
 {
   FILE *fh;
   struct stat attrib;
   Bit_Chain dat = { 0 };
-  int error;
+  int error, dupfd, mapped = 0;
 
-  assert(filename);
   assert(dwg);
+  loglevel = dwg->opts & 0xf;
   dat.version = (Dwg_Version_Type)dwg->header.version;
   dat.from_version = (Dwg_Version_Type)dwg->header.from_version;
 
-  // Encode the DWG struct
-  dat.size = 0;
+  /* The encoder seeks back to patch sizes and CRCs, so only an empty
+     read-write regular file can be mapped and written in place. */
+#ifdef USE_MMAP
+  mapped = !fstat(fd, &attrib) && S_ISREG (attrib.st_mode)
+           && (fcntl(fd, F_GETFL) & O_ACCMODE) == O_RDWR
+           && lseek(fd, 0, SEEK_CUR) == 0;
+#else
+  (void)attrib;
+#endif
+  dupfd = dup(fd);
+  fh = dupfd >= 0 ? fdopen(dupfd, mapped ? "r+b" : "wb") : NULL;
+  if (!fh)
+    {
+      LOG_ERROR("Could not open file descriptor %d\n", fd)
+      if (dupfd >= 0)
+        close(dupfd);
+      return DWG_ERR_IOERROR;
+    }
+  if (mapped)
+    dat.fh = fh;
+
+  // Encode the DWG struct, into the mapped file or into memory
   error = dwg_encode ((Dwg_Data *)dwg, &dat);
   if (error >= DWG_ERR_CRITICAL)
     {
       LOG_ERROR("Failed to encode datastructure.\n")
-      if (dat.size > 0) {
-        free (dat.chain);
-        dat.chain = NULL;
-        dat.size = 0;
-      }
-      return error;
     }
+  // Write the data into the file, if it was not mapped
+  else if (!dat.fh
+           && fwrite (dat.chain, sizeof (char), dat.size, fh) != dat.size)
+    {
+      LOG_ERROR("Failed to write data into file descriptor %d\n", fd)
+      error |= DWG_ERR_IOERROR;
+    }
+#ifdef USE_MMAP
+  // If mapping failed after the file was extended, cut off the rest
+  else if (mapped && !dat.fh
+           && (fflush (fh) || ftruncate (fileno (fh), dat.size)))
+    {
+      LOG_ERROR("Failed to truncate file descriptor %d\n", fd)
+      error |= DWG_ERR_IOERROR;
+    }
+#endif
+  error |= bit_chain_free(&dat);
+  if (fclose (fh))
+    error |= DWG_ERR_IOERROR;
+  return error;
+}
+
+int
+dwg_write_file(const char *restrict filename, const Dwg_Data *restrict dwg)
+{
+  struct stat attrib;
+  int fd, error;
+
+  assert(filename);
+  assert(dwg);
+  loglevel = dwg->opts & 0xf;
 
   // try opening the output file in write mode
   if (!stat (filename, &attrib))
     {
       LOG_ERROR("The file already exists. We won't overwrite it.")
-      return error | DWG_ERR_IOERROR;
+      return DWG_ERR_IOERROR;
     }
-  fh = fopen (filename, "wb");
-  if (!fh)
+  fd = open (filename, O_RDWR | O_CREAT | O_EXCL | O_BINARY, 0666);
+  if (fd < 0)
     {
       LOG_ERROR("Failed to create the file: %s\n", filename)
-      return error | DWG_ERR_IOERROR;
+      return DWG_ERR_IOERROR;
     }
-
-  // Write the data into the file
-  if (fwrite (dat.chain, sizeof (char), dat.size, fh) != dat.size)
+  error = dwg_write_fd(fd, dwg);
+  if (close (fd))
+    error |= DWG_ERR_IOERROR;
+  if (error >= DWG_ERR_CRITICAL)
     {
-      LOG_ERROR("Failed to write data into the file: %s\n", filename)
-      fclose (fh);
-      free (dat.chain);
-      dat.chain = NULL;
-      dat.size = 0;
-      return error | DWG_ERR_IOERROR;
+      LOG_ERROR("Failed to write the file: %s\n", filename)
+      unlink (filename);
     }
-  fclose (fh);
-
-  if (dat.size > 0) {
-    free (dat.chain);
-    dat.chain = NULL;
-    dat.size = 0;
-  }
-
   return error;
 }
 #endif /* USE_WRITE */
@@ -559,7 +823,8 @@ dwg_get_num_entities(const Dwg_Data *dwg)
   return dwg->num_entities;
 }
 
-/** Returns a copy of all entities */
+/** Returns a copy of all entities.
+    Entities deferred by DWG_OPTS_LAZY are NULL, see dwg_decode_lazy_objects(). */
 Dwg_Object_Entity **
 dwg_get_entities(const Dwg_Data *dwg)
 {
@@ -646,9 +911,9 @@ dwg_ref_object_relative(const Dwg_Data *restrict dwg,
  * TODO: Check and update each handleref obj cache.
  */
 Dwg_Object *
-dwg_resolve_handle(const Dwg_Data * dwg, const BITCODE_BL absref)
+dwg_resolve_handle(const Dwg_Data * dwg, const long unsigned int absref)
 {
-  uint32_t i = hash_get(dwg->object_map, (uint32_t)absref);
+  uint32_t i = hash_get(dwg->object_map, (uint64_t)absref);
   LOG_HANDLE("object_map{%lX} => %u\n", (unsigned long)absref, i);
   if (i == HASH_NOT_FOUND ||
       (BITCODE_BL)i >= dwg->num_objects) //the latter being an invalid handle (read from DWG)
@@ -656,7 +921,7 @@ dwg_resolve_handle(const Dwg_Data * dwg, const BITCODE_BL absref)
       // ignore warning on invalid handles. These are warned earlier already
       if (absref && absref < dwg->num_objects)
         {
-          LOG_WARN("Object handle not found, " FORMAT_BL " in " FORMAT_BL " objects",
+          LOG_WARN("Object handle not found, %lu in " FORMAT_BL " objects",
                    absref, dwg->num_objects);
         }
       return NULL;
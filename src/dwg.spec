@@ -1678,16 +1678,16 @@ static int decode_3dsolid(Bit_Chain* dat, Bit_Chain* hdl_dat,
           do
             {
               FIELD_VALUE(encr_sat_data) = (char**)
-                realloc(FIELD_VALUE(encr_sat_data), (i+1) * sizeof (char*));
+                arena_realloc(FIELD_VALUE(encr_sat_data), (i+1) * sizeof (char*));
               FIELD_VALUE(block_size) = (BITCODE_BL*)
-                realloc(FIELD_VALUE(block_size), (i+1) * sizeof (BITCODE_BL));
+                arena_realloc(FIELD_VALUE(block_size), (i+1) * sizeof (BITCODE_BL));
               FIELD_BL (block_size[i], 0);
               FIELD_TF (encr_sat_data[i], FIELD_VALUE(block_size[i]), 1);
               total_size += FIELD_VALUE (block_size[i]);
             } while (FIELD_VALUE (block_size[i++]));
 
           // de-obfuscate SAT data
-          FIELD_VALUE(acis_data) = malloc (total_size+1);
+          FIELD_VALUE(acis_data) = arena_malloc (total_size+1);
           num_blocks = i-1;
           FIELD_VALUE(num_blocks) = num_blocks;
           index = 0;
@@ -1726,8 +1726,8 @@ static int decode_3dsolid(Bit_Chain* dat, Bit_Chain* hdl_dat,
           FIELD_VALUE(acis_data) = NULL;
           //TODO string in strhdl, even <r2007
           FIELD_VALUE(num_blocks) = 2;
-          FIELD_VALUE(block_size) = calloc(2, sizeof (BITCODE_RL));
-          FIELD_VALUE(encr_sat_data) = calloc(2, sizeof (char*));
+          FIELD_VALUE(block_size) = arena_calloc(2, sizeof (BITCODE_RL));
+          FIELD_VALUE(encr_sat_data) = arena_calloc(2, sizeof (char*));
           FIELD_TF (encr_sat_data[0], 15, 1); // "ACIS BinaryFile"
           FIELD_VALUE(block_size[0]) = 15;
           FIELD_RL (block_size[1], 0);
@@ -5256,9 +5256,9 @@ DWG_OBJECT(XRECORD)
            vcount++)
         {
           FIELD_VALUE(objid_handles) = vcount
-            ? realloc(FIELD_VALUE(objid_handles),
+            ? arena_realloc(FIELD_VALUE(objid_handles),
                                    (vcount+1) * sizeof(Dwg_Object_Ref))
-            : malloc(sizeof(Dwg_Object_Ref));
+            : arena_malloc(sizeof(Dwg_Object_Ref));
           FIELD_HANDLE_N (objid_handles[vcount], vcount, ANYCODE, 0);
           if (!FIELD_VALUE(objid_handles[vcount]))
             break;
@@ -6499,7 +6499,7 @@ DWG_OBJECT(SUN)
   FIELD_BS(unknown, 421); //16777215
   DEBUG_HERE_OBJ
   //27 111111111100001000000000 011 [32,58]
-  bit_advance_position(dat, 24);
+  DECODER_OR_ENCODER { bit_advance_position(dat, 24); }
   FIELD_BD (intensity, 40); //01
   FIELD_B (has_shadow, 291); //1
   FIELD_BL (julian_day, 91); // same as TIMEBLL
@@ -6508,7 +6508,7 @@ DWG_OBJECT(SUN)
   //
   DEBUG_HERE_OBJ //128
   //22 0 010000001011000000010 | 14 0 1011000000010
-  bit_advance_position(dat, 21);
+  DECODER_OR_ENCODER { bit_advance_position(dat, 21); }
 
   //FIELD_BD (altitude, 0); //calculated? 10
   //FIELD_BD (azimuth, 0);  //calculated? 10
@@ -6538,7 +6538,7 @@ DWG_OBJECT(SUN)
     FIELD_VECTOR (bits, B, num_bits, 0);
   }
 #endif
-  bit_set_position(dat, rcount1 + 60);
+  DECODER_OR_ENCODER { bit_set_position(dat, rcount1 + 60); }
 
 #if 0
   //find handle stream
@@ -6858,7 +6858,7 @@ DWG_OBJECT(ASSOCACTION)
   FIELD_BL (body.value, 0); //rbuf really
   //FIELD_B (is_actionevaluation_in_progress, 90);
   DEBUG_POS_OBJ
-  bit_set_position(dat, rcount1 + 27);
+  DECODER_OR_ENCODER { bit_set_position(dat, rcount1 + 27); }
   FIELD_BL (status, 90); //27-36
   if (FIELD_VALUE(status)>0x100) {
     LOG_ERROR("Invalid ASSOCACTION.status " FORMAT_BL, FIELD_VALUE(status));
@@ -6902,11 +6902,11 @@ DWG_OBJECT(ASSOCOSNAPPOINTREFACTIONPARAM)
   FIELD_BS (num_params, 90); //1
   DEBUG_HERE_OBJ
 
-  bit_advance_position(dat, 122-118);
+  DECODER_OR_ENCODER { bit_advance_position(dat, 122-118); }
   START_HANDLE_STREAM;
   DEBUG_POS_OBJ
   FIELD_HANDLE (writedep, ANYCODE, 360); //122-129
-  bit_advance_position(dat, 168-130);
+  DECODER_OR_ENCODER { bit_advance_position(dat, 168-130); }
   DEBUG_POS_OBJ
   FIELD_HANDLE (actionparam, 4, 330); //168-175
   REACTORS(4);
@@ -42,6 +42,35 @@
 */
 static Dwg_Version_Type dwg_version = R_INVALID;
 
+/* Returns the utf-8 name: since r2007 a malloc'd copy, which the caller
+   must free. Else the field itself. */
+static char *
+dwg_api_name_copy(Dwg_Data *restrict dwg, char *restrict name)
+{
+  Dwg_Version_Type version = dwg ? (Dwg_Version_Type)dwg->header.version
+                                 : dwg_version;
+  if (version < R_2007 || !name)
+    return name;
+  return bit_convert_TU((BITCODE_TU)name);
+}
+
+/* Returns the utf-8 name: since r2007 the copy interned in the dwg, see
+   dwg_intern_TU(), so it must not be freed. Else the field itself. */
+static char *
+dwg_api_name(Dwg_Data *restrict dwg, char *restrict name)
+{
+  Dwg_Version_Type version = dwg ? (Dwg_Version_Type)dwg->header.version
+                                 : dwg_version;
+  if (version < R_2007)
+    return name;
+  if (!dwg)
+    {
+      LOG_ERROR("%s: no dwg to hold the copy", __FUNCTION__)
+      return NULL;
+    }
+  return dwg_intern_TU(dwg, (BITCODE_TU)name);
+}
+
 /********************************************************************
  * Functions to return NULL-terminated array of all owned entities  *
  ********************************************************************/
@@ -3166,10 +3195,8 @@ dwg_ent_block_get_name(const dwg_ent_block *restrict block,
   if (block)
     {
       *error = 0;
-      if (dwg_version >= R_2007)
-        return bit_convert_TU((BITCODE_TU)block->name);
-      else
-        return block->name;
+      return dwg_api_name_copy(block->parent ? block->parent->dwg : NULL,
+                               block->name);
     }
   else
     {
@@ -5110,10 +5137,9 @@ dwg_obj_mlinestyle_get_name(const dwg_obj_mlinestyle *restrict mlinestyle,
   if (mlinestyle)
     {
       *error = 0;
-      if (dwg_version >= R_2007)
-        return bit_convert_TU((BITCODE_TU)mlinestyle->name);
-      else
-        return mlinestyle->name;
+      return dwg_api_name_copy(mlinestyle->parent ? mlinestyle->parent->dwg
+                                                  : NULL,
+                               mlinestyle->name);
     }
   else
     {
@@ -5436,10 +5462,8 @@ dwg_obj_appid_get_name(const dwg_obj_appid *restrict appid,
   if (appid)
     {
       *error = 0;
-      if (dwg_version >= R_2007)
-        return bit_convert_TU((BITCODE_TU)appid->name);
-      else
-        return appid->name;
+      return dwg_api_name_copy(appid->parent ? appid->parent->dwg : NULL,
+                               appid->name);
     }
   else
     {
@@ -5540,13 +5564,10 @@ dwg_ent_dim_get_block_name(const dwg_ent_dim *restrict dim,
 {
   if (dim)
     {
-      char *name = ((dwg_ent_dim_linear *)dim)->
-                     block->obj->tio.object->tio.BLOCK_HEADER->name;
+      Dwg_Object *obj = ((dwg_ent_dim_linear *)dim)->block->obj;
       *error = 0;
-      if (dwg_version >= R_2007)
-        return bit_convert_TU((BITCODE_TU)name);
-      else
-        return name;
+      return dwg_api_name_copy(obj->parent,
+                               obj->tio.object->tio.BLOCK_HEADER->name);
     }
   else
     {
@@ -18089,10 +18110,8 @@ dwg_obj_block_header_get_name(const dwg_obj_block_header *restrict hdr,
   if (hdr)
     {
       *error = 0;
-      if (dwg_version >= R_2007)
-        return bit_convert_TU((BITCODE_TU)hdr->name);
-      else
-        return hdr->name;
+      return dwg_api_name_copy(hdr->parent ? hdr->parent->dwg : NULL,
+                               hdr->name);
     }
   else
     {
@@ -18162,6 +18181,8 @@ dwg_get_block_header(dwg_data *restrict dwg,
 ********************************************************************/
 
 /** Get name of the layer (utf-8 encoded)
+    Since r2007 it returns a malloc'd copy, before the direct reference to the
+    dwg field.
 \code Usage: char* layer_name = dwg_obj_layer_get_name(layer, &error);
 \endcode
 \param[in]  layer
@@ -18174,10 +18195,34 @@ dwg_obj_layer_get_name(const dwg_obj_layer *restrict layer,
   if (layer)
     {
       *error = 0;
-      if (dwg_version >= R_2007)
-        return bit_convert_TU((BITCODE_TU)layer->name);
-      else
-        return layer->name;
+      return dwg_api_name_copy(layer->parent ? layer->parent->dwg : NULL,
+                               layer->name);
+    }
+  else
+    {
+      *error = 1;
+      LOG_ERROR("%s: empty arg", __FUNCTION__)
+      return NULL;
+    }
+}
+
+/** Get name of the layer (utf-8 encoded), never to be freed.
+    Since r2007 it returns the copy owned by the dwg, see dwg_intern_TU(),
+    before the direct reference to the dwg field.
+\code Usage: char* layer_name = dwg_obj_layer_get_name_interned(layer, &error);
+\endcode
+\param[in]  layer
+\param[out] error  set to 0 for ok, >0 if not found.
+*/
+char *
+dwg_obj_layer_get_name_interned(const dwg_obj_layer *restrict layer,
+                                int *restrict error)
+{
+  if (layer)
+    {
+      *error = 0;
+      return dwg_api_name(layer->parent ? layer->parent->dwg : NULL,
+                          layer->name);
     }
   else
     {
@@ -18388,19 +18433,32 @@ dwg_ref_get_table_name(const dwg_object_ref *restrict ref,
   return name;
 }
 
-// TODO: the same for the dwg_tbl_generic obj
-
-/** Get name of the table object entry (utf-8 encoded)
-    Since r2007 it returns a malloc'd copy, before the direct reference to the
-    dwg field.
-\code Usage: char* name = dwg_obj_table_get_name(obj, &error);
+/** Returns name of the referenced table entry (as UTF-8), never to be freed.
+    Defaults to ByLayer.
+    Since r2007 it returns the copy owned by the dwg, see dwg_intern_TU(),
+    before the direct reference to the dwg field or the constant "ByLayer".
+\code Usage: char* name = dwg_ref_get_table_name_interned(ref, &error);
 \endcode
-\param[in]  obj    a TABLE dwg_object*
-\param[out] error  set to 0 for ok, >0 if not found.
+\param[in]  ref     dwg_obj_ref*   A handle
+\param[out] error   int*, is set to 0 for ok, 1 on error
 */
 char *
-dwg_obj_table_get_name(const dwg_object *restrict obj,
-                       int *restrict error)
+dwg_ref_get_table_name_interned(const dwg_object_ref *restrict ref,
+                                int *restrict error)
+{
+  char *name = NULL;
+  if (ref && ref->obj)
+    name = dwg_obj_table_get_name_interned(ref->obj, error);
+  if (!name)
+    name = (char*)"ByLayer";
+  return name;
+}
+
+// TODO: the same for the dwg_tbl_generic obj
+
+/* the name field of the table object entry */
+static char *
+dwg_obj_table_name(const dwg_object *restrict obj, int *restrict error)
 {
   if (obj &&
       obj->supertype == DWG_SUPERTYPE_OBJECT &&
@@ -18411,10 +18469,7 @@ dwg_obj_table_get_name(const dwg_object *restrict obj,
       // TODO: Dictionary also?
       Dwg_Object_STYLE *table = obj->tio.object->tio.STYLE;
       *error = 0;
-      if (obj->parent->header.version >= R_2007)
-        return bit_convert_TU((BITCODE_TU)table->name); //creates a copy
-      else
-        return table->name;
+      return table->name;
     }
   else
     {
@@ -18425,6 +18480,38 @@ dwg_obj_table_get_name(const dwg_object *restrict obj,
     }
 }
 
+/** Get name of the table object entry (utf-8 encoded)
+    Since r2007 it returns a malloc'd copy, before the direct reference to the
+    dwg field.
+\code Usage: char* name = dwg_obj_table_get_name(obj, &error);
+\endcode
+\param[in]  obj    a TABLE dwg_object*
+\param[out] error  set to 0 for ok, >0 if not found.
+*/
+char *
+dwg_obj_table_get_name(const dwg_object *restrict obj,
+                       int *restrict error)
+{
+  char *name = dwg_obj_table_name(obj, error);
+  return name ? dwg_api_name_copy(obj->parent, name) : NULL;
+}
+
+/** Get name of the table object entry (utf-8 encoded), never to be freed.
+    Since r2007 it returns the copy owned by the dwg, see dwg_intern_TU(),
+    before the direct reference to the dwg field.
+\code Usage: char* name = dwg_obj_table_get_name_interned(obj, &error);
+\endcode
+\param[in]  obj    a TABLE dwg_object*
+\param[out] error  set to 0 for ok, >0 if not found.
+*/
+char *
+dwg_obj_table_get_name_interned(const dwg_object *restrict obj,
+                                int *restrict error)
+{
+  char *name = dwg_obj_table_name(obj, error);
+  return name ? dwg_api_name(obj->parent, name) : NULL;
+}
+
 
 /*******************************************************************
 *                    FUNCTIONS FOR GENERIC ENTITY                  *
@@ -18452,6 +18539,28 @@ dwg_ent_get_layer_name(const dwg_obj_ent *restrict ent,
   return name;
 }
 
+/** Returns the entity layer name (as UTF-8), or "0", never to be freed.
+    Since r2007 it returns the copy owned by the dwg, see dwg_intern_TU(),
+    before the direct reference to the dwg field or the constant "0".
+\code Usage: char* layer = dwg_ent_get_layer_name_interned(ent, &error);
+\endcode
+\param[in]  ent     dwg_obj_ent*
+\param[out] error   int*, is set to 0 for ok, 1 on error
+*/
+char *
+dwg_ent_get_layer_name_interned(const dwg_obj_ent *restrict ent,
+                                int *restrict error)
+{
+  char *name = NULL;
+  Dwg_Object* layer = ent->layer ? ent->layer->obj : NULL;
+
+  if (layer)
+    name = dwg_obj_table_get_name_interned(layer, error);
+  if (!name)
+    name = (char*)"0";
+  return name;
+}
+
 /** Returns the entity bitsize
 \code Usage: bitsize = dwg_ent_get_bitsize(ent, &error);
 \endcode
@@ -18866,6 +18975,8 @@ dwg_object_to_entity(dwg_object *restrict obj,
       *error = 0;
       if (dwg_version == R_INVALID)
         dwg_version = (Dwg_Version_Type)obj->parent->header.version;
+      if (!obj->tio.entity) // deferred with DWG_OPTS_LAZY
+        *error = dwg_decode_lazy_object(obj) >= DWG_ERR_CRITICAL;
       return obj->tio.entity;
     }
   else
@@ -19331,6 +19442,8 @@ dwg_ref_get_object(const dwg_object_ref *restrict ref,
   if (ref)
     {
       *error = 0;
+      if (ref->obj && !ref->obj->tio.entity) // deferred with DWG_OPTS_LAZY
+        (void)dwg_decode_lazy_object(ref->obj);
       return ref->obj;
     }
   else
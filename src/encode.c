@@ -40,6 +40,7 @@
 #include "common.h"
 #include "bits.h"
 #include "dwg.h"
+#include "classes.h"
 #include "encode.h"
 #include "decode.h"
 
@@ -546,6 +547,8 @@ dwg_encode_add_object(Dwg_Object *restrict obj, Bit_Chain *restrict dat, unsigne
 
 static int
 dwg_encode_xdata(Bit_Chain *restrict dat, Dwg_Object_XRECORD *restrict obj, int size);
+static size_t
+encode_size_estimate(const Dwg_Data *restrict dwg);
 
 /*--------------------------------------------------------------------------------
  * Public functions
@@ -589,7 +592,26 @@ dwg_encode(Dwg_Data *restrict dwg, Bit_Chain *restrict dat)
     }
 #endif  /* USE_TRACING */
 
-  bit_chain_alloc(dat);
+  // the objects skipped by dwg->decode_filter are missing
+  for (j = 0; j < dwg->num_objects; j++)
+    if (dwg->object[j].supertype == DWG_SUPERTYPE_UNKNOWN
+        && !dwg->object[j].tio.unknown)
+      {
+        LOG_ERROR("Object %u was skipped by the decode_filter, "
+                  "cannot encode", (unsigned)j)
+        return DWG_ERR_INVALIDDWG;
+      }
+
+  // allocate (or map) the whole output at once
+  if (!dat->size || !dat->chain)
+    bit_chain_init(dat, encode_size_estimate(dwg));
+  else
+    bit_chain_alloc(dat);
+  if (!dat->chain)
+    {
+      LOG_ERROR("Out of memory")
+      return DWG_ERR_OUTOFMEM;
+    }
   hdl_dat = dat;
 
   /*------------------------------------------------------------
@@ -694,10 +716,8 @@ dwg_encode(Dwg_Data *restrict dwg, Bit_Chain *restrict dat)
       }
     LOG_TRACE("\n#### Write 2004 File Header ####\n");
     dat->byte = 0x80;
-    if (dat->byte+0x80 >= dat->size - 1) {
-      dat->size = dat->byte + 0x80;
+    while (dat->byte + 0x80 >= dat->size - 1)
       bit_chain_alloc(dat);
-    }
     memcpy(&dat->chain[0x80], encrypted_data, size);
     LOG_INFO("@0x%lx\n", dat->byte);
 
@@ -1141,6 +1161,23 @@ dwg_section_page_checksum(const uint32_t seed, Bit_Chain *dat, uint32_t size)
 
 #include "dwg.spec"
 
+/* The size of the output, from the sizes of the decoded objects.
+   Objects without a size (new ones) are guessed, and 1/8 is added for
+   the maps and section headers.
+ */
+static size_t
+encode_size_estimate(const Dwg_Data *restrict dwg)
+{
+  size_t size = 0x1000 + dwg->picture.size + dwg->num_classes * 64;
+  BITCODE_BL i;
+
+  for (i = 0; i < dwg->num_objects; i++)
+    size += (dwg->object[i].size ? dwg->object[i].size : 128) + 4;
+  // the object map: about 4 bytes per handle and offset
+  size += dwg->num_objects * 8;
+  return size + size / 8;
+}
+
 /** dwg_encode_variable_type
  * Encode object by class name, not type. if type > 500.
  * Returns 0 on success, else some Dwg_Error.
@@ -26,13 +26,20 @@
 #endif
 #include <string.h>
 #include <assert.h>
+#if defined(HAVE_MMAP) && defined(HAVE_SYS_MMAN_H)
+# include <sys/mman.h>
+# define USE_MMAP 1
+#endif
 
 #include "common.h"
 #include "bits.h"
 #include "dwg.h"
+#include "classes.h"
 #include "decode.h"
 #include "free.h"
 #include "hash.h"
+#include "arena.h"
+#include "intern.h"
 
 static unsigned int loglevel;
 #ifdef USE_TRACING
@@ -54,6 +61,8 @@ static Bit_Chain *dat = &pdat;
 #define IS_FREE
 
 #define FREE_IF(ptr) { if (ptr) free(ptr); ptr = NULL; }
+/* the eed is also freed by the decoder, maybe in an arena */
+#define FREE_EED(ptr) { if (ptr) arena_release(ptr); ptr = NULL; }
 
 #define VALUE(value,type,dxf)
 #define VALUE_RC(value,dxf) VALUE(value, RC, dxf)
@@ -346,20 +355,20 @@ dwg_free_eed(Dwg_Object* obj)
   if (obj->supertype == DWG_SUPERTYPE_ENTITY) {
     Dwg_Object_Entity* _obj = obj->tio.entity;
     for (i=0; i < _obj->num_eed; i++) {
-      FREE_IF(_obj->eed[i].raw);
-      FREE_IF(_obj->eed[i].data);
+      FREE_EED(_obj->eed[i].raw);
+      FREE_EED(_obj->eed[i].data);
     }
-    FREE_IF(_obj->eed);
+    FREE_EED(_obj->eed);
     _obj->num_eed = 0;
   }
   else {
     Dwg_Object_Object* _obj = obj->tio.object;
     if (!_obj) return;
     for (i=0; i < _obj->num_eed; i++) {
-      FREE_IF(_obj->eed[i].raw);
-      FREE_IF(_obj->eed[i].data);
+      FREE_EED(_obj->eed[i].raw);
+      FREE_EED(_obj->eed[i].data);
     }
-    FREE_IF(_obj->eed);
+    FREE_EED(_obj->eed);
     _obj->num_eed = 0;
   }
 }
@@ -409,6 +418,15 @@ dwg_free_object(Dwg_Object *obj)
     return;
   if (obj->type == DWG_TYPE_FREED || obj->tio.object == NULL)
     return;
+  // freed alone, not by dwg_free: unmap its handle
+  if (dwg->object_map
+      && hash_get(dwg->object_map, obj->handle.value) == obj->index)
+    hash_del(dwg->object_map, obj->handle.value);
+  if (dwg->arena) // freed with the arena
+    {
+      obj->type = DWG_TYPE_FREED;
+      return;
+    }
   dat->from_version = dat->version;
   if (obj->supertype == DWG_SUPERTYPE_UNKNOWN)
     goto unhandled;
@@ -723,12 +741,20 @@ dwg_free(Dwg_Data * dwg)
         }
 #endif  /* USE_TRACING */
       LOG_INFO("\n============\ndwg_free\n")
+      // the header vars are version dependent, also when no object is freed
+      dat->version = dwg->header.version;
+      dat->from_version = dwg->header.from_version;
+      // first, so that the objects are not unmapped one by one
+      if (dwg->object_map)
+        hash_free (dwg->object_map);
+      dwg->object_map = NULL;
       // copied table fields have duplicate pointers, but are freed only once
-      for (i=0; i < dwg->num_objects; ++i)
-        {
-          if (!dwg_obj_is_control(&dwg->object[i]))
-            dwg_free_object(&dwg->object[i]);
-        }
+      if (!dwg->arena)
+        for (i=0; i < dwg->num_objects; ++i)
+          {
+            if (!dwg_obj_is_control(&dwg->object[i]))
+              dwg_free_object(&dwg->object[i]);
+          }
       FREE_IF(dwg->header.section);
       dwg_free_header_vars(dwg);
       if (dwg->picture.size && dwg->picture.chain)
@@ -739,11 +765,12 @@ dwg_free(Dwg_Data * dwg)
         FREE_IF(dwg->header.section_info);
       for (i=0; i < dwg->second_header.num_handlers; i++)
         FREE_IF(dwg->second_header.handlers[i].data);
-      for (i=0; i < dwg->num_objects; ++i)
-        {
-          if (dwg_obj_is_control(&dwg->object[i]))
-            dwg_free_object(&dwg->object[i]);
-        }
+      if (!dwg->arena)
+        for (i=0; i < dwg->num_objects; ++i)
+          {
+            if (dwg_obj_is_control(&dwg->object[i]))
+              dwg_free_object(&dwg->object[i]);
+          }
       if (dwg->num_classes)
         {
           for (i=0; i < dwg->num_classes; ++i)
@@ -756,14 +783,36 @@ dwg_free(Dwg_Data * dwg)
             }
           FREE_IF(dwg->dwg_class);
         }
-      for (i=0; i < dwg->num_object_refs; ++i)
+      FREE_IF(dwg->class_dispatch);
+      // the object_refs themselves are in the slabs
+      FREE_IF(dwg->object_ref);
+      FREE_IF(dwg->object_ref_index);
+      while (dwg->ref_slab)
         {
-          FREE_IF(dwg->object_ref[i]);
+          Dwg_Ref_Slab *next = dwg->ref_slab->next;
+          free(dwg->ref_slab);
+          dwg->ref_slab = next;
         }
-      FREE_IF(dwg->object_ref);
+      if (dwg->lazy)
+        {
+          Dwg_Lazy *lazy = dwg->lazy;
+#ifdef USE_MMAP
+          if (lazy->release == LAZY_MUNMAP)
+            munmap(lazy->dat.chain, lazy->dat.size);
+          else
+#endif
+          if (lazy->release == LAZY_FREE)
+            free(lazy->dat.chain);
+          free(lazy->address);
+          free(lazy);
+          dwg->lazy = NULL;
+        }
+      intern_free(dwg->strings);
+      dwg->strings = NULL;
+      // all objects at once
+      arena_free(dwg->arena);
+      dwg->arena = NULL;
       FREE_IF(dwg->object);
-      if (dwg->object_map)
-        hash_free (dwg->object_map);
 #undef FREE_IF
     }
 }
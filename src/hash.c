@@ -12,8 +12,12 @@
 
 /*
  * hash.c: int hashmap for the object_ref map.
- *         uses linear probing for best cache usage.
- *         values are inlined into the array.
+ *         A Swiss table: every slot has a control byte, which is empty,
+ *         deleted, or the low 7 bits of the hash of its key. A lookup
+ *         compares a group of 16 control bytes at once (with SSE2), and
+ *         only looks at the keys with matching bits.
+ *         The groups are probed quadratically, the table is kept at most
+ *         7/8 full.
  * written by Reini Urban
  */
 
@@ -21,159 +25,288 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
 //#include "logging.h"
 
+#define HASH_GROUP 16
+#define HASH_EMPTY ((int8_t)-128)
+#define HASH_DELETED ((int8_t)-2)
+// 7/8 max load
+#define HASH_MAX_LOAD(size) ((size) - (size) / 8)
+
+// the murmur3 64-bit finalizer
+static inline uint64_t hash_func(uint64_t key)
+{
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return key;
+}
+// Handles are dense and mostly ascending. So the slot keeps the low bits
+// of the key, for locality with few collisions, and only the control
+// byte is mixed.
+#define HASH_POS(key) ((uint32_t)(key) ^ (uint32_t)((key) >> 32))
+#define HASH_H2(h) ((int8_t)((h) & 0x7f))
+
+static inline unsigned hash_ctz(uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned)__builtin_ctz(mask);
+#else
+  unsigned i = 0;
+  while (!(mask & 1))
+    {
+      mask >>= 1;
+      i++;
+    }
+  return i;
+#endif
+}
+
+// bitmask of the slots in the group with the control byte c
+static inline uint32_t group_match(const int8_t *ctrl, int8_t c)
+{
+#ifdef __SSE2__
+  __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+  return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(c)));
+#else
+  uint32_t mask = 0;
+  int i;
+  for (i = 0; i < HASH_GROUP; i++)
+    if (ctrl[i] == c)
+      mask |= 1U << i;
+  return mask;
+#endif
+}
+
+// bitmask of the empty or deleted slots in the group
+static inline uint32_t group_free(const int8_t *ctrl)
+{
+#ifdef __SSE2__
+  __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+  return (uint32_t)_mm_movemask_epi8(group);
+#else
+  uint32_t mask = 0;
+  int i;
+  for (i = 0; i < HASH_GROUP; i++)
+    if (ctrl[i] < 0)
+      mask |= 1U << i;
+  return mask;
+#endif
+}
+
+// the first group is mirrored at the end, for the unaligned group loads
+static inline void hash_set_ctrl(dwg_inthash *hash, uint32_t i, int8_t c)
+{
+  hash->ctrl[i] = c;
+  if (i < HASH_GROUP)
+    hash->ctrl[hash->size + i] = c;
+}
+
+static int hash_alloc(dwg_inthash *hash, uint32_t size)
+{
+  hash->ctrl = malloc(size + HASH_GROUP);
+  hash->array = malloc(size * sizeof(struct _hashbucket)); // key+value pairs
+  if (!hash->ctrl || !hash->array)
+    {
+      free(hash->ctrl);
+      free(hash->array);
+      return 1;
+    }
+  memset(hash->ctrl, HASH_EMPTY, size + HASH_GROUP);
+  hash->size = size;
+  hash->elems = 0;
+  hash->deleted = 0;
+  return 0;
+}
+
 dwg_inthash *hash_new(uint32_t size)
 {
   dwg_inthash *hash = malloc(sizeof(dwg_inthash));
-  uint32_t cap;
+  uint64_t cap;
   if (!hash)
     return NULL;
-  // multiply with load factor,
-  // and round size to next power of 2 (fast) or prime (secure),
-  if (!size) size = 15;
-  cap = (uint32_t)(size * 100.0/HASH_LOAD);
-  while (size <= cap) // this is slow, but only done once. clz would be much faster
+  // divide by the max load factor, and round to the next power of 2
+  cap = (uint64_t)size * 8 / 7 + 1;
+  if (cap > 0x80000000UL)
+    cap = 0x80000000UL;
+  size = HASH_GROUP;
+  while (size < cap)
     size <<= 1U;
-  hash->array = calloc(size, sizeof(struct _hashbucket)); // key+value pairs
-  hash->elems = 0;
-  hash->size = size;
+  if (hash_alloc(hash, size))
+    {
+      free(hash);
+      return NULL;
+    }
   return hash;
 }
 
-// if exceeds load factor
-static inline int hash_need_resize(dwg_inthash *hash)
+// the first empty or deleted slot for a new key
+static uint32_t hash_free_slot(dwg_inthash *hash, uint64_t key)
 {
-  return (uint32_t)(hash->elems * 100.0/HASH_LOAD) > hash->size;
+  uint32_t mask = hash->size - 1;
+  uint32_t pos = HASH_POS(key) & mask;
+  uint32_t step = 0;
+  uint32_t m;
+  while (!(m = group_free(&hash->ctrl[pos])))
+    {
+      step += HASH_GROUP;
+      pos = (pos + step) & mask;
+    }
+  return (pos + hash_ctz(m)) & mask;
 }
 
-static void hash_resize(dwg_inthash *hash)
+// into a new array of size, which drops the deleted slots
+static int hash_resize(dwg_inthash *hash, uint32_t size)
 {
   dwg_inthash oldhash = *hash;
-  uint32_t size = hash->size * 2;
   uint32_t i;
 
-  // allocate key+value pairs afresh
-  hash->array = calloc(size, sizeof(struct _hashbucket));
-  if (!hash->array) {
-    *hash = oldhash;
-    return;
-  }
-  hash->elems = 0;
-  hash->size = size;
-  memset(hash->array, 0, size * sizeof(struct _hashbucket));
-  // spread out the old elements in double space, less collisions
-  for (i=0; i<oldhash.size; i++)
+  if (hash_alloc(hash, size))
+    {
+      *hash = oldhash;
+      return 1;
+    }
+  for (i = 0; i < oldhash.size; i++)
     {
-      if (oldhash.array[i].key)
-        hash_set(hash, oldhash.array[i].key, oldhash.array[i].value);
+      if (oldhash.ctrl[i] >= 0)
+        {
+          uint64_t key = oldhash.array[i].key;
+          uint64_t h = hash_func(key);
+          uint32_t j = hash_free_slot(hash, key);
+          hash_set_ctrl(hash, j, HASH_H2(h));
+          hash->array[j] = oldhash.array[i];
+        }
     }
+  hash->elems = oldhash.elems;
+  free(oldhash.ctrl);
   free(oldhash.array);
-  return;
-}
-
-// found this gem by Thomas Mueller at stackoverflow. triviality threshold.
-// it's like a normal murmur or jenkins finalizer,
-// just statistically tested to be optimal.
-// Note that this is entirely "insecure", the inverse func is trivial.
-// We don't care as we deal with DWG and had linear search before.
-static inline uint32_t hash_func(uint32_t key)
-{
-  key = ((key >> 16) ^ key) * 0x45d9f3b;
-  key = ((key >> 16) ^ key) * 0x45d9f3b;
-  key = (key >> 16) ^ key;
-  return key;
+  return 0;
 }
 
-// 0 is disallowed as key, even if there's no deletion.
-uint32_t hash_get(dwg_inthash *hash, uint32_t key)
+// 0 is disallowed as key
+uint32_t hash_get(dwg_inthash *hash, uint64_t key)
 {
-  uint32_t i = hash_func(key) % hash->size;
-  uint32_t j = i;
-  while (hash->array[i].key && hash->array[i].key != key)
+  uint64_t h = hash_func(key);
+  uint32_t mask = hash->size - 1;
+  uint32_t pos = HASH_POS(key) & mask;
+  uint32_t step = 0;
+  for (;;)
     {
-      //fprintf(stderr, "get collision at %d\n", i);
-      i++; // linear probing with wrap around
-      if (i == hash->size)
-        i = 0;
-      if (i == j) // not found
+      const int8_t *ctrl = &hash->ctrl[pos];
+      uint32_t m = group_match(ctrl, HASH_H2(h));
+      while (m)
+        {
+          uint32_t i = (pos + hash_ctz(m)) & mask;
+          if (hash->array[i].key == key)
+            return hash->array[i].value;
+          m &= m - 1;
+        }
+      if (group_match(ctrl, HASH_EMPTY)) // not found
         return HASH_NOT_FOUND;
+      step += HASH_GROUP;
+      pos = (pos + step) & mask;
     }
-  if (hash->array[i].key)
-    return hash->array[i].value;
-  else
-    return HASH_NOT_FOUND;
 }
 
 // search or insert. key 0 is forbidden.
-void hash_set(dwg_inthash *hash, uint32_t key, uint32_t value)
+void hash_set(dwg_inthash *hash, uint64_t key, uint32_t value)
 {
-  uint32_t i = hash_func(key) % hash->size;
-  uint32_t j = i;
+  uint64_t h = hash_func(key);
+  uint32_t mask = hash->size - 1;
+  uint32_t pos = HASH_POS(key) & mask;
+  uint32_t step = 0;
+  uint32_t slot = HASH_NOT_FOUND;
   if (key == 0) {
       fprintf(stderr, "forbidden 0 key\n");
       return;
   }
-  // empty slot
-  if (!hash->array[i].key) {
-    hash->array[i].key = key;
-    hash->array[i].value = value;
-    hash->elems++;
-    return;
-  }
-  while (hash->array[i].key)
+  for (;;)
     {
-      if (hash->array[i].key == key) { // found
-        hash->array[i].value = value;
-        return;
-      }
-      //fprintf(stderr, "set collision at %d\n", i);
-      i++; // linear probing with wrap around
-      if (i == hash->size)
-        i = 0;
-      if (i == j) // not found
+      const int8_t *ctrl = &hash->ctrl[pos];
+      uint32_t m = group_match(ctrl, HASH_H2(h));
+      while (m)
         {
-          //fprintf(stderr, "set not found at %d\n", i);
-          // if does not exist, add at i+1
-          if (hash_need_resize(hash)) {
-            //fprintf(stderr, "resize at %d\n", hash->size);
-            hash_resize(hash);
-            return hash_set(hash, key, value);
+          uint32_t i = (pos + hash_ctz(m)) & mask;
+          if (hash->array[i].key == key) { // found
+            hash->array[i].value = value;
+            return;
           }
-          while (hash->array[i].key) // find next empty slot
+          m &= m - 1;
+        }
+      if (slot == HASH_NOT_FOUND && (m = group_free(ctrl)))
+        slot = (pos + hash_ctz(m)) & mask;
+      if (group_match(ctrl, HASH_EMPTY)) // not found
+        break;
+      step += HASH_GROUP;
+      pos = (pos + step) & mask;
+    }
+  if (hash->ctrl[slot] == HASH_EMPTY)
+    {
+      if (hash->elems + hash->deleted + 1 > HASH_MAX_LOAD(hash->size))
+        {
+          // grow, or just drop the deleted slots
+          uint32_t size = hash->elems + 1 > HASH_MAX_LOAD(hash->size) / 2
+            ? hash->size * 2 : hash->size;
+          if (!hash_resize(hash, size))
+            {
+              hash_set(hash, key, value);
+              return;
+            }
+          if (hash->elems + hash->deleted + 2 > hash->size) // keep an empty slot
             {
-              // up to here we have no coverage!
-              //fprintf(stderr, "set 2nd collision at %d\n", i);
-              i++; // again linear probing with wrap around
-              if (i == hash->size)
-                i = 0;
-              if (i == j) // not found
-                {
-                  //fprintf(stderr, "not found resize at %d\n", hash->size);
-                  hash_resize(hash); // guarantees new empty slots
-                  hash_set(hash, key, value);
-                  return;
-                }
-              else
-                { // insert at empty slot
-                  hash->array[i].key = key;
-                  hash->array[i].value = value;
-                  hash->elems++;
-                  return;
-                }
+              fprintf(stderr, "hash_set: out of memory\n");
+              return;
             }
         }
     }
-  // empty slot
-  hash->array[i].key = key;
-  hash->array[i].value = value;
+  else
+    hash->deleted--;
+  hash_set_ctrl(hash, slot, HASH_H2(h));
+  hash->array[slot].key = key;
+  hash->array[slot].value = value;
   hash->elems++;
-  return;
+}
+
+uint32_t hash_del(dwg_inthash *hash, uint64_t key)
+{
+  uint64_t h = hash_func(key);
+  uint32_t mask = hash->size - 1;
+  uint32_t pos = HASH_POS(key) & mask;
+  uint32_t step = 0;
+  for (;;)
+    {
+      const int8_t *ctrl = &hash->ctrl[pos];
+      uint32_t m = group_match(ctrl, HASH_H2(h));
+      while (m)
+        {
+          uint32_t i = (pos + hash_ctz(m)) & mask;
+          if (hash->array[i].key == key)
+            {
+              // a probe might have passed this slot, so no HASH_EMPTY
+              hash_set_ctrl(hash, i, HASH_DELETED);
+              hash->elems--;
+              hash->deleted++;
+              return hash->array[i].value;
+            }
+          m &= m - 1;
+        }
+      if (group_match(ctrl, HASH_EMPTY))
+        return HASH_NOT_FOUND;
+      step += HASH_GROUP;
+      pos = (pos + step) & mask;
+    }
 }
 
 void hash_free(dwg_inthash *hash)
 {
+  free (hash->ctrl);
   free (hash->array);
+  hash->ctrl = NULL;
   hash->array = NULL;
   hash->size = 0;
   hash->elems = 0;
@@ -14,9 +14,10 @@
 #define HASH_H
 
 /*
- * hash.h: simple fast int hashmap for the object_ref map,
- *         mapping uint32_t to uint32_t.
- *         0 kys and values are disallowed even if there's no deletion.
+ * hash.h: fast int hashmap for the object_ref map,
+ *         mapping 64-bit handles to uint32_t object indices.
+ *         Swiss table: a control byte per slot, probed 16 at a time.
+ *         0 keys are disallowed.
  * written by Reini Urban
  */
 #ifndef _WIN32
@@ -27,22 +28,25 @@
 #include <stdint.h>
 #include <inttypes.h>
 
-#define HASH_LOAD 75 // in percent. recommended is 50
 #define HASH_NOT_FOUND (uint32_t)-1
 
 struct _hashbucket {
-  uint32_t key;
+  uint64_t key;
   uint32_t value;
 };
 typedef struct _inthash {
+  int8_t *ctrl;  /* size + HASH_GROUP control bytes, the 1st group mirrored */
   struct _hashbucket *array; /* of key, value pairs */
-  uint32_t size;
+  uint32_t size; /* power of 2 */
   uint32_t elems; // to get the fill rate
+  uint32_t deleted;
 } dwg_inthash;
 
 dwg_inthash *hash_new(uint32_t size);
-uint32_t hash_get(dwg_inthash *hash, uint32_t key);
-void hash_set(dwg_inthash *hash, uint32_t key, uint32_t value);
+uint32_t hash_get(dwg_inthash *hash, uint64_t key);
+void hash_set(dwg_inthash *hash, uint64_t key, uint32_t value);
+/* returns the old value or HASH_NOT_FOUND */
+uint32_t hash_del(dwg_inthash *hash, uint64_t key);
 void hash_free(dwg_inthash *hash);
 
 #endif
@@ -20,9 +20,7 @@
 
   // char version[6] handled separately. older releases just had a version[12]
 #ifdef IS_JSON
-  KEY(zero_5);
-  fprintf(dat->fh, "[ %d, %d, %d, %d, %d ],\n",
-          _obj->zero_5[0], _obj->zero_5[1], _obj->zero_5[2], _obj->zero_5[3], _obj->zero_5[4]);
+  FIELD_VECTOR_INL(zero_5, RC, 5, 0);
 #else
   for (i=0; i<5; i++) {
     FIELD_RC(zero_5[i], 0);
@@ -64,7 +62,7 @@
       for (i = 0; i < 54; i++)
         bit_write_RC(dat, 0);
     }
-    else {
+    DECODER {
       dat->byte += 54;
     }
     /* now at 0x80 follows the encrypted header data */
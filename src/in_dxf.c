@@ -48,6 +48,7 @@
 #include "common.h"
 #include "bits.h"
 #include "dwg.h"
+#include "classes.h"
 #include "in_dxf.h"
 #include "out_dxf.h"
 #include "decode.h"
@@ -1132,6 +1133,7 @@ dwg_read_dxf(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
           {
             dxf_free_pair(pair);
             dxf_classes_read (dat, dwg);
+            dwg_resolve_classes (dwg);
           }
         else if (!strcmp(pair->value.s, "TABLES"))
           {
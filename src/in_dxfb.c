@@ -31,6 +31,7 @@
 #include "common.h"
 #include "bits.h"
 #include "dwg.h"
+#include "classes.h"
 #include "in_dxf.h"
 #include "out_dxf.h"
 #include "decode.h"
@@ -1022,6 +1023,7 @@ dwg_read_dxfb(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
           {
             dxf_free_pair(pair);
             dxfb_classes_read (dat, dwg);
+            dwg_resolve_classes (dwg);
           }
         else if (!strcmp(pair->value.s, "TABLES"))
           {
@@ -0,0 +1,147 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * intern.c: the string intern table of a drawing.
+ *           The hash.c map from the 64-bit hash of the UCS-2 string to
+ *           its entry. The string is copied, as the field may be changed
+ *           later. Entries with the same hash are chained.
+ */
+
+#include "intern.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "bits.h"
+#include "hash.h"
+
+typedef struct _intern_entry
+{
+  uint32_t len;  // in UCS-2 chars, without the final 0
+  uint32_t next; // the previous entry with the same hash, or HASH_NOT_FOUND
+  uint16_t *key;
+  char *utf8;
+} Intern_Entry;
+
+struct _dwg_strings
+{
+  dwg_inthash *map; // hash => index into entries
+  uint32_t size;
+  uint32_t used;
+  Intern_Entry *entries;
+};
+
+#define INTERN_MIN_SIZE 64
+
+/* FNV-1a 64 over the UCS-2 chars. Not 0, which hash.c disallows. */
+static uint64_t
+intern_hash(const uint16_t *restrict wstr, uint32_t *restrict lenp)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  uint32_t len = 0;
+  for (; wstr[len]; len++)
+    {
+      hash ^= wstr[len];
+      hash *= 1099511628211ULL;
+    }
+  *lenp = len;
+  return hash ? hash : 1;
+}
+
+/* converts wstr only on the first call, see dwg.h */
+char *
+dwg_intern_TU(Dwg_Data *restrict dwg, const BITCODE_TU restrict wstr)
+{
+  Dwg_Strings *strings = dwg->strings;
+  Intern_Entry *e;
+  uint64_t hash;
+  uint32_t len, i, first;
+
+  if (!wstr)
+    return NULL;
+  if (!strings)
+    {
+      strings = calloc(1, sizeof(Dwg_Strings));
+      if (!strings)
+        return NULL;
+      strings->map = hash_new(INTERN_MIN_SIZE);
+      strings->entries = malloc(INTERN_MIN_SIZE * sizeof(Intern_Entry));
+      if (!strings->map || !strings->entries)
+        {
+          if (strings->map)
+            hash_free(strings->map);
+          free(strings->entries);
+          free(strings);
+          return NULL;
+        }
+      strings->size = INTERN_MIN_SIZE;
+      dwg->strings = strings;
+    }
+
+  hash = intern_hash((const uint16_t *)wstr, &len);
+  first = hash_get(strings->map, hash);
+  for (i = first; i != HASH_NOT_FOUND; i = e->next)
+    {
+      e = &strings->entries[i];
+      if (e->len == len && !memcmp(e->key, wstr, len * sizeof(uint16_t)))
+        return e->utf8;
+    }
+
+  // not found
+  if (strings->used == strings->size)
+    {
+      e = realloc(strings->entries,
+                  2 * strings->size * sizeof(Intern_Entry));
+      if (!e)
+        return NULL;
+      strings->entries = e;
+      strings->size *= 2;
+    }
+  i = strings->used;
+  e = &strings->entries[i];
+  e->key = malloc((len + 1) * sizeof(uint16_t));
+  if (!e->key)
+    return NULL;
+  e->utf8 = bit_convert_TU((BITCODE_TU)wstr);
+  hash_set(strings->map, hash, i);
+  if (!e->utf8 || hash_get(strings->map, hash) != i) // out of memory
+    {
+      if (first != HASH_NOT_FOUND)
+        hash_set(strings->map, hash, first);
+      else
+        hash_del(strings->map, hash);
+      free(e->utf8);
+      free(e->key);
+      return NULL;
+    }
+  memcpy(e->key, wstr, (len + 1) * sizeof(uint16_t));
+  e->len = len;
+  e->next = first;
+  strings->used++;
+  return e->utf8;
+}
+
+void
+intern_free(Dwg_Strings *strings)
+{
+  uint32_t i;
+  if (!strings)
+    return;
+  for (i = 0; i < strings->used; i++)
+    {
+      free(strings->entries[i].key);
+      free(strings->entries[i].utf8);
+    }
+  hash_free(strings->map);
+  free(strings->entries);
+  free(strings);
+}
@@ -0,0 +1,32 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+#ifndef INTERN_H
+#define INTERN_H
+
+/*
+ * intern.h: the string intern table of a drawing, see dwg_intern_TU().
+ *           Holds one UTF-8 copy per distinct r2007+ UCS-2 string,
+ *           which stays valid until dwg_free.
+ */
+#ifndef _WIN32
+#include "config.h"
+#else
+#include "config_win32.h"
+#endif
+#include "dwg.h"
+
+typedef struct _dwg_strings Dwg_Strings;
+
+void intern_free(Dwg_Strings *strings);
+
+#endif
@@ -44,6 +44,7 @@ TODO:
 #include "common.h"
 #include "bits.h"
 #include "dwg.h"
+#include "classes.h"
 #include "decode.h"
 #include "out_dxf.h"
 
@@ -74,6 +75,259 @@ static inline char* alloca(size_t size) {
 }
 #endif
 
+/*--------------------------------------------------------------------------------
+ * OUTPUT
+ * Everything is written into dat->chain, which is flushed to dat->fh in big
+ * chunks. Numbers are formatted here, not by stdio, as printf is the
+ * bottleneck with big drawings.
+ */
+
+#define DXF_BUFSIZE (1024 * 1024)
+
+/* The printf formats of the group codes, see dxf_format() */
+enum DXF_FMT
+{
+  DXF_FMT_UNRESOLVED = 0,
+  DXF_FMT_STRING, // %s
+  DXF_FMT_HEX,    // %X
+  DXF_FMT_RD,     // %-16.14f
+  DXF_FMT_RS,     // %6i
+  DXF_FMT_RL,     // %9li
+  DXF_FMT_RLL,    // %12li
+  DXF_FMT_BL,     // %6i of the int32 (90-99)
+  DXF_FMT_UNKNOWN
+};
+/* resolved once per group code */
+static unsigned char dxf_fmt_table[1072];
+
+static void
+dxf_flush(Bit_Chain *restrict dat)
+{
+  if (dat->byte)
+    fwrite(dat->chain, 1, dat->byte, dat->fh);
+  dat->byte = 0;
+}
+
+static void
+dxf_write(Bit_Chain *restrict dat, const char *restrict s, size_t len)
+{
+  if (dat->byte + len > dat->size)
+    {
+      dxf_flush(dat);
+      if (len > dat->size)
+        {
+          fwrite(s, 1, len, dat->fh);
+          return;
+        }
+    }
+  memcpy(&dat->chain[dat->byte], s, len);
+  dat->byte += len;
+}
+
+static void
+dxf_puts(Bit_Chain *restrict dat, const char *restrict s)
+{
+  if (s)
+    dxf_write(dat, s, strlen(s));
+}
+
+static void
+dxf_putc(Bit_Chain *restrict dat, const char c)
+{
+  if (dat->byte >= dat->size)
+    dxf_write(dat, &c, 1);
+  else
+    dat->chain[dat->byte++] = (unsigned char)c;
+}
+
+/* %*li, right-aligned to width */
+static void
+dxf_write_int(Bit_Chain *restrict dat, const long value, const int width)
+{
+  char s[24];
+  char *p = &s[sizeof(s)];
+  unsigned long u = value < 0 ? 0UL - (unsigned long)value
+                              : (unsigned long)value;
+  do
+    {
+      *--p = '0' + (char)(u % 10);
+      u /= 10;
+    }
+  while (u);
+  if (value < 0)
+    *--p = '-';
+  while (&s[sizeof(s)] - p < width)
+    *--p = ' ';
+  dxf_write(dat, p, &s[sizeof(s)] - p);
+}
+
+/* %lX */
+static void
+dxf_write_hex(Bit_Chain *restrict dat, unsigned long value)
+{
+  static const char hex[] = "0123456789ABCDEF";
+  char s[16];
+  char *p = &s[sizeof(s)];
+  do
+    {
+      *--p = hex[value & 0xf];
+      value >>= 4;
+    }
+  while (value);
+  dxf_write(dat, p, &s[sizeof(s)] - p);
+}
+
+/* %3i\r\n */
+static void
+dxf_write_group(Bit_Chain *restrict dat, const int dxf)
+{
+  dxf_write_int(dat, dxf, 3);
+  dxf_write(dat, "\r\n", 2);
+}
+
+/* %3i\r\n%lX\r\n */
+static void
+dxf_write_group_hex(Bit_Chain *restrict dat, const int dxf,
+                    const unsigned long value)
+{
+  dxf_write_group(dat, dxf);
+  dxf_write_hex(dat, value);
+  dxf_write(dat, "\r\n", 2);
+}
+
+/* %3i\r\n%s\r\n */
+static void
+dxf_write_group_string(Bit_Chain *restrict dat, const int dxf,
+                       const char *restrict str)
+{
+  dxf_write_group(dat, dxf);
+  dxf_puts(dat, str);
+  dxf_write(dat, "\r\n", 2);
+}
+
+/* %-16.14f, correctly rounded from the binary value as glibc does.
+   With trim, .00000000000000 is shortened to .0, .50000000000000 to .5
+   and .12500000000000 to .125. */
+static void
+dxf_write_RD(Bit_Chain *restrict dat, const double value, const int trim)
+{
+#ifdef __SIZEOF_INT128__
+  char s[40];
+  char *p = &s[sizeof(s)];
+  const uint64_t pow14 = UINT64_C(100000000000000);
+  uint64_t bits, m, ip, fp;
+  unsigned __int128 q;
+  int e, i;
+
+  memcpy(&bits, &value, sizeof(bits));
+  e = (int)((bits >> 52) & 0x7ff);
+  m = bits & ((UINT64_C(1) << 52) - 1);
+  if (e)
+    m |= UINT64_C(1) << 52;
+  e = (e ? e : 1) - 1075;
+  /* value = m * 2^e. Larger values, inf and nan are left to snprintf */
+  if (e > 0)
+    goto fallback;
+  q = (unsigned __int128)m * pow14; // < 2^100
+  if (e < -100)
+    q = 0;
+  else if (e < 0)
+    {
+      const unsigned __int128 rem = q & (((unsigned __int128)1 << -e) - 1);
+      const unsigned __int128 half = (unsigned __int128)1 << (-e - 1);
+      q >>= -e;
+      // round half to even
+      if (rem > half || (rem == half && (q & 1)))
+        q++;
+    }
+  ip = (uint64_t)(q / pow14);
+  fp = (uint64_t)(q % pow14);
+  *--p = '\n';
+  *--p = '\r';
+  if (trim && fp == 0)
+    *--p = '0';
+  else if (trim && fp == UINT64_C(50000000000000))
+    *--p = '5';
+  else if (trim && fp == UINT64_C(12500000000000))
+    {
+      p -= 3;
+      memcpy(p, "125", 3);
+    }
+  else
+    for (i = 0; i < 14; i++)
+      {
+        *--p = '0' + (char)(fp % 10);
+        fp /= 10;
+      }
+  *--p = '.';
+  do
+    {
+      *--p = '0' + (char)(ip % 10);
+      ip /= 10;
+    }
+  while (ip);
+  if (bits >> 63)
+    *--p = '-';
+  // the width 16 is always filled
+  dxf_write(dat, p, &s[sizeof(s)] - p);
+  return;
+
+ fallback:
+#endif
+  {
+    // up to 309 integer digits
+    char _buf[352];
+    char *_s;
+    snprintf(_buf, sizeof(_buf), "%-16.14f", value);
+    if (trim)
+      {
+        if ((_s = strstr(_buf, ".00000000000000")))
+          strcpy(_s, ".0");
+        else if ((_s = strstr(_buf, ".50000000000000")))
+          strcpy(_s, ".5");
+        else if ((_s = strstr(_buf, ".12500000000000")))
+          strcpy(_s, ".125");
+      }
+    dxf_puts(dat, _buf);
+    dxf_write(dat, "\r\n", 2);
+  }
+}
+
+static enum DXF_FMT
+dxf_fmt_resolve(int code)
+{
+  const char *fmt;
+  // the int32 BL's. -Wpointer-to-int-cast
+  if (90 <= code && code < 100)
+    return DXF_FMT_BL;
+  fmt = dxf_format(code);
+  if (!strcmp(fmt, "%s"))
+    return DXF_FMT_STRING;
+  if (!strcmp(fmt, "%X"))
+    return DXF_FMT_HEX;
+  if (!strcmp(fmt, "%-16.14f"))
+    return DXF_FMT_RD;
+  if (!strcmp(fmt, "%6i"))
+    return DXF_FMT_RS;
+  if (!strcmp(fmt, "%9li"))
+    return DXF_FMT_RL;
+  if (!strcmp(fmt, "%12li"))
+    return DXF_FMT_RLL;
+  return DXF_FMT_UNKNOWN;
+}
+
+static inline enum DXF_FMT
+dxf_fmt(int code)
+{
+  if (0 <= code && code < (int)sizeof(dxf_fmt_table))
+    {
+      if (!dxf_fmt_table[code])
+        dxf_fmt_table[code] = (unsigned char)dxf_fmt_resolve(code);
+      return (enum DXF_FMT)dxf_fmt_table[code];
+    }
+  return dxf_fmt_resolve(code);
+}
+
 /*--------------------------------------------------------------------------------
  * MACROS
  */
@@ -94,6 +348,7 @@ static inline char* alloca(size_t size) {
 #ifdef HAVE_NATIVE_WCHAR2
 # define VALUE_TU(value,dxf)\
   { GROUP(dxf); \
+    dxf_flush(dat); \
     fprintf(dat->fh, "%ls\r\n", value ? (wchar_t*)value : L""); }
 #else
 # define VALUE_TU(wstr,dxf) \
@@ -103,13 +358,13 @@ static inline char* alloca(size_t size) {
     GROUP(dxf);\
     if (wstr) \
       while ((_c = *ws++)) { \
-        fprintf(dat->fh, "%c", (char)(_c & 0xff)); \
+        dxf_putc(dat, (char)(_c & 0xff)); \
       } \
-    fprintf(dat->fh, "\r\n"); \
+    dxf_write(dat, "\r\n", 2); \
   }
 #endif
 #define VALUE_TFF(str,dxf) \
-  { GROUP(dxf); fprintf(dat->fh, "%s\r\n", str); }
+  { dxf_write_group_string(dat, dxf, str); }
 #define VALUE_BINARY(value,size,dxf) \
 { \
   long len = size; \
@@ -119,9 +374,10 @@ static inline char* alloca(size_t size) {
     GROUP(dxf); \
     if (value) \
       for (j=0; j < l; j++) { \
-        fprintf(dat->fh, "%02X", value[j]); \
+        dxf_putc(dat, "0123456789ABCDEF"[(value[j] >> 4) & 0xf]); \
+        dxf_putc(dat, "0123456789ABCDEF"[value[j] & 0xf]); \
       } \
-    fprintf(dat->fh, "\r\n"); \
+    dxf_write(dat, "\r\n", 2); \
     len -= 127; \
   } while (len > 127); \
 }
@@ -129,11 +385,12 @@ static inline char* alloca(size_t size) {
 
 #define FIELD_VALUE(nam) _obj->nam
 #define ANYCODE -1
+#define VALUE_HEX(value, dxf) \
+  dxf_write_group_hex(dat, dxf, (unsigned long)(value))
 // the hex code
 #define VALUE_HANDLE(value, nam, handle_code, dxf)       \
   if (dxf) { \
-    fprintf(dat->fh, "%3i\r\n%lX\r\n", dxf, \
-            value != NULL ? ((BITCODE_H)value)->absolute_ref : 0); \
+    VALUE_HEX(value != NULL ? ((BITCODE_H)value)->absolute_ref : 0, dxf); \
   }
 // the name in the table, referenced by the handle
 // names on: 6 7 8. which else? there are more styles: plot, ...
@@ -149,7 +406,7 @@ static inline char* alloca(size_t size) {
     else if (dxf == 8) \
       FIELD_HANDLE_NAME(nam, dxf, LAYER) \
     else if (dat->version >= R_13) \
-      fprintf(dat->fh, "%3i\r\n%lX\r\n", dxf, _obj->nam->absolute_ref); \
+      VALUE_HEX(_obj->nam->absolute_ref, dxf); \
   }
 #define SUB_FIELD_HANDLE(o, nam, handle_code, dxf) \
   if (dxf != 0 && _obj->o.nam) { \
@@ -162,14 +419,14 @@ static inline char* alloca(size_t size) {
     else if (dxf == 8) \
       SUB_FIELD_HANDLE_NAME(o, nam, dxf, LAYER)  \
     else if (dat->version >= R_13) \
-      fprintf(dat->fh, "%3i\r\n%lX\r\n", dxf, _obj->o.nam->absolute_ref); \
+      VALUE_HEX(_obj->o.nam->absolute_ref, dxf); \
   }
 #define HEADER_9(nam) \
     GROUP(9);\
-    fprintf (dat->fh, "$%s\r\n", #nam)
+    dxf_puts (dat, "$" #nam "\r\n")
 #define VALUE_H(value, dxf) \
     if (dxf) \
-      fprintf(dat->fh, "%3i\r\n%lX\r\n", dxf, value ? value->absolute_ref : 0)
+      VALUE_HEX(value ? value->absolute_ref : 0, dxf)
 #define HEADER_H(nam,dxf) \
     HEADER_9(nam);\
     VALUE_H(dwg->header_vars.nam, dxf)
@@ -177,9 +434,15 @@ static inline char* alloca(size_t size) {
 #define HEADER_VALUE(nam, type, dxf, value) \
   if (dxf) {\
     GROUP(9);\
-    fprintf (dat->fh, "$" #nam "\r\n");\
-    VALUE (value, type, dxf);\
+    dxf_puts (dat, "$" #nam "\r\n");\
+    HEADER_VALUE_##type (value, dxf);\
   }
+/* only VALUE_TFF takes strings */
+#define HEADER_VALUE_TV(value, dxf) VALUE_TFF (value, dxf)
+#define HEADER_VALUE_TU(value, dxf) VALUE_TU (value, dxf)
+#define HEADER_VALUE_RC(value, dxf) VALUE (value, RC, dxf)
+#define HEADER_VALUE_RS(value, dxf) VALUE (value, RS, dxf)
+#define HEADER_VALUE_BD(value, dxf) VALUE (value, BD, dxf)
 #define HEADER_VAR(nam, type, dxf) \
   HEADER_VALUE(nam, type, dxf, dwg->header_vars.nam)
 
@@ -195,71 +458,87 @@ static inline char* alloca(size_t size) {
 
 #define SECTION(section) \
   LOG_INFO("Section " #section "\n")\
-  fprintf(dat->fh, "  0\r\nSECTION\r\n  2\r\n" #section "\r\n")
-#define ENDSEC()         fprintf(dat->fh, "  0\r\nENDSEC\r\n")
-#define TABLE(table)     fprintf(dat->fh, "  0\r\nTABLE\r\n  2\r\n" #table "\r\n")
-#define ENDTAB()         fprintf(dat->fh, "  0\r\nENDTAB\r\n")
-#define RECORD(record)   fprintf(dat->fh, "  0\r\n" #record "\r\n")
-#define record(record)   fprintf(dat->fh, "  0\r\n%s\r\n", record)
+  dxf_puts(dat, "  0\r\nSECTION\r\n  2\r\n" #section "\r\n")
+#define ENDSEC()         dxf_puts(dat, "  0\r\nENDSEC\r\n")
+#define TABLE(table)     dxf_puts(dat, "  0\r\nTABLE\r\n  2\r\n" #table "\r\n")
+#define ENDTAB()         dxf_puts(dat, "  0\r\nENDTAB\r\n")
+#define RECORD(record)   dxf_puts(dat, "  0\r\n" #record "\r\n")
+#define record(record)   dxf_write_group_string(dat, 0, record)
 #define SUBCLASS(text)   if (dat->from_version >= R_2000) { VALUE_TV(#text, 100); }
 
 #define GROUP(dxf) \
-    fprintf (dat->fh, "%3i\r\n", dxf)
+    dxf_write_group (dat, dxf)
 /* avoid empty numbers, and fixup some bad %f libc formatting */
 #define VALUE(value, type, dxf) \
   if (dxf) { \
-    char *_s; \
-    const char *_fmt = dxf_format (dxf); \
     GROUP(dxf); \
-    GCC_DIAG_IGNORE(-Wformat-nonliteral) \
-    snprintf(buf, 255, _fmt, value); \
-    GCC_DIAG_RESTORE \
-    /* not a string, empty num. must be zero */ \
-    if (strcmp(_fmt, "%s") && !*buf) \
-      strcpy(buf, "0"); \
-    else if (90 <= dxf && dxf < 100) { \
-      /* -Wpointer-to-int-cast */ \
-      const int32_t _si = (int32_t)(intptr_t)(value); \
-      snprintf(buf, 255, "%6i", _si); \
-    } else if (!strcmp(_fmt, "%-16.14f")) {      \
-      if (!strcmp(buf, "0.00000000000000")) \
-        strcpy(buf, "0.0"); \
-      else if ((_s = strstr(buf, ".00000000000000"))) \
-        strcpy(_s, ".0"); \
-      else if ((_s = strstr(buf, ".50000000000000"))) \
-        strcpy(_s, ".5"); \
-      else if ((_s = strstr(buf, ".12500000000000"))) \
-        strcpy(_s, ".125"); \
-    } \
-    fprintf(dat->fh, "%s\r\n", buf); \
+    switch (dxf_fmt (dxf)) \
+      { \
+      case DXF_FMT_RD: \
+        dxf_write_RD(dat, (double)(value), 1); \
+        break; \
+      case DXF_FMT_RS: \
+        dxf_write_int(dat, (int)(value), 6); \
+        dxf_write(dat, "\r\n", 2); \
+        break; \
+      case DXF_FMT_RL: \
+        dxf_write_int(dat, (long)(value), 9); \
+        dxf_write(dat, "\r\n", 2); \
+        break; \
+      case DXF_FMT_RLL: \
+        dxf_write_int(dat, (long)(value), 12); \
+        dxf_write(dat, "\r\n", 2); \
+        break; \
+      case DXF_FMT_BL: { \
+        /* -Wpointer-to-int-cast */ \
+        const int32_t _si = (int32_t)(intptr_t)(value); \
+        dxf_write_int(dat, _si, 6); \
+        dxf_write(dat, "\r\n", 2); \
+        break; \
+      } \
+      case DXF_FMT_HEX: \
+        dxf_write_hex(dat, (unsigned int)(value)); \
+        dxf_write(dat, "\r\n", 2); \
+        break; \
+      case DXF_FMT_STRING: \
+      case DXF_FMT_UNKNOWN: \
+      case DXF_FMT_UNRESOLVED: \
+      default: \
+        GCC_DIAG_IGNORE(-Wformat-nonliteral) \
+        snprintf(buf, 255, dxf_format (dxf), value); \
+        GCC_DIAG_RESTORE \
+        dxf_puts(dat, buf); \
+        dxf_write(dat, "\r\n", 2); \
+        break; \
+      } \
   }
 #define VALUE_RD(value, dxf) \
   if (dxf && !bit_isnan(value)) { \
     GROUP(dxf); \
     if (value == 0.0 || value == 0) \
-      fprintf(dat->fh, "0.0\r\n"); \
+      dxf_write(dat, "0.0\r\n", 5); \
     else if (value == 0.5) \
-      fprintf(dat->fh, "0.5\r\n"); \
+      dxf_write(dat, "0.5\r\n", 5); \
     else if (value == 0.125) \
-      fprintf(dat->fh, "0.125\r\n"); \
+      dxf_write(dat, "0.125\r\n", 7); \
     else \
-      fprintf(dat->fh, "%-16.14f\r\n", value); \
+      dxf_write_RD(dat, value, 0); \
   }
 #define VALUE_B(value, dxf) \
   if (dxf) { \
     GROUP(dxf); \
     if (value == 0) \
-      fprintf(dat->fh, "     0\r\n"); \
+      dxf_write(dat, "     0\r\n", 8); \
     else \
-      fprintf(dat->fh, "     1\r\n"); \
+      dxf_write(dat, "     1\r\n", 8); \
   }
 
 #define FIELD_HANDLE_NAME(nam, dxf, table) \
   {\
     Dwg_Object_Ref *ref = _obj->nam;\
     Dwg_Object *o = ref ? ref->obj : NULL;\
-    if (o && !strcmp(o->dxfname, #table)) \
-      dxf_cvt_tablerecord(dat, o, o ? o->tio.object->tio.table->name : (char*)"0", dxf); \
+    if (o && o->tio.object && !strcmp(o->dxfname, #table)) \
+      dxf_cvt_tablerecord(dat, o, o->tio.object->tio.table->name, dxf); \
     else { \
       VALUE_TFF("", dxf) \
     } \
@@ -268,8 +547,8 @@ static inline char* alloca(size_t size) {
   {\
     Dwg_Object_Ref *ref = _obj->ob.nam;\
     Dwg_Object *o = ref ? ref->obj : NULL;\
-    if (o && !strcmp(o->dxfname, #table)) \
-      dxf_cvt_tablerecord(dat, o, o ? o->tio.object->tio.table->name : (char*)"0", dxf); \
+    if (o && o->tio.object && !strcmp(o->dxfname, #table)) \
+      dxf_cvt_tablerecord(dat, o, o->tio.object->tio.table->name, dxf); \
     else { \
       VALUE_TFF("", dxf) \
     } \
@@ -378,8 +657,11 @@ static inline char* alloca(size_t size) {
 #define HEADER_TIMEBLL(nam, dxf) \
   HEADER_9(nam); FIELD_TIMEBLL(nam, dxf)
 #define FIELD_TIMEBLL(nam,dxf) \
-  GROUP(dxf); fprintf(dat->fh, FORMAT_RL "." FORMAT_RL "\r\n", \
-                      _obj->nam.days, _obj->nam.ms)
+  GROUP(dxf); \
+  dxf_write_int(dat, (long)_obj->nam.days, 0); \
+  dxf_putc(dat, '.'); \
+  dxf_write_int(dat, (long)_obj->nam.ms, 0); \
+  dxf_write(dat, "\r\n", 2)
 #define HEADER_CMC(nam,dxf) \
     HEADER_9(nam);\
     VALUE_RS(dwg->header_vars.nam.index, dxf)
@@ -476,30 +758,30 @@ static inline char* alloca(size_t size) {
       obj->tio.object->xdicobjhandle && \
       obj->tio.object->xdicobjhandle->absolute_ref) \
   { \
-    fprintf(dat->fh, "102\r\n{ACAD_XDICTIONARY\r\n");\
+    dxf_puts(dat, "102\r\n{ACAD_XDICTIONARY\r\n");\
     VALUE_HANDLE(obj->tio.object->xdicobjhandle, xdicobjhandle, code, 360); \
-    fprintf(dat->fh, "102\r\n}\r\n");\
+    dxf_puts(dat, "102\r\n}\r\n");\
   }
 #define _REACTORS(code)\
   if (dat->version >= R_13 && \
       obj->tio.object->num_reactors && \
       obj->tio.object->reactors) \
   { \
-    fprintf(dat->fh, "102\r\n{ACAD_REACTORS\r\n");\
+    dxf_puts(dat, "102\r\n{ACAD_REACTORS\r\n");\
     for (vcount=0; vcount < obj->tio.object->num_reactors; vcount++)\
       { /* soft ptr */ \
         VALUE_HANDLE(obj->tio.object->reactors[vcount], reactors, code, 330); \
       }\
-    fprintf(dat->fh, "102\r\n}\r\n");\
+    dxf_puts(dat, "102\r\n}\r\n");\
   }
 #define ENT_REACTORS(code)\
   if (dat->version >= R_13 && _obj->num_reactors && _obj->reactors) {\
-    fprintf(dat->fh, "102\r\n{ACAD_REACTORS\r\n");\
+    dxf_puts(dat, "102\r\n{ACAD_REACTORS\r\n");\
     for (vcount=0; vcount < _obj->num_reactors; vcount++)\
       {\
         VALUE_HANDLE(_obj->reactors[vcount], reactors, code, 330);       \
       }\
-    fprintf(dat->fh, "102\r\n}\r\n");\
+    dxf_puts(dat, "102\r\n}\r\n");\
   }
 #define REACTORS(code)
 #define XDICOBJHANDLE(code)
@@ -508,9 +790,9 @@ static inline char* alloca(size_t size) {
       obj->tio.entity->xdicobjhandle && \
       obj->tio.entity->xdicobjhandle->absolute_ref) \
   { \
-    fprintf(dat->fh, "102\r\n{ACAD_XDICTIONARY\r\n");\
+    dxf_puts(dat, "102\r\n{ACAD_XDICTIONARY\r\n");\
     VALUE_HANDLE(obj->tio.entity->xdicobjhandle, xdicobjhandle, code, 360); \
-    fprintf(dat->fh, "102\r\n}\r\n");\
+    dxf_puts(dat, "102\r\n}\r\n");\
   }
 #define BLOCK_NAME(nam, dxf) \
   dxf_cvt_blockname(dat, _obj->nam, dxf)
@@ -543,6 +825,8 @@ dwg_dxf_##token (Bit_Chain *restrict dat, const Dwg_Object *restrict obj) \
   Dwg_Data* dwg = obj->parent; \
   Dwg_Entity_##token *ent, *_obj;\
   Dwg_Object_Entity *_ent;\
+  if (!obj->tio.entity) /* skipped by dwg->decode_filter */ \
+    return 0; \
   if (!strcmp(#token, "GEOPOSITIONMARKER"))\
     RECORD(POSITIONMARKER);\
   else if (dat->version < R_13 && strlen(#token) == 10 && !strcmp(#token, "LWPOLYLINE")) \
@@ -571,7 +855,7 @@ dwg_dxf_##token (Bit_Chain *restrict dat, const Dwg_Object *restrict obj) \
               obj->handle.code,\
               obj->handle.size,\
               obj->handle.value); \
-    fprintf(dat->fh, "%3i\r\n%lX\r\n", 5, obj->handle.value); \
+    VALUE_HEX (obj->handle.value, 5); \
   } \
   SINCE(R_13) { \
     error |= dxf_common_entity_handle_data(dat, obj); \
@@ -589,13 +873,15 @@ dwg_dxf_ ##token (Bit_Chain *restrict dat, const Dwg_Object *restrict obj) \
   Bit_Chain *hdl_dat = dat;\
   Dwg_Data* dwg = obj->parent; \
   Dwg_Object_##token *_obj;\
+  if (!obj->tio.object) /* skipped by dwg->decode_filter */ \
+    return 0; \
   LOG_INFO("Object " #token ":\n")\
   _obj = obj->tio.object->tio.token;\
   if (!dwg_obj_is_control(obj)) { \
     if (obj->fixedtype == DWG_TYPE_TABLE) \
       ; \
     else if (obj->type >= 500 && obj->dxfname)        \
-      fprintf(dat->fh, "  0\r\n%s\r\n", obj->dxfname); \
+      record (obj->dxfname); \
     else if (obj->type == DWG_TYPE_PLACEHOLDER) \
       RECORD(ACDBPLACEHOLDER); \
     else if (obj->type != DWG_TYPE_BLOCK_HEADER) \
@@ -603,7 +889,7 @@ dwg_dxf_ ##token (Bit_Chain *restrict dat, const Dwg_Object *restrict obj) \
     SINCE(R_13) { \
       int dxf = 5; \
       if (obj->type == DWG_TYPE_DIMSTYLE) dxf = 105; \
-      fprintf(dat->fh, "%3i\r\n%lX\r\n", dxf, obj->handle.value); \
+      VALUE_HEX (obj->handle.value, dxf); \
       _XDICOBJHANDLE(3); \
       _REACTORS(4); \
     } \
@@ -627,17 +913,15 @@ dxf_write_xdata(Bit_Chain *restrict dat, const Dwg_Object *restrict obj,
 
   while (rbuf)
     {
-      const char* fmt;
       short type;
       int dxftype = rbuf->type;
 
-      fmt = dxf_format(rbuf->type);
       type = get_base_value_type(rbuf->type);
       dxftype = (rbuf->type > 1000 || obj->fixedtype == DWG_TYPE_XRECORD)
         ? rbuf->type
         : rbuf->type + 1000;
 
-      if (!strcmp(fmt, "(unknown code)"))
+      if (dxf_fmt(rbuf->type) == DXF_FMT_UNKNOWN)
         {
           if (type == VT_INVALID) {
             LOG_WARN("Invalid xdata code %d", dxftype);
@@ -679,13 +963,12 @@ dxf_write_xdata(Bit_Chain *restrict dat, const Dwg_Object *restrict obj,
           break;
         case VT_HANDLE:
         case VT_OBJECTID:
-          fprintf(dat->fh, "%3i\r\n%lX\r\n", dxftype,
-                  (unsigned long)*(uint64_t*)rbuf->value.hdl);
+          VALUE_HEX (*(uint64_t*)rbuf->value.hdl, dxftype);
           break;
         case VT_INVALID:
           break; //skip
         default:
-          fprintf(dat->fh, "%3i\r\n\r\n", dxftype);
+          dxf_write_group_string (dat, dxftype, "");
           break;
         }
       rbuf = tmp;
@@ -720,16 +1003,15 @@ dxf_fixup_string(Bit_Chain *restrict dat, char *restrict str)
       if (strchr(str, '\n') || strchr(str, '\r'))
         {
           char *_buf = alloca(2*strlen(str));
-          fprintf(dat->fh, "%s\r\n", cquote(_buf, str));
+          dxf_puts(dat, cquote(_buf, str));
 #ifndef HAVE_ALLOCA
           free(_buf);
 #endif
         }
       else
-        fprintf(dat->fh, "%s\r\n", str);
+        dxf_puts(dat, str);
     }
-  else
-    fprintf(dat->fh, "\r\n");
+  dxf_write(dat, "\r\n", 2);
 }
 
 // r13+ converts STANDARD to Standard, BYLAYER to ByLayer, BYBLOCK to ByBlock
@@ -746,34 +1028,34 @@ dxf_cvt_tablerecord(Bit_Chain *restrict dat, const Dwg_Object *restrict obj,
       if (dat->from_version >= R_13 && dat->version < R_13)
         { // convert the other way round, from newer to older
           if (!strcmp(name, "Standard"))
-            fprintf(dat->fh, "%3i\r\nSTANDARD\r\n", dxf);
+            dxf_write_group_string (dat, dxf, "STANDARD");
           else if (!strcmp(name, "ByLayer"))
-            fprintf(dat->fh, "%3i\r\nBYLAYER\r\n", dxf);
+            dxf_write_group_string (dat, dxf, "BYLAYER");
           else if (!strcmp(name, "ByBlock"))
-            fprintf(dat->fh, "%3i\r\nBYBLOCK\r\n", dxf);
+            dxf_write_group_string (dat, dxf, "BYBLOCK");
           else if (!strcmp(name, "*Active"))
-            fprintf(dat->fh, "%3i\r\n*ACTIVE\r\n", dxf);
+            dxf_write_group_string (dat, dxf, "*ACTIVE");
           else
-            fprintf(dat->fh, "%3i\r\n%s\r\n", dxf, name);
+            dxf_write_group_string (dat, dxf, name);
         }
       else
         { // convert some standard names
           if (dat->version >= R_13 && !strcmp(name, "STANDARD"))
-            fprintf(dat->fh, "%3i\r\nStandard\r\n", dxf);
+            dxf_write_group_string (dat, dxf, "Standard");
           else if (dat->version >= R_13 && !strcmp(name, "BYLAYER"))
-            fprintf(dat->fh, "%3i\r\nByLayer\r\n", dxf);
+            dxf_write_group_string (dat, dxf, "ByLayer");
           else if (dat->version >= R_13 && !strcmp(name, "BYBLOCK"))
-            fprintf(dat->fh, "%3i\r\nByBlock\r\n", dxf);
+            dxf_write_group_string (dat, dxf, "ByBlock");
           else if (dat->version >= R_13 && !strcmp(name, "*ACTIVE"))
-            fprintf(dat->fh, "%3i\r\n*Active\r\n", dxf);
+            dxf_write_group_string (dat, dxf, "*Active");
           else
-            fprintf(dat->fh, "%3i\r\n%s\r\n", dxf, name);
+            dxf_write_group_string (dat, dxf, name);
         }
       if (dat->version >= R_2007)
         free (name);
     }
   else {
-    fprintf(dat->fh, "%3i\r\n\r\n", dxf);
+    dxf_write_group_string (dat, dxf, "");
   }
 }
 
@@ -786,7 +1068,7 @@ dxf_cvt_blockname(Bit_Chain *restrict dat, char *restrict name, const int dxf)
 {
   if (!name)
     {
-      fprintf(dat->fh, "%3i\r\n\r\n", dxf);
+      dxf_write_group_string (dat, dxf, "");
       return;
     }
   if (dat->from_version >= R_2007) // r2007+ unicode names
@@ -795,33 +1077,43 @@ dxf_cvt_blockname(Bit_Chain *restrict dat, char *restrict name, const int dxf)
     }
   if (dat->version == dat->from_version) // no conversion
     {
-      fprintf(dat->fh, "%3i\r\n%s\r\n", dxf, name);
+      dxf_write_group_string (dat, dxf, name);
     }
   else if (dat->version < R_13 && dat->from_version >= R_13) // to older
     {
       if (strlen(name) < 10)
-        fprintf(dat->fh, "%3i\r\n%s\r\n", dxf, name);
+        dxf_write_group_string (dat, dxf, name);
       else if (!strcmp(name, "*Model_Space"))
-        fprintf(dat->fh, "%3i\r\n$MODEL_SPACE\r\n", dxf);
+        dxf_write_group_string (dat, dxf, "$MODEL_SPACE");
       else if (!strcmp(name, "*Paper_Space"))
-        fprintf(dat->fh, "%3i\r\n$PAPER_SPACE\r\n", dxf);
+        dxf_write_group_string (dat, dxf, "$PAPER_SPACE");
       else if (!memcmp(name, "*Paper_Space", sizeof("*Paper_Space")-1))
-        fprintf(dat->fh, "%3i\r\n$PAPER_SPACE%s\r\n", dxf, &name[12]);
+        {
+          GROUP (dxf);
+          dxf_puts (dat, "$PAPER_SPACE");
+          dxf_puts (dat, &name[12]);
+          dxf_write (dat, "\r\n", 2);
+        }
       else
-        fprintf(dat->fh, "%3i\r\n%s\r\n", dxf, name);
+        dxf_write_group_string (dat, dxf, name);
     }
   else if (dat->version >= R_13 && dat->from_version < R_13) // to newer
     {
       if (strlen(name) < 10)
-        fprintf(dat->fh, "%3i\r\n%s\r\n", dxf, name);
+        dxf_write_group_string (dat, dxf, name);
       else if (!strcmp(name, "$MODEL_SPACE"))
-        fprintf(dat->fh, "%3i\r\n*Model_Space\r\n", dxf);
+        dxf_write_group_string (dat, dxf, "*Model_Space");
       else if (!strcmp(name, "$PAPER_SPACE"))
-        fprintf(dat->fh, "%3i\r\n*Paper_Space\r\n", dxf);
+        dxf_write_group_string (dat, dxf, "*Paper_Space");
       else if (!memcmp(name, "$PAPER_SPACE", sizeof("$PAPER_SPACE")-1))
-        fprintf(dat->fh, "%3i\r\n*Paper_Space%s\r\n", dxf, &name[12]);
+        {
+          GROUP (dxf);
+          dxf_puts (dat, "*Paper_Space");
+          dxf_puts (dat, &name[12]);
+          dxf_write (dat, "\r\n", 2);
+        }
       else
-        fprintf(dat->fh, "%3i\r\n%s\r\n", dxf, name);
+        dxf_write_group_string (dat, dxf, name);
     }
   if (dat->from_version >= R_2007)
     free (name);
@@ -831,7 +1123,7 @@ dxf_cvt_blockname(Bit_Chain *restrict dat, char *restrict name, const int dxf)
 #define COMMON_TABLE_CONTROL_FLAGS \
   if (ctrl) { \
     SINCE(R_13) { \
-      fprintf(dat->fh, "%3i\r\n%lX\r\n", 5, ctrl->handle.value); \
+      VALUE_HEX (ctrl->handle.value, 5); \
     } \
     SINCE(R_14) { \
       VALUE_H (_ctrl->null_handle, 330); \
@@ -926,10 +1218,11 @@ static int dxf_3dsolid(Bit_Chain *restrict dat,
                     GROUP(1);
                   else
                     GROUP(3);
+                  dxf_write(dat, s, l);
                   if (s[l-1] == '\r')
-                    fprintf(dat->fh, "%.*s\n", l, s);
+                    dxf_putc(dat, '\n');
                   else
-                    fprintf(dat->fh, "%.*s\r\n", l, s);
+                    dxf_write(dat, "\r\n", 2);
                   l++;
                   len -= l;
                   s += l;
@@ -1881,7 +2174,7 @@ dxf_blocks_write (Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
   // The modelspace header needs to have an block_entity.
   // There are cases (r2010 AEC dwgs) where they don't have one.
   if (msref && msref->obj &&
-      msref->obj->type == DWG_TYPE_BLOCK_HEADER &&
+      msref->obj->type == DWG_TYPE_BLOCK_HEADER && msref->obj->tio.object &&
       msref->obj->tio.object->tio.BLOCK_HEADER->block_entity)
     mspace = msref->obj;
   else
@@ -1980,10 +2273,16 @@ dwg_write_dxf(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
 {
   const int minimal = dwg->opts & 0x10;
   struct Dwg_Header *obj = &dwg->header;
+  const Bit_Chain orig = *dat;
+  int error = 1;
 
   loglevel = dwg->opts & 0xf;
   if (dat->from_version == R_INVALID)
     dat->from_version = dat->version;
+  dat->byte = 0;
+  dat->bit = 0;
+  dat->chain = (unsigned char *)malloc(DXF_BUFSIZE);
+  dat->size = dat->chain ? DXF_BUFSIZE : 0;
 
   VALUE_TV(PACKAGE_STRING, 999);
 
@@ -2020,10 +2319,16 @@ dwg_write_dxf(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
     }
   }
   RECORD(EOF);
+  error = 0;
 
-  return 0;
  fail:
-  return 1;
+  dxf_flush(dat);
+  free(dat->chain);
+  dat->chain = orig.chain;
+  dat->size = orig.size;
+  dat->byte = orig.byte;
+  dat->bit = orig.bit;
+  return error;
 }
 
 #undef IS_PRINT
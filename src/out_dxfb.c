@@ -26,6 +26,7 @@
 #include "common.h"
 #include "bits.h"
 #include "dwg.h"
+#include "classes.h"
 #include "decode.h"
 #include "out_dxf.h"
 
@@ -475,6 +476,8 @@ dwg_dxfb_##token (Bit_Chain *restrict dat, const Dwg_Object *restrict obj) \
   Dwg_Entity_##token *ent, *_obj;\
   Dwg_Object_Entity *_ent;\
   int error = 0; \
+  if (!obj->tio.entity) /* skipped by dwg->decode_filter */ \
+    return 0; \
   if (!strcmp(#token, "GEOPOSITIONMARKER"))\
     RECORD(POSITIONMARKER)\
   else if (dat->version < R_13 && strlen(#token) == 10 && !strcmp(#token, "LWPOLYLINE")) \
@@ -522,6 +525,8 @@ dwg_dxfb_ ##token (Bit_Chain *restrict dat, const Dwg_Object *restrict obj) \
   Dwg_Data* dwg = obj->parent;\
   Dwg_Object_##token *_obj;\
   int error = 0; \
+  if (!obj->tio.object) /* skipped by dwg->decode_filter */ \
+    return 0; \
   LOG_INFO("Object " #token ":\n")\
   _obj = obj->tio.object->tio.token;\
   if (!dwg_obj_is_control(obj)) { \
@@ -1601,7 +1606,7 @@ dxfb_blocks_write (Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
   // The modelspace header needs to have an block_entity.
   // There are cases (r2010 AEC dwgs) where they don't have one.
   if (msref && msref->obj &&
-      msref->obj->type == DWG_TYPE_BLOCK_HEADER &&
+      msref->obj->type == DWG_TYPE_BLOCK_HEADER && msref->obj->tio.object &&
       msref->obj->tio.object->tio.BLOCK_HEADER->block_entity)
     mspace = msref->obj;
   else
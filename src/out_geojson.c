@@ -239,10 +239,15 @@ dwg_geojson_feature(Bit_Chain *restrict dat, Dwg_Object *restrict obj,
                     const char *restrict subclass)
 {
   char tmp[64];
+  int error;
   PAIR_S(type, "Feature");
   KEY(properties);
   SAMEHASH;
-  PAIR_S(Layer, "0"); //TODO layer name
+  // since r2007 interned, converted only once per layer
+  if (obj->supertype == DWG_SUPERTYPE_ENTITY)
+    PAIR_S(Layer, dwg_ent_get_layer_name(obj->tio.entity, &error))
+  else
+    PAIR_S(Layer, "0")
     PAIR_S(SubClasses, subclass);
     PAIR_NULL(ExtendedEntity);
     PAIR_NULL(Linetype);
@@ -339,6 +344,8 @@ dwg_geojson_variable_type(Dwg_Data *restrict dwg, Bit_Chain *restrict dat,
 static void
 dwg_geojson_object(Bit_Chain *restrict dat, Dwg_Object *restrict obj)
 {
+  if (!obj->tio.entity) // skipped by dwg->decode_filter
+    return;
   switch (obj->type)
     {
     case DWG_TYPE_INSERT:
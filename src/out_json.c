@@ -25,18 +25,10 @@
 #include <string.h>
 #include <assert.h>
 
-#ifdef HAVE_ALLOCA_H
-#include <alloca.h>
-#define HAVE_ALLOCA
-#elif defined(_WIN32) && defined(HAVE_MALLOC_H)
-#include <malloc.h>
-#define alloca(s) _alloca(s)
-#define HAVE_ALLOCA
-#endif
-
 #include "common.h"
 #include "bits.h"
 #include "dwg.h"
+#include "classes.h"
 #include "decode.h"
 #include "out_json.h"
 
@@ -45,19 +37,328 @@
 
 /* the current version per spec block */
 static unsigned int cur_ver = 0;
-/* see also examples/unknown.c */
-static char* cquote(char *restrict dest, const char *restrict src);
-#ifdef HAVE_NATIVE_WCHAR2
-static wchar_t* wcquote(wchar_t *restrict dest, const wchar_t *restrict src);
-#endif
-static void  print_wcquote(Bit_Chain *restrict dat, dwg_wchar_t *restrict wstr);
 
-#ifndef HAVE_ALLOCA
-static inline char* alloca(size_t size);
-static inline char* alloca(size_t size) {
-  return malloc(size);
+/*--------------------------------------------------------------------------------
+ * OUTPUT
+ * Everything is written into dat->chain, which is flushed to dat->fh in big
+ * chunks. The last 2 bytes always stay in the buffer, so that NOCOMMA can
+ * drop a trailing ",\n" without seeking back in dat->fh, which fails on
+ * pipes. Numbers and strings are formatted here, not by stdio.
+ */
+
+#define JSON_BUFSIZE (1024 * 1024)
+
+static void
+json_write(Bit_Chain *restrict dat, const char *restrict s, size_t len)
+{
+  if (dat->byte + len > dat->size)
+    {
+      if (dat->byte > 2)
+        {
+          fwrite(dat->chain, 1, dat->byte - 2, dat->fh);
+          memmove(dat->chain, &dat->chain[dat->byte - 2], 2);
+          dat->byte = 2;
+        }
+      if (dat->byte + len > dat->size)
+        {
+          fwrite(dat->chain, 1, dat->byte, dat->fh);
+          fwrite(s, 1, len - 2, dat->fh);
+          memcpy(dat->chain, &s[len - 2], 2);
+          dat->byte = 2;
+          return;
+        }
+    }
+  memcpy(&dat->chain[dat->byte], s, len);
+  dat->byte += len;
+}
+
+static void
+json_puts(Bit_Chain *restrict dat, const char *restrict s)
+{
+  json_write(dat, s, strlen(s));
+}
+
+static void
+json_putc(Bit_Chain *restrict dat, const char c)
+{
+  if (dat->byte >= dat->size)
+    json_write(dat, &c, 1);
+  else
+    dat->chain[dat->byte++] = (unsigned char)c;
+}
+
+/* drop the separator after the last value of an array or hash */
+static void
+json_nocomma(Bit_Chain *restrict dat)
+{
+  if (dat->byte >= 2 && dat->chain[dat->byte - 2] == ','
+      && dat->chain[dat->byte - 1] == '\n')
+    dat->byte -= 2;
+}
+
+/* 2 spaces per level */
+static void
+json_prefix(Bit_Chain *restrict dat)
+{
+  static const char spaces[] = "                                ";
+  size_t n = 2 * (size_t)dat->bit;
+  while (n > sizeof(spaces) - 1)
+    {
+      json_write(dat, spaces, sizeof(spaces) - 1);
+      n -= sizeof(spaces) - 1;
+    }
+  json_write(dat, spaces, n);
+}
+
+/* %lu */
+static void
+json_write_uint(Bit_Chain *restrict dat, uint64_t value)
+{
+  char s[24];
+  char *p = &s[sizeof(s)];
+  do
+    {
+      *--p = '0' + (char)(value % 10);
+      value /= 10;
+    }
+  while (value);
+  json_write(dat, p, &s[sizeof(s)] - p);
+}
+
+/* %ld */
+static void
+json_write_int(Bit_Chain *restrict dat, const int64_t value)
+{
+  if (value < 0)
+    {
+      json_putc(dat, '-');
+      json_write_uint(dat, UINT64_C(0) - (uint64_t)value);
+    }
+  else
+    json_write_uint(dat, (uint64_t)value);
 }
+
+/* %x, %X or %0*x */
+static void
+json_write_hex(Bit_Chain *restrict dat, uint64_t value, const int upper,
+               const int width)
+{
+  const char *hex = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+  char s[24];
+  char *p = &s[sizeof(s)];
+  do
+    {
+      *--p = hex[value & 0xf];
+      value >>= 4;
+    }
+  while (value);
+  while (&s[sizeof(s)] - p < width)
+    *--p = '0';
+  json_write(dat, p, &s[sizeof(s)] - p);
+}
+
+/* %f, correctly rounded from the binary value as glibc does */
+static void
+json_write_double(Bit_Chain *restrict dat, const double value)
+{
+#ifdef __SIZEOF_INT128__
+  char s[48];
+  char *p = &s[sizeof(s)];
+  const uint64_t pow6 = UINT64_C(1000000);
+  uint64_t bits, m, fp;
+  unsigned __int128 q, ip;
+  int e, i;
+
+  memcpy(&bits, &value, sizeof(bits));
+  e = (int)((bits >> 52) & 0x7ff);
+  m = bits & ((UINT64_C(1) << 52) - 1);
+  if (e)
+    m |= UINT64_C(1) << 52;
+  e = (e ? e : 1) - 1075;
+  /* value = m * 2^e. Values >= 2^107, inf and nan are left to snprintf */
+  if (e > 54)
+    goto fallback;
+  q = (unsigned __int128)m * pow6; // < 2^73
+  if (e > 0)
+    q <<= e;
+  else if (e < -80)
+    q = 0;
+  else if (e < 0)
+    {
+      const unsigned __int128 rem = q & (((unsigned __int128)1 << -e) - 1);
+      const unsigned __int128 half = (unsigned __int128)1 << (-e - 1);
+      q >>= -e;
+      // round half to even
+      if (rem > half || (rem == half && (q & 1)))
+        q++;
+    }
+  ip = q / pow6;
+  fp = (uint64_t)(q % pow6);
+  for (i = 0; i < 6; i++)
+    {
+      *--p = '0' + (char)(fp % 10);
+      fp /= 10;
+    }
+  *--p = '.';
+  if (ip <= UINT64_MAX)
+    {
+      uint64_t u = (uint64_t)ip;
+      do
+        {
+          *--p = '0' + (char)(u % 10);
+          u /= 10;
+        }
+      while (u);
+    }
+  else
+    do
+      {
+        *--p = '0' + (char)(ip % 10);
+        ip /= 10;
+      }
+    while (ip);
+  if (bits >> 63)
+    *--p = '-';
+  json_write(dat, p, &s[sizeof(s)] - p);
+  return;
+
+ fallback:
 #endif
+  {
+    // up to 309 integer digits
+    char _buf[352];
+    snprintf(_buf, sizeof(_buf), "%f", value);
+    json_puts(dat, _buf);
+  }
+}
+
+/* "%d.%d.%lu",\n */
+static void
+json_write_handle(Bit_Chain *restrict dat, const int code, const int size,
+                  const unsigned long value)
+{
+  json_putc(dat, '"');
+  json_write_int(dat, code);
+  json_putc(dat, '.');
+  json_write_int(dat, size);
+  json_putc(dat, '.');
+  json_write_uint(dat, value);
+  json_write(dat, "\",\n", 3);
+}
+
+/* [ %f, %f ],\n */
+static void
+json_write_2RD(Bit_Chain *restrict dat, const double x, const double y)
+{
+  json_write(dat, "[ ", 2);
+  json_write_double(dat, x);
+  json_write(dat, ", ", 2);
+  json_write_double(dat, y);
+  json_write(dat, " ],\n", 4);
+}
+
+/* [ %f, %f, %f ],\n */
+static void
+json_write_3RD(Bit_Chain *restrict dat, const double x, const double y,
+               const double z)
+{
+  json_write(dat, "[ ", 2);
+  json_write_double(dat, x);
+  json_write(dat, ", ", 2);
+  json_write_double(dat, y);
+  json_write(dat, ", ", 2);
+  json_write_double(dat, z);
+  json_write(dat, " ],\n", 4);
+}
+
+/* \", \\, \n, \r and \u00XX for the other control characters */
+static void
+json_write_escape(Bit_Chain *restrict dat, const unsigned c)
+{
+  static const char hex[] = "0123456789abcdef";
+  char s[6] = { '\\', 'u', '0', '0', '0', '0' };
+  if (c == '"' || c == '\\')
+    {
+      s[1] = (char)c;
+      json_write(dat, s, 2);
+    }
+  else if (c == '\n')
+    json_write(dat, "\\n", 2);
+  else if (c == '\r')
+    json_write(dat, "\\r", 2);
+  else
+    {
+      s[2] = hex[(c >> 12) & 0xf];
+      s[3] = hex[(c >> 8) & 0xf];
+      s[4] = hex[(c >> 4) & 0xf];
+      s[5] = hex[c & 0xf];
+      json_write(dat, s, 6);
+    }
+}
+
+/* a quoted string. The runs of plain characters are copied at once. */
+static void
+json_write_string(Bit_Chain *restrict dat, const char *restrict str)
+{
+  json_putc(dat, '"');
+  if (str)
+    {
+      const unsigned char *s = (const unsigned char *)str;
+      const unsigned char *run = s;
+      for (; *s; s++)
+        {
+          if (*s < 0x20 || *s == '"' || *s == '\\')
+            {
+              json_write(dat, (const char *)run, s - run);
+              json_write_escape(dat, *s);
+              run = s + 1;
+            }
+        }
+      json_write(dat, (const char *)run, s - run);
+    }
+  json_putc(dat, '"');
+}
+
+/* a quoted UTF-16 string, with all non-ASCII chars as \uXXXX */
+static void
+json_write_wstring(Bit_Chain *restrict dat, BITCODE_TU ws)
+{
+  json_putc(dat, '"');
+  if (ws)
+    {
+      uint16_t c;
+      while ((c = *ws++))
+        {
+          if (c < 0x20 || c >= 0x7f || c == '"' || c == '\\')
+            json_write_escape(dat, c);
+          else
+            json_putc(dat, (char)c);
+        }
+    }
+  json_putc(dat, '"');
+}
+
+/* %02X per byte */
+static void
+json_write_binary(Bit_Chain *restrict dat, const unsigned char *restrict s,
+                  long len)
+{
+  static const char hex[] = "0123456789ABCDEF";
+  char buf[256];
+  while (len > 0)
+    {
+      const long n = len > 128 ? 128 : len;
+      long j;
+      for (j = 0; j < n; j++)
+        {
+          buf[2 * j] = hex[s[j] >> 4];
+          buf[2 * j + 1] = hex[s[j] & 0xf];
+        }
+      json_write(dat, buf, 2 * n);
+      s += n;
+      len -= n;
+    }
+}
 
 /*--------------------------------------------------------------------------------
  * MACROS
@@ -67,16 +368,16 @@ static inline char* alloca(size_t size) {
 #define IS_PRINT
 #define IS_JSON
 
-#define PREFIX   _prefix(dat);
-#define ARRAY    fprintf (dat->fh, "[\n"); dat->bit++
-#define ENDARRAY fprintf (dat->fh, "\n"); dat->bit--; PREFIX fprintf (dat->fh, "],\n")
-#define LASTENDARRAY fprintf (dat->fh, "\n"); dat->bit--; PREFIX fprintf (dat->fh, "]\n")
-#define KEYs(nam) PREFIX fprintf (dat->fh, "\"%s\": ", nam)
-#define KEY(nam) PREFIX fprintf (dat->fh, "\"%s\": ", #nam)
-#define HASH     PREFIX fprintf (dat->fh, "{\n"); dat->bit++
-#define ENDHASH  fprintf (dat->fh, "\n"); dat->bit--; PREFIX fprintf (dat->fh, "},\n")
-#define LASTENDHASH fprintf (dat->fh, "\n"); dat->bit--; PREFIX fprintf (dat->fh, "}")
-#define NOCOMMA  fseek(dat->fh, -2, SEEK_CUR)
+#define PREFIX   json_prefix(dat);
+#define ARRAY    json_write(dat, "[\n", 2); dat->bit++
+#define ENDARRAY json_putc(dat, '\n'); dat->bit--; PREFIX json_write(dat, "],\n", 3)
+#define LASTENDARRAY json_putc(dat, '\n'); dat->bit--; PREFIX json_write(dat, "]\n", 2)
+#define KEYs(nam) PREFIX json_putc(dat, '"'); json_puts(dat, nam); json_write(dat, "\": ", 3)
+#define KEY(nam) PREFIX json_puts(dat, "\"" #nam "\": ")
+#define HASH     PREFIX json_write(dat, "{\n", 2); dat->bit++
+#define ENDHASH  json_putc(dat, '\n'); dat->bit--; PREFIX json_write(dat, "},\n", 3)
+#define LASTENDHASH json_putc(dat, '\n'); dat->bit--; PREFIX json_putc(dat, '}')
+#define NOCOMMA  json_nocomma(dat)
 
 #define TABLE(nam) KEY(nam); HASH
 #define ENDTAB()    NOCOMMA; ENDHASH
@@ -84,75 +385,77 @@ static inline char* alloca(size_t size) {
 #define RECORD(nam) KEY(nam); HASH
 #define ENDRECORD()  NOCOMMA; ENDHASH
 // a named list
-#define SECTION(nam) PREFIX fprintf (dat->fh, "\"%s\": [\n", #nam); dat->bit++;
+#define SECTION(nam) PREFIX json_puts(dat, "\"" #nam "\": [\n"); dat->bit++;
 #define ENDSEC()      ENDARRAY
 
 #undef  FORMAT_RC
 #define FORMAT_RC "%d"
+// FORMAT_##type, without printf
+#define JSON_WRITE_B(value)     json_write_int(dat, (int)(value))
+#define JSON_WRITE_BB(value)    json_write_uint(dat, (unsigned)(value))
+#define JSON_WRITE_3B(value)    json_write_uint(dat, (unsigned)(value))
+#define JSON_WRITE_RC(value)    json_write_int(dat, (int)(value))
+#define JSON_WRITE_RCd(value)   json_write_int(dat, (int)(value))
+#define JSON_WRITE_RCu(value)   json_write_uint(dat, (unsigned)(value))
+#define JSON_WRITE_BS(value)    json_write_uint(dat, (uint16_t)(value))
+#define JSON_WRITE_RS(value)    json_write_uint(dat, (uint16_t)(value))
+#define JSON_WRITE_BL(value)    json_write_uint(dat, (uint32_t)(value))
+#define JSON_WRITE_RL(value)    json_write_uint(dat, (uint32_t)(value))
+#define JSON_WRITE_BLd(value)   json_write_int(dat, (int32_t)(value))
+#define JSON_WRITE_RLd(value)   json_write_int(dat, (int32_t)(value))
+#define JSON_WRITE_BLX(value)   json_write_hex(dat, (uint32_t)(value), 1, 0)
+#define JSON_WRITE_BLx(value)   json_write_hex(dat, (uint32_t)(value), 0, 0)
+#define JSON_WRITE_MS(value)    JSON_WRITE_BL(value)
+#define JSON_WRITE_MC(value)    json_write_int(dat, (long)(value))
+#define JSON_WRITE_UMC(value)   json_write_uint(dat, (unsigned long)(value))
+#define JSON_WRITE_BLL(value)   json_write_int(dat, (int64_t)(value))
+#define JSON_WRITE_RLL(value)   json_write_int(dat, (int64_t)(value))
+#define JSON_WRITE_4BITS(value) json_write_hex(dat, (unsigned)(value), 0, 0)
+#define JSON_WRITE_RD(value)    json_write_double(dat, (double)(value))
+#define JSON_WRITE_BD(value)    json_write_double(dat, (double)(value))
+#define JSON_WRITE_DD(value)    json_write_double(dat, (double)(value))
+#define JSON_WRITE_BT(value)    json_write_double(dat, (double)(value))
+
 #define VALUE(value,type,dxf) \
-  fprintf(dat->fh, FORMAT_##type ",\n", value)
+  (JSON_WRITE_##type(value), json_write(dat, ",\n", 2))
 #define VALUE_B(value,dxf)  VALUE(value, B, dxf)
 #define VALUE_RC(value,dxf) VALUE(value, RC, dxf)
 #define VALUE_RS(value,dxf) VALUE(value, RS, dxf)
 #define VALUE_RL(value,dxf) VALUE(value, RL, dxf)
 #define VALUE_RD(value,dxf) VALUE(value, RD, dxf)
 #define VALUE_2RD(pt,dxf) \
-    fprintf(dat->fh, "[ %f, %f ],\n", pt.x, pt.y)
+  json_write_2RD(dat, (pt).x, (pt).y)
 #define VALUE_2DD(pt,d1,d2,dxf) VALUE_2RD(pt,dxf)
 #define VALUE_3RD(pt,dxf) \
-  fprintf(dat->fh, "[ %f, %f, %f ],\n", pt.x, pt.y, pt.z)
+  json_write_3RD(dat, (pt).x, (pt).y, (pt).z)
 #define VALUE_3BD(pt,dxf) VALUE_3RD(pt,dxf)
 #define VALUE_TV(nam,dxf)
 
 #define FIELD(nam,type,dxf) \
-  { PREFIX fprintf(dat->fh, "\"" #nam "\": " FORMAT_##type ",\n", _obj->nam); }
+  { PREFIX json_puts(dat, "\"" #nam "\": "); \
+    VALUE(_obj->nam, type, dxf); }
 #define _FIELD(nam,type,value) \
-  { PREFIX fprintf(dat->fh, "\"" #nam "\": " FORMAT_##type ",\n", obj->nam); }
+  { PREFIX json_puts(dat, "\"" #nam "\": "); \
+    VALUE(obj->nam, type, 0); }
 #define ENT_FIELD(nam,type,value) \
-  { PREFIX fprintf(dat->fh, "\"" #nam "\": " FORMAT_##type ",\n", _ent->nam); }
+  { PREFIX json_puts(dat, "\"" #nam "\": "); \
+    VALUE(_ent->nam, type, 0); }
 #define SUB_FIELD(o,nam,type,dxf) \
-  { PREFIX fprintf(dat->fh, "\"" #nam "\": " FORMAT_##type ",\n", _obj->o.nam); }
+  { PREFIX json_puts(dat, "\"" #nam "\": "); \
+    VALUE(_obj->o.nam, type, dxf); }
 
 #define FIELD_CAST(nam,type,cast,dxf) FIELD(nam,cast,dxf)
 #define FIELD_TRACE(nam,type)
 #define FIELD_G_TRACE(nam,type,dxf)
-#ifdef HAVE_ALLOCA
-#define FIELD_TEXT(nam,str) \
-  { \
-    PREFIX \
-    if (str && (strchr(str, '"') || strchr(str, '\\'))) { \
-      char *_buf = alloca(2*strlen(str)); \
-      fprintf(dat->fh, "\"" #nam "\": \"%s\",\n", cquote(_buf, str)); \
-    } else { \
-      fprintf(dat->fh, "\"" #nam "\": \"%s\",\n", str ? str : ""); \
-    } \
-  }
-#else
 #define FIELD_TEXT(nam,str) \
   { \
-    PREFIX \
-    if (str && (strchr(str, '"') || strchr(str, '\\'))) { \
-      char *_buf = malloc(2*strlen(str)); \
-      fprintf(dat->fh, "\"" #nam "\": \"%s\",\n", cquote(_buf, str)); \
-      free(_buf); \
-    } else { \
-      fprintf(dat->fh, "\"" #nam "\": \"%s\",\n", str ? str : ""); \
-    } \
+    PREFIX json_puts(dat, "\"" #nam "\": "); \
+    json_write_string(dat, str); \
+    json_write(dat, ",\n", 2); \
   }
-#endif
 
-#ifdef HAVE_NATIVE_WCHAR2
-# define VALUE_TEXT_TU(wstr) \
-    if (wstr && (wcschr(wstr, L'"') || wcschr(wstr, L'\\'))) { \
-      wchar_t *_buf = malloc(2*wcslen(wstr)); \
-      fprintf(dat->fh, "\"%ls\",\n", wcquote(_buf, wstr)); \
-      free(_buf); \
-    } else { \
-      fprintf(dat->fh, "\"%ls\",\n", wstr ? (wchar_t*)wstr : L""); \
-    }
-#else
-# define VALUE_TEXT_TU(wstr) print_wcquote(dat, (BITCODE_TU)wstr)
-#endif
+#define VALUE_TEXT_TU(wstr) \
+  (json_write_wstring(dat, (BITCODE_TU)wstr), json_write(dat, ",\n", 2))
 #define FIELD_TEXT_TU(nam, wstr) \
   KEY(nam); VALUE_TEXT_TU((BITCODE_TU)wstr)
 
@@ -161,51 +464,43 @@ static inline char* alloca(size_t size) {
 // todo: only the name, not the ref
 #define VALUE_HANDLE(hdlptr, nam, handle_code, dxf)     \
   if (hdlptr) { \
-    fprintf(dat->fh, "\"%d.%d.%lu\",\n", \
-            hdlptr->handleref.code, \
-            hdlptr->handleref.size, \
-            hdlptr->handleref.value); \
-  } else { fprintf(dat->fh, "\"0.0.0\",\n"); }
+    json_write_handle(dat, hdlptr->handleref.code, \
+                      hdlptr->handleref.size, \
+                      hdlptr->handleref.value); \
+  } else { json_write(dat, "\"0.0.0\",\n", 9); }
 #define VALUE_H(hdl, dxf) \
-  fprintf(dat->fh, "\"%d.%d.%lu\",\n", \
-            (hdl).code, \
-            (hdl).size, \
-            (hdl).value)
+  json_write_handle(dat, (hdl).code, (hdl).size, (hdl).value)
 #define FIELD_HANDLE(nam, handle_code, dxf) \
-  PREFIX if (_obj->nam) { \
-    fprintf(dat->fh, "\"" #nam "\": \"%d.%d.%lu\",\n", \
-            _obj->nam->handleref.code, \
-            _obj->nam->handleref.size, \
-            _obj->nam->handleref.value); \
-  } else { fprintf(dat->fh, "\"" #nam "\": \"0.0.0\",\n"); }
+  PREFIX json_puts(dat, "\"" #nam "\": "); \
+  if (_obj->nam) { \
+    json_write_handle(dat, _obj->nam->handleref.code, \
+                      _obj->nam->handleref.size, \
+                      _obj->nam->handleref.value); \
+  } else { json_write(dat, "\"0.0.0\",\n", 9); }
 #define SUB_FIELD_HANDLE(o,nam,handle_code, dxf) \
-  PREFIX if (_obj->o.nam) { \
-    fprintf(dat->fh, "\"" #nam "\": \"%d.%d.%lu\",\n", \
-            _obj->o.nam->handleref.code, \
-            _obj->o.nam->handleref.size, \
-            _obj->o.nam->handleref.value); \
-  } else { fprintf(dat->fh, "\"" #nam "\": \"0.0.0\",\n"); }
+  PREFIX json_puts(dat, "\"" #nam "\": "); \
+  if (_obj->o.nam) { \
+    json_write_handle(dat, _obj->o.nam->handleref.code, \
+                      _obj->o.nam->handleref.size, \
+                      _obj->o.nam->handleref.value); \
+  } else { json_write(dat, "\"0.0.0\",\n", 9); }
 #define FIELD_DATAHANDLE(nam, code, dxf) FIELD_HANDLE(nam, code, dxf)
 #define FIELD_HANDLE_N(nam, vcount, handle_code, dxf) \
   PREFIX if (_obj->nam) { \
-    fprintf(dat->fh, "\"%d.%d.%lu\",\n", \
-            _obj->nam->handleref.code, \
-            _obj->nam->handleref.size, \
-            _obj->nam->handleref.value); \
+    json_write_handle(dat, _obj->nam->handleref.code, \
+                      _obj->nam->handleref.size, \
+                      _obj->nam->handleref.value); \
   } else {\
-    fprintf(dat->fh, "\"0.0.0\",\n"); \
+    json_write(dat, "\"0.0.0\",\n", 9); \
   }
 #define FIELD_BINARY(nam,size,dxf) \
 { \
-  long len = size; \
   KEY(nam); \
-  fprintf(dat->fh, "\""); \
+  json_putc(dat, '"'); \
   if (_obj->nam) { \
-    for (long j=0; j < len; j++) { \
-      fprintf(dat->fh, "%02X", _obj->nam[j]); \
-    } \
+    json_write_binary(dat, (const unsigned char *)_obj->nam, (long)(size)); \
   } \
-  fprintf(dat->fh, "\",\n"); \
+  json_write(dat, "\",\n", 3); \
 }
 
 #define FIELD_B(nam,dxf)   FIELD(nam, B, dxf)
@@ -232,26 +527,25 @@ static inline char* alloca(size_t size) {
 #define FIELD_BT(nam,dxf)    FIELD(nam, BT, dxf);
 #define FIELD_4BITS(nam,dxf) FIELD(nam,4BITS,dxf)
 #define FIELD_BE(nam,dxf)    FIELD_3RD(nam,dxf)
-#define FIELD_DD(nam, _default, dxf) \
-    PREFIX fprintf(dat->fh, "\"" #nam "\": " FORMAT_DD ",\n", _obj->nam)
+#define FIELD_DD(nam, _default, dxf) FIELD(nam, DD, dxf)
 #define FIELD_2DD(nam, d1, d2, dxf) FIELD_2RD(nam,dxf)
 #define FIELD_3DD(nam, def, dxf)    FIELD_3RD(nam,dxf)
 #define FIELD_2RD(nam,dxf) { \
-    PREFIX fprintf(dat->fh, "\"" #nam "\": [ %f, %f ],\n", \
-                   _obj->nam.x, _obj->nam.y); }
+    PREFIX json_puts(dat, "\"" #nam "\": "); \
+    VALUE_2RD(_obj->nam, dxf); }
 #define FIELD_2BD(nam,dxf)   FIELD_2RD(nam,dxf)
 #define FIELD_2BD_1(nam,dxf) FIELD_2RD(nam,dxf)
 #define FIELD_3RD(nam,dxf) { \
-    PREFIX fprintf(dat->fh, "\"" #nam "\": [ %f, %f, %f ],\n", \
-                   _obj->nam.x, _obj->nam.y, _obj->nam.z); }
+    PREFIX json_puts(dat, "\"" #nam "\": "); \
+    VALUE_3RD(_obj->nam, dxf); }
 #define FIELD_3BD(nam,dxf)     FIELD_3RD(nam,dxf)
 #define FIELD_3BD_1(nam,dxf)   FIELD_3RD(nam,dxf)
 #define FIELD_3DPOINT(nam,dxf) FIELD_3BD(nam,dxf)
 
 #define SUB_FIELD_T(o,nam,dxf) \
   { if (dat->version >= R_2007) { KEY(nam); VALUE_TEXT_TU((BITCODE_TU)_obj->o.nam); } \
-    else                        { PREFIX; fprintf(dat->fh, "\"" #nam "\": \"%s\",\n", \
-                                                    _obj->o.nam); } }
+    else                        { KEY(nam); json_write_string(dat, _obj->o.nam); \
+                                  json_write(dat, ",\n", 2); } }
 #define SUB_FIELD_B(o,nam,dxf)   SUB_FIELD(o, nam, B, dxf)
 #define SUB_FIELD_BB(o,nam,dxf)  SUB_FIELD(o, nam, BB, dxf)
 #define SUB_FIELD_3B(o,nam,dxf)  SUB_FIELD(o, nam, 3B, dxf)
@@ -275,34 +569,44 @@ static inline char* alloca(size_t size) {
 #define FIELD_CMC(color,dxf1,dxf2) { \
   if (dat->version >= R_2004) { \
     RECORD(color); \
-    PREFIX fprintf(dat->fh, "\"index\": %d,\n", _obj->color.index); \
-    PREFIX fprintf(dat->fh, "\"" #color ".rgb\": \"%06x\",\n", (unsigned)_obj->color.rgb); \
+    PREFIX json_puts(dat, "\"index\": "); \
+    VALUE(_obj->color.index, BLd, 0); \
+    PREFIX json_puts(dat, "\"" #color ".rgb\": \""); \
+    json_write_hex(dat, (unsigned)_obj->color.rgb, 0, 6); \
+    json_write(dat, "\",\n", 3); \
     /*if (_obj->color.flag & 1) { \
-      PREFIX fprintf(dat->fh, "\"" #color ".name\": \"%s\",\n", _obj->color.name); } \
+      FIELD_TEXT(name, _obj->color.name); } \
     if (_obj->color.flag & 2) { \
-      PREFIX fprintf(dat->fh, "\"" #color ".bookname\": \"%s\",\n", _obj->color.book_name); } */\
+      FIELD_TEXT(bookname, _obj->color.book_name); } */\
     ENDRECORD(); \
   } else { \
-    PREFIX fprintf(dat->fh, "\"" #color "\": %d,\n", _obj->color.index); \
+    PREFIX json_puts(dat, "\"" #color "\": "); \
+    VALUE(_obj->color.index, BLd, 0); \
   } \
 }
 #define SUB_FIELD_CMC(o,color,dxf1,dxf2) {    \
   if (dat->version >= R_2004) { \
     RECORD(color); \
-    PREFIX fprintf(dat->fh, "\"index\": %d,\n", _obj->o.color.index); \
-    PREFIX fprintf(dat->fh, "\"" #color ".rgb\": \"%06x\",\n", (unsigned)_obj->o.color.rgb); \
+    PREFIX json_puts(dat, "\"index\": "); \
+    VALUE(_obj->o.color.index, BLd, 0); \
+    PREFIX json_puts(dat, "\"" #color ".rgb\": \""); \
+    json_write_hex(dat, (unsigned)_obj->o.color.rgb, 0, 6); \
+    json_write(dat, "\",\n", 3); \
     /*if (_obj->color.flag & 1) { \
-      PREFIX fprintf(dat->fh, "\"" #color ".name\": \"%s\",\n", _obj->o.color.name); } \
+      FIELD_TEXT(name, _obj->o.color.name); } \
     if (_obj->color.flag & 2) { \
-      PREFIX fprintf(dat->fh, "\"" #color ".bookname\": \"%s\",\n", _obj->o.color.book_name); } */\
+      FIELD_TEXT(bookname, _obj->o.color.book_name); } */\
     ENDRECORD(); \
   } else { \
-    PREFIX fprintf(dat->fh, "\"" #color "\": %d,\n", _obj->o.color.index); \
+    PREFIX json_puts(dat, "\"" #color "\": "); \
+    VALUE(_obj->o.color.index, BLd, 0); \
   } \
 }
-#define FIELD_TIMEBLL(nam,dxf) \
-    PREFIX fprintf(dat->fh, "\"" #nam "\": " FORMAT_BL "." FORMAT_BL ",\n", \
-            _obj->nam.days, _obj->nam.ms)
+#define FIELD_TIMEBLL(nam,dxf) { \
+    PREFIX json_puts(dat, "\"" #nam "\": "); \
+    JSON_WRITE_BL(_obj->nam.days); \
+    json_putc(dat, '.'); \
+    VALUE(_obj->nam.ms, BL, dxf); }
 
 //FIELD_VECTOR_N(nam, type, size):
 // reads data of the type indicated by 'type' 'size' times and stores
@@ -312,17 +616,31 @@ static inline char* alloca(size_t size) {
     if (_obj->nam) { \
       for (vcount=0; vcount < (BITCODE_BL)size; vcount++)\
         {\
-          PREFIX fprintf(dat->fh, FORMAT_##type ",\n", _obj->nam[vcount]); \
+          PREFIX VALUE(_obj->nam[vcount], type, dxf); \
         }\
       if (size) NOCOMMA;\
     } \
     ENDARRAY;
+// a short vector on a single line
+#define FIELD_VECTOR_INL(nam, type, size, dxf) \
+  { \
+    BITCODE_BL _i; \
+    KEY(nam); json_write(dat, "[ ", 2); \
+    for (_i = 0; _i < (BITCODE_BL)size; _i++) \
+      { \
+        if (_i) \
+          json_write(dat, ", ", 2); \
+        JSON_WRITE_##type(_obj->nam[_i]); \
+      } \
+    json_write(dat, " ],\n", 4); \
+  }
 #define FIELD_VECTOR_T(nam, size, dxf)\
     KEY(nam); ARRAY; \
     if (_obj->nam) { \
       PRE (R_2007) { \
         for (vcount=0; vcount < (BITCODE_BL)_obj->size; vcount++) { \
-          PREFIX fprintf(dat->fh, "\"%s\",\n", _obj->nam[vcount]); \
+          PREFIX json_write_string(dat, _obj->nam[vcount]); \
+          json_write(dat, ",\n", 2); \
         } \
       } else { \
         for (vcount=0; vcount < (BITCODE_BL)_obj->size; vcount++) { \
@@ -442,12 +760,6 @@ static inline char* alloca(size_t size) {
 #define START_HANDLE_STREAM
 
 
-static void
-_prefix(Bit_Chain* dat) {
-  for (int _i=0; _i < dat->bit; _i++) { fprintf (dat->fh, "  "); }
-}
-
-
 #define DWG_ENTITY(token) \
 static int \
 dwg_json_##token (Bit_Chain *restrict dat, Dwg_Object *restrict obj) \
@@ -458,6 +770,8 @@ dwg_json_##token (Bit_Chain *restrict dat, Dwg_Object *restrict obj) \
   Dwg_Data* dwg = obj->parent; \
   Dwg_Entity_##token *ent, *_obj;\
   Dwg_Object_Entity *_ent;\
+  if (!obj->tio.entity) /* skipped by dwg->decode_filter */ \
+    return 0; \
   LOG_INFO("Entity " #token ":\n")\
   _ent = obj->tio.entity;\
   _obj = ent = _ent->tio.token;\
@@ -485,6 +799,8 @@ dwg_json_ ##token (Bit_Chain *restrict dat, Dwg_Object *restrict obj) \
   Bit_Chain *hdl_dat = dat;\
   Dwg_Data* dwg = obj->parent; \
   Dwg_Object_##token *_obj;\
+  if (!obj->tio.object) /* skipped by dwg->decode_filter */ \
+    return 0; \
   LOG_INFO("Object " #token ":\n")\
   _obj = obj->tio.object->tio.token;\
   FIELD_TEXT(object, #token);\
@@ -506,69 +822,6 @@ json_common_entity_handle_data(Bit_Chain *restrict dat, Dwg_Object *restrict obj
 
 #include "dwg.spec"
 
-static void
-print_wcquote(Bit_Chain *restrict dat, dwg_wchar_t *restrict wstr) {
-  BITCODE_TU ws = (BITCODE_TU)wstr;
-  uint16_t c;
-  fprintf(dat->fh, "\"");
-  if (ws) {
-    while ((c = *ws++)) {
-      if      (c == L'"')  { fprintf(dat->fh, "\\\""); }
-      else if (c == L'\\') { fprintf(dat->fh, "\\\\"); }
-      else if (c == L'\n') { fprintf(dat->fh, "\\n"); }
-      else if (c == L'\r') { fprintf(dat->fh, "\\r"); }
-      else if (c < 0x1f || c > 0xff) {
-        fprintf(dat->fh, "\\u%04x", c);
-      }
-      else
-        fprintf(dat->fh, "%c", (char)(c & 0xff));
-    }
-  }
-  fprintf(dat->fh, "\",\n");
-}
-
-static char*
-cquote(char *restrict dest, const char *restrict src) {
-  char c;
-  char *d = dest;
-  char *s = (char*)src;
-  while ((c = *s++)) {
-    if      (c == '"')  { *dest++ = '\\'; *dest++ = c; }
-    else if (c == '\\') { *dest++ = '\\'; *dest++ = c; }
-    else if (c == '\n') { *dest++ = '\\'; *dest++ = 'n'; }
-    else if (c == '\r') { *dest++ = '\\'; *dest++ = 'r'; }
-    else if (c < 0x1f)  { *dest++ = '\\'; *dest++ = 'u';
-                          *dest++ = '0';  *dest++ = '0';
-                          *dest++ = c < 0x10 ? '0' : '1';
-                          *dest++ = (c % 16 > 10 ? 'a' + (c%16) : '0' + (c%16)); }
-    else                                  *dest++ = c;
-  }
-  *dest = 0; //add final delim, skipped above
-  return d;
-}
-
-#ifdef HAVE_NATIVE_WCHAR2
-static wchar_t*
-wcquote(wchar_t *restrict dest, const wchar_t *restrict src) {
-  wchar_t c;
-  wchar_t *d = dest;
-  wchar_t *s = (wchar_t*)src;
-  while ((c = *s++)) {
-    if      (c == L'"')  { *dest++ = L'\\'; *dest++ = c; }
-    else if (c == L'\\') { *dest++ = L'\\'; *dest++ = c; }
-    else if (c == L'\n') { *dest++ = L'\\'; *dest++ = L'n'; }
-    else if (c == L'\r') { *dest++ = L'\\'; *dest++ = L'r'; }
-    else if (c < 0x1f)   { *dest++ = L'\\'; *dest++ = L'u';
-                          *dest++ = L'0';  *dest++ = L'0';
-                          *dest++ = c < 0x10 ? L'0' : L'1';
-                          *dest++ = (c % 16 > 10 ? L'a' + (c%16) : L'0' + (c%16)); }
-    else                                  *dest++ = c;
-  }
-  *dest = 0; //add final delim, skipped above
-  return d;
-}
-#endif
-
 /* returns 0 on success
  */
 static int
@@ -597,6 +850,8 @@ dwg_json_variable_type(Dwg_Data *restrict dwg, Bit_Chain *restrict dat,
 static int
 dwg_json_object(Bit_Chain *restrict dat, Dwg_Object *restrict obj)
 {
+  if (!obj->tio.object) // skipped by dwg->decode_filter
+    return 0;
   switch (obj->type)
     {
     case DWG_TYPE_TEXT:
@@ -808,7 +1063,9 @@ json_fileheader_write(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
   int i;
 
   RECORD(FILEHEADER); // single hash
-  KEY(version); fprintf(dat->fh, "\"%s\",\n", version_codes[dwg->header.version]);
+  KEY(version);
+  json_write_string(dat, version_codes[dwg->header.version]);
+  json_write(dat, ",\n", 2);
 
   #include "header.spec"
 
@@ -892,7 +1149,11 @@ json_handles_write (Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
     {
       Dwg_Object *obj = &dwg->object[j];
       // handle => abs. offset
-      PREFIX; fprintf(dat->fh, "[ %lu, %lu ],\n", obj->handle.value, obj->address);
+      PREFIX json_write(dat, "[ ", 2);
+      json_write_uint(dat, obj->handle.value);
+      json_write(dat, ", ", 2);
+      json_write_uint(dat, obj->address);
+      json_write(dat, " ],\n", 4);
     }
   NOCOMMA;
   ENDSEC();
@@ -906,7 +1167,8 @@ json_preview_write (Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
   if (_obj->chain && _obj->size && _obj->size > 10)
     {
       KEY(THUMBNAILIMAGE); HASH;
-      PREFIX fprintf(dat->fh, "\"size\": %lu,\n", _obj->size);
+      PREFIX json_puts(dat, "\"size\": ");
+      VALUE(_obj->size, UMC, 0);
       FIELD_BINARY(chain, _obj->size, 310);
       NOCOMMA;
       ENDHASH;
@@ -919,9 +1181,22 @@ dwg_write_json(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
 {
   const int minimal = dwg->opts & 0x10;
   struct Dwg_Header *obj = &dwg->header;
+  const Bit_Chain orig = *dat;
+  int error;
 
-  fprintf (dat->fh, "{\n"
-                     "  \"created_by\": \"%s\",\n", PACKAGE_STRING);
+  dat->byte = 0;
+  dat->bit = 0;
+  dat->chain = (unsigned char *)malloc(JSON_BUFSIZE);
+  if (!dat->chain)
+    {
+      *dat = orig;
+      LOG_ERROR("Out of memory");
+      return DWG_ERR_OUTOFMEM;
+    }
+  dat->size = JSON_BUFSIZE;
+
+  json_puts (dat, "{\n"
+                  "  \"created_by\": \"" PACKAGE_STRING "\",\n");
   dat->bit++; // ident
 
   if (!minimal) {
@@ -936,30 +1211,39 @@ dwg_write_json(Bit_Chain *restrict dat, Dwg_Data *restrict dwg)
 
   if (!minimal && dat->version >= R_13)
     {
-      if (json_classes_write (dat, dwg) >= DWG_ERR_CRITICAL)
+      if ((error = json_classes_write (dat, dwg)) >= DWG_ERR_CRITICAL)
         goto fail;
     }
 
-  if (json_objects_write (dat, dwg) >= DWG_ERR_CRITICAL)
+  if ((error = json_objects_write (dat, dwg)) >= DWG_ERR_CRITICAL)
     goto fail;
 
   if (!minimal && dat->version >= R_2000) {
-    if (json_preview_write (dat, dwg) >= DWG_ERR_CRITICAL)
+    if ((error = json_preview_write (dat, dwg)) >= DWG_ERR_CRITICAL)
       goto fail;
   }
 
   /* object map */
   if (!minimal && dat->version >= R_13) {
-    if (json_handles_write (dat, dwg) >= DWG_ERR_CRITICAL)
+    if ((error = json_handles_write (dat, dwg)) >= DWG_ERR_CRITICAL)
       goto fail;
   }
 
   NOCOMMA;
   dat->bit--;
-  fprintf (dat->fh, "}\n");
-  return 0;
+  json_write (dat, "}\n", 2);
+  error = 0;
  fail:
-  return 1;
+  if (dat->byte)
+    fwrite(dat->chain, 1, dat->byte, dat->fh);
+  if (ferror(dat->fh))
+    {
+      LOG_ERROR("Failed to write the JSON output");
+      error |= DWG_ERR_IOERROR;
+    }
+  free(dat->chain);
+  *dat = orig;
+  return error;
 }
 
 #undef IS_PRINT
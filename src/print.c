@@ -27,6 +27,7 @@
 #include "common.h"
 #include "bits.h"
 #include "dwg.h"
+#include "classes.h"
 #include "decode.h"
 #include "print.h"
 
@@ -303,6 +304,8 @@ dwg_print_##token (Bit_Chain *restrict dat, Dwg_Object *restrict obj)\
   Bit_Chain* str_dat = dat;\
   Dwg_Data* dwg = obj->parent;\
   int error = 0; \
+  if (!obj->tio.entity) /* skipped by dwg->decode_filter */ \
+    return 0; \
   LOG_INFO("Entity " #token ":\n")\
   _ent = obj->tio.entity;\
   _obj = ent = _ent->tio.token;\
@@ -323,6 +326,8 @@ dwg_print_ ##token (Bit_Chain *restrict dat, Dwg_Object *restrict obj) \
   Bit_Chain* str_dat = dat;\
   Dwg_Data* dwg = obj->parent;\
   int error = 0; \
+  if (!obj->tio.object) /* skipped by dwg->decode_filter */ \
+    return 0; \
   LOG_INFO("Object " #token ":\n")\
   _obj = obj->tio.object->tio.token;\
   LOG_TRACE("Object handle: %d.%d.%lX\n",\
@@ -18,18 +18,23 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #ifdef HAVE_MALLOC_H
 #include <malloc.h>
 #endif
 
+#ifdef DEBUG
 #define debug(fmt,...)  \
   fprintf(stderr, "%s:%d: %s() - " fmt, __FILE__, __LINE__, __func__, ##__VA_ARGS__)
+#else
+#define debug(fmt,...)  (void)0
+#endif
 #define POLY_LENGTH     32
 
 typedef unsigned char *Poly;
-typedef Poly *PolyRow;
-typedef PolyRow *PolyMatrix;
+typedef unsigned char PolyRow[3][POLY_LENGTH];
+typedef PolyRow PolyMatrix[2];
 
 /*
  * Private functions
@@ -39,15 +44,20 @@ static void rowop(PolyMatrix, int, int);
 static int fix_errors(unsigned char *, unsigned char *, unsigned char *);
 static void solve_key_equation(unsigned char *, unsigned char *, unsigned char *);
 static unsigned char evaluate(Poly, int, unsigned char);
-static void free_matrix(PolyMatrix);
-static PolyMatrix initialize_matrix(unsigned char *);
-static unsigned char f256_multiply(unsigned char, unsigned char);
+static void initialize_matrix(PolyMatrix, unsigned char *);
+static inline unsigned char f256_multiply(unsigned char, unsigned char);
+static int has_errors(const unsigned char *);
+static int syndromes(const unsigned char *, unsigned char *);
+static int decode_block(unsigned char *, int);
+#ifdef DEBUG
 static void dump_syndrome(unsigned char *);
+#endif
 
 /*
  * Public functions
  */
 int rs_decode_block(unsigned char *, int);
+int rs_decode_blocks(unsigned char *, const unsigned char *, int, int);
 void rs_encode_block(unsigned char *, unsigned char *, int);
 
 /*
@@ -129,41 +139,6 @@ const unsigned char f256_power[] = {
   0x4e, 0x9c, 0x51, 0xa2, 0x2d, 0x5a, 0xb4,
 };
 
-static const unsigned char f256_residue[] = {
-  0x00, 0x69, 0xd2, 0xbb, 0xcd, 0xa4, 0x1f, 0x76,
-  0xf3, 0x9a, 0x21, 0x48, 0x3e, 0x57, 0xec, 0x85,
-  0x8f, 0xe6, 0x5d, 0x34, 0x42, 0x2b, 0x90, 0xf9,
-  0x7c, 0x15, 0xae, 0xc7, 0xb1, 0xd8, 0x63, 0x0a,
-  0x77, 0x1e, 0xa5, 0xcc, 0xba, 0xd3, 0x68, 0x01,
-  0x84, 0xed, 0x56, 0x3f, 0x49, 0x20, 0x9b, 0xf2,
-  0xf8, 0x91, 0x2a, 0x43, 0x35, 0x5c, 0xe7, 0x8e,
-  0x0b, 0x62, 0xd9, 0xb0, 0xc6, 0xaf, 0x14, 0x7d,
-  0xee, 0x87, 0x3c, 0x55, 0x23, 0x4a, 0xf1, 0x98,
-  0x1d, 0x74, 0xcf, 0xa6, 0xd0, 0xb9, 0x02, 0x6b,
-  0x61, 0x08, 0xb3, 0xda, 0xac, 0xc5, 0x7e, 0x17,
-  0x92, 0xfb, 0x40, 0x29, 0x5f, 0x36, 0x8d, 0xe4,
-  0x99, 0xf0, 0x4b, 0x22, 0x54, 0x3d, 0x86, 0xef,
-  0x6a, 0x03, 0xb8, 0xd1, 0xa7, 0xce, 0x75, 0x1c,
-  0x16, 0x7f, 0xc4, 0xad, 0xdb, 0xb2, 0x09, 0x60,
-  0xe5, 0x8c, 0x37, 0x5e, 0x28, 0x41, 0xfa, 0x93,
-  0xb5, 0xdc, 0x67, 0x0e, 0x78, 0x11, 0xaa, 0xc3,
-  0x46, 0x2f, 0x94, 0xfd, 0x8b, 0xe2, 0x59, 0x30,
-  0x3a, 0x53, 0xe8, 0x81, 0xf7, 0x9e, 0x25, 0x4c,
-  0xc9, 0xa0, 0x1b, 0x72, 0x04, 0x6d, 0xd6, 0xbf,
-  0xc2, 0xab, 0x10, 0x79, 0x0f, 0x66, 0xdd, 0xb4,
-  0x31, 0x58, 0xe3, 0x8a, 0xfc, 0x95, 0x2e, 0x47,
-  0x4d, 0x24, 0x9f, 0xf6, 0x80, 0xe9, 0x52, 0x3b,
-  0xbe, 0xd7, 0x6c, 0x05, 0x73, 0x1a, 0xa1, 0xc8,
-  0x5b, 0x32, 0x89, 0xe0, 0x96, 0xff, 0x44, 0x2d,
-  0xa8, 0xc1, 0x7a, 0x13, 0x65, 0x0c, 0xb7, 0xde,
-  0xd4, 0xbd, 0x06, 0x6f, 0x19, 0x70, 0xcb, 0xa2,
-  0x27, 0x4e, 0xf5, 0x9c, 0xea, 0x83, 0x38, 0x51,
-  0x2c, 0x45, 0xfe, 0x97, 0xe1, 0x88, 0x33, 0x5a,
-  0xdf, 0xb6, 0x0d, 0x64, 0x12, 0x7b, 0xc0, 0xa9,
-  0xa3, 0xca, 0x71, 0x18, 0x6e, 0x07, 0xbc, 0xd5,
-  0x50, 0x39, 0x82, 0xeb, 0x9d, 0xf4, 0x4f, 0x26,
-};
-
 const unsigned char f256_logarithm[] = {
   0x00, /* not defined */
   0x00, 0x01, 0x10, 0x02, 0x20, 0x11, 0xcc, 0x03,
@@ -209,23 +184,283 @@ static const unsigned char rsgen[] = {
   0x01,
 };
 
-static unsigned char f256_multiply(unsigned char a, unsigned char b)
-{
-  unsigned int prod = 0;
-  unsigned int A = a;
-  unsigned int B = b;
+/*
+ * The products of all bytes with its coefficients, without the leading 1:
+ * byte j of rsgen_mul[b] is b * rsgen[j], little-endian in 2 words.
+ * For the division by the generator polynomial, one shift per byte.
+ */
+static const uint64_t rsgen_mul[256][2] = {
+  { 0x0000000000000000ULL, 0x0000000000000000ULL },
+  { 0x449e24a11f63e36aULL, 0xdba9cefdfc2f1e13ULL },
+  { 0x8855482b3ec6afd4ULL, 0xdf3bf593915e3c26ULL },
+  { 0xcccb6c8a21a54cbeULL, 0x04923b6e6d712235ULL },
+  { 0x79aa90567ce537c1ULL, 0xd776834f4bbc784cULL },
+  { 0x3d34b4f76386d4abULL, 0x0cdf4db2b793665fULL },
+  { 0xf1ffd87d42239815ULL, 0x084d76dcdae2446aULL },
+  { 0xb561fcdc5d407b7fULL, 0xd3e4b82126cd5a79ULL },
+  { 0xf23d49acf8a36eebULL, 0xc7ec6f9e9611f098ULL },
+  { 0xb6a36d0de7c08d81ULL, 0x1c45a1636a3eee8bULL },
+  { 0x7a680187c665c13fULL, 0x18d79a0d074fccbeULL },
+  { 0x3ef62526d9062255ULL, 0xc37e54f0fb60d2adULL },
+  { 0x8b97d9fa8446592aULL, 0x109aecd1ddad88d4ULL },
+  { 0xcf09fd5b9b25ba40ULL, 0xcb33222c218296c7ULL },
+  { 0x03c291d1ba80f6feULL, 0xcfa119424cf3b4f2ULL },
+  { 0x475cb570a5e31594ULL, 0x1408d7bfb0dcaae1ULL },
+  { 0x8d7a9231992fdcbfULL, 0xe7b1de5545228959ULL },
+  { 0xc9e4b690864c3fd5ULL, 0x3c1810a8b90d974aULL },
+  { 0x052fda1aa7e9736bULL, 0x388a2bc6d47cb57fULL },
+  { 0x41b1febbb88a9001ULL, 0xe323e53b2853ab6cULL },
+  { 0xf4d00267e5caeb7eULL, 0x30c75d1a0e9ef115ULL },
+  { 0xb04e26c6faa90814ULL, 0xeb6e93e7f2b1ef06ULL },
+  { 0x7c854a4cdb0c44aaULL, 0xeffca8899fc0cd33ULL },
+  { 0x381b6eedc46fa7c0ULL, 0x3455667463efd320ULL },
+  { 0x7f47db9d618cb254ULL, 0x205db1cbd33379c1ULL },
+  { 0x3bd9ff3c7eef513eULL, 0xfbf47f362f1c67d2ULL },
+  { 0xf71293b65f4a1d80ULL, 0xff664458426d45e7ULL },
+  { 0xb38cb7174029feeaULL, 0x24cf8aa5be425bf4ULL },
+  { 0x06ed4bcb1d698595ULL, 0xf72b3284988f018dULL },
+  { 0x42736f6a020a66ffULL, 0x2c82fc7964a01f9eULL },
+  { 0x8eb803e023af2a41ULL, 0x2810c71709d13dabULL },
+  { 0xca2627413cccc92bULL, 0xf3b909eaf5fe23b8ULL },
+  { 0x73f44d625b5ed117ULL, 0xa70bd5aa8a447bb2ULL },
+  { 0x376a69c3443d327dULL, 0x7ca21b57766b65a1ULL },
+  { 0xfba1054965987ec3ULL, 0x783020391b1a4794ULL },
+  { 0xbf3f21e87afb9da9ULL, 0xa399eec4e7355987ULL },
+  { 0x0a5edd3427bbe6d6ULL, 0x707d56e5c1f803feULL },
+  { 0x4ec0f99538d805bcULL, 0xabd498183dd71dedULL },
+  { 0x820b951f197d4902ULL, 0xaf46a37650a63fd8ULL },
+  { 0xc695b1be061eaa68ULL, 0x74ef6d8bac8921cbULL },
+  { 0x81c904cea3fdbffcULL, 0x60e7ba341c558b2aULL },
+  { 0xc557206fbc9e5c96ULL, 0xbb4e74c9e07a9539ULL },
+  { 0x099c4ce59d3b1028ULL, 0xbfdc4fa78d0bb70cULL },
+  { 0x4d0268448258f342ULL, 0x6475815a7124a91fULL },
+  { 0xf8639498df18883dULL, 0xb791397b57e9f366ULL },
+  { 0xbcfdb039c07b6b57ULL, 0x6c38f786abc6ed75ULL },
+  { 0x7036dcb3e1de27e9ULL, 0x68aacce8c6b7cf40ULL },
+  { 0x34a8f812febdc483ULL, 0xb30302153a98d153ULL },
+  { 0xfe8edf53c2710da8ULL, 0x40ba0bffcf66f2ebULL },
+  { 0xba10fbf2dd12eec2ULL, 0x9b13c5023349ecf8ULL },
+  { 0x76db9778fcb7a27cULL, 0x9f81fe6c5e38cecdULL },
+  { 0x3245b3d9e3d44116ULL, 0x44283091a217d0deULL },
+  { 0x87244f05be943a69ULL, 0x97cc88b084da8aa7ULL },
+  { 0xc3ba6ba4a1f7d903ULL, 0x4c65464d78f594b4ULL },
+  { 0x0f71072e805295bdULL, 0x48f77d231584b681ULL },
+  { 0x4bef238f9f3176d7ULL, 0x935eb3dee9aba892ULL },
+  { 0x0cb396ff3ad26343ULL, 0x8756646159770273ULL },
+  { 0x482db25e25b18029ULL, 0x5cffaa9ca5581c60ULL },
+  { 0x84e6ded40414cc97ULL, 0x586d91f2c8293e55ULL },
+  { 0xc078fa751b772ffdULL, 0x83c45f0f34062046ULL },
+  { 0x751906a946375482ULL, 0x5020e72e12cb7a3fULL },
+  { 0x318722085954b7e8ULL, 0x8b8929d3eee4642cULL },
+  { 0xfd4c4e8278f1fb56ULL, 0x8f1b12bd83954619ULL },
+  { 0xb9d26a236792183cULL, 0x54b2dc407fba580aULL },
+  { 0xe6819ac4b6bccb2eULL, 0x2716c33d7d88f60dULL },
+  { 0xa21fbe65a9df2844ULL, 0xfcbf0dc081a7e81eULL },
+  { 0x6ed4d2ef887a64faULL, 0xf82d36aeecd6ca2bULL },
+  { 0x2a4af64e97198790ULL, 0x2384f85310f9d438ULL },
+  { 0x9f2b0a92ca59fcefULL, 0xf060407236348e41ULL },
+  { 0xdbb52e33d53a1f85ULL, 0x2bc98e8fca1b9052ULL },
+  { 0x177e42b9f49f533bULL, 0x2f5bb5e1a76ab267ULL },
+  { 0x53e06618ebfcb051ULL, 0xf4f27b1c5b45ac74ULL },
+  { 0x14bcd3684e1fa5c5ULL, 0xe0faaca3eb990695ULL },
+  { 0x5022f7c9517c46afULL, 0x3b53625e17b61886ULL },
+  { 0x9ce99b4370d90a11ULL, 0x3fc159307ac73ab3ULL },
+  { 0xd877bfe26fbae97bULL, 0xe46897cd86e824a0ULL },
+  { 0x6d16433e32fa9204ULL, 0x378c2feca0257ed9ULL },
+  { 0x2988679f2d99716eULL, 0xec25e1115c0a60caULL },
+  { 0xe5430b150c3c3dd0ULL, 0xe8b7da7f317b42ffULL },
+  { 0xa1dd2fb4135fdebaULL, 0x331e1482cd545cecULL },
+  { 0x6bfb08f52f931791ULL, 0xc0a71d6838aa7f54ULL },
+  { 0x2f652c5430f0f4fbULL, 0x1b0ed395c4856147ULL },
+  { 0xe3ae40de1155b845ULL, 0x1f9ce8fba9f44372ULL },
+  { 0xa730647f0e365b2fULL, 0xc435260655db5d61ULL },
+  { 0x125198a353762050ULL, 0x17d19e2773160718ULL },
+  { 0x56cfbc024c15c33aULL, 0xcc7850da8f39190bULL },
+  { 0x9a04d0886db08f84ULL, 0xc8ea6bb4e2483b3eULL },
+  { 0xde9af42972d36ceeULL, 0x1343a5491e67252dULL },
+  { 0x99c64159d730797aULL, 0x074b72f6aebb8fccULL },
+  { 0xdd5865f8c8539a10ULL, 0xdce2bc0b529491dfULL },
+  { 0x11930972e9f6d6aeULL, 0xd87087653fe5b3eaULL },
+  { 0x550d2dd3f69535c4ULL, 0x03d94998c3caadf9ULL },
+  { 0xe06cd10fabd54ebbULL, 0xd03df1b9e507f780ULL },
+  { 0xa4f2f5aeb4b6add1ULL, 0x0b943f441928e993ULL },
+  { 0x683999249513e16fULL, 0x0f06042a7459cba6ULL },
+  { 0x2ca7bd858a700205ULL, 0xd4afcad78876d5b5ULL },
+  { 0x9575d7a6ede21a39ULL, 0x801d1697f7cc8dbfULL },
+  { 0xd1ebf307f281f953ULL, 0x5bb4d86a0be393acULL },
+  { 0x1d209f8dd324b5edULL, 0x5f26e3046692b199ULL },
+  { 0x59bebb2ccc475687ULL, 0x848f2df99abdaf8aULL },
+  { 0xecdf47f091072df8ULL, 0x576b95d8bc70f5f3ULL },
+  { 0xa84163518e64ce92ULL, 0x8cc25b25405febe0ULL },
+  { 0x648a0fdbafc1822cULL, 0x8850604b2d2ec9d5ULL },
+  { 0x20142b7ab0a26146ULL, 0x53f9aeb6d101d7c6ULL },
+  { 0x67489e0a154174d2ULL, 0x47f1790961dd7d27ULL },
+  { 0x23d6baab0a2297b8ULL, 0x9c58b7f49df26334ULL },
+  { 0xef1dd6212b87db06ULL, 0x98ca8c9af0834101ULL },
+  { 0xab83f28034e4386cULL, 0x436342670cac5f12ULL },
+  { 0x1ee20e5c69a44313ULL, 0x9087fa462a61056bULL },
+  { 0x5a7c2afd76c7a079ULL, 0x4b2e34bbd64e1b78ULL },
+  { 0x96b746775762ecc7ULL, 0x4fbc0fd5bb3f394dULL },
+  { 0xd22962d648010fadULL, 0x9415c1284710275eULL },
+  { 0x180f459774cdc686ULL, 0x67acc8c2b2ee04e6ULL },
+  { 0x5c9161366bae25ecULL, 0xbc05063f4ec11af5ULL },
+  { 0x905a0dbc4a0b6952ULL, 0xb8973d5123b038c0ULL },
+  { 0xd4c4291d55688a38ULL, 0x633ef3acdf9f26d3ULL },
+  { 0x61a5d5c10828f147ULL, 0xb0da4b8df9527caaULL },
+  { 0x253bf160174b122dULL, 0x6b738570057d62b9ULL },
+  { 0xe9f09dea36ee5e93ULL, 0x6fe1be1e680c408cULL },
+  { 0xad6eb94b298dbdf9ULL, 0xb44870e394235e9fULL },
+  { 0xea320c3b8c6ea86dULL, 0xa040a75c24fff47eULL },
+  { 0xaeac289a930d4b07ULL, 0x7be969a1d8d0ea6dULL },
+  { 0x62674410b2a807b9ULL, 0x7f7b52cfb5a1c858ULL },
+  { 0x26f960b1adcbe4d3ULL, 0xa4d29c32498ed64bULL },
+  { 0x93989c6df08b9facULL, 0x773624136f438c32ULL },
+  { 0xd706b8ccefe87cc6ULL, 0xac9feaee936c9221ULL },
+  { 0x1bcdd446ce4d3078ULL, 0xa80dd180fe1db014ULL },
+  { 0x5f53f0e7d12ed312ULL, 0x73a41f7d0232ae07ULL },
+  { 0xa56b5de10511ff5cULL, 0x4e2cef7afa79851aULL },
+  { 0xe1f579401a721c36ULL, 0x9585218706569b09ULL },
+  { 0x2d3e15ca3bd75088ULL, 0x91171ae96b27b93cULL },
+  { 0x69a0316b24b4b3e2ULL, 0x4abed4149708a72fULL },
+  { 0xdcc1cdb779f4c89dULL, 0x995a6c35b1c5fd56ULL },
+  { 0x985fe91666972bf7ULL, 0x42f3a2c84deae345ULL },
+  { 0x5494859c47326749ULL, 0x466199a6209bc170ULL },
+  { 0x100aa13d58518423ULL, 0x9dc8575bdcb4df63ULL },
+  { 0x5756144dfdb291b7ULL, 0x89c080e46c687582ULL },
+  { 0x13c830ece2d172ddULL, 0x52694e1990476b91ULL },
+  { 0xdf035c66c3743e63ULL, 0x56fb7577fd3649a4ULL },
+  { 0x9b9d78c7dc17dd09ULL, 0x8d52bb8a011957b7ULL },
+  { 0x2efc841b8157a676ULL, 0x5eb603ab27d40dceULL },
+  { 0x6a62a0ba9e34451cULL, 0x851fcd56dbfb13ddULL },
+  { 0xa6a9cc30bf9109a2ULL, 0x818df638b68a31e8ULL },
+  { 0xe237e891a0f2eac8ULL, 0x5a2438c54aa52ffbULL },
+  { 0x2811cfd09c3e23e3ULL, 0xa99d312fbf5b0c43ULL },
+  { 0x6c8feb71835dc089ULL, 0x7234ffd243741250ULL },
+  { 0xa04487fba2f88c37ULL, 0x76a6c4bc2e053065ULL },
+  { 0xe4daa35abd9b6f5dULL, 0xad0f0a41d22a2e76ULL },
+  { 0x51bb5f86e0db1422ULL, 0x7eebb260f4e7740fULL },
+  { 0x15257b27ffb8f748ULL, 0xa5427c9d08c86a1cULL },
+  { 0xd9ee17adde1dbbf6ULL, 0xa1d047f365b94829ULL },
+  { 0x9d70330cc17e589cULL, 0x7a79890e9996563aULL },
+  { 0xda2c867c649d4d08ULL, 0x6e715eb1294afcdbULL },
+  { 0x9eb2a2dd7bfeae62ULL, 0xb5d8904cd565e2c8ULL },
+  { 0x5279ce575a5be2dcULL, 0xb14aab22b814c0fdULL },
+  { 0x16e7eaf6453801b6ULL, 0x6ae365df443bdeeeULL },
+  { 0xa386162a18787ac9ULL, 0xb907ddfe62f68497ULL },
+  { 0xe718328b071b99a3ULL, 0x62ae13039ed99a84ULL },
+  { 0x2bd35e0126bed51dULL, 0x663c286df3a8b8b1ULL },
+  { 0x6f4d7aa039dd3677ULL, 0xbd95e6900f87a6a2ULL },
+  { 0xd69f10835e4f2e4bULL, 0xe9273ad0703dfea8ULL },
+  { 0x92013422412ccd21ULL, 0x328ef42d8c12e0bbULL },
+  { 0x5eca58a86089819fULL, 0x361ccf43e163c28eULL },
+  { 0x1a547c097fea62f5ULL, 0xedb501be1d4cdc9dULL },
+  { 0xaf3580d522aa198aULL, 0x3e51b99f3b8186e4ULL },
+  { 0xebaba4743dc9fae0ULL, 0xe5f87762c7ae98f7ULL },
+  { 0x2760c8fe1c6cb65eULL, 0xe16a4c0caadfbac2ULL },
+  { 0x63feec5f030f5534ULL, 0x3ac382f156f0a4d1ULL },
+  { 0x24a2592fa6ec40a0ULL, 0x2ecb554ee62c0e30ULL },
+  { 0x603c7d8eb98fa3caULL, 0xf5629bb31a031023ULL },
+  { 0xacf71104982aef74ULL, 0xf1f0a0dd77723216ULL },
+  { 0xe86935a587490c1eULL, 0x2a596e208b5d2c05ULL },
+  { 0x5d08c979da097761ULL, 0xf9bdd601ad90767cULL },
+  { 0x1996edd8c56a940bULL, 0x221418fc51bf686fULL },
+  { 0xd55d8152e4cfd8b5ULL, 0x268623923cce4a5aULL },
+  { 0x91c3a5f3fbac3bdfULL, 0xfd2fed6fc0e15449ULL },
+  { 0x5be582b2c760f2f4ULL, 0x0e96e485351f77f1ULL },
+  { 0x1f7ba613d803119eULL, 0xd53f2a78c93069e2ULL },
+  { 0xd3b0ca99f9a65d20ULL, 0xd1ad1116a4414bd7ULL },
+  { 0x972eee38e6c5be4aULL, 0x0a04dfeb586e55c4ULL },
+  { 0x224f12e4bb85c535ULL, 0xd9e067ca7ea30fbdULL },
+  { 0x66d13645a4e6265fULL, 0x0249a937828c11aeULL },
+  { 0xaa1a5acf85436ae1ULL, 0x06db9259effd339bULL },
+  { 0xee847e6e9a20898bULL, 0xdd725ca413d22d88ULL },
+  { 0xa9d8cb1e3fc39c1fULL, 0xc97a8b1ba30e8769ULL },
+  { 0xed46efbf20a07f75ULL, 0x12d345e65f21997aULL },
+  { 0x218d8335010533cbULL, 0x16417e883250bb4fULL },
+  { 0x6513a7941e66d0a1ULL, 0xcde8b075ce7fa55cULL },
+  { 0xd0725b484326abdeULL, 0x1e0c0854e8b2ff25ULL },
+  { 0x94ec7fe95c4548b4ULL, 0xc5a5c6a9149de136ULL },
+  { 0x582713637de0040aULL, 0xc137fdc779ecc303ULL },
+  { 0x1cb937c26283e760ULL, 0x1a9e333a85c3dd10ULL },
+  { 0x43eac725b3ad3472ULL, 0x693a2c4787f17317ULL },
+  { 0x0774e384acced718ULL, 0xb293e2ba7bde6d04ULL },
+  { 0xcbbf8f0e8d6b9ba6ULL, 0xb601d9d416af4f31ULL },
+  { 0x8f21abaf920878ccULL, 0x6da81729ea805122ULL },
+  { 0x3a405773cf4803b3ULL, 0xbe4caf08cc4d0b5bULL },
+  { 0x7ede73d2d02be0d9ULL, 0x65e561f530621548ULL },
+  { 0xb2151f58f18eac67ULL, 0x61775a9b5d13377dULL },
+  { 0xf68b3bf9eeed4f0dULL, 0xbade9466a13c296eULL },
+  { 0xb1d78e894b0e5a99ULL, 0xaed643d911e0838fULL },
+  { 0xf549aa28546db9f3ULL, 0x757f8d24edcf9d9cULL },
+  { 0x3982c6a275c8f54dULL, 0x71edb64a80bebfa9ULL },
+  { 0x7d1ce2036aab1627ULL, 0xaa4478b77c91a1baULL },
+  { 0xc87d1edf37eb6d58ULL, 0x79a0c0965a5cfbc3ULL },
+  { 0x8ce33a7e28888e32ULL, 0xa2090e6ba673e5d0ULL },
+  { 0x402856f4092dc28cULL, 0xa69b3505cb02c7e5ULL },
+  { 0x04b67255164e21e6ULL, 0x7d32fbf8372dd9f6ULL },
+  { 0xce9055142a82e8cdULL, 0x8e8bf212c2d3fa4eULL },
+  { 0x8a0e71b535e10ba7ULL, 0x55223cef3efce45dULL },
+  { 0x46c51d3f14444719ULL, 0x51b00781538dc668ULL },
+  { 0x025b399e0b27a473ULL, 0x8a19c97cafa2d87bULL },
+  { 0xb73ac5425667df0cULL, 0x59fd715d896f8202ULL },
+  { 0xf3a4e1e349043c66ULL, 0x8254bfa075409c11ULL },
+  { 0x3f6f8d6968a170d8ULL, 0x86c684ce1831be24ULL },
+  { 0x7bf1a9c877c293b2ULL, 0x5d6f4a33e41ea037ULL },
+  { 0x3cad1cb8d2218626ULL, 0x49679d8c54c20ad6ULL },
+  { 0x78333819cd42654cULL, 0x92ce5371a8ed14c5ULL },
+  { 0xb4f85493ece729f2ULL, 0x965c681fc59c36f0ULL },
+  { 0xf0667032f384ca98ULL, 0x4df5a6e239b328e3ULL },
+  { 0x45078ceeaec4b1e7ULL, 0x9e111ec31f7e729aULL },
+  { 0x0199a84fb1a7528dULL, 0x45b8d03ee3516c89ULL },
+  { 0xcd52c4c590021e33ULL, 0x412aeb508e204ebcULL },
+  { 0x89cce0648f61fd59ULL, 0x9a8325ad720f50afULL },
+  { 0x301e8a47e8f3e565ULL, 0xce31f9ed0db508a5ULL },
+  { 0x7480aee6f790060fULL, 0x15983710f19a16b6ULL },
+  { 0xb84bc26cd6354ab1ULL, 0x110a0c7e9ceb3483ULL },
+  { 0xfcd5e6cdc956a9dbULL, 0xcaa3c28360c42a90ULL },
+  { 0x49b41a119416d2a4ULL, 0x19477aa2460970e9ULL },
+  { 0x0d2a3eb08b7531ceULL, 0xc2eeb45fba266efaULL },
+  { 0xc1e1523aaad07d70ULL, 0xc67c8f31d7574ccfULL },
+  { 0x857f769bb5b39e1aULL, 0x1dd541cc2b7852dcULL },
+  { 0xc223c3eb10508b8eULL, 0x09dd96739ba4f83dULL },
+  { 0x86bde74a0f3368e4ULL, 0xd274588e678be62eULL },
+  { 0x4a768bc02e96245aULL, 0xd6e663e00afac41bULL },
+  { 0x0ee8af6131f5c730ULL, 0x0d4fad1df6d5da08ULL },
+  { 0xbb8953bd6cb5bc4fULL, 0xdeab153cd0188071ULL },
+  { 0xff17771c73d65f25ULL, 0x0502dbc12c379e62ULL },
+  { 0x33dc1b965273139bULL, 0x0190e0af4146bc57ULL },
+  { 0x77423f374d10f0f1ULL, 0xda392e52bd69a244ULL },
+  { 0xbd64187671dc39daULL, 0x298027b8489781fcULL },
+  { 0xf9fa3cd76ebfdab0ULL, 0xf229e945b4b89fefULL },
+  { 0x3531505d4f1a960eULL, 0xf6bbd22bd9c9bddaULL },
+  { 0x71af74fc50797564ULL, 0x2d121cd625e6a3c9ULL },
+  { 0xc4ce88200d390e1bULL, 0xfef6a4f7032bf9b0ULL },
+  { 0x8050ac81125aed71ULL, 0x255f6a0aff04e7a3ULL },
+  { 0x4c9bc00b33ffa1cfULL, 0x21cd51649275c596ULL },
+  { 0x0805e4aa2c9c42a5ULL, 0xfa649f996e5adb85ULL },
+  { 0x4f5951da897f5731ULL, 0xee6c4826de867164ULL },
+  { 0x0bc7757b961cb45bULL, 0x35c586db22a96f77ULL },
+  { 0xc70c19f1b7b9f8e5ULL, 0x3157bdb54fd84d42ULL },
+  { 0x83923d50a8da1b8fULL, 0xeafe7348b3f75351ULL },
+  { 0x36f3c18cf59a60f0ULL, 0x391acb69953a0928ULL },
+  { 0x726de52deaf9839aULL, 0xe2b305946915173bULL },
+  { 0xbea689a7cb5ccf24ULL, 0xe6213efa0464350eULL },
+  { 0xfa38ad06d43f2c4eULL, 0x3d88f007f84b2b1dULL },
+};
 
-  while (B != 0)
-    {
-      if (B & 1)
-        prod ^= A;
 
-      B >>= 1;
-      A <<= 1;
-    }
+/*
+ * Multiplication via the logarithm tables: X^(log a + log b)
+ */
+static inline unsigned char
+f256_multiply(unsigned char a, unsigned char b)
+{
+  unsigned int l;
 
-  prod ^= f256_residue[prod >> 8];
-  return prod & 0xff;
+  if (a == 0 || b == 0)
+    return 0;
+  l = f256_logarithm[a] + f256_logarithm[b];
+  return f256_power[l >= 255 ? l - 255 : l];
 }
 
 
@@ -237,7 +472,7 @@ void
 rs_encode_block(unsigned char *parity, unsigned char *src, int count)
 {
   int i, j;
-  unsigned char leader, coeff;
+  unsigned char leader;
 
   memset(parity, 0, 16);
 
@@ -262,56 +497,95 @@ rs_encode_block(unsigned char *parity, unsigned char *src, int count)
 }
 
 /*
- * Decode a 255-byte block in place. Returns number of corrected errors,
- * if fix is set, or -1 in case of unfixed errors.
+ * Whether a 255-byte block is no codeword, i.e. has a remainder when
+ * divided by the generator polynomial. The same as any syndrome being
+ * nonzero, as its roots are X^1..X^16, but with a single table lookup
+ * per byte. This is the fast path for the common case without errors.
  */
-int
-rs_decode_block(unsigned char *blk, int fix)
+static int
+has_errors(const unsigned char *blk)
 {
-  int i, j;
-  unsigned char leader;
-  unsigned char *synbuf, *sigma, *omega;
-  int errflag = 0;
+  int k;
+  /* the remainder: bytes 0-7 in lo, 8-15 in hi */
+  uint64_t lo = 0, hi = 0;
 
-  synbuf = malloc(POLY_LENGTH);
+  for (k=254; k>=0; k--)
+    {
+      const uint64_t *prod = rsgen_mul[hi >> 56];
+      hi = ((hi << 8) | (lo >> 56)) ^ prod[1];
+      lo = ((lo << 8) | blk[k]) ^ prod[0];
+    }
+  return (lo | hi) != 0;
+}
 
-  memset(synbuf, 0 , 16);
+/*
+ * The 16 syndromes of a 255-byte block, the block evaluated at X^1..X^16.
+ * Returns 0 if all are zero, i.e. the block has no errors.
+ */
+static int
+syndromes(const unsigned char *blk, unsigned char *s)
+{
+  int j, k;
+  int errflag = 0;
+  unsigned int y[16];
 
   for (j=0; j<16; j++)
+    y[j] = blk[254];
+  /* Horner's method for all 16 at once, multiplying each by X^(j+1)
+     via the logarithm. The 16 are independent, so the lookups overlap. */
+  for (k=253; k>=0; k--)
     {
-      synbuf[j] = evaluate(blk, 255, f256_power[j+1]);
-      if (synbuf[j] != 0)
-        errflag = 1;
+      for (j=0; j<16; j++)
+        {
+          unsigned int l = f256_logarithm[y[j]] + j + 1;
+          y[j] = (y[j] ? f256_power[l >= 255 ? l - 255 : l] : 0) ^ blk[k];
+        }
     }
-
-  if (!errflag)
+  for (j=0; j<16; j++)
     {
-      debug("No error in Reed-Solomon block\n");
-          free(synbuf);
-      return 0;
+      s[j] = y[j];
+      errflag |= y[j];
     }
+  return errflag;
+}
 
+/*
+ * Decode a 255-byte block in place, without any allocation.
+ * Returns number of corrected errors, if fix is set, or -1 in case of
+ * unfixed errors. The block is left unchanged then.
+ */
+static int
+decode_block(unsigned char *blk, int fix)
+{
+  int i;
+  unsigned char synbuf[POLY_LENGTH];
+  unsigned char sigma[POLY_LENGTH];
+  unsigned char omega[POLY_LENGTH];
+  unsigned char orig[255];
+
+  /* the common case: no errors */
+  if (!has_errors(blk) || !syndromes(blk, synbuf))
+    return 0;
+
+#ifdef DEBUG
   debug("Errors detected in Reed-Solomon block\n");
   dump_syndrome(synbuf);
-
+#endif
   if (!fix)
-    {
-          free(synbuf);
-          return -1;
-    }
+    return -1;
 
-  sigma = malloc(POLY_LENGTH);
   memset(sigma, 0, POLY_LENGTH);
-
-  omega = malloc(POLY_LENGTH);
   memset(omega, 0, POLY_LENGTH);
+  memcpy(orig, blk, 255);
 
   solve_key_equation(synbuf, sigma, omega);
   i = fix_errors(blk, sigma, omega);
-
-  free(sigma);
-  free(omega);
-  free(synbuf);
+  /* more errors than correctable may lead to a wrong fix */
+  if (i >= 0 && syndromes(blk, synbuf))
+    {
+      memcpy(blk, orig, 255);
+      i = -1;
+    }
   if (i < 0)
     debug("Errors in Reed-Solomon block are not recoverable\n");
   else
@@ -320,6 +594,46 @@ rs_decode_block(unsigned char *blk, int fix)
   return i;
 }
 
+/*
+ * Decode a 255-byte block in place. Returns number of corrected errors,
+ * if fix is set, or -1 in case of unfixed errors.
+ */
+int
+rs_decode_block(unsigned char *blk, int fix)
+{
+  return decode_block(blk, fix);
+}
+
+/*
+ * Decode block_count interleaved 255-byte blocks, as in the R2007 system
+ * pages, where byte j of block i is at src[i + j*block_count].
+ * The 239 data bytes of each block are written to dst, one block after
+ * the other. Returns the number of corrected errors, if fix is set, or -1
+ * if any block has unfixed errors. Its data is copied as is then.
+ */
+int
+rs_decode_blocks(unsigned char *dst, const unsigned char *src,
+                 int block_count, int fix)
+{
+  int i, j, nerr;
+  int fixed = 0, failed = 0;
+  unsigned char blk[255];
+
+  for (i=0; i<block_count; i++)
+    {
+      for (j=0; j<255; j++)
+        blk[j] = src[i + j*block_count];
+
+      nerr = decode_block(blk, fix);
+      if (nerr < 0)
+        failed = 1;
+      else
+        fixed += nerr;
+      memcpy(&dst[i*239], blk, 239);
+    }
+  return failed ? -1 : fixed;
+}
+
 static int degree(Poly poly)
 {
   int i;
@@ -338,7 +652,7 @@ rowop(PolyMatrix matrix, int dst, int src)
   int limit;
   int power;
   unsigned char coeff;
-  int i, j, k, l;
+  int i, j;
 
   dstd = degree(matrix[dst][2]);
   srcd = degree(matrix[src][2]);
@@ -358,23 +672,10 @@ rowop(PolyMatrix matrix, int dst, int src)
     }
 }
 
-static PolyMatrix
-initialize_matrix(unsigned char *s)
+static void
+initialize_matrix(PolyMatrix matrix, unsigned char *s)
 {
-  int deg;
-  PolyMatrix matrix;
-  int i,j;
-
-  matrix = malloc(sizeof(PolyRow)*2);
-  for (i=0; i<2; i++)
-    {
-      matrix[i] = malloc(sizeof(Poly)*3);
-      for (j=0; j<3; j++)
-        {
-          matrix[i][j] = malloc(POLY_LENGTH);
-          memset(matrix[i][j], 0, POLY_LENGTH);
-        }
-    }
+  memset(matrix, 0, sizeof(PolyMatrix));
 
   /* Initialize matrix */
   matrix[0][0][0] = 1;
@@ -382,23 +683,6 @@ initialize_matrix(unsigned char *s)
 
   matrix[1][1][0] = 1;
   matrix[1][2][16] = 1;
-
-  return matrix;
-}
-
-static void
-free_matrix(PolyMatrix matrix)
-{
-  int i,j;
-
-  for (i=0; i<2; i++)
-    {
-      for (j=0; j<2; j++)
-        {
-          free(matrix[i][j]);
-        }
-      free(matrix[i]);
-    }
 }
 
 static unsigned char
@@ -407,11 +691,8 @@ evaluate(Poly poly, int deg, unsigned char x)
   unsigned char y;
 
   y = poly[deg];
-  while (deg >= 0)
-    {
-      y = f256_multiply(x, y) ^ poly[deg];
-      deg--;
-    }
+  while (--deg >= 0)
+    y = f256_multiply(x, y) ^ poly[deg];
   return y;
 }
 
@@ -420,11 +701,8 @@ solve_key_equation(unsigned char *s, unsigned char *sigma, unsigned char *omega)
 {
   int fixed_row;
   PolyMatrix matrix;
-  unsigned char leader0, leader1;
-  int x, i;
-
 
-  matrix = initialize_matrix(s);
+  initialize_matrix(matrix, s);
   fixed_row = 0;
 
   while (degree(matrix[fixed_row][0]) > 8 || degree(matrix[fixed_row][2]) > 7)
@@ -443,14 +721,12 @@ solve_key_equation(unsigned char *s, unsigned char *sigma, unsigned char *omega)
 
   memcpy(sigma, matrix[fixed_row][0], POLY_LENGTH);
   memcpy(omega, matrix[fixed_row][2], POLY_LENGTH);
-
-  free_matrix(matrix);
 }
 
 static int
 fix_errors(unsigned char *blk, unsigned char *sigma, unsigned char *omega)
 {
-  int i,j, x, d;
+  int i, x, d;
   int nerr;
   unsigned char errorval;
   unsigned char roots[8];
@@ -458,10 +734,14 @@ fix_errors(unsigned char *blk, unsigned char *sigma, unsigned char *omega)
 
   nerr = 0;
 
-  for (x=0; x<256; x++)
+  for (x=1; x<256; x++)
     {
       if (evaluate(sigma, 8, x) == 0)
-        roots[nerr++] = x;
+        {
+          if (nerr == 8)
+            return -1;
+          roots[nerr++] = x;
+        }
     }
 
   d = degree(sigma);
@@ -526,8 +806,6 @@ dump_matrix(PolyMatrix matrix)
   debug_row(matrix[1]);
 }
 
-#endif
-
 static void
 dump_syndrome(unsigned char *s)
 {
@@ -541,3 +819,5 @@ dump_syndrome(unsigned char *s)
     }
   fputc('\n',stderr);
 }
+
+#endif
@@ -0,0 +1,119 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+/*
+ * threads.c: a pool of worker threads, taking the next item from a shared
+ *            counter until all are done.
+ */
+
+#include "threads.h"
+#include <stdlib.h>
+#ifdef HAVE_UNISTD_H
+# include <unistd.h>
+#endif
+
+unsigned
+threads_num(unsigned long num, unsigned per_thread)
+{
+#ifdef USE_THREADS
+  long n = 0;
+  char *probe = getenv ("LIBREDWG_THREADS");
+  if (probe)
+    n = atol (probe);
+# ifdef _SC_NPROCESSORS_ONLN
+  if (n <= 0)
+    n = sysconf (_SC_NPROCESSORS_ONLN);
+# endif
+  if (n > MAX_THREADS)
+    n = MAX_THREADS;
+  if (n > (long)(num / per_thread))
+    n = (long)(num / per_thread);
+  return n > 1 ? (unsigned)n : 1;
+#else
+  (void)num;
+  (void)per_thread;
+  return 1;
+#endif
+}
+
+#ifdef USE_THREADS
+
+typedef struct _threads_pool
+{
+  unsigned num_items;
+  unsigned next_item;
+  Threads_Item_Fn fn;
+  void *arg;
+  pthread_mutex_t mutex;
+} Threads_Pool;
+
+static void *
+threads_worker(void *p)
+{
+  Threads_Pool *pool = (Threads_Pool *)p;
+
+  for (;;)
+    {
+      unsigned item;
+
+      pthread_mutex_lock(&pool->mutex);
+      item = pool->next_item;
+      if (item < pool->num_items)
+        pool->next_item++;
+      pthread_mutex_unlock(&pool->mutex);
+      if (item >= pool->num_items)
+        break;
+      pool->fn(pool->arg, item);
+    }
+  return NULL;
+}
+
+#endif /* USE_THREADS */
+
+unsigned
+threads_run(unsigned num_threads, unsigned num_items, Threads_Item_Fn fn,
+            void *arg)
+{
+  unsigned i;
+#ifdef USE_THREADS
+  if (num_threads > 1 && num_items > 1)
+    {
+      Threads_Pool pool;
+      pthread_t thread[MAX_THREADS];
+      unsigned num_started = 0, t;
+
+      if (num_threads > MAX_THREADS)
+        num_threads = MAX_THREADS;
+      pool.num_items = num_items;
+      pool.next_item = 0;
+      pool.fn = fn;
+      pool.arg = arg;
+      pthread_mutex_init(&pool.mutex, NULL);
+      for (t = 1; t < num_threads; t++)
+        {
+          if (!pthread_create(&thread[num_started], NULL, threads_worker,
+                              &pool))
+            num_started++;
+        }
+      threads_worker(&pool); // and join in
+      for (t = 0; t < num_started; t++)
+        pthread_join(thread[t], NULL);
+      pthread_mutex_destroy(&pool.mutex);
+      return num_started + 1;
+    }
+#else
+  (void)num_threads;
+#endif
+  for (i = 0; i < num_items; i++)
+    fn(arg, i);
+  return 1;
+}
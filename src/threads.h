@@ -0,0 +1,48 @@
+/*****************************************************************************/
+/*  LibreDWG - free implementation of the DWG file format                    */
+/*                                                                           */
+/*  Copyright (C) 2018 Free Software Foundation, Inc.                        */
+/*                                                                           */
+/*  This library is free software, licensed under the terms of the GNU       */
+/*  General Public License as published by the Free Software Foundation,     */
+/*  either version 3 of the License, or (at your option) any later version.  */
+/*  You should have received a copy of the GNU General Public License        */
+/*  along with this program.  If not, see <http://www.gnu.org/licenses/>.    */
+/*****************************************************************************/
+
+#ifndef THREADS_H
+#define THREADS_H
+
+/*
+ * threads.h: the worker threads of the object decoder and of the page
+ *            decompressor.
+ *
+ * threads_run hands out the items in order to the threads, the calling
+ * one included, which call fn for each. Without pthreads all items are
+ * processed serially.
+ */
+#ifndef _WIN32
+#include "config.h"
+#else
+#include "config_win32.h"
+#endif
+#if defined(HAVE_PTHREAD) && defined(HAVE_PTHREAD_H)
+# include <pthread.h>
+# define USE_THREADS 1
+#endif
+
+#define MAX_THREADS 64
+
+/* Number of threads for num items, with at least per_thread items for
+   each: LIBREDWG_THREADS or the number of online CPUs, at most
+   MAX_THREADS. 1 without pthreads. */
+unsigned threads_num(unsigned long num, unsigned per_thread);
+
+typedef void (*Threads_Item_Fn)(void *arg, unsigned item);
+
+/* Calls fn(arg, item) for all items with num_threads threads.
+   Returns the number of threads used. */
+unsigned threads_run(unsigned num_threads, unsigned num_items,
+                     Threads_Item_Fn fn, void *arg);
+
+#endif
@@ -0,0 +1,111 @@
+#include "../../src/arena.h"
+
+//-Wno-format-nonliteral
+#include <dejagnu.h>
+#include <string.h>
+#include <stdlib.h>
+#include "tests_common.h"
+
+#define NUM_BLOCKS 100000
+
+/* The header vars are malloc'ed before the arena exists, so dwg_free
+   must free them also in arena mode. It NULLs every freed field. */
+static void
+leak_test(const char *input, const int opts)
+{
+  Dwg_Data dwg;
+  memset(&dwg, 0, sizeof(Dwg_Data));
+  dwg.opts = opts;
+  if (dwg_read_file(input, &dwg) >= DWG_ERR_CRITICAL
+      || !dwg.header_vars.unknown_text1 || !dwg.header_vars.DIMPOST)
+    {
+      fail("dwg_read_file %s", input);
+      return;
+    }
+  dwg_free(&dwg);
+  if (!dwg.header_vars.unknown_text1 && !dwg.header_vars.DIMPOST)
+    pass("dwg_free opts 0x%x: header vars freed", opts);
+  else
+    fail("dwg_free opts 0x%x: header vars leaked", opts);
+}
+
+int
+main (int argc, char const *argv[])
+{
+  Dwg_Arena *arena = arena_new();
+  Dwg_Arena *other = arena_new();
+  char *blocks[NUM_BLOCKS];
+  char *big, *p;
+  int i;
+
+  if (!arena || !other)
+    {
+      fail("arena_new");
+      return 1;
+    }
+
+  arena_use(arena);
+  for (i = 0; i < NUM_BLOCKS; i++)
+    {
+      blocks[i] = arena_malloc(i % 61 + 1);
+      memset(blocks[i], i & 0xff, i % 61 + 1);
+    }
+  for (i = 0; i < NUM_BLOCKS; i++)
+    {
+      if ((unsigned char)blocks[i][i % 61] != (i & 0xff)
+          || ((size_t)blocks[i] & (sizeof(double) - 1)))
+        break;
+    }
+  if (i == NUM_BLOCKS)
+    pass("arena_malloc %d blocks", NUM_BLOCKS);
+  else
+    fail("arena_malloc block %d", i);
+
+  p = arena_calloc(100, 3);
+  for (i = 0; i < 300; i++)
+    if (p[i])
+      break;
+  if (i == 300)
+    pass("arena_calloc");
+  else
+    fail("arena_calloc [%d] = %d", i, p[i]);
+
+  // the last block grows in place, others are copied
+  strcpy(p, "arena");
+  p = arena_realloc(p, 1000);
+  big = arena_malloc(1024 * 1024);
+  memset(big, 1, 1024 * 1024);
+  blocks[0] = arena_realloc(blocks[0], 5000);
+  if (!strcmp(p, "arena") && blocks[0][0] == 0 && big[1024 * 1024 - 1] == 1)
+    pass("arena_realloc");
+  else
+    fail("arena_realloc");
+  arena_release(p); // no-op
+
+  arena_use(other);
+  p = arena_malloc(10);
+  strcpy(p, "other");
+  arena_use(NULL);
+  arena_join(arena, other);
+  if (!strcmp(p, "other"))
+    pass("arena_join");
+  else
+    fail("arena_join");
+
+  // no current arena: libc
+  p = arena_malloc(10);
+  arena_release(p);
+  arena_free(arena);
+  pass("arena_free");
+
+  {
+    const char *input = getenv("INPUT");
+    if (!input)
+      input = "example_2000.dwg";
+    // arena first, the version of a previous dwg_free is kept
+    leak_test(input, DWG_OPTS_ARENA);
+    leak_test(input, DWG_OPTS_ARENA | DWG_OPTS_LAZY);
+    leak_test(input, 0);
+  }
+  return 0;
+}
@@ -534,6 +534,16 @@ main (int argc, char const *argv[])
     fail("bit_calc_CRC %X", bs);
   bit_advance_position(&bitchain, 16);
 
+  {
+    // longer than one slice of 8, with a tail
+    unsigned char str[] = "123456789abcdefghij";
+    uint32_t crc32 = bit_calc_CRC32(0, str, 19);
+    if (crc32 == 0x42420DA2)
+      pass("bit_calc_CRC32");
+    else
+      fail("bit_calc_CRC32 %X", (unsigned)crc32);
+  }
+
   bit_write_TV(&bitchain, (char*)"GNU"); //now we store the \0 also
   if (bitchain.byte == 70 && bitchain.bit == 2)
     pass("bit_write_TV");
@@ -639,6 +649,18 @@ main (int argc, char const *argv[])
     else
       fail("bit_search_sentinel %d", bitchain.byte);
   }
+  {
+    unsigned char missing[16];
+    unsigned char *sentinels[] = { missing, sentinel };
+    unsigned long found[2];
+    int num;
+    memset(missing, 0xA5, 16);
+    num = bit_search_sentinels(&bitchain, sentinels, 2, found);
+    if (num == 1 && found[0] == 0 && found[1] == 108)
+      pass("bit_search_sentinels");
+    else
+      fail("bit_search_sentinels %d %lu %lu", num, found[0], found[1]);
+  }
   {
     unsigned int check = bit_calc_CRC(0xC0C1, (unsigned char *)bitchain.chain, 108);
     if (check == 0xEB57)
@@ -648,7 +670,7 @@ main (int argc, char const *argv[])
   }
 
   bit_chain_alloc(&bitchain);
-  if (bitchain.size == 82020)
+  if (bitchain.size == 82120)
     pass("bit_chain_alloc");
   else
     fail("bit_chain_alloc %ld", bitchain.size);
@@ -670,6 +692,48 @@ main (int argc, char const *argv[])
       pass("bit_convert_TU");
     free(s);
   }
+  {
+    // ASCII runs around non-ASCII, a surrogate pair and a lone surrogate
+    dwg_wchar_t w[64];
+    const char *expect = "0123456789abcdefghijklmnopqrstuv\xc3\xa4wxyz0123456789"
+                         "\xf0\x9f\x98\x80!\xef\xbf\xbd";
+    char *s;
+    BITCODE_TU back;
+    int i, n = 0;
+    for (i = 0; i < 32; i++)
+      w[n++] = expect[i];
+    w[n++] = 0xe4;
+    for (i = 34; i < 48; i++)
+      w[n++] = expect[i];
+    w[n++] = 0xd83d;
+    w[n++] = 0xde00;
+    w[n++] = '!';
+    w[n++] = 0xdc00;
+    w[n] = 0;
+    s = bit_convert_TU(w);
+    if (s && !strcmp(s, expect))
+      pass("bit_convert_TU utf-16");
+    else
+      fail("bit_convert_TU utf-16 %s", s);
+    back = bit_utf8_to_TU(s);
+    w[n - 1] = 0xfffd;
+    for (i = 0; i <= n; i++)
+      if (back[i] != w[i])
+        break;
+    if (i > n)
+      pass("bit_utf8_to_TU");
+    else
+      fail("bit_utf8_to_TU [%d] %x != %x", i, back[i], w[i]);
+    free(back);
+    free(s);
+    // invalid and truncated sequences
+    back = bit_utf8_to_TU((char *)"a\xe4\xb8");
+    if (back[0] == 'a' && back[1] == 0xfffd && back[2] == 0xfffd && !back[3])
+      pass("bit_utf8_to_TU invalid");
+    else
+      fail("bit_utf8_to_TU invalid %x %x %x", back[1], back[2], back[3]);
+    free(back);
+  }
 
   free (bitchain.chain);
   return 0;
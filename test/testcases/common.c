@@ -59,6 +59,7 @@ test_code (char *filename)
   int error;
   dwg_data dwg;
 
+  memset (&dwg, 0, sizeof (dwg_data));
   error = dwg_read_file (filename, &dwg);
   if (error < DWG_ERR_CRITICAL)
     {
@@ -2,6 +2,7 @@
 CLANG_DIAG_IGNORE(-Wpragma-pack)
 #include "../../src/decode.c"
 CLANG_DIAG_RESTORE
+#include "../../src/decompress.c"
 
 #include <dejagnu.h>
 #include "tests_common.h"
@@ -15,8 +16,10 @@ read_literal_length_tests (void)
 {
   //Prepare the sample data
   Bit_Chain bitchain = strtobt ("00000101");
+  const BITCODE_RC *src = bitchain.chain;
   unsigned char opcode = 0x05;
-  if (read_literal_length (&bitchain, &opcode) == 0x08)
+  if (read_literal_length (&src, &bitchain.chain[bitchain.size], &opcode)
+      == 0x08)
     {
       pass ("read_literal_length");
     }
@@ -30,7 +33,9 @@ void
 read_long_compression_offset_tests (void)
 {
   Bit_Chain bitchain = strtobt ("11011101");
-  if (read_long_compression_offset (&bitchain) == 0xDD)
+  const BITCODE_RC *src = bitchain.chain;
+  if (read_long_compression_offset (&src, &bitchain.chain[bitchain.size])
+      == 0xDD)
     {
       pass ("read_long_compression_offset");
     }
@@ -46,8 +51,10 @@ void
 read_two_byte_offset_tests (void)
 {
   Bit_Chain bitchain = strtobt ("1111000000000111");
+  const BITCODE_RC *src = bitchain.chain;
   int litlength = 0x03;
-  int result = read_two_byte_offset (&bitchain, &litlength);
+  int result = read_two_byte_offset (&src, &bitchain.chain[bitchain.size],
+                                     &litlength);
   if (result == 508 && litlength == 0)
     {
       pass ("read_two_byte_offset");
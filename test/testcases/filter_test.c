@@ -0,0 +1,150 @@
+#include "../../src/config.h"
+#include <dejagnu.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dwg.h"
+#include "bits.h"
+#include "out_dxf.h"
+#include "out_json.h"
+
+static int
+lines_only(const Dwg_Data *dwg, const unsigned int type)
+{
+  (void)dwg;
+  return type == DWG_TYPE_LINE;
+}
+
+static int
+reject_all(const Dwg_Data *dwg, const unsigned char *data,
+           const long unsigned int size)
+{
+  (void)dwg;
+  (void)data;
+  (void)size;
+  return 0;
+}
+
+int
+main (int argc, char const *argv[])
+{
+  Dwg_Data dwg;
+  BITCODE_BL i, lines = 0, skipped = 0;
+  const char *input = getenv("INPUT");
+  int error;
+
+  if (!input)
+    input = "example_2000.dwg";
+  /* without the option the filter is not read */
+  memset(&dwg, 0, sizeof(Dwg_Data));
+  dwg.decode_filter = lines_only;
+  error = dwg_read_file(input, &dwg);
+  if (error >= DWG_ERR_CRITICAL)
+    {
+      fail("dwg_read_file %s: 0x%x", input, error);
+      return 1;
+    }
+  if (!dwg.decode_filter)
+    pass("decode_filter ignored");
+  else
+    fail("decode_filter ignored");
+  dwg_free(&dwg);
+
+  /* without the option the objects_filter is not read */
+  memset(&dwg, 0, sizeof(Dwg_Data));
+  dwg.objects_filter = reject_all;
+  error = dwg_read_file(input, &dwg);
+  if (error < DWG_ERR_CRITICAL && !dwg.objects_filter && dwg.num_objects)
+    pass("objects_filter ignored");
+  else
+    fail("objects_filter ignored");
+  dwg_free(&dwg);
+
+  memset(&dwg, 0, sizeof(Dwg_Data));
+  dwg.opts = DWG_OPTS_OBJECTS_FILTER;
+  dwg.objects_filter = reject_all;
+  error = dwg_read_file(input, &dwg);
+  if (dwg.objects_filter == reject_all && !dwg.num_objects)
+    pass("objects_filter kept");
+  else
+    fail("objects_filter kept: %u objects", dwg.num_objects);
+  dwg_free(&dwg);
+
+  memset(&dwg, 0, sizeof(Dwg_Data));
+  dwg.opts = DWG_OPTS_DECODE_FILTER;
+  dwg.decode_filter = lines_only;
+  error = dwg_read_file(input, &dwg);
+  if (error >= DWG_ERR_CRITICAL)
+    {
+      fail("dwg_read_file %s: 0x%x", input, error);
+      return 1;
+    }
+  if (dwg.decode_filter == lines_only)
+    pass("decode_filter kept");
+  else
+    fail("decode_filter kept");
+
+  for (i = 0; i < dwg.num_objects; i++)
+    {
+      Dwg_Object *obj = &dwg.object[i];
+      if (obj->type == DWG_TYPE_LINE && obj->tio.entity
+          && obj->tio.entity->tio.LINE)
+        lines++;
+      else if (obj->supertype == DWG_SUPERTYPE_UNKNOWN && !obj->tio.object
+               && obj->handle.value
+               && dwg_resolve_handle(&dwg, obj->handle.value) == obj)
+        skipped++;
+      else if (obj->fixedtype != DWG_TYPE_BLOCK_CONTROL
+               && obj->fixedtype != DWG_TYPE_LAYER_CONTROL
+               && obj->fixedtype != DWG_TYPE_STYLE_CONTROL
+               && obj->fixedtype != DWG_TYPE_LTYPE_CONTROL
+               && obj->fixedtype != DWG_TYPE_VIEW_CONTROL
+               && obj->fixedtype != DWG_TYPE_UCS_CONTROL
+               && obj->fixedtype != DWG_TYPE_VPORT_CONTROL
+               && obj->fixedtype != DWG_TYPE_APPID_CONTROL
+               && obj->fixedtype != DWG_TYPE_DIMSTYLE_CONTROL
+               && obj->fixedtype != DWG_TYPE_VPORT_ENTITY_CONTROL)
+        break;
+    }
+  if (i == dwg.num_objects && lines && skipped)
+    pass("decode_filter: %u lines, %u skipped", lines, skipped);
+  else
+    fail("decode_filter: object %u type %u", i, dwg.object[i].type);
+
+  if (dwg.layer_control.num_entries && dwg.layer_control.layers
+      && dwg.layer_control.layers[0] && dwg.layer_control.layers[0]->obj)
+    pass("layer_control");
+  else
+    fail("layer_control");
+
+  /* the skipped objects must be ignored by all writers and dispatchers */
+  {
+    Bit_Chain dat;
+    memset(&dat, 0, sizeof(Bit_Chain));
+    dat.version = dwg.header.version;
+    dat.from_version = dwg.header.from_version;
+    dat.fh = tmpfile();
+    error = dwg_write_dxf(&dat, &dwg);
+    error |= dwg_write_dxfb(&dat, &dwg);
+    error |= dwg_write_json(&dat, &dwg);
+    error |= dwg_write_geojson(&dat, &dwg);
+    fclose(dat.fh);
+    if (error < DWG_ERR_CRITICAL)
+      pass("write dxf, dxfb, json and geojson");
+    else
+      fail("write dxf, dxfb, json and geojson: 0x%x", error);
+  }
+#ifdef USE_WRITE
+  error = dwg_write_file("filter_test.dwg", &dwg);
+  remove("filter_test.dwg");
+  if (error >= DWG_ERR_CRITICAL)
+    pass("write dwg: 0x%x", error);
+  else
+    fail("write dwg without the skipped objects");
+#endif
+
+  for (i = 0; i < dwg.num_objects; i++)
+    dwg_free_object(&dwg.object[i]);
+  dwg_free(&dwg);
+  pass("free");
+  return 0;
+}
@@ -40,5 +40,36 @@ main (int argc, char const *argv[])
         fail("hash_get(%d) => %d", rnd, v);
     }
 
+  // handles above 32 bits
+  for (i=1; i < 1000; i++)
+    hash_set(hash, ((uint64_t)i << 32) | 1, i);
+  for (i=1; i < 1000; i++)
+    {
+      uint32_t v;
+      if ((v = hash_get(hash, ((uint64_t)i << 32) | 1)) != (uint32_t)i)
+        fail("hash_get(%d << 32 | 1) => %d", i, v);
+    }
+  pass("hash 64-bit keys");
+
+  for (i=2; i < max/PRESSURE_FACTOR; i += 2)
+    {
+      uint32_t v;
+      if ((v = hash_del(hash, i)) != (uint32_t)i+1)
+        fail("hash_del(%d) => %d", i, v);
+    }
+  for (i=1; i < max/PRESSURE_FACTOR; i++)
+    {
+      uint32_t v = hash_get(hash, i);
+      if (v != (i % 2 ? (uint32_t)i+1 : HASH_NOT_FOUND))
+        fail("hash_get(%d) after hash_del => %d", i, v);
+    }
+  for (i=2; i < max/PRESSURE_FACTOR; i += 2)
+    hash_set(hash, i, i+1);
+  if (hash->elems == (uint32_t)(max/PRESSURE_FACTOR - 1 + 999))
+    pass("hash_del elems %u", hash->elems);
+  else
+    fail("hash_del elems %u", hash->elems);
+
+  hash_free(hash);
   return 0;
 }
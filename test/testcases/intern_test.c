@@ -0,0 +1,83 @@
+#include <dejagnu.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dwg.h"
+
+#define NUM_STRINGS 1000
+
+int
+main (int argc, char const *argv[])
+{
+  Dwg_Data dwg;
+  BITCODE_RS layer[] = { 'L', 'a', 'y', 'e', 'r', '1', 0 };
+  BITCODE_RS copy[] = { 'L', 'a', 'y', 'e', 'r', '1', 0 };
+  BITCODE_RS other[] = { 'L', 'a', 'y', 'e', 'r', '2', 0 };
+  BITCODE_RS greek[] = { 0x3b1, 0x20ac, 0 }; // α€
+  BITCODE_RS wstr[8];
+  char *names[NUM_STRINGS];
+  char *s1, *s2;
+  int i;
+
+  memset(&dwg, 0, sizeof(Dwg_Data));
+
+  s1 = dwg_intern_TU(&dwg, (BITCODE_TU)layer);
+  s2 = dwg_intern_TU(&dwg, (BITCODE_TU)copy);
+  if (s1 && !strcmp(s1, "Layer1") && s1 == s2)
+    pass("dwg_intern_TU same string");
+  else
+    fail("dwg_intern_TU same string %s %p %p", s1, s1, s2);
+
+  s2 = dwg_intern_TU(&dwg, (BITCODE_TU)other);
+  if (s2 && !strcmp(s2, "Layer2") && s1 != s2)
+    pass("dwg_intern_TU other string");
+  else
+    fail("dwg_intern_TU other string %s", s2);
+
+  s2 = dwg_intern_TU(&dwg, (BITCODE_TU)greek);
+  if (s2 && !strcmp(s2, "\xce\xb1\xe2\x82\xac"))
+    pass("dwg_intern_TU utf-8");
+  else
+    fail("dwg_intern_TU utf-8 %s", s2);
+
+  if (!dwg_intern_TU(&dwg, NULL))
+    pass("dwg_intern_TU NULL");
+  else
+    fail("dwg_intern_TU NULL");
+
+  // enough to grow the table, the earlier copies must stay valid
+  for (i = 0; i < NUM_STRINGS; i++)
+    {
+      int j;
+      char name[8];
+      sprintf(name, "%d", i);
+      for (j = 0; name[j]; j++)
+        wstr[j] = name[j];
+      wstr[j] = 0;
+      names[i] = dwg_intern_TU(&dwg, (BITCODE_TU)wstr);
+    }
+  for (i = 0; i < NUM_STRINGS; i++)
+    {
+      char name[8];
+      int j;
+      sprintf(name, "%d", i);
+      for (j = 0; name[j]; j++)
+        wstr[j] = name[j];
+      wstr[j] = 0;
+      if (!names[i] || strcmp(names[i], name)
+          || names[i] != dwg_intern_TU(&dwg, (BITCODE_TU)wstr))
+        break;
+    }
+  if (i == NUM_STRINGS && !strcmp(s1, "Layer1")
+      && s1 == dwg_intern_TU(&dwg, (BITCODE_TU)layer))
+    pass("dwg_intern_TU %d strings", NUM_STRINGS);
+  else
+    fail("dwg_intern_TU string %d", i);
+
+  dwg_free(&dwg);
+  if (!dwg.strings)
+    pass("dwg_free strings");
+  else
+    fail("dwg_free strings");
+  return 0;
+}
@@ -94,12 +94,12 @@ common_entity_attrs (xmlNodePtr node, const Dwg_Object *obj)
   //Always return the default "0"
   name = dwg_ent_get_layer_name(ent, &error);
   if (!error)
-    newXMLcProp ("Layer", name); //leaks r2007+
+    newXMLcProp ("Layer", name);
 
   //Always return the default: ByLayer
   name = dwg_ref_get_table_name(ent->ltype, &error);
   if (!error)
-    newXMLcProp ("Linetype", name); //leaks r2007+
+    newXMLcProp ("Linetype", name);
 
   buf = doubletochar (ent->linetype_scale);
   newXMLProp ("LinetypeScale", buf);
@@ -109,11 +109,11 @@ common_entity_attrs (xmlNodePtr node, const Dwg_Object *obj)
 
   name = dwg_ref_get_table_name(ent->material, &error);
   if (!error)
-    newXMLcProp ("Material", name); //leaks r2007+
+    newXMLcProp ("Material", name);
 
   name = dwg_ref_get_table_name(ent->plotstyle, &error);
   if (!error)
-    newXMLcProp ("PlotStyleName", name); //leaks r2007+
+    newXMLcProp ("PlotStyleName", name);
 }
 
 /*